@@ -9,32 +9,101 @@
 #define WIFI_SSID "ProjectNightfall"
 #define WIFI_PASSWORD "rescue2025"
 #define WIFI_SERVER_PORT 8888
+#define WIFI_SERVER_IP "192.168.4.1"           // Rear board's AP
+#define WIFI_FRONT_STATIC_IP "192.168.4.200"   // Above the AP's DHCP pool (.2 - .101)
+#define WIFI_CAMERA_STATIC_IP "192.168.4.201"
+#define DASHBOARD_FS_ROOT "/www" // Packed dashboard on the rear LittleFS (tools/pack_dashboard.py)
 
 // Serial Configuration
 #define SERIAL_BAUD_RATE 115200
 
 // Motor Settings
-#define MOTOR_PWM_FREQ 5000         // Hz
-#define MOTOR_PWM_RESOLUTION 8      // 8-bit (0-255)
+#define MOTOR_PWM_FREQ 20000        // Hz (above hearing)
+#define MOTOR_PWM_RESOLUTION 10     // bits of duty; speed commands stay -255..255
+#define MOTOR_DEADBAND_DUTY 0.15f   // Duty fraction where an uncalibrated wheel starts to turn
+#define MOTOR_CAL_NVS_NAMESPACE "motor_cal" // Preferences namespace for the per-motor duty curves
 #define MOTOR_NORMAL_SPEED 180      // Normal cruising speed
 #define MOTOR_CLIMB_SPEED 255       // Maximum climbing speed
+#define CLIMB_MAX_CLOSING_CM_S 20.0f // Range closing faster than this while climbing = collision
 #define MOTOR_TURN_SPEED 150        // Speed during turns
 #define MOTOR_BACK_NORMAL_SPEED 150 // Rear motor default speed
+#define DRIVE_FULL_SCALE_CM_S 100.0f // Loaded ground speed at command 255 (stall detector model)
+#define FRONT_MOTOR_RAMP_MS 0       // Front: LEDC fade ms for 0->255 (0 = instant, tracks rear)
 
 // Sensor Settings
 #define ULTRASONIC_THRESHOLD_SAFE 30     // cm - safe distance
 #define ULTRASONIC_THRESHOLD_OBSTACLE 20 // cm - obstacle detected
 #define ULTRASONIC_THRESHOLD_CLIFF 10    // cm - cliff/climbable edge
+#define US_MEDIAN_WINDOW 5               // Samples in the per-sensor median filter
+#define US_STALE_MS 400                  // ms without a valid echo before a range is stale
+#define US_MIN_CONFIDENCE 0.3f           // Below this, motion is slowed to creep speed
+
+// Ultrasonic firing schedule
+#define US_SCHED_TICK_MS 5                // Scheduler timer period (echo collection granularity)
+#define US_GROUP_GAP_MS 5                 // Quiet time between firing groups (stray echoes)
+#define US_GROUP_MIN_SEPARATION_DEG 120   // Sensors this far apart fire together
+#define US_TRAVEL_PRIORITY_BOOST 2        // Extra firing weight for the group facing travel
+#define US_TRAVEL_CONE_DEG 30             // Sensors within this of travel direction get the boost
+#define US_SECTOR_HALF_WIDTH_DEG 60       // Sensors within this of the axis feed front/rear range
 
 #define GAS_THRESHOLD_ALERT 400     // Analog value threshold (0-4095)
 #define GAS_THRESHOLD_ANALOG 350    // Gas sensor baseline (0-4095) for SafetyMonitor
 #define GAS_THRESHOLD_EMERGENCY 500 // Emergency threshold
 
+// Gas ADC acquisition (readings are calibrated, then expressed as 0-4095 counts
+// of GAS_ADC_FULL_SCALE_MV so the thresholds above stay board-independent)
+#define GAS_ADC_CONTINUOUS 1         // 1 = DMA continuous mode, 0 = polled analogRead
+#define GAS_ADC_SAMPLE_RATE_HZ 20000 // Conversion rate in continuous mode
+#define GAS_ADC_DECIMATION_LOG2 8    // CIC ratio 256 -> ~78 Hz output
+#define GAS_ADC_FULL_SCALE_MV 3300   // Voltage mapped to 4095 counts
+
+// Geometry (for odometry and mapping)
+#define ROBOT_TRACK_WIDTH_CM 18.0f // Distance between left and right wheels
+#define US_FRONT_OFFSET_CM 10.0f   // Front ultrasonic mount ahead of robot centre
+#define US_REAR_OFFSET_CM 10.0f    // Rear ultrasonic mount behind robot centre
+#define US_MAP_MAX_RANGE_CM 300.0f // Ranges beyond this are mapped as "no echo"
+
 // Safety & Navigation
 #define ENABLE_AUTONOMOUS 1               // Toggle autonomous mode
 #define NAVIGATION_UPDATE_INTERVAL_MS 200 // ms between nav updates
 #define SENSOR_UPDATE_INTERVAL_MS 100     // ms between sensor reads
 #define TELEMETRY_INTERVAL_MS 500         // ms between telemetry broadcasts
+#define MAP_STREAM_INTERVAL_MS 250        // ms between occupancy grid delta messages
+#define MAP_TILES_PER_MESSAGE 4           // Max changed tiles per delta message
+#define PLANNER_MAX_EXPANSIONS 150        // D* Lite node expansions per loop tick (~1 ms)
+
+// Link supervision (WebSocket ping/pong per role)
+#define LINK_PING_INTERVAL_MS 100      // Server pings every client at this rate
+#define LINK_DEGRADED_AGE_MS 300       // Heartbeat older than this -> degraded
+#define LINK_LOST_AGE_MS 600           // Heartbeat older than this -> lost
+#define LINK_DEGRADED_RTT_MS 150       // Smoothed RTT above this -> degraded
+#define LINK_MIN_TX_SPACE 1024         // Free TCP send buffer below this -> degraded
+#define LINK_DEGRADED_SPEED_LIMIT 100  // PWM cap while a required link is degraded
+#define LINK_REQUIRE_FRONT 1           // Stop when the front motor link is lost
+#define LINK_REQUIRE_DASHBOARD 1       // Stop when the operator dashboard is lost
+
+// Client reconnect (front, camera)
+#define WIFI_CACHED_ATTEMPTS 3         // Rejoins on the cached BSSID/channel before a full scan
+#define WIFI_RETRY_MIN_MS 100          // Between WiFi join attempts
+#define WIFI_RETRY_SCAN_MS 2000        // Between full-scan join attempts
+#define WS_RECONNECT_MIN_MS 20         // First WebSocket retry after the link is back
+#define WS_RECONNECT_MAX_MS 2000       // Backoff ceiling
+#define WS_RECONNECT_JITTER_PCT 25     // +/- random spread on each backoff step
+#define WS_HEARTBEAT_INTERVAL_MS 500   // Client ping; a half-open link is dropped after
+#define WS_HEARTBEAT_TIMEOUT_MS 300    // two missed pongs
+
+// Safety supervisor (independent task, cuts the rear bridge directly)
+#define SAFETY_SUPERVISOR_PERIOD_MS 10 // Rule evaluation period
+#define SAFETY_TASK_PRIORITY 20        // Above loop() and AsyncTCP, below the IPC tasks
+#define SAFETY_TASK_CORE 1             // Same core as loop() so it preempts it
+#define SAFETY_LOOP_STALL_MS 250       // loop() silent this long while driving -> outputs cut
+
+// Relay autotune of the approach loop (run from IDLE facing a wall)
+#define AUTOTUNE_RELAY_PWM 90          // Relay amplitude: +-PWM around standstill
+#define AUTOTUNE_HYSTERESIS_CM 1.5f    // Relay band around the setpoint (above range noise)
+#define AUTOTUNE_CYCLES 4              // Consistent limit cycles required
+#define AUTOTUNE_TIMEOUT_MS 60000      // Give up after this long
+#define GAIN_SCHEDULE_NVS_NAMESPACE "approach_gs" // Preferences namespace for the approach gain schedule
 
 // Watchdog & Timing
 #define MAIN_LOOP_RATE_MS 50                 // Main loop target frequency (20 Hz)
@@ -65,7 +134,8 @@ enum RobotState
     STATE_AUTONOMOUS,
     STATE_MANUAL,
     STATE_EMERGENCY,
-    STATE_ERROR
+    STATE_ERROR,
+    ROBOT_STATE_COUNT // Number of states (not a state)
 };
 
 enum NavigationState
@@ -77,7 +147,8 @@ enum NavigationState
     NAV_BACKING_UP,
     NAV_CLIMBING,
     NAV_STUCK,
-    NAV_IDLE
+    NAV_IDLE,
+    NAV_STATE_COUNT // Number of states (not a state)
 };
 
 #endif // CONFIG_H
@@ -0,0 +1,138 @@
+#include "ClientTable.h"
+#include <string.h>
+
+ClientTable::ClientTable()
+{
+    memset(_clients, 0, sizeof(_clients));
+    memset(_roleMask, 0, sizeof(_roleMask));
+    for (uint8_t r = 0; r < LINK_ROLE_COUNT; r++)
+    {
+        _roleSlot[r] = NO_SLOT;
+    }
+}
+
+// ============================================
+// MEMBERSHIP
+// ============================================
+
+int8_t ClientTable::add(uint32_t clientId, unsigned long nowMs)
+{
+    if (clientId == 0) return NO_SLOT;
+
+    remove(clientId); // Same ID again: start over
+
+    for (int8_t i = 0; i < MAX_CLIENTS; i++)
+    {
+        if (_clients[i].clientId != 0) continue;
+
+        memset(&_clients[i], 0, sizeof(Client));
+        _clients[i].clientId = clientId;
+        _clients[i].role = LINK_ROLE_UNKNOWN; // Until a handshake says otherwise
+        _clients[i].connectedMs = nowMs;
+        _roleMask[LINK_ROLE_UNKNOWN] |= (uint8_t)(1u << i);
+        return i;
+    }
+    return NO_SLOT; // Full - the client works, it just isn't addressable
+}
+
+void ClientTable::remove(uint32_t clientId)
+{
+    int8_t slot = slotOf(clientId);
+    if (slot == NO_SLOT) return;
+
+    leaveRole(slot);
+    _clients[slot].clientId = 0;
+}
+
+bool ClientTable::setRole(uint32_t clientId, LinkRole role, unsigned long nowMs)
+{
+    int8_t slot = slotOf(clientId);
+    if (slot == NO_SLOT || role >= LINK_ROLE_COUNT) return false;
+
+    leaveRole(slot);
+
+    Client &client = _clients[slot];
+    client.role = role;
+    client.registered = true;
+    client.registeredMs = nowMs;
+    _roleMask[role] |= (uint8_t)(1u << slot);
+    _roleSlot[role] = slot;
+    return true;
+}
+
+void ClientTable::leaveRole(int8_t slot)
+{
+    LinkRole role = _clients[slot].role;
+    _roleMask[role] &= (uint8_t)~(1u << slot);
+
+    // Fall back to another client of the role, if any
+    if (_roleSlot[role] == slot)
+    {
+        _roleSlot[role] = _roleMask[role] ? (int8_t)__builtin_ctz(_roleMask[role]) : NO_SLOT;
+    }
+}
+
+int8_t ClientTable::slotOf(uint32_t clientId) const
+{
+    if (clientId == 0) return NO_SLOT;
+    for (int8_t i = 0; i < MAX_CLIENTS; i++)
+    {
+        if (_clients[i].clientId == clientId) return i;
+    }
+    return NO_SLOT;
+}
+
+// ============================================
+// ROLE LOOKUP
+// ============================================
+
+uint32_t ClientTable::getRoleClient(LinkRole role) const
+{
+    int8_t slot = _roleSlot[role];
+    return (slot == NO_SLOT) ? 0 : _clients[slot].clientId;
+}
+
+LinkRole ClientTable::getRole(uint32_t clientId) const
+{
+    int8_t slot = slotOf(clientId);
+    return (slot == NO_SLOT) ? LINK_ROLE_UNKNOWN : _clients[slot].role;
+}
+
+// ============================================
+// PER-CLIENT STATS
+// ============================================
+
+void ClientTable::onSent(int8_t slot, size_t bytes)
+{
+    if (!valid(slot)) return;
+    _clients[slot].framesSent++;
+    _clients[slot].bytesSent += bytes;
+}
+
+void ClientTable::onSentAll(size_t bytes)
+{
+    for (int8_t i = 0; i < MAX_CLIENTS; i++)
+    {
+        onSent(i, bytes);
+    }
+}
+
+void ClientTable::onDropped(int8_t slot)
+{
+    if (valid(slot)) _clients[slot].framesDropped++;
+}
+
+void ClientTable::setQueueDepth(int8_t slot, uint8_t depth)
+{
+    if (valid(slot)) _clients[slot].queueDepth = depth;
+}
+
+uint8_t ClientTable::getCount() const
+{
+    uint8_t count = 0;
+    for (uint8_t r = 0; r < LINK_ROLE_COUNT; r++)
+    {
+        count += (uint8_t)__builtin_popcount(_roleMask[r]);
+    }
+    return count;
+}
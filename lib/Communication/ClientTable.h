@@ -0,0 +1,97 @@
+#ifndef CLIENT_TABLE_H
+#define CLIENT_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "LinkSupervisor.h"
+
+/**
+ * Fixed-capacity table of the server's WebSocket clients
+ *
+ * One slot per connected client with its role, connection and
+ * registration times and send counters. Each role keeps a bitmask of the
+ * slots holding it, so "is the front connected" and "who is the front"
+ * are O(1) and nothing is allocated on connect or registration.
+ *
+ * A client is LINK_ROLE_UNKNOWN until its handshake names a role, like
+ * in LinkSupervisor. For single-instance boards the latest registration
+ * is the one addressed.
+ *
+ * Not thread-safe: the caller serialises access. Pure logic - no Arduino
+ * dependencies.
+ */
+class ClientTable
+{
+public:
+    static constexpr uint8_t MAX_CLIENTS = LinkSupervisor::MAX_LINKS;
+    static constexpr int8_t NO_SLOT = -1;
+
+    struct Client
+    {
+        uint32_t clientId;          // 0 = free slot
+        LinkRole role;
+        bool registered;            // Sent a role handshake
+        unsigned long connectedMs;
+        unsigned long registeredMs;
+        uint32_t framesSent;
+        uint32_t bytesSent;
+        uint32_t framesDropped;     // Not queued: the client's send queue was full
+        uint8_t queueDepth;         // Messages waiting to go out (last sample)
+    };
+
+    ClientTable();
+
+    // ========================================
+    // MEMBERSHIP
+    // ========================================
+
+    /**
+     * @return the client's slot, NO_SLOT if the table is full
+     */
+    int8_t add(uint32_t clientId, unsigned long nowMs);
+    void remove(uint32_t clientId);
+
+    /**
+     * Record a role handshake
+     * @return false for an unknown client
+     */
+    bool setRole(uint32_t clientId, LinkRole role, unsigned long nowMs);
+
+    int8_t slotOf(uint32_t clientId) const;
+
+    // ========================================
+    // ROLE LOOKUP (O(1))
+    // ========================================
+
+    bool isRoleConnected(LinkRole role) const { return _roleMask[role] != 0; }
+    uint8_t getRoleMask(LinkRole role) const { return _roleMask[role]; }
+
+    /**
+     * Client ID of the role's latest registration, 0 if none is connected
+     */
+    uint32_t getRoleClient(LinkRole role) const;
+
+    LinkRole getRole(uint32_t clientId) const;
+
+    // ========================================
+    // PER-CLIENT STATS
+    // ========================================
+
+    void onSent(int8_t slot, size_t bytes);
+    void onSentAll(size_t bytes);
+    void onDropped(int8_t slot);
+    void setQueueDepth(int8_t slot, uint8_t depth);
+
+    uint8_t getCount() const;
+    const Client &getClient(uint8_t slot) const { return _clients[slot]; }
+
+private:
+    Client _clients[MAX_CLIENTS];
+    uint8_t _roleMask[LINK_ROLE_COUNT];
+    int8_t _roleSlot[LINK_ROLE_COUNT];  // Latest registration per role
+
+    void leaveRole(int8_t slot);
+    bool valid(int8_t slot) const { return slot >= 0 && slot < MAX_CLIENTS && _clients[slot].clientId != 0; }
+};
+
+#endif // CLIENT_TABLE_H
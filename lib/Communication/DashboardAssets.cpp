@@ -0,0 +1,126 @@
+#include "DashboardAssets.h"
+
+#ifdef BACK_CONTROLLER
+
+#include "config.h"
+
+static const char *INDEX_FILE = "/etags.txt";
+static const char *INDEX_PAGE = "/index.html";
+static const char *ASSET_PREFIX = "/assets/";
+
+// Hashed build output never changes under the same name
+static const char *CACHE_IMMUTABLE = "public, max-age=31536000, immutable";
+static const char *CACHE_REVALIDATE = "no-cache";
+
+DashboardAssets::DashboardAssets(fs::FS &fs, const char *root)
+    : _fs(fs), _root(root), _count(0)
+{
+}
+
+bool DashboardAssets::begin()
+{
+    _count = 0;
+
+    File index = _fs.open(_root + INDEX_FILE, "r");
+    if (!index) return false;
+
+    // One "<path> <hash>" per line
+    while (index.available() && _count < MAX_FILES)
+    {
+        String line = index.readStringUntil('\n');
+        line.trim();
+        int sep = line.indexOf(' ');
+        if (sep <= 0 || line[0] != '/') continue;
+
+        _files[_count].path = line.substring(0, sep);
+        _files[_count].etag = "\"" + line.substring(sep + 1) + "\"";
+        _count++;
+    }
+    bool truncated = index.available() > 0;
+    index.close();
+
+    if (truncated) DEBUG_PRINTF("[Dashboard] More than %u files - rest not served\n", MAX_FILES);
+    DEBUG_PRINTF("[Dashboard] %u files under %s\n", _count, _root.c_str());
+    return _count > 0;
+}
+
+// ============================================
+// LOOKUP
+// ============================================
+
+const DashboardAssets::Entry *DashboardAssets::find(const String &path) const
+{
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (_files[i].path == path) return &_files[i];
+    }
+    return nullptr;
+}
+
+const DashboardAssets::Entry *DashboardAssets::resolve(const String &url) const
+{
+    if (url == "/") return find(INDEX_PAGE);
+
+    const Entry *entry = find(url);
+    if (entry) return entry;
+
+    // A client-side route, not a missing file
+    int slash = url.lastIndexOf('/');
+    if (url.indexOf('.', slash) < 0) return find(INDEX_PAGE);
+    return nullptr;
+}
+
+const char *DashboardAssets::contentType(const String &path)
+{
+    if (path.endsWith(".html")) return "text/html";
+    if (path.endsWith(".js")) return "application/javascript";
+    if (path.endsWith(".css")) return "text/css";
+    if (path.endsWith(".svg")) return "image/svg+xml";
+    if (path.endsWith(".png")) return "image/png";
+    if (path.endsWith(".ico")) return "image/x-icon";
+    if (path.endsWith(".json") || path.endsWith(".map")) return "application/json";
+    if (path.endsWith(".woff2")) return "font/woff2";
+    return "application/octet-stream";
+}
+
+// ============================================
+// REQUESTS (AsyncTCP task)
+// ============================================
+
+bool DashboardAssets::canHandle(AsyncWebServerRequest *request)
+{
+    if (request->method() != HTTP_GET || !resolve(request->url())) return false;
+
+    // Headers are only kept when asked for before parsing
+    request->addInterestingHeader("If-None-Match");
+    return true;
+}
+
+void DashboardAssets::handleRequest(AsyncWebServerRequest *request)
+{
+    const Entry *entry = resolve(request->url());
+    if (!entry)
+    {
+        request->send(404);
+        return;
+    }
+
+    const char *cache = entry->path.startsWith(ASSET_PREFIX) ? CACHE_IMMUTABLE : CACHE_REVALIDATE;
+
+    AsyncWebServerResponse *response;
+    if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == entry->etag)
+    {
+        response = request->beginResponse(304);
+    }
+    else
+    {
+        response = request->beginResponse(_fs, _root + entry->path + ".gz", contentType(entry->path));
+        response->addHeader("Content-Encoding", "gzip");
+    }
+    response->addHeader("ETag", entry->etag);
+    response->addHeader("Cache-Control", cache);
+    response->addHeader("Vary", "Accept-Encoding");
+    request->send(response);
+}
+
+#endif // BACK_CONTROLLER
@@ -0,0 +1,66 @@
+#ifndef DASHBOARD_ASSETS_H
+#define DASHBOARD_ASSETS_H
+
+#ifdef BACK_CONTROLLER
+
+#include <Arduino.h>
+#include <FS.h>
+#include <ESPAsyncWebServer.h>
+
+/**
+ * Dashboard static files from the rear board's filesystem
+ *
+ * tools/pack_dashboard.py turns robot-dashboard/dist into data/www: every
+ * file stored gzipped as <path>.gz, plus an etags.txt index with a content
+ * hash per path. Files are sent exactly as stored (Content-Encoding: gzip):
+ * - Strong ETag from the hash; a matching If-None-Match gets 304 without
+ *   opening the file
+ * - Vite's hashed output under /assets/ is immutable for a year; anything
+ *   else (index.html) revalidates, so a new image shows up on reload
+ * - Unknown paths without an extension get index.html (client-side routes)
+ *
+ * Only paths in the index are served - nothing else on the filesystem is
+ * reachable over HTTP.
+ */
+class DashboardAssets : public AsyncWebHandler
+{
+public:
+    static const uint8_t MAX_FILES = 32;
+
+    /**
+     * @param root Directory of the packed dashboard (e.g. "/www")
+     */
+    DashboardAssets(fs::FS &fs, const char *root);
+
+    /**
+     * Load the ETag index (filesystem must be mounted)
+     * @return false if there is no packed dashboard on the image
+     */
+    bool begin();
+
+    uint8_t getFileCount() const { return _count; }
+
+    // AsyncWebHandler
+    bool canHandle(AsyncWebServerRequest *request) override;
+    void handleRequest(AsyncWebServerRequest *request) override;
+
+private:
+    struct Entry
+    {
+        String path;    // URL path, e.g. "/assets/index-3f2a.js"
+        String etag;    // Quoted, ready for the header
+    };
+
+    fs::FS &_fs;
+    String _root;
+    Entry _files[MAX_FILES];
+    uint8_t _count;
+
+    const Entry *find(const String &path) const;
+    const Entry *resolve(const String &url) const;
+    static const char *contentType(const String &path);
+};
+
+#endif // BACK_CONTROLLER
+
+#endif // DASHBOARD_ASSETS_H
@@ -0,0 +1,192 @@
+#include "LinkSupervisor.h"
+#include <string.h>
+#include <strings.h>
+
+// RTT smoothing (EMA weight of a new sample, in 1/8ths)
+static const uint32_t RTT_ALPHA_8 = 2;
+
+// A pong that arrives later than this is ignored for RTT (age still counts it)
+static const uint32_t MAX_RTT_MS = 5000;
+
+static const LinkSupervisor::Thresholds DEFAULT_THRESHOLDS = {300, 600, 150, 1024};
+
+LinkSupervisor::LinkSupervisor()
+    : _thresholds(DEFAULT_THRESHOLDS)
+{
+    memset(_links, 0, sizeof(_links));
+    memset(_roles, 0, sizeof(_roles));
+    memset(_seen, 0, sizeof(_seen));
+    for (uint8_t r = 0; r < LINK_ROLE_COUNT; r++)
+    {
+        _roles[r].state = LINK_ABSENT;
+    }
+}
+
+LinkSupervisor::Link *LinkSupervisor::find(uint32_t clientId)
+{
+    for (uint8_t i = 0; i < MAX_LINKS; i++)
+    {
+        if (_links[i].used && _links[i].clientId == clientId) return &_links[i];
+    }
+    return nullptr;
+}
+
+// ============================================
+// EVENTS
+// ============================================
+
+void LinkSupervisor::onConnect(uint32_t clientId, unsigned long nowMs)
+{
+    Link *link = find(clientId);
+    for (uint8_t i = 0; !link && i < MAX_LINKS; i++)
+    {
+        if (!_links[i].used) link = &_links[i];
+    }
+    if (!link) return; // Table full - client simply isn't supervised
+
+    memset(link, 0, sizeof(Link));
+    link->used = true;
+    link->clientId = clientId;
+    link->role = LINK_ROLE_UNKNOWN; // Until a handshake says otherwise
+    link->lastRxMs = nowMs;
+    link->txSpace = 0xFFFFFFFFUL;
+}
+
+void LinkSupervisor::onDisconnect(uint32_t clientId)
+{
+    Link *link = find(clientId);
+    if (link) link->used = false;
+}
+
+void LinkSupervisor::setRole(uint32_t clientId, LinkRole role)
+{
+    Link *link = find(clientId);
+    if (link && role < LINK_ROLE_COUNT) link->role = role;
+}
+
+void LinkSupervisor::onReceive(uint32_t clientId, unsigned long nowMs)
+{
+    Link *link = find(clientId);
+    if (link) link->lastRxMs = nowMs;
+}
+
+void LinkSupervisor::onPingSent(uint32_t clientId, unsigned long nowMs)
+{
+    Link *link = find(clientId);
+    if (!link || link->pingOutstanding) return; // Keep timing the oldest ping
+    link->pingSentMs = nowMs;
+    link->pingOutstanding = true;
+}
+
+void LinkSupervisor::onPong(uint32_t clientId, unsigned long nowMs)
+{
+    Link *link = find(clientId);
+    if (!link) return;
+
+    link->lastRxMs = nowMs;
+    if (!link->pingOutstanding) return;
+    link->pingOutstanding = false;
+
+    uint32_t rtt = nowMs - link->pingSentMs;
+    if (rtt > MAX_RTT_MS) return;
+    link->rttMs = (link->rttMs == 0) ? rtt : (link->rttMs * (8 - RTT_ALPHA_8) + rtt * RTT_ALPHA_8) / 8;
+}
+
+void LinkSupervisor::setTxSpace(uint32_t clientId, uint32_t bytes, bool queueFull)
+{
+    Link *link = find(clientId);
+    if (!link) return;
+    link->txSpace = bytes;
+    link->queueFull = queueFull;
+}
+
+// ============================================
+// EVALUATION
+// ============================================
+
+LinkState LinkSupervisor::classify(const Link &link, unsigned long nowMs) const
+{
+    uint32_t age = nowMs - link.lastRxMs;
+
+    // An unanswered ping ages the link even if the last rx was recent
+    if (link.pingOutstanding && nowMs - link.pingSentMs > age) age = nowMs - link.pingSentMs;
+
+    if (age > _thresholds.lostAgeMs) return LINK_LOST;
+    if (age > _thresholds.degradedAgeMs ||
+        link.rttMs > _thresholds.degradedRttMs ||
+        link.queueFull ||
+        link.txSpace < _thresholds.minTxSpaceBytes)
+        return LINK_DEGRADED;
+    return LINK_OK;
+}
+
+void LinkSupervisor::evaluate(unsigned long nowMs)
+{
+    for (uint8_t r = 0; r < LINK_ROLE_COUNT; r++)
+    {
+        RoleHealth &health = _roles[r];
+        LinkState best = LINK_LOST;
+        const Link *bestLink = nullptr;
+        uint8_t clients = 0;
+
+        for (uint8_t i = 0; i < MAX_LINKS; i++)
+        {
+            const Link &link = _links[i];
+            if (!link.used || link.role != r) continue;
+
+            clients++;
+            LinkState s = classify(link, nowMs);
+            if (!bestLink || s < best)
+            {
+                best = s;
+                bestLink = &link;
+            }
+        }
+
+        // Only a registration makes a role seen: a board still on its way
+        // to registering must not stand in for a dashboard
+        if (clients > 0 && r != LINK_ROLE_UNKNOWN) _seen[r] = true;
+        LinkState state = _seen[r] ? best : LINK_ABSENT;
+
+        if (state == LINK_LOST && health.state != LINK_LOST) health.lostCount++;
+        health.state = state;
+        health.clients = clients;
+        health.ageMs = bestLink ? nowMs - bestLink->lastRxMs : 0;
+        health.rttMs = bestLink ? bestLink->rttMs : 0;
+        health.txSpace = bestLink ? bestLink->txSpace : 0;
+    }
+}
+
+// ============================================
+// NAMES
+// ============================================
+
+const char *LinkSupervisor::stateName(LinkState state)
+{
+    switch (state)
+    {
+        case LINK_OK:       return "ok";
+        case LINK_DEGRADED: return "degraded";
+        case LINK_LOST:     return "lost";
+        default:            return "absent";
+    }
+}
+
+const char *LinkSupervisor::roleName(LinkRole role)
+{
+    switch (role)
+    {
+        case LINK_ROLE_FRONT:  return "front";
+        case LINK_ROLE_CAMERA:    return "camera";
+        case LINK_ROLE_DASHBOARD: return "dashboard";
+        default:                  return "unknown";
+    }
+}
+
+LinkRole LinkSupervisor::roleFromString(const char *role)
+{
+    if (strcasecmp(role, "front") == 0) return LINK_ROLE_FRONT;
+    if (strcasecmp(role, "camera") == 0) return LINK_ROLE_CAMERA;
+    if (strcasecmp(role, "dashboard") == 0 || strcasecmp(role, "gateway") == 0) return LINK_ROLE_DASHBOARD;
+    return LINK_ROLE_UNKNOWN;
+}
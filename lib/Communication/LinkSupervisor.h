@@ -0,0 +1,124 @@
+#ifndef LINK_SUPERVISOR_H
+#define LINK_SUPERVISOR_H
+
+#include <stdint.h>
+
+/**
+ * Per-role WebSocket link health
+ *
+ * The server pings every client at a fixed rate; anything received
+ * (including the pong) refreshes the heartbeat. Per client it tracks
+ * heartbeat age, ping round-trip time (EMA) and send backlog, and
+ * aggregates the healthiest client of each role:
+ *
+ * - ABSENT:   role never registered since boot (no policy action)
+ * - OK
+ * - DEGRADED: heartbeat late, RTT high or send queue backing up
+ * - LOST:     heartbeat missing or connection closed; back to OK as soon
+ *             as a client of the role is healthy again
+ *
+ * Event methods are called from the AsyncTCP task; the caller serialises
+ * access. Pure logic - no Arduino dependencies.
+ */
+
+enum LinkRole
+{
+    LINK_ROLE_FRONT,
+    LINK_ROLE_CAMERA,
+    LINK_ROLE_DASHBOARD,    // Operator dashboards and the telemetry gateway
+    LINK_ROLE_UNKNOWN,      // Connected, no role handshake yet - never marks a role seen
+    LINK_ROLE_COUNT
+};
+
+enum LinkState
+{
+    LINK_ABSENT,
+    LINK_OK,
+    LINK_DEGRADED,
+    LINK_LOST
+};
+
+class LinkSupervisor
+{
+public:
+    static constexpr uint8_t MAX_LINKS = 8;
+
+    struct Thresholds
+    {
+        uint32_t degradedAgeMs;     // Heartbeat older than this -> DEGRADED
+        uint32_t lostAgeMs;         // Heartbeat older than this -> LOST
+        uint32_t degradedRttMs;     // Smoothed RTT above this -> DEGRADED
+        uint32_t minTxSpaceBytes;   // Less free send buffer -> DEGRADED
+    };
+
+    struct RoleHealth
+    {
+        LinkState state;
+        uint32_t ageMs;         // Heartbeat age of the best client
+        uint32_t rttMs;         // Smoothed ping RTT of the best client
+        uint32_t txSpace;       // Free send buffer of the best client
+        uint8_t clients;        // Connected clients with this role
+        uint32_t lostCount;     // Transitions into LOST
+    };
+
+    LinkSupervisor();
+
+    void setThresholds(const Thresholds &t) { _thresholds = t; }
+
+    // ========================================
+    // EVENTS (per client)
+    // ========================================
+
+    void onConnect(uint32_t clientId, unsigned long nowMs);
+    void onDisconnect(uint32_t clientId);
+    void setRole(uint32_t clientId, LinkRole role);
+    void onReceive(uint32_t clientId, unsigned long nowMs);
+    void onPingSent(uint32_t clientId, unsigned long nowMs);
+    void onPong(uint32_t clientId, unsigned long nowMs);
+    void setTxSpace(uint32_t clientId, uint32_t bytes, bool queueFull);
+
+    // ========================================
+    // EVALUATION
+    // ========================================
+
+    /**
+     * Recompute per-role state (call at the ping rate)
+     */
+    void evaluate(unsigned long nowMs);
+
+    LinkState getState(LinkRole role) const { return _roles[role].state; }
+    const RoleHealth &getHealth(LinkRole role) const { return _roles[role]; }
+
+    static const char *stateName(LinkState state);
+    static const char *roleName(LinkRole role);
+
+    /**
+     * Map a handshake role string to a LinkRole ("gateway" is a dashboard,
+     * anything unrecognised stays unknown)
+     */
+    static LinkRole roleFromString(const char *role);
+
+private:
+    struct Link
+    {
+        bool used;
+        uint32_t clientId;
+        LinkRole role;
+        unsigned long lastRxMs;
+        unsigned long pingSentMs;
+        bool pingOutstanding;
+        uint32_t rttMs;
+        uint32_t txSpace;
+        bool queueFull;
+    };
+
+    Link _links[MAX_LINKS];
+    RoleHealth _roles[LINK_ROLE_COUNT];
+    bool _seen[LINK_ROLE_COUNT];
+    Thresholds _thresholds;
+
+    Link *find(uint32_t clientId);
+    LinkState classify(const Link &link, unsigned long nowMs) const;
+};
+
+#endif // LINK_SUPERVISOR_H
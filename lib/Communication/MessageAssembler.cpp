@@ -0,0 +1,68 @@
+#include "MessageAssembler.h"
+#include <string.h>
+
+MessageAssembler::MessageAssembler()
+    : _length(0), _owner(0), _state(IDLE)
+{
+    _buffer[0] = '\0';
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void MessageAssembler::start(uint32_t owner, bool text)
+{
+    if (_state == ASSEMBLING || _state == DISCARDING) _stats.aborted++;
+
+    _owner = owner;
+    _length = 0;
+    _state = text ? ASSEMBLING : DISCARDING;
+    if (!text) _stats.unsupported++;
+}
+
+MessageAssembler::Result MessageAssembler::append(const uint8_t *data, size_t len, bool last)
+{
+    if (_state == ASSEMBLING)
+    {
+        if (len > CAPACITY - _length)
+        {
+            // Keep consuming to the end, but nothing more is stored
+            _stats.oversized++;
+            _state = DISCARDING;
+        }
+        else
+        {
+            memcpy(_buffer + _length, data, len);
+            _length += len;
+        }
+    }
+    else if (_state != DISCARDING)
+    {
+        return ASSEMBLER_DROPPED; // Not started (or not released)
+    }
+
+    if (!last) return ASSEMBLER_PENDING;
+
+    if (_state == DISCARDING)
+    {
+        release();
+        return ASSEMBLER_DROPPED;
+    }
+
+    _buffer[_length] = '\0';
+    _state = COMPLETE;
+    _stats.assembled++;
+    if (_length > _stats.largest) _stats.largest = (uint32_t)_length;
+    return ASSEMBLER_COMPLETE;
+}
+
+void MessageAssembler::abort()
+{
+    if (_state == ASSEMBLING || _state == DISCARDING) _stats.aborted++;
+    release();
+}
+
+void MessageAssembler::release()
+{
+    _state = IDLE;
+    _length = 0;
+    _owner = 0;
+}
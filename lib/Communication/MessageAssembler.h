@@ -0,0 +1,95 @@
+#ifndef MESSAGE_ASSEMBLER_H
+#define MESSAGE_ASSEMBLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Bounded reassembly of a WebSocket message that arrives in pieces
+ *
+ * A message can be split into several frames by the sender, and a frame
+ * into several chunks by TCP. Pieces are appended as they arrive into a
+ * fixed buffer; the message is complete on the last piece of its final
+ * frame. One assembler holds one message at a time, bound to the client
+ * that started it.
+ *
+ * Anything that can't be assembled is consumed to its end and dropped, so
+ * its tail is never mistaken for a new message:
+ * - oversized: more than CAPACITY bytes
+ * - unsupported: binary (the protocol is JSON text)
+ * - aborted: cut short by a disconnect or a new message
+ *
+ * Not thread-safe: pieces of one connection arrive on one task. Pure
+ * logic - no Arduino dependencies.
+ */
+class MessageAssembler
+{
+public:
+    static constexpr size_t CAPACITY = 4096;
+
+    enum Result : uint8_t
+    {
+        ASSEMBLER_PENDING,      // Need more pieces
+        ASSEMBLER_COMPLETE,     // getMessage() holds the whole message
+        ASSEMBLER_DROPPED       // Message ended but was discarded
+    };
+
+    struct Stats
+    {
+        uint32_t assembled;
+        uint32_t oversized;
+        uint32_t unsupported;
+        uint32_t aborted;
+        uint32_t largest;       // Bytes, of an assembled message
+    };
+
+    MessageAssembler();
+
+    /**
+     * First piece of a new message is about to be appended
+     * @param owner Connection the message belongs to
+     * @param text False for binary: the message is consumed and dropped
+     */
+    void start(uint32_t owner, bool text);
+
+    /**
+     * @param last True for the last piece of the final frame
+     */
+    Result append(const uint8_t *data, size_t len, bool last);
+
+    /**
+     * Give up on the message in progress (disconnect, protocol error)
+     */
+    void abort();
+
+    /**
+     * Done with a COMPLETE message - the buffer is free again
+     */
+    void release();
+
+    bool isBusy() const { return _state != IDLE; }
+    uint32_t getOwner() const { return _owner; }
+
+    // NUL-terminated; writable so a JSON parser can use it in place
+    char *getMessage() { return _buffer; }
+    size_t getLength() const { return _length; }
+
+    const Stats &getStats() const { return _stats; }
+
+private:
+    enum State : uint8_t
+    {
+        IDLE,
+        ASSEMBLING,
+        DISCARDING,
+        COMPLETE
+    };
+
+    char _buffer[CAPACITY + 1];
+    size_t _length;
+    uint32_t _owner;
+    State _state;
+    Stats _stats;
+};
+
+#endif // MESSAGE_ASSEMBLER_H
@@ -1,4 +1,5 @@
 #include "MessageProtocol.h"
+#include <base64.h>
 
 namespace Msg
 {
@@ -13,6 +14,7 @@ namespace Msg
     const char *TYPE_STATUS = "status";
     const char *TYPE_PING = "ping";
     const char *TYPE_ACK = "ack";
+    const char *TYPE_MAP_DELTA = "map_delta";
 
     const char *ROLE_BACK = "back";
     const char *ROLE_FRONT = "front";
@@ -21,6 +23,9 @@ namespace Msg
     const char *HAZARD_GAS = "gas_detected";
     const char *HAZARD_COLLISION = "collision";
     const char *HAZARD_TILT = "excessive_tilt";
+    const char *HAZARD_CONNECTION = "connection_lost";
+    const char *HAZARD_STALL = "control_stall";
+    const char *HAZARD_MOTOR_STALL = "motor_stall";
 
     // ==========================================
     // BUILDERS
@@ -36,6 +41,11 @@ namespace Msg
         sensors["front_dist"] = data.frontDist;
         sensors["rear_dist"] = data.rearDist;
         sensors["gas"] = data.gasLevel;
+        sensors["gas_mv"] = data.gasMillivolts;
+        sensors["front_conf"] = data.frontConfidence;
+        sensors["rear_conf"] = data.rearConfidence;
+        sensors["front_drop"] = data.frontDropouts;
+        sensors["rear_drop"] = data.rearDropouts;
 
         // Motors
         JsonObject motors = doc.createNestedObject("motors");
@@ -48,6 +58,38 @@ namespace Msg
         JsonObject state = doc.createNestedObject("state");
         state["autonomous"] = data.isAutonomous;
         state["nav_state"] = data.navState;
+        state["mode"] = data.mode;
+        state["mode_tr"] = data.modeTransitions;
+        state["mode_rej"] = data.modeRejected;
+        state["cmd_drop"] = data.cmdDrops;
+        state["cmd_coal"] = data.cmdCoalesced;
+        state["cmd_lat_ms"] = data.cmdLatencyMs;
+
+        // Transition traces: [time, from, to, event]
+        JsonArray modeTrace = state.createNestedArray("mode_trace");
+        for (uint8_t i = 0; i < data.modeTraceCount; i++)
+        {
+            JsonArray t = modeTrace.createNestedArray();
+            t.add(data.modeTrace[i].timeMs);
+            t.add(data.modeTrace[i].from);
+            t.add(data.modeTrace[i].to);
+            t.add(data.modeTrace[i].event);
+        }
+        JsonArray navTrace = state.createNestedArray("nav_trace");
+        for (uint8_t i = 0; i < data.navTraceCount; i++)
+        {
+            JsonArray t = navTrace.createNestedArray();
+            t.add(data.navTrace[i].timeMs);
+            t.add(data.navTrace[i].from);
+            t.add(data.navTrace[i].to);
+            t.add(data.navTrace[i].event);
+        }
+
+        // Local planner
+        JsonObject plan = doc.createNestedObject("plan");
+        plan["valid"] = data.planValid;
+        plan["heading"] = data.planHeading;
+        plan["exp"] = data.planExpansions;
         
         // Metadata
         doc["server_clients"] = data.clientCount;
@@ -56,6 +98,14 @@ namespace Msg
         JsonObject network = doc.createNestedObject("network");
         network["front"] = data.frontOnline;
         network["camera"] = data.cameraOnline;
+        network["front_link"] = data.frontLink;
+        network["front_rtt"] = data.frontRttMs;
+        network["front_age"] = data.frontAgeMs;
+        network["dash_link"] = data.dashboardLink;
+        network["dash_rtt"] = data.dashboardRttMs;
+        network["dash_age"] = data.dashboardAgeMs;
+        network["rx_asm"] = data.rxAssembled;
+        network["rx_drop"] = data.rxDropped;
         
         // Control debug (Phase 2.5)
         JsonObject control = doc.createNestedObject("control");
@@ -65,7 +115,29 @@ namespace Msg
         control["P"] = data.pidP;
         control["I"] = data.pidI;
         control["D"] = data.pidD;
+        control["kP"] = data.pidKp;
+        control["kI"] = data.pidKi;
+        control["kD"] = data.pidKd;
+        control["sched"] = data.gainScheduled;
+        control["tune"] = data.tuneState;
+        control["tune_cyc"] = data.tuneCycles;
         
+        // Collision guard
+        JsonObject safety = doc.createNestedObject("safety");
+        safety["level"] = data.collisionLevel;
+        safety["limit"] = data.speedLimit;
+        safety["ttc"] = data.ttc;
+        safety["closing"] = data.closingSpeed;
+        safety["gas_rise"] = data.gasRiseLevel;
+        safety["gas_base"] = data.gasBaseline;
+        safety["gas_slope"] = data.gasSlope;
+        safety["sup_trips"] = data.supervisorTrips;
+        safety["sup_stalls"] = data.supervisorStalls;
+        safety["stop_lat_us"] = data.stopLatencyUs;
+        safety["stop_lat_max_us"] = data.maxStopLatencyUs;
+        safety["sup_period_max_us"] = data.maxSupervisorPeriodUs;
+        safety["loop_gap_max_ms"] = data.maxLoopGapMs;
+
         // Timing
         JsonObject timing = doc.createNestedObject("timing");
         timing["loop_us"] = data.loopTimeUs;
@@ -77,12 +149,17 @@ namespace Msg
         rearLeft["rpm"] = data.wheelRearLeft.rpm;
         rearLeft["dist_cm"] = data.wheelRearLeft.distanceCm;
         rearLeft["stale"] = data.wheelRearLeft.stale;
+        rearLeft["traction"] = data.wheelRearLeft.traction;
+        rearLeft["ratio"] = data.wheelRearLeft.tractionRatio;
         
         JsonObject rearRight = encoders.createNestedObject("rear_right");
         rearRight["counts"] = data.wheelRearRight.counts;
         rearRight["rpm"] = data.wheelRearRight.rpm;
         rearRight["dist_cm"] = data.wheelRearRight.distanceCm;
         rearRight["stale"] = data.wheelRearRight.stale;
+        rearRight["traction"] = data.wheelRearRight.traction;
+        rearRight["ratio"] = data.wheelRearRight.tractionRatio;
+        encoders["stalls"] = data.wheelStalls;
         
         doc["ts"] = millis();
     }
@@ -114,6 +191,34 @@ namespace Msg
         doc["ts"] = millis();
     }
 
+    void buildMapDelta(JsonDocument &doc, const MapDelta &delta)
+    {
+        doc["type"] = TYPE_MAP_DELTA;
+        doc["cell_cm"] = delta.cellCm;
+        doc["tile"] = delta.tileCells;
+
+        JsonArray origin = doc.createNestedArray("origin");
+        origin.add(delta.originX);
+        origin.add(delta.originY);
+
+        JsonArray pose = doc.createNestedArray("pose");
+        pose.add(delta.poseX);
+        pose.add(delta.poseY);
+        pose.add(delta.poseHeading);
+
+        // Each tile: [tileX, tileY, base64(RLE run/value pairs)]
+        JsonArray tiles = doc.createNestedArray("tiles");
+        for (uint8_t i = 0; i < delta.tileCount; i++)
+        {
+            JsonArray tile = tiles.createNestedArray();
+            tile.add(delta.tiles[i].x);
+            tile.add(delta.tiles[i].y);
+            tile.add(base64::encode(delta.tiles[i].rle, delta.tiles[i].len));
+        }
+
+        doc["ts"] = millis();
+    }
+
     // ==========================================
     // PARSERS
     // ==========================================
@@ -24,6 +24,7 @@ namespace Msg
     extern const char *TYPE_STATUS;
     extern const char *TYPE_PING;
     extern const char *TYPE_ACK;
+    extern const char *TYPE_MAP_DELTA;
 
     // Roles
     extern const char *ROLE_BACK;
@@ -34,6 +35,9 @@ namespace Msg
     extern const char *HAZARD_GAS;
     extern const char *HAZARD_COLLISION;
     extern const char *HAZARD_TILT;
+    extern const char *HAZARD_CONNECTION;
+    extern const char *HAZARD_STALL;
+    extern const char *HAZARD_MOTOR_STALL;
 
     // ==========================================
     // STRUCTS
@@ -43,6 +47,11 @@ namespace Msg
         float frontDist;
         float rearDist;
         int gasLevel;
+        uint32_t gasMillivolts; // Calibrated MQ-2 output
+        float frontConfidence;  // Range filter confidence 0..1 (0 = stale)
+        float rearConfidence;
+        uint32_t frontDropouts;
+        uint32_t rearDropouts;
         int frontLeftSpeed;
         int frontRightSpeed;
         int rearLeftSpeed;
@@ -52,6 +61,16 @@ namespace Msg
         int clientCount;
         bool frontOnline;
         bool cameraOnline;
+
+        // Link supervision (state name, smoothed ping RTT, heartbeat age)
+        const char *frontLink;
+        uint16_t frontRttMs;
+        uint16_t frontAgeMs;
+        const char *dashboardLink;
+        uint16_t dashboardRttMs;
+        uint16_t dashboardAgeMs;
+        uint32_t rxAssembled;       // Inbound messages reassembled from pieces
+        uint32_t rxDropped;         // ... and dropped (binary, oversized, cut short)
         
         // Control debug (Phase 2.5)
         float pidOutput;
@@ -60,7 +79,56 @@ namespace Msg
         float pidP;
         float pidI;
         float pidD;
+        float pidKp;            // Gains in use (scheduled or fixed)
+        float pidKi;
+        float pidKd;
+        bool gainScheduled;
+        const char *tuneState;  // Relay autotune (RelayAutotuner::stateName)
+        uint8_t tuneCycles;
         uint16_t loopTimeUs;
+
+        // Local planner
+        bool planValid;
+        float planHeading;      // Relative heading target (rad)
+        uint16_t planExpansions;
+
+        // Collision guard (time-to-collision braking)
+        int collisionLevel;
+        int speedLimit;
+        float ttc;
+        float closingSpeed;
+
+        // Gas rate-of-rise detector
+        int gasRiseLevel;
+        float gasBaseline;
+        float gasSlope;         // counts/s
+
+        // Safety supervisor (independent task)
+        uint32_t supervisorTrips;
+        uint32_t supervisorStalls;
+        uint32_t stopLatencyUs;     // Last trip: sample -> outputs cut
+        uint32_t maxStopLatencyUs;  // Worst trip: sample -> outputs cut
+        uint32_t maxSupervisorPeriodUs;
+        uint32_t maxLoopGapMs;
+
+        // Mode / navigation state machines (newest transition first)
+        struct Transition {
+            uint32_t timeMs;
+            const char *from;
+            const char *to;
+            const char *event;
+        };
+        static constexpr uint8_t TRACE_LEN = 3;
+        const char *mode;
+        uint32_t modeTransitions;
+        uint32_t modeRejected;      // Events the current mode doesn't accept
+        uint32_t cmdDrops;          // Inbound ui_cmd queue full
+        uint32_t cmdCoalesced;      // Drive commands superseded before applied
+        uint32_t cmdLatencyMs;      // Worst ui_cmd received -> applied delay
+        Transition modeTrace[TRACE_LEN];
+        uint8_t modeTraceCount;
+        Transition navTrace[TRACE_LEN];
+        uint8_t navTraceCount;
         
         // Phase 3.1: Encoder telemetry (rear wheels)
         struct WheelTelemetry {
@@ -68,7 +136,30 @@ namespace Msg
             float rpm;
             float distanceCm;
             bool stale;
+            const char *traction;   // StallDetector::stateName
+            float tractionRatio;    // Measured / modelled counts
         } wheelRearLeft, wheelRearRight;
+        uint32_t wheelStalls;       // Stall events since boot
+    };
+
+    // One changed occupancy grid tile (RLE-encoded run/value byte pairs)
+    struct MapTile {
+        int32_t x;          // World tile coordinates
+        int32_t y;
+        const uint8_t *rle;
+        size_t len;
+    };
+
+    struct MapDelta {
+        float cellCm;
+        uint8_t tileCells;  // Cells per tile side
+        int32_t originX;    // Window lower-left, world cells
+        int32_t originY;
+        float poseX;        // Robot pose (cm, rad)
+        float poseY;
+        float poseHeading;
+        const MapTile *tiles;
+        uint8_t tileCount;
     };
 
     struct MotorCmd {
@@ -85,6 +176,7 @@ namespace Msg
     void buildMotorCmd(JsonDocument &doc, const MotorCmd &cmd);
     void buildStatus(JsonDocument &doc, const char *role, const char *status, const char *msg);
     void buildHazardAlert(JsonDocument &doc, const char *hazardType, const char *message, bool critical = true);
+    void buildMapDelta(JsonDocument &doc, const MapDelta &delta);
 
     // ==========================================
     // PARSERS (Deserialize)
@@ -1,5 +1,10 @@
 #include "WiFiManager.h"
 #include "MessageProtocol.h"
+#include "config.h"
+
+// Reassembled messages are parsed in place, so the JsonDocument pool only
+// holds the tree: nodes per byte of text, with room for short-number arrays
+static const size_t JSON_POOL_PER_BYTE = 3;
 
 // ==========================================
 // CLIENT MANAGER (Front ESP32 & Camera)
@@ -9,11 +14,18 @@
 WSClient_Manager *g_wsClientInstance = nullptr;
 
 WSClient_Manager::WSClient_Manager(const char *ssid, const char *password, const char *serverIP, uint16_t serverPort, const char *role)
-    : _ssid(ssid), _password(password), _serverIP(serverIP), _serverPort(serverPort), _role(role), _wsConnected(false), _lastWiFiCheck(0)
+    : _ssid(ssid), _password(password), _serverIP(serverIP), _serverPort(serverPort), _role(role), _wsConnected(false),
+      _useStaticIP(false), _bssid{0}, _channel(0), _wifiDropped(false), _wifiGotIP(false), _lossMs(0), _wifiUpMs(0),
+      _lastWiFiBegin(0), _wifiAttempts(0), _wsBackoffMs(WS_RECONNECT_MIN_MS), _wsBackoffStart(0), _reconnect{0, 0, 0, 0}
 {
     g_wsClientInstance = this;
 }
 
+void WSClient_Manager::setStaticIP(const char *ip)
+{
+    _useStaticIP = _staticIP.fromString(ip);
+}
+
 void WSClient_Manager::begin()
 {
     beginWithTimeout(0); // No timeout by default, use update() for non-blocking
@@ -27,8 +39,19 @@ void WSClient_Manager::beginWithTimeout(uint32_t timeoutMs)
     Serial.printf("[WSClient] Role: %s\n", _role);
     Serial.flush();
 
+    WiFi.persistent(false);         // No flash write on every join
     WiFi.mode(WIFI_STA);
-    WiFi.begin(_ssid, _password);
+    WiFi.setAutoReconnect(false);   // update() rejoins, sooner than the driver would
+    WiFi.onEvent(onWiFiEvent);
+
+    if (_useStaticIP)
+    {
+        IPAddress gateway;
+        gateway.fromString(_serverIP);
+        WiFi.config(_staticIP, gateway, IPAddress(255, 255, 255, 0));
+        Serial.printf("[WSClient] Static IP: %s\n", _staticIP.toString().c_str());
+    }
+    startWiFi();
 
     // If timeout specified, wait for connection (useful during boot)
     if (timeoutMs > 0) {
@@ -62,8 +85,10 @@ void WSClient_Manager::beginWithTimeout(uint32_t timeoutMs)
     // Register event handler
     _webSocket.onEvent(onWebSocketEvent);
 
-    // Auto reconnect every 5s if lost
-    _webSocket.setReconnectInterval(5000);
+    // Retry soon, backing off while the server stays away; the heartbeat
+    // drops a half-open connection instead of waiting on TCP
+    resetBackoff();
+    _webSocket.enableHeartbeat(WS_HEARTBEAT_INTERVAL_MS, WS_HEARTBEAT_TIMEOUT_MS, 2);
     
     Serial.println("[WSClient] ===== Startup Complete =====");
     Serial.println();
@@ -74,19 +99,98 @@ void WSClient_Manager::update()
 {
     unsigned long now = millis();
 
-    // WiFi Reconnect Logic
-    if (now - _lastWiFiCheck >= 5000)
+    // Associated and addressed again: remember the AP, retry the server now
+    if (_wifiGotIP)
     {
-        _lastWiFiCheck = now;
-        if (WiFi.status() != WL_CONNECTED)
+        _wifiGotIP = false;
+        const uint8_t *bssid = WiFi.BSSID();
+        if (bssid)
         {
-            Serial.println("[WSClient] WiFi lost. Reconnecting...");
-            WiFi.disconnect();
-            WiFi.begin(_ssid, _password);
+            memcpy(_bssid, bssid, sizeof(_bssid));
+            _channel = WiFi.channel();
         }
+        _wifiAttempts = 0;
+        if (_lossMs) _wifiUpMs = now;
+        resetBackoff();
+        Serial.printf("[WSClient] WiFi up: %s (channel %d)\n", WiFi.localIP().toString().c_str(), (int)_channel);
+    }
+
+    // Dropped (or the last join failed): rejoin right away; poll slowly in
+    // case no event comes
+    bool dropped = _wifiDropped && (now - _lastWiFiBegin >= WIFI_RETRY_MIN_MS);
+    if (dropped || (WiFi.status() != WL_CONNECTED && now - _lastWiFiBegin >= WIFI_RETRY_SCAN_MS))
+    {
+        _wifiDropped = false;
+        if (_wsConnected) _webSocket.disconnect(); // The TCP connection died with the link
+        startWiFi();
+    }
+
+    // Each retry window that passes without a connection doubles the next
+    if (!_wsConnected && now - _wsBackoffStart >= _wsBackoffMs)
+    {
+        _wsBackoffStart = now;
+        _wsBackoffMs = (_wsBackoffMs * 2 < WS_RECONNECT_MAX_MS) ? _wsBackoffMs * 2 : WS_RECONNECT_MAX_MS;
+
+        uint32_t spread = _wsBackoffMs * WS_RECONNECT_JITTER_PCT / 100;
+        _webSocket.setReconnectInterval(_wsBackoffMs - spread + esp_random() % (2 * spread + 1));
     }
 
-    _webSocket.loop();
+    // No point trying the server without a network
+    if (_wsConnected || WiFi.status() == WL_CONNECTED)
+    {
+        _webSocket.loop();
+    }
+}
+
+void WSClient_Manager::startWiFi()
+{
+    _lastWiFiBegin = millis();
+
+    // The cached AP skips the scan; fall back to one in case it moved
+    if (_channel != 0 && _wifiAttempts < WIFI_CACHED_ATTEMPTS)
+        WiFi.begin(_ssid, _password, _channel, _bssid);
+    else
+        WiFi.begin(_ssid, _password);
+
+    if (_wifiAttempts < 255) _wifiAttempts++;
+}
+
+void WSClient_Manager::markLinkLost()
+{
+    if (_lossMs != 0) return; // Already timing this outage
+
+    unsigned long now = millis();
+    _lossMs = now ? now : 1;
+    _wifiUpMs = 0;
+}
+
+void WSClient_Manager::resetBackoff()
+{
+    _wsBackoffMs = WS_RECONNECT_MIN_MS;
+    _wsBackoffStart = millis();
+    _webSocket.setReconnectInterval(WS_RECONNECT_MIN_MS);
+}
+
+// System event task: only flags, update() does the work
+void WSClient_Manager::onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info)
+{
+    if (!g_wsClientInstance)
+        return;
+
+    switch (event)
+    {
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+        g_wsClientInstance->markLinkLost();
+        g_wsClientInstance->_wifiDropped = true;
+        break;
+
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+        g_wsClientInstance->_wifiGotIP = true;
+        break;
+
+    default:
+        break;
+    }
 }
 
 bool WSClient_Manager::isConnected()
@@ -121,48 +225,100 @@ void WSClient_Manager::onWebSocketEvent(WStype_t type, uint8_t *payload, size_t
     case WStype_DISCONNECTED:
         Serial.printf("[WSClient] Disconnected!\n");
         g_wsClientInstance->_wsConnected = false;
+        g_wsClientInstance->_assembly.abort();
+        g_wsClientInstance->markLinkLost();
         break;
 
     case WStype_CONNECTED:
+    {
         Serial.printf("[WSClient] Connected to url: %s\n", payload);
-        g_wsClientInstance->_wsConnected = true;
+        WSClient_Manager *self = g_wsClientInstance;
+        self->_wsConnected = true;
+        self->resetBackoff();
 
-        // Send Role Handshake
+        // Outage over (not counted on the first connect after boot)
+        if (self->_lossMs)
         {
-            StaticJsonDocument<256> doc;
-            doc["type"] = "status";
-            doc["role"] = g_wsClientInstance->_role;
-            doc["status"] = "connected";
-            g_wsClientInstance->sendMessage(doc);
+            unsigned long now = millis();
+            ReconnectStats &r = self->_reconnect;
+            r.count++;
+            r.lastMs = now - self->_lossMs;
+            if (r.lastMs > r.maxMs) r.maxMs = r.lastMs;
+            r.lastWiFiMs = self->_wifiUpMs ? self->_wifiUpMs - self->_lossMs : 0;
+            self->_lossMs = 0;
+            Serial.printf("[WSClient] Link restored in %lu ms (WiFi %lu ms)\n",
+                          (unsigned long)r.lastMs, (unsigned long)r.lastWiFiMs);
         }
-        break;
+
+        // Send Role Handshake, with how the last recovery went
+        StaticJsonDocument<256> doc;
+        doc["type"] = "status";
+        doc["role"] = self->_role;
+        doc["status"] = "connected";
+        doc["reconnects"] = self->_reconnect.count;
+        doc["reconnect_ms"] = self->_reconnect.lastMs;
+        doc["reconnect_max_ms"] = self->_reconnect.maxMs;
+        doc["wifi_ms"] = self->_reconnect.lastWiFiMs;
+        self->sendMessage(doc);
+    }
+    break;
 
     case WStype_TEXT:
     {
         StaticJsonDocument<512> doc;
         DeserializationError error = deserializeJson(doc, payload, length);
-        if (!error && g_wsClientInstance->_messageHandler)
-        {
-            g_wsClientInstance->_messageHandler(doc);
-        }
-        else if (error)
-        {
-            Serial.print("[WSClient] JSON Error: ");
-            Serial.println(error.c_str());
-        }
+        g_wsClientInstance->dispatch(doc, error);
     }
     break;
 
-    case WStype_BIN:
-    case WStype_ERROR:
+    // Message split into several frames by the server
     case WStype_FRAGMENT_TEXT_START:
     case WStype_FRAGMENT_BIN_START:
+        g_wsClientInstance->_assembly.start(0, type == WStype_FRAGMENT_TEXT_START);
+        g_wsClientInstance->appendFragment(payload, length, false);
+        break;
+
     case WStype_FRAGMENT:
     case WStype_FRAGMENT_FIN:
+        g_wsClientInstance->appendFragment(payload, length, type == WStype_FRAGMENT_FIN);
+        break;
+
+    case WStype_BIN:
+    case WStype_ERROR:
         break;
     }
 }
 
+void WSClient_Manager::appendFragment(uint8_t *payload, size_t length, bool last)
+{
+    MessageAssembler::Result result = _assembly.append(payload, length, last);
+    if (result == MessageAssembler::ASSEMBLER_COMPLETE)
+    {
+        DynamicJsonDocument doc(_assembly.getLength() * JSON_POOL_PER_BYTE + 256);
+        DeserializationError error = deserializeJson(doc, _assembly.getMessage(), _assembly.getLength());
+        dispatch(doc, error);
+        _assembly.release();
+    }
+    else if (result == MessageAssembler::ASSEMBLER_DROPPED)
+    {
+        Serial.printf("[WSClient] Fragmented message dropped (binary or over %u bytes)\n",
+                      (unsigned)MessageAssembler::CAPACITY);
+    }
+}
+
+void WSClient_Manager::dispatch(JsonDocument &doc, DeserializationError error)
+{
+    if (!error && _messageHandler)
+    {
+        _messageHandler(doc);
+    }
+    else if (error)
+    {
+        Serial.print("[WSClient] JSON Error: ");
+        Serial.println(error.c_str());
+    }
+}
+
 #endif
 
 // ==========================================
@@ -171,8 +327,11 @@ void WSClient_Manager::onWebSocketEvent(WStype_t type, uint8_t *payload, size_t
 #ifdef BACK_CONTROLLER
 
 WSServer_Manager::WSServer_Manager(uint16_t port)
-    : _server(port), _ws("/ws")
+    : _server(port), _ws("/ws"), _linkMux(portMUX_INITIALIZER_UNLOCKED), _lastPing(0), _assemblyNoSlot(0)
 {
+    LinkSupervisor::Thresholds thresholds = {
+        LINK_DEGRADED_AGE_MS, LINK_LOST_AGE_MS, LINK_DEGRADED_RTT_MS, LINK_MIN_TX_SPACE};
+    _links.setThresholds(thresholds);
 }
 
 void WSServer_Manager::begin()
@@ -195,9 +354,64 @@ void WSServer_Manager::begin()
     Serial.println("[WSServer] TCP/WS Server Started");
 }
 
+void WSServer_Manager::addHandler(AsyncWebHandler *handler)
+{
+    _server.addHandler(handler);
+}
+
 void WSServer_Manager::update()
 {
     _ws.cleanupClients();
+
+    unsigned long now = millis();
+    if (now - _lastPing >= LINK_PING_INTERVAL_MS)
+    {
+        _lastPing = now;
+        superviseLinks();
+    }
+}
+
+void WSServer_Manager::superviseLinks()
+{
+    unsigned long now = millis();
+
+    // Ping everyone; the pong (or any other frame) is the heartbeat
+    for (AsyncWebSocketClient *client : _ws.getClients())
+    {
+        if (client->status() != WS_CONNECTED)
+            continue;
+
+        client->ping();
+        uint32_t space = client->client() ? client->client()->space() : 0;
+        bool full = client->queueIsFull();
+        size_t depth = client->queueLen();
+
+        portENTER_CRITICAL(&_linkMux);
+        _links.onPingSent(client->id(), now);
+        _links.setTxSpace(client->id(), space, full);
+        _clients.setQueueDepth(_clients.slotOf(client->id()), depth > 255 ? 255 : (uint8_t)depth);
+        portEXIT_CRITICAL(&_linkMux);
+    }
+
+    portENTER_CRITICAL(&_linkMux);
+    _links.evaluate(now);
+    portEXIT_CRITICAL(&_linkMux);
+}
+
+LinkState WSServer_Manager::getLinkState(LinkRole role)
+{
+    portENTER_CRITICAL(&_linkMux);
+    LinkState state = _links.getState(role);
+    portEXIT_CRITICAL(&_linkMux);
+    return state;
+}
+
+LinkSupervisor::RoleHealth WSServer_Manager::getLinkHealth(LinkRole role)
+{
+    portENTER_CRITICAL(&_linkMux);
+    LinkSupervisor::RoleHealth health = _links.getHealth(role);
+    portEXIT_CRITICAL(&_linkMux);
+    return health;
 }
 
 void WSServer_Manager::broadcast(const JsonDocument &doc)
@@ -205,6 +419,77 @@ void WSServer_Manager::broadcast(const JsonDocument &doc)
     String msg;
     serializeJson(doc, msg);
     _ws.textAll(msg);
+
+    portENTER_CRITICAL(&_linkMux);
+    _clients.onSentAll(msg.length());
+    portEXIT_CRITICAL(&_linkMux);
+}
+
+bool WSServer_Manager::sendToRole(LinkRole role, const JsonDocument &doc)
+{
+    portENTER_CRITICAL(&_linkMux);
+    uint32_t id = _clients.getRoleClient(role);
+    portEXIT_CRITICAL(&_linkMux);
+    if (id == 0) return false;
+
+    return sendTo(_ws.client(id), doc);
+}
+
+bool WSServer_Manager::sendTo(AsyncWebSocketClient *client, const JsonDocument &doc)
+{
+    if (!client || client->status() != WS_CONNECTED) return false;
+
+    portENTER_CRITICAL(&_linkMux);
+    int8_t slot = _clients.slotOf(client->id());
+    portEXIT_CRITICAL(&_linkMux);
+
+    // The library would discard it anyway - count it here
+    if (client->queueIsFull())
+    {
+        portENTER_CRITICAL(&_linkMux);
+        _clients.onDropped(slot);
+        portEXIT_CRITICAL(&_linkMux);
+        return false;
+    }
+
+    String msg;
+    serializeJson(doc, msg);
+    client->text(msg);
+
+    portENTER_CRITICAL(&_linkMux);
+    _clients.onSent(slot, msg.length());
+    portEXIT_CRITICAL(&_linkMux);
+    return true;
+}
+
+void WSServer_Manager::publish(const JsonDocument &doc)
+{
+    String msg;
+    serializeJson(doc, msg);
+
+    for (AsyncWebSocketClient *client : _ws.getClients())
+    {
+        if (client->status() != WS_CONNECTED)
+            continue;
+
+        portENTER_CRITICAL(&_linkMux);
+        int8_t slot = _clients.slotOf(client->id());
+        LinkRole role = _clients.getRole(client->id());
+        bool board = (role == LINK_ROLE_FRONT || role == LINK_ROLE_CAMERA);
+        portEXIT_CRITICAL(&_linkMux);
+        if (board)
+            continue;
+
+        bool full = client->queueIsFull();
+        if (!full) client->text(msg);
+
+        portENTER_CRITICAL(&_linkMux);
+        if (full)
+            _clients.onDropped(slot);
+        else
+            _clients.onSent(slot, msg.length());
+        portEXIT_CRITICAL(&_linkMux);
+    }
 }
 
 void WSServer_Manager::onEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len)
@@ -212,15 +497,39 @@ void WSServer_Manager::onEvent(AsyncWebSocket *server, AsyncWebSocketClient *cli
     if (type == WS_EVT_CONNECT)
     {
         Serial.printf("[WSServer] Client #%u connected from %s\n", client->id(), client->remoteIP().toString().c_str());
-        _clientRoles[client->id()] = "unknown"; // Default
+        portENTER_CRITICAL(&_linkMux);
+        _clients.add(client->id(), millis()); // Unknown until it registers
+        _links.onConnect(client->id(), millis());
+        portEXIT_CRITICAL(&_linkMux);
     }
     else if (type == WS_EVT_DISCONNECT)
     {
-        Serial.printf("[WSServer] Client #%u disconnected\n", client->id());
-        _clientRoles.erase(client->id());
+        ClientTable::Client stats = {};
+        portENTER_CRITICAL(&_linkMux);
+        int8_t slot = _clients.slotOf(client->id());
+        if (slot != ClientTable::NO_SLOT) stats = _clients.getClient(slot);
+        _clients.remove(client->id());
+        _links.onDisconnect(client->id());
+        portEXIT_CRITICAL(&_linkMux);
+
+        MessageAssembler *assembly = assemblyFor(client->id(), false);
+        if (assembly) assembly->abort();
+
+        Serial.printf("[WSServer] Client #%u disconnected (%u frames / %u bytes sent, %u dropped)\n",
+                      client->id(), stats.framesSent, stats.bytesSent, stats.framesDropped);
+    }
+    else if (type == WS_EVT_PONG)
+    {
+        portENTER_CRITICAL(&_linkMux);
+        _links.onPong(client->id(), millis());
+        portEXIT_CRITICAL(&_linkMux);
     }
     else if (type == WS_EVT_DATA)
     {
+        portENTER_CRITICAL(&_linkMux);
+        _links.onReceive(client->id(), millis());
+        portEXIT_CRITICAL(&_linkMux);
+
         handleWebSocketMessage(arg, data, len, client);
     }
 }
@@ -228,37 +537,124 @@ void WSServer_Manager::onEvent(AsyncWebSocket *server, AsyncWebSocketClient *cli
 void WSServer_Manager::handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocketClient *client)
 {
     AwsFrameInfo *info = (AwsFrameInfo *)arg;
+
+    // Whole message in one piece (the common case)
     if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT)
     {
-
         StaticJsonDocument<512> doc;
         DeserializationError error = deserializeJson(doc, data, len);
+        dispatch(doc, error, client);
+        return;
+    }
+
+    // Split across frames and/or TCP segments
+    bool first = (info->num == 0 && info->index == 0);
+    bool last = info->final && (info->index + len == info->len);
+
+    MessageAssembler *assembly = assemblyFor(client->id(), first);
+    if (!assembly) return;
+
+    if (first) assembly->start(client->id(), info->message_opcode == WS_TEXT);
 
-        if (!error)
+    MessageAssembler::Result result = assembly->append(data, len, last);
+    if (result == MessageAssembler::ASSEMBLER_COMPLETE)
+    {
+        // Strings stay in the buffer (zero-copy), the pool only holds the tree
+        DynamicJsonDocument doc(assembly->getLength() * JSON_POOL_PER_BYTE + 256);
+        DeserializationError error = deserializeJson(doc, assembly->getMessage(), assembly->getLength());
+        dispatch(doc, error, client);
+        assembly->release();
+    }
+    else if (result == MessageAssembler::ASSEMBLER_DROPPED)
+    {
+        Serial.printf("[WSServer] Message from #%u dropped (binary or over %u bytes)\n",
+                      client->id(), (unsigned)MessageAssembler::CAPACITY);
+    }
+}
+
+MessageAssembler *WSServer_Manager::assemblyFor(uint32_t clientId, bool first)
+{
+    for (uint8_t i = 0; i < REASSEMBLY_SLOTS; i++)
+    {
+        if (_assembly[i].isBusy() && _assembly[i].getOwner() == clientId) return &_assembly[i];
+    }
+
+    // Continuation of a message that was never started here (already dropped)
+    if (!first) return nullptr;
+
+    for (uint8_t i = 0; i < REASSEMBLY_SLOTS; i++)
+    {
+        if (!_assembly[i].isBusy()) return &_assembly[i];
+    }
+
+    _assemblyNoSlot++;
+    Serial.printf("[WSServer] Message from #%u dropped (all %u reassembly buffers busy)\n", clientId, REASSEMBLY_SLOTS);
+    return nullptr;
+}
+
+void WSServer_Manager::dispatch(JsonDocument &doc, DeserializationError error, AsyncWebSocketClient *client)
+{
+    if (!error)
+    {
+        // Check for status/role message
+        const char *type = doc["type"] | "";
+        if (strcmp(type, "status") == 0)
         {
-            // Check for status/role message
-            const char *type = doc["type"] | "";
-            if (strcmp(type, "status") == 0)
+            const char *role = doc["role"] | "";
+            if (strlen(role) > 0)
             {
-                const char *role = doc["role"] | "";
-                if (strlen(role) > 0)
+                LinkRole linkRole = LinkSupervisor::roleFromString(role);
+
+                portENTER_CRITICAL(&_linkMux);
+                _clients.setRole(client->id(), linkRole, millis());
+                _links.setRole(client->id(), linkRole);
+                portEXIT_CRITICAL(&_linkMux);
+                uint32_t reconnects = doc["reconnects"] | 0;
+                if (reconnects > 0)
+                {
+                    Serial.printf("[WSServer] Client #%u registered as %s (reconnect #%lu in %lu ms, WiFi %lu ms, max %lu ms)\n",
+                                  client->id(), role, (unsigned long)reconnects,
+                                  (unsigned long)(doc["reconnect_ms"] | 0UL), (unsigned long)(doc["wifi_ms"] | 0UL),
+                                  (unsigned long)(doc["reconnect_max_ms"] | 0UL));
+                }
+                else
                 {
-                    _clientRoles[client->id()] = String(role);
                     Serial.printf("[WSServer] Client #%u registered as %s\n", client->id(), role);
                 }
             }
-
-            if (_messageHandler)
-            {
-                _messageHandler(doc, client);
-            }
         }
-        else if (error)
+
+        if (_messageHandler)
         {
-            Serial.print("[WSServer] JSON Error: ");
-            Serial.println(error.c_str());
+            _messageHandler(doc, client);
         }
     }
+    else if (error)
+    {
+        Serial.print("[WSServer] JSON Error: ");
+        Serial.println(error.c_str());
+    }
+}
+
+uint32_t WSServer_Manager::getAssembledMessages()
+{
+    uint32_t count = 0;
+    for (uint8_t i = 0; i < REASSEMBLY_SLOTS; i++)
+    {
+        count += _assembly[i].getStats().assembled;
+    }
+    return count;
+}
+
+uint32_t WSServer_Manager::getDroppedMessages()
+{
+    uint32_t count = _assemblyNoSlot;
+    for (uint8_t i = 0; i < REASSEMBLY_SLOTS; i++)
+    {
+        const MessageAssembler::Stats &stats = _assembly[i].getStats();
+        count += stats.oversized + stats.unsupported + stats.aborted;
+    }
+    return count;
 }
 
 void WSServer_Manager::setMessageHandler(std::function<void(const JsonDocument &, AsyncWebSocketClient *)> handler)
@@ -271,21 +667,28 @@ uint8_t WSServer_Manager::getClientCount()
     return _ws.count();
 }
 
-String WSServer_Manager::getClientRole(uint32_t id)
+LinkRole WSServer_Manager::getClientRole(uint32_t id)
 {
-    if (_clientRoles.count(id))
-        return _clientRoles[id];
-    return "unknown";
+    portENTER_CRITICAL(&_linkMux);
+    LinkRole role = _clients.getRole(id);
+    portEXIT_CRITICAL(&_linkMux);
+    return role;
 }
 
-bool WSServer_Manager::isRoleConnected(const char *role)
+bool WSServer_Manager::isRoleConnected(LinkRole role)
 {
-    for (auto const &entry : _clientRoles)
-    {
-        if (entry.second.equalsIgnoreCase(role))
-            return true;
-    }
-    return false;
+    // Single byte read - no lock needed
+    return _clients.isRoleConnected(role);
+}
+
+bool WSServer_Manager::getClientStats(uint8_t slot, ClientTable::Client &out)
+{
+    if (slot >= ClientTable::MAX_CLIENTS) return false;
+
+    portENTER_CRITICAL(&_linkMux);
+    out = _clients.getClient(slot);
+    portEXIT_CRITICAL(&_linkMux);
+    return out.clientId != 0;
 }
 
 #endif
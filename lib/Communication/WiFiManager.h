@@ -3,7 +3,9 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
-#include <map>
+#include "LinkSupervisor.h"
+#include "ClientTable.h"
+#include "MessageAssembler.h"
 
 // Conditional Includes based on Role
 #ifdef BACK_CONTROLLER
@@ -26,6 +28,20 @@ class WSClient_Manager
 public:
     WSClient_Manager(const char *ssid, const char *password, const char *serverIP, uint16_t serverPort, const char *role);
 
+    struct ReconnectStats
+    {
+        uint32_t count;         // Recoveries since boot (link lost -> WebSocket back)
+        uint32_t lastMs;        // Last recovery, lost -> WebSocket connected
+        uint32_t maxMs;
+        uint32_t lastWiFiMs;    // ... of which WiFi (lost -> IP), 0 if WiFi stayed up
+    };
+
+    /**
+     * Fixed address instead of DHCP (call before begin) - saves the lease
+     * exchange on every reconnect. Gateway is the server.
+     */
+    void setStaticIP(const char *ip);
+
     void begin();
     void beginWithTimeout(uint32_t timeoutMs);  // Blocks until connected or timeout
     void update(); // Must be called in loop()
@@ -35,6 +51,12 @@ public:
     void sendMessage(const JsonDocument &doc);
     void setMessageHandler(std::function<void(const JsonDocument &)> handler);
 
+    // Messages the server split into several frames
+    const MessageAssembler::Stats &getReassemblyStats() const { return _assembly.getStats(); }
+
+    // Also sent with every handshake
+    const ReconnectStats &getReconnectStats() const { return _reconnect; }
+
 private:
     const char *_ssid;
     const char *_password;
@@ -43,12 +65,34 @@ private:
     const char *_role;
     
     bool _wsConnected;
-    unsigned long _lastWiFiCheck;
+
+    // Fast reconnect - WiFi events arrive on the system event task,
+    // update() acts on them
+    IPAddress _staticIP;
+    bool _useStaticIP;
+    uint8_t _bssid[6];              // AP of the last association
+    int32_t _channel;               // 0 = nothing cached, scan
+    volatile bool _wifiDropped;
+    volatile bool _wifiGotIP;
+    volatile unsigned long _lossMs; // Link went down (0 = up)
+    unsigned long _wifiUpMs;        // Got an IP during the current outage
+    unsigned long _lastWiFiBegin;
+    uint8_t _wifiAttempts;          // Since the link went down
+    uint32_t _wsBackoffMs;
+    unsigned long _wsBackoffStart;
+    ReconnectStats _reconnect;
     
     WebSocketsClient _webSocket;
     std::function<void(const JsonDocument &)> _messageHandler;
+    MessageAssembler _assembly;
 
+    void startWiFi();
+    void markLinkLost();
+    void resetBackoff();
+    static void onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info);
     static void onWebSocketEvent(WStype_t type, uint8_t *payload, size_t length);
+    void appendFragment(uint8_t *payload, size_t length, bool last);
+    void dispatch(JsonDocument &doc, DeserializationError error);
 };
 
 #endif
@@ -67,24 +111,78 @@ public:
     void begin();
     void update(); // Placeholder for consistency
 
+    // Every client - for messages the boards act on too (hazard alerts, status)
     void broadcast(const JsonDocument &doc);
+
+    /**
+     * Send to the board registered under a role (latest registration wins)
+     * @return false if no client is registered under it
+     */
+    bool sendToRole(LinkRole role, const JsonDocument &doc);
+
+    /**
+     * Send to one client (e.g. a reply to the sender of a command)
+     * @return false if it is gone or its send queue is full
+     */
+    bool sendTo(AsyncWebSocketClient *client, const JsonDocument &doc);
+
+    /**
+     * Send to subscribers: every client except the boards (dashboards,
+     * gateway, unregistered). For telemetry and replies the boards ignore.
+     */
+    void publish(const JsonDocument &doc);
+
     void setMessageHandler(std::function<void(const JsonDocument &, AsyncWebSocketClient *)> handler);
+
+    /**
+     * Extra HTTP handler on the same server (e.g. the dashboard assets)
+     * Checked after /ws
+     */
+    void addHandler(AsyncWebHandler *handler);
     
     // Count connected clients
     uint8_t getClientCount();
-    String getClientRole(uint32_t id);
-    bool isRoleConnected(const char* role);
+    LinkRole getClientRole(uint32_t id);
+    bool isRoleConnected(LinkRole role);
+
+    /**
+     * Copy of one client table slot (role, timestamps, send counters)
+     * @return false for a free slot
+     */
+    bool getClientStats(uint8_t slot, ClientTable::Client &out);
+
+    // Messages that arrived in pieces: reassembled, and dropped (binary,
+    // oversized, cut short, or no free buffer)
+    uint32_t getAssembledMessages();
+    uint32_t getDroppedMessages();
+
+    // Link health (ping/pong heartbeat, RTT, send backlog per role)
+    LinkState getLinkState(LinkRole role);
+    LinkSupervisor::RoleHealth getLinkHealth(LinkRole role);
 
 private:
     AsyncWebServer _server;
     AsyncWebSocket _ws;
     std::function<void(const JsonDocument &, AsyncWebSocketClient *)> _messageHandler;
     
-    // Map client ID to Role string
-    std::map<uint32_t, String> _clientRoles;
+    // Clients and link supervision - events arrive on the AsyncTCP task,
+    // both guarded by _linkMux
+    ClientTable _clients;
+    LinkSupervisor _links;
+    portMUX_TYPE _linkMux;
+    unsigned long _lastPing;
+
+    void superviseLinks();
+
+    // Messages in pieces, one per client at a time (AsyncTCP task only)
+    static const uint8_t REASSEMBLY_SLOTS = 2;
+    MessageAssembler _assembly[REASSEMBLY_SLOTS];
+    volatile uint32_t _assemblyNoSlot;
 
     void onEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len);
     void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocketClient *client);
+    MessageAssembler *assemblyFor(uint32_t clientId, bool first);
+    void dispatch(JsonDocument &doc, DeserializationError error, AsyncWebSocketClient *client);
 };
 
 #endif
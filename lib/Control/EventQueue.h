@@ -0,0 +1,104 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <stdint.h>
+
+/**
+ * Bounded lock-free multi-producer / single-consumer queue
+ *
+ * - Any task (AsyncTCP callbacks, timers, loop()) may push(); only one
+ *   task may pop()
+ * - Each slot carries a sequence number (Vyukov): producers claim a slot
+ *   with one CAS on the head, publish it with a release store; the
+ *   consumer never writes the head, producers never write the tail
+ * - Full queue: push() fails and the drop is counted, nothing blocks
+ *
+ * Capacity must be a power of two. Pure logic - no Arduino dependencies.
+ */
+template <typename T, uint8_t CAPACITY>
+class EventQueue
+{
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "EventQueue capacity must be a power of two");
+
+public:
+    EventQueue() : _head(0), _tail(0), _drops(0)
+    {
+        for (uint32_t i = 0; i < CAPACITY; i++)
+        {
+            _slots[i].seq = i;
+        }
+    }
+
+    /**
+     * Enqueue from any task
+     * @return false (and counts a drop) when the queue is full
+     */
+    bool push(const T &value)
+    {
+        uint32_t pos = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+        Slot *slot;
+
+        for (;;)
+        {
+            slot = &_slots[pos & (CAPACITY - 1)];
+            uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+            int32_t diff = (int32_t)(seq - pos);
+
+            if (diff == 0)
+            {
+                // Slot free for this position - claim it
+                if (__atomic_compare_exchange_n(&_head, &pos, pos + 1, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // Consumer hasn't freed it yet: full
+                __atomic_fetch_add(&_drops, 1, __ATOMIC_RELAXED);
+                return false;
+            }
+            else
+            {
+                // Another producer took this position
+                pos = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+            }
+        }
+
+        slot->value = value;
+        __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /**
+     * Dequeue (consumer task only)
+     * @return false when empty
+     */
+    bool pop(T &out)
+    {
+        Slot &slot = _slots[_tail & (CAPACITY - 1)];
+        uint32_t seq = __atomic_load_n(&slot.seq, __ATOMIC_ACQUIRE);
+        if ((int32_t)(seq - (_tail + 1)) < 0) return false;
+
+        out = slot.value;
+        __atomic_store_n(&slot.seq, _tail + CAPACITY, __ATOMIC_RELEASE);
+        _tail++;
+        return true;
+    }
+
+    uint32_t getDrops() const { return __atomic_load_n(&_drops, __ATOMIC_RELAXED); }
+
+private:
+    struct Slot
+    {
+        uint32_t seq;
+        T value;
+    };
+
+    Slot _slots[CAPACITY];
+    uint32_t _head;     // Next position to claim (producers)
+    uint32_t _tail;     // Next position to read (consumer)
+    uint32_t _drops;
+};
+
+#endif // EVENT_QUEUE_H
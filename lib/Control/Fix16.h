@@ -0,0 +1,89 @@
+#ifndef FIX16_H
+#define FIX16_H
+
+#include <stdint.h>
+
+/**
+ * Q16.16 signed fixed-point number
+ *
+ * Drop-in numeric type for the control templates (PidBank): +, -, * and
+ * comparisons behave like float, additions and products saturate instead
+ * of wrapping, so an integrator can't flip sign on overflow.
+ *
+ * Range +-32767.99998, resolution 1/65536. Conversions from float happen
+ * at configuration time; the update path is integer only.
+ * Pure logic - no Arduino dependencies.
+ */
+class Fix16
+{
+public:
+    static constexpr int32_t RAW_MAX = INT32_MAX;
+    static constexpr int32_t RAW_MIN = INT32_MIN;
+
+    constexpr Fix16() : _raw(0) {}
+
+    explicit constexpr Fix16(float value)
+        : _raw(value >= 32768.0f   ? RAW_MAX
+               : value <= -32768.0f ? RAW_MIN
+                                    : (int32_t)(value * 65536.0f + (value >= 0 ? 0.5f : -0.5f)))
+    {
+    }
+
+    static constexpr Fix16 fromRaw(int32_t raw)
+    {
+        Fix16 f;
+        f._raw = raw;
+        return f;
+    }
+
+    constexpr int32_t raw() const { return _raw; }
+    explicit constexpr operator float() const { return _raw * (1.0f / 65536.0f); }
+
+    // ========================================
+    // ARITHMETIC (saturating)
+    // ========================================
+
+    friend Fix16 operator+(Fix16 a, Fix16 b)
+    {
+        int32_t r;
+        if (__builtin_add_overflow(a._raw, b._raw, &r)) r = (a._raw < 0) ? RAW_MIN : RAW_MAX;
+        return fromRaw(r);
+    }
+
+    friend Fix16 operator-(Fix16 a, Fix16 b)
+    {
+        int32_t r;
+        if (__builtin_sub_overflow(a._raw, b._raw, &r)) r = (a._raw < 0) ? RAW_MIN : RAW_MAX;
+        return fromRaw(r);
+    }
+
+    friend Fix16 operator*(Fix16 a, Fix16 b)
+    {
+        int64_t p = ((int64_t)a._raw * b._raw) >> 16;
+        if (p > RAW_MAX) return fromRaw(RAW_MAX);
+        if (p < RAW_MIN) return fromRaw(RAW_MIN);
+        return fromRaw((int32_t)p);
+    }
+
+    Fix16 operator-() const { return fromRaw(_raw == RAW_MIN ? RAW_MAX : -_raw); }
+
+    Fix16 &operator+=(Fix16 o) { return *this = *this + o; }
+    Fix16 &operator-=(Fix16 o) { return *this = *this - o; }
+    Fix16 &operator*=(Fix16 o) { return *this = *this * o; }
+
+    // ========================================
+    // COMPARISON
+    // ========================================
+
+    friend constexpr bool operator<(Fix16 a, Fix16 b) { return a._raw < b._raw; }
+    friend constexpr bool operator>(Fix16 a, Fix16 b) { return a._raw > b._raw; }
+    friend constexpr bool operator<=(Fix16 a, Fix16 b) { return a._raw <= b._raw; }
+    friend constexpr bool operator>=(Fix16 a, Fix16 b) { return a._raw >= b._raw; }
+    friend constexpr bool operator==(Fix16 a, Fix16 b) { return a._raw == b._raw; }
+    friend constexpr bool operator!=(Fix16 a, Fix16 b) { return a._raw != b._raw; }
+
+private:
+    int32_t _raw;
+};
+
+#endif // FIX16_H
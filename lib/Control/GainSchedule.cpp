@@ -0,0 +1,176 @@
+#include "GainSchedule.h"
+#include <Preferences.h>
+#include <string.h>
+
+// NVS blob layout - bump on any change to Blob
+static const uint32_t BLOB_MAGIC = 0x47534348;  // "GSCH"
+static const uint8_t BLOB_VERSION = 1;
+static const char *BLOB_KEY = "table";
+
+struct Blob
+{
+    uint32_t magic;
+    uint8_t version;
+    uint8_t speedPoints;
+    uint8_t rangePoints;
+    uint8_t enabled;
+    float speeds[GainSchedule::SPEED_POINTS];
+    float ranges[GainSchedule::RANGE_POINTS];
+    GainSchedule::Gains gains[GainSchedule::SPEED_POINTS][GainSchedule::RANGE_POINTS];
+};
+
+GainSchedule::GainSchedule()
+    : _enabled(false)
+{
+    // Placeholder axes until setUniform() / load()
+    const Gains unity = {1.0f, 0.0f, 0.0f};
+    const float axis[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    static_assert(SPEED_POINTS <= 4 && RANGE_POINTS <= 4, "Placeholder axis too short");
+    setUniform(unity, axis, axis);
+    _enabled = false;
+}
+
+void GainSchedule::setUniform(const Gains &gains, const float *speedsCmS, const float *rangesCm)
+{
+    memcpy(_speeds, speedsCmS, sizeof(_speeds));
+    memcpy(_ranges, rangesCm, sizeof(_ranges));
+    for (uint8_t s = 0; s < SPEED_POINTS; s++)
+    {
+        for (uint8_t r = 0; r < RANGE_POINTS; r++) _gains[s][r] = gains;
+    }
+    _enabled = true;
+}
+
+// ============================================
+// EDITING
+// ============================================
+
+bool GainSchedule::setSpeedBreakpoints(const float *speedsCmS)
+{
+    if (!increasing(speedsCmS, SPEED_POINTS)) return false;
+    memcpy(_speeds, speedsCmS, sizeof(_speeds));
+    return true;
+}
+
+bool GainSchedule::setRangeBreakpoints(const float *rangesCm)
+{
+    if (!increasing(rangesCm, RANGE_POINTS)) return false;
+    memcpy(_ranges, rangesCm, sizeof(_ranges));
+    return true;
+}
+
+bool GainSchedule::setGains(uint8_t speedIdx, uint8_t rangeIdx, const Gains &gains)
+{
+    if (speedIdx >= SPEED_POINTS || rangeIdx >= RANGE_POINTS) return false;
+    if (gains.kP < 0 || gains.kI < 0 || gains.kD < 0) return false;
+    _gains[speedIdx][rangeIdx] = gains;
+    return true;
+}
+
+bool GainSchedule::increasing(const float *values, uint8_t count)
+{
+    for (uint8_t i = 1; i < count; i++)
+    {
+        if (!(values[i] > values[i - 1])) return false;
+    }
+    return true;
+}
+
+// ============================================
+// LOOKUP
+// ============================================
+
+// Index of the lower breakpoint and the fraction towards the next one
+uint8_t GainSchedule::segment(const float *axis, uint8_t count, float x, float &t)
+{
+    if (x <= axis[0])
+    {
+        t = 0.0f;
+        return 0;
+    }
+    for (uint8_t i = 0; i + 1 < count; i++)
+    {
+        if (x < axis[i + 1])
+        {
+            t = (x - axis[i]) / (axis[i + 1] - axis[i]);
+            return i;
+        }
+    }
+    t = 1.0f;
+    return count - 2;
+}
+
+GainSchedule::Gains GainSchedule::lookup(float speedCmS, float rangeCm) const
+{
+    float ts = 0.0f, tr = 0.0f;
+    uint8_t s = (speedCmS < 0) ? 0 : segment(_speeds, SPEED_POINTS, speedCmS, ts);
+    uint8_t r = segment(_ranges, RANGE_POINTS, rangeCm, tr);
+
+    const Gains &g00 = _gains[s][r];
+    const Gains &g01 = _gains[s][r + 1];
+    const Gains &g10 = _gains[s + 1][r];
+    const Gains &g11 = _gains[s + 1][r + 1];
+
+    float w00 = (1 - ts) * (1 - tr);
+    float w01 = (1 - ts) * tr;
+    float w10 = ts * (1 - tr);
+    float w11 = ts * tr;
+
+    Gains out;
+    out.kP = w00 * g00.kP + w01 * g01.kP + w10 * g10.kP + w11 * g11.kP;
+    out.kI = w00 * g00.kI + w01 * g01.kI + w10 * g10.kI + w11 * g11.kI;
+    out.kD = w00 * g00.kD + w01 * g01.kD + w10 * g10.kD + w11 * g11.kD;
+    return out;
+}
+
+// ============================================
+// PERSISTENCE
+// ============================================
+
+bool GainSchedule::load(const char *nvsNamespace)
+{
+    Preferences prefs;
+    if (!prefs.begin(nvsNamespace, true)) return false;
+
+    Blob blob;
+    size_t len = prefs.getBytes(BLOB_KEY, &blob, sizeof(blob));
+    prefs.end();
+
+    if (len != sizeof(blob) || blob.magic != BLOB_MAGIC || blob.version != BLOB_VERSION ||
+        blob.speedPoints != SPEED_POINTS || blob.rangePoints != RANGE_POINTS)
+        return false;
+    if (!increasing(blob.speeds, SPEED_POINTS) || !increasing(blob.ranges, RANGE_POINTS)) return false;
+
+    memcpy(_speeds, blob.speeds, sizeof(_speeds));
+    memcpy(_ranges, blob.ranges, sizeof(_ranges));
+    memcpy(_gains, blob.gains, sizeof(_gains));
+    _enabled = blob.enabled != 0;
+    return true;
+}
+
+bool GainSchedule::save(const char *nvsNamespace) const
+{
+    Blob blob;
+    blob.magic = BLOB_MAGIC;
+    blob.version = BLOB_VERSION;
+    blob.speedPoints = SPEED_POINTS;
+    blob.rangePoints = RANGE_POINTS;
+    blob.enabled = _enabled ? 1 : 0;
+    memcpy(blob.speeds, _speeds, sizeof(_speeds));
+    memcpy(blob.ranges, _ranges, sizeof(_ranges));
+    memcpy(blob.gains, _gains, sizeof(_gains));
+
+    Preferences prefs;
+    if (!prefs.begin(nvsNamespace, false)) return false;
+    size_t written = prefs.putBytes(BLOB_KEY, &blob, sizeof(blob));
+    prefs.end();
+    return written == sizeof(blob);
+}
+
+void GainSchedule::erase(const char *nvsNamespace)
+{
+    Preferences prefs;
+    if (!prefs.begin(nvsNamespace, false)) return;
+    prefs.remove(BLOB_KEY);
+    prefs.end();
+}
@@ -0,0 +1,81 @@
+#ifndef GAIN_SCHEDULE_H
+#define GAIN_SCHEDULE_H
+
+#include <stdint.h>
+
+/**
+ * PID gain schedule over measured speed and range
+ *
+ * A SPEED_POINTS x RANGE_POINTS grid of (kP, kI, kD), bilinearly
+ * interpolated between breakpoints and held flat outside them. Pair with
+ * PidBank::setTuningsBumpless() so moving through the grid never steps
+ * the output.
+ *
+ * Tables are edited from the dashboard and persisted in NVS (Preferences)
+ * as one versioned blob; a blob from an older layout is ignored and the
+ * defaults stay in place.
+ */
+class GainSchedule
+{
+public:
+    static const uint8_t SPEED_POINTS = 4;
+    static const uint8_t RANGE_POINTS = 4;
+
+    struct Gains
+    {
+        float kP;
+        float kI;
+        float kD;
+    };
+
+    GainSchedule();
+
+    /**
+     * Breakpoints and every cell to the given gains; scheduling enabled
+     */
+    void setUniform(const Gains &gains, const float *speedsCmS, const float *rangesCm);
+
+    // ========================================
+    // EDITING (rejects non-increasing axes / negative gains)
+    // ========================================
+
+    bool setSpeedBreakpoints(const float *speedsCmS);
+    bool setRangeBreakpoints(const float *rangesCm);
+    bool setGains(uint8_t speedIdx, uint8_t rangeIdx, const Gains &gains);
+    void setEnabled(bool enabled) { _enabled = enabled; }
+
+    // ========================================
+    // LOOKUP
+    // ========================================
+
+    /**
+     * Interpolated gains
+     * @param speedCmS Measured speed (< 0 = unknown: lowest speed row)
+     * @param rangeCm  Range to the obstacle being approached
+     */
+    Gains lookup(float speedCmS, float rangeCm) const;
+
+    bool isEnabled() const { return _enabled; }
+    float getSpeedBreakpoint(uint8_t i) const { return _speeds[i]; }
+    float getRangeBreakpoint(uint8_t i) const { return _ranges[i]; }
+    const Gains &getGains(uint8_t speedIdx, uint8_t rangeIdx) const { return _gains[speedIdx][rangeIdx]; }
+
+    // ========================================
+    // PERSISTENCE
+    // ========================================
+
+    bool load(const char *nvsNamespace);
+    bool save(const char *nvsNamespace) const;
+    static void erase(const char *nvsNamespace);
+
+private:
+    float _speeds[SPEED_POINTS];
+    float _ranges[RANGE_POINTS];
+    Gains _gains[SPEED_POINTS][RANGE_POINTS];
+    bool _enabled;
+
+    static bool increasing(const float *values, uint8_t count);
+    static uint8_t segment(const float *axis, uint8_t count, float x, float &t);
+};
+
+#endif // GAIN_SCHEDULE_H
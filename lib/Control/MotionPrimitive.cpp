@@ -0,0 +1,128 @@
+#include "MotionPrimitive.h"
+#include <math.h>
+
+// Tracking
+static const float POSITION_GAIN = 8.0f;        // PWM per cm behind (or ahead of) the reference
+static const float DONE_TOLERANCE_CM = 0.5f;    // Mean shortfall accepted as "there"
+
+// Timeout: the profile plus slack for spin-up and a slow final approach
+static const float TIMEOUT_FACTOR = 1.5f;
+static const uint32_t TIMEOUT_SLACK_MS = 500;
+
+MotionPrimitive::MotionPrimitive(float trackWidthCm, float fullScaleCmS)
+    : _halfTrack(trackWidthCm / 2.0f), _fullScale(fullScaleCmS),
+      _kind(MOTION_NONE), _status(MOTION_IDLE), _maxPwm(0), _startMs(0), _timeoutMs(0),
+      _startCm{0, 0}, _sign{0, 0}, _covered{0, 0}, _command{0, 0}
+{
+}
+
+void MotionPrimitive::startRotate(float angleRad, const Limits &limits, float leftCm, float rightCm,
+                                  uint32_t nowMs)
+{
+    // CCW: left wheel back, right wheel forward
+    int8_t dir = (angleRad >= 0) ? 1 : -1;
+    start(MOTION_ROTATE, fabsf(angleRad) * _halfTrack, -dir, dir, limits, leftCm, rightCm, nowMs);
+}
+
+void MotionPrimitive::startDrive(float distanceCm, const Limits &limits, float leftCm, float rightCm,
+                                 uint32_t nowMs)
+{
+    int8_t dir = (distanceCm >= 0) ? 1 : -1;
+    start(MOTION_DRIVE, fabsf(distanceCm), dir, dir, limits, leftCm, rightCm, nowMs);
+}
+
+void MotionPrimitive::start(Kind kind, float arcCm, int8_t leftSign, int8_t rightSign, const Limits &limits,
+                            float leftCm, float rightCm, uint32_t nowMs)
+{
+    _kind = kind;
+    _profile.plan(arcCm, limits.vMax, limits.aMax, limits.shape);
+    _maxPwm = limits.maxPwm;
+    _startMs = nowMs;
+    _timeoutMs = (uint32_t)(_profile.getDuration() * TIMEOUT_FACTOR * 1000.0f) + TIMEOUT_SLACK_MS;
+
+    _startCm[0] = leftCm;
+    _startCm[1] = rightCm;
+    _sign[0] = leftSign;
+    _sign[1] = rightSign;
+    _covered[0] = 0;
+    _covered[1] = 0;
+    _command[0] = 0;
+    _command[1] = 0;
+
+    _status = (arcCm > DONE_TOLERANCE_CM) ? MOTION_RUNNING : MOTION_DONE;
+}
+
+void MotionPrimitive::cancel()
+{
+    if (_status != MOTION_RUNNING) return;
+    _status = MOTION_IDLE;
+    _command[0] = 0;
+    _command[1] = 0;
+}
+
+void MotionPrimitive::finish(Status status)
+{
+    _status = status;
+    _command[0] = 0;
+    _command[1] = 0;
+}
+
+bool MotionPrimitive::update(float leftCm, float rightCm, bool valid, uint32_t nowMs)
+{
+    if (_status != MOTION_RUNNING) return false;
+
+    uint32_t elapsedMs = nowMs - _startMs;
+    if (elapsedMs > _timeoutMs)
+    {
+        finish(MOTION_TIMED_OUT);
+        return true;
+    }
+
+    if (valid)
+    {
+        _covered[0] = (leftCm - _startCm[0]) * _sign[0];
+        _covered[1] = (rightCm - _startCm[1]) * _sign[1];
+
+        // Done as soon as the target is reached, however early
+        float mean = (_covered[0] + _covered[1]) / 2.0f;
+        if (mean >= _profile.getDistance() - DONE_TOLERANCE_CM)
+        {
+            finish(MOTION_DONE);
+            return true;
+        }
+    }
+
+    float ref, vel;
+    _profile.sample(elapsedMs / 1000.0f, ref, vel);
+    float feedForward = vel / _fullScale * 255.0f;
+
+    for (uint8_t w = 0; w < 2; w++)
+    {
+        float cmd = feedForward;
+        if (valid) cmd += POSITION_GAIN * (ref - _covered[w]);
+
+        if (cmd > _maxPwm) cmd = (float)_maxPwm;
+        if (cmd < -_maxPwm) cmd = (float)-_maxPwm;
+        _command[w] = (int)lroundf(cmd) * _sign[w];
+    }
+    return false;
+}
+
+float MotionPrimitive::getProgress() const
+{
+    float target = _profile.getDistance();
+    if (target <= 0) return 1.0f;
+    return (_covered[0] + _covered[1]) / 2.0f / target;
+}
+
+const char *MotionPrimitive::statusName(Status status)
+{
+    switch (status)
+    {
+    case MOTION_IDLE: return "idle";
+    case MOTION_RUNNING: return "running";
+    case MOTION_DONE: return "done";
+    case MOTION_TIMED_OUT: return "timed_out";
+    default: return "?";
+    }
+}
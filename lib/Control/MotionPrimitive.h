@@ -0,0 +1,111 @@
+#ifndef MOTION_PRIMITIVE_H
+#define MOTION_PRIMITIVE_H
+
+#include <stdint.h>
+#include "MotionProfile.h"
+
+/**
+ * Encoder-closed motion primitives: "rotate N degrees", "drive N cm"
+ *
+ * Each wheel follows a MotionProfile over its own arc. Its command is the
+ * profile velocity as feed-forward (commands are linear, so one full-scale
+ * speed maps cm/s to PWM) plus a proportional correction on the position
+ * error, which also keeps the two wheels in step. The primitive finishes
+ * as soon as the wheels have covered the target on average - not when a
+ * timer says so - and times out if they can't (blocked, encoders lost).
+ *
+ * Rotation is measured as wheel arc over half the track width, like the
+ * odometry heading.
+ *
+ * Pure logic (no Arduino calls): distances and timestamps are passed in.
+ */
+class MotionPrimitive
+{
+public:
+    enum Kind : uint8_t
+    {
+        MOTION_NONE,
+        MOTION_ROTATE,
+        MOTION_DRIVE
+    };
+
+    enum Status : uint8_t
+    {
+        MOTION_IDLE,
+        MOTION_RUNNING,
+        MOTION_DONE,        // Target reached
+        MOTION_TIMED_OUT    // Gave up short of the target
+    };
+
+    struct Limits
+    {
+        float vMax;         // Wheel speed, cm/s
+        float aMax;         // Wheel acceleration, cm/s^2
+        ProfileShape shape;
+        int maxPwm;         // Command limit, feedback included
+    };
+
+    /**
+     * @param trackWidthCm Distance between left and right wheels
+     * @param fullScaleCmS Wheel speed at command 255
+     */
+    MotionPrimitive(float trackWidthCm, float fullScaleCmS);
+
+    /**
+     * Rotate in place
+     * @param angleRad CCW-positive (left turn)
+     * @param leftCm/rightCm Current cumulative wheel distances
+     */
+    void startRotate(float angleRad, const Limits &limits, float leftCm, float rightCm, uint32_t nowMs);
+
+    /**
+     * Drive straight (negative = reverse)
+     */
+    void startDrive(float distanceCm, const Limits &limits, float leftCm, float rightCm, uint32_t nowMs);
+
+    void cancel();
+
+    /**
+     * Step on the latest cumulative wheel distances
+     * @param valid False while the encoders are stale: feed-forward only,
+     *              and only the timeout can end the primitive
+     * @return true on the step the primitive finished (done or timed out)
+     */
+    bool update(float leftCm, float rightCm, bool valid, uint32_t nowMs);
+
+    int getLeftCommand() const { return _command[0]; }
+    int getRightCommand() const { return _command[1]; }
+    Status getStatus() const { return _status; }
+    bool isRunning() const { return _status == MOTION_RUNNING; }
+    Kind getKind() const { return _kind; }
+
+    /**
+     * Mean distance covered / target (0..1, may overshoot)
+     */
+    float getProgress() const;
+
+    static const char *statusName(Status status);
+
+private:
+    float _halfTrack;
+    float _fullScale;
+
+    Kind _kind;
+    Status _status;
+    MotionProfile _profile;
+    int _maxPwm;
+    uint32_t _startMs;
+    uint32_t _timeoutMs;
+
+    // Per wheel (left, right)
+    float _startCm[2];
+    int8_t _sign[2];        // Wheel direction for this primitive
+    float _covered[2];      // Distance along _sign since the start
+    int _command[2];
+
+    void start(Kind kind, float arcCm, int8_t leftSign, int8_t rightSign, const Limits &limits,
+               float leftCm, float rightCm, uint32_t nowMs);
+    void finish(Status status);
+};
+
+#endif // MOTION_PRIMITIVE_H
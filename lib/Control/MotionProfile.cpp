@@ -0,0 +1,82 @@
+#include "MotionProfile.h"
+#include <math.h>
+
+MotionProfile::MotionProfile()
+    : _distance(0), _vPeak(0), _rampTime(0), _cruiseTime(0), _shape(PROFILE_TRAPEZOID)
+{
+}
+
+void MotionProfile::plan(float distance, float vMax, float aMax, ProfileShape shape)
+{
+    _shape = shape;
+    _distance = 0;
+    _vPeak = 0;
+    _rampTime = 0;
+    _cruiseTime = 0;
+    if (distance <= 0 || vMax <= 0 || aMax <= 0) return;
+
+    // Ramp time per unit of peak velocity (smoothstep peaks at 1.5x the mean)
+    float k = (shape == PROFILE_S_CURVE) ? 1.5f / aMax : 1.0f / aMax;
+
+    _distance = distance;
+    _vPeak = vMax;
+    _rampTime = k * vMax;
+
+    // Both ramps together cover vPeak * T; too short a move never cruises
+    if (_vPeak * _rampTime > distance)
+    {
+        _vPeak = sqrtf(distance / k);
+        _rampTime = k * _vPeak;
+    }
+    _cruiseTime = (distance - _vPeak * _rampTime) / _vPeak;
+    if (_cruiseTime < 0) _cruiseTime = 0;
+}
+
+void MotionProfile::ramp(float u, float &position, float &velocity) const
+{
+    if (_shape == PROFILE_S_CURVE)
+    {
+        float u2 = u * u;
+        velocity = _vPeak * (3.0f * u2 - 2.0f * u2 * u);
+        position = _vPeak * _rampTime * (u2 * u - 0.5f * u2 * u2);
+    }
+    else
+    {
+        velocity = _vPeak * u;
+        position = 0.5f * _vPeak * _rampTime * u * u;
+    }
+}
+
+void MotionProfile::sample(float t, float &position, float &velocity) const
+{
+    float end = getDuration();
+    if (t <= 0 || _distance <= 0)
+    {
+        position = 0;
+        velocity = 0;
+        return;
+    }
+    if (t >= end)
+    {
+        position = _distance;
+        velocity = 0;
+        return;
+    }
+
+    if (t < _rampTime)
+    {
+        ramp(t / _rampTime, position, velocity);
+    }
+    else if (t < _rampTime + _cruiseTime)
+    {
+        position = 0.5f * _vPeak * _rampTime + _vPeak * (t - _rampTime);
+        velocity = _vPeak;
+    }
+    else
+    {
+        // Deceleration mirrors the acceleration ramp about the end point
+        float p;
+        ramp((end - t) / _rampTime, p, velocity);
+        position = _distance - p;
+    }
+}
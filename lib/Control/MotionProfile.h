@@ -0,0 +1,55 @@
+#ifndef MOTION_PROFILE_H
+#define MOTION_PROFILE_H
+
+#include <stdint.h>
+
+enum ProfileShape : uint8_t
+{
+    PROFILE_TRAPEZOID,  // Constant acceleration ramps
+    PROFILE_S_CURVE     // Smoothstep ramps: acceleration rises and falls smoothly
+};
+
+/**
+ * Point-to-point velocity profile over a distance
+ *
+ * Accelerate to the peak velocity, cruise, decelerate to rest exactly at
+ * the distance. Moves too short to reach vMax become triangular. The
+ * S-curve ramp is v = vPeak (3u^2 - 2u^3) with its peak acceleration held
+ * to aMax; both shapes cover vPeak * T / 2 per ramp, so planning differs
+ * only in the ramp time T.
+ *
+ * Distances are unsigned - the caller applies the direction.
+ * Pure logic - no Arduino dependencies.
+ */
+class MotionProfile
+{
+public:
+    MotionProfile();
+
+    /**
+     * @param distance Length of the move (<= 0 = empty profile)
+     * @param vMax     Velocity limit
+     * @param aMax     Acceleration limit (peak, for the S-curve)
+     */
+    void plan(float distance, float vMax, float aMax, ProfileShape shape);
+
+    /**
+     * Reference at t seconds after the start (at rest on the distance once finished)
+     */
+    void sample(float t, float &position, float &velocity) const;
+
+    float getDistance() const { return _distance; }
+    float getPeakVelocity() const { return _vPeak; }
+    float getDuration() const { return 2.0f * _rampTime + _cruiseTime; }
+
+private:
+    float _distance;
+    float _vPeak;
+    float _rampTime;
+    float _cruiseTime;
+    ProfileShape _shape;
+
+    void ramp(float u, float &position, float &velocity) const;
+};
+
+#endif // MOTION_PROFILE_H
@@ -17,6 +17,9 @@
  * - Configurable output limits
  * - Derivative kick prevention
  * - Time-based or call-based computation
+ *
+ * Fixed-rate loops with several controllers should use PidBank.h instead
+ * (templated float/Q16.16, explicit timestamp, one pass per bank).
  */
 class PIDController
 {
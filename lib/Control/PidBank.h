@@ -0,0 +1,333 @@
+#ifndef PID_BANK_H
+#define PID_BANK_H
+
+#include <stdint.h>
+#include "Fix16.h"
+
+/**
+ * Batched PID controllers (structure of arrays)
+ *
+ * PidBank<T, N, Options> holds N controllers sharing one sample clock -
+ * e.g. the per-wheel speed loops, heading hold and approach - and updates
+ * them all in one pass over parallel arrays:
+ * - T is float or Fix16 (Q16.16); the update path only uses +, -, *
+ * - The timestamp is passed in: dt and 1/dt are computed once per bank,
+ *   not once per controller, and there is no millis() call in the loop
+ * - Behaviour is fixed at compile time by Options (below), so the unused
+ *   branches are not in the loop at all
+ * - Gains are stored pre-multiplied (I term, not raw integral), so
+ *   changing kI doesn't bump the output; setTuningsBumpless() also folds
+ *   the P and D change into the I term (gain scheduling)
+ *
+ * Pid<T, Options> is the single-controller form with the same maths.
+ * Pure logic - no Arduino dependencies.
+ */
+
+enum PidWindup : uint8_t
+{
+    PID_WINDUP_CLAMP,        // Clamp the I term to the output range
+    PID_WINDUP_CONDITIONAL,  // + hold the I term while the output is pushed further into saturation
+    PID_WINDUP_BACK_CALC     // + bleed the saturation excess back out of the I term
+};
+
+/**
+ * Compile-time controller options
+ * @tparam D_ON_MEASUREMENT  Derivative of the input instead of the error (no setpoint kick)
+ * @tparam WINDUP            Anti-windup strategy
+ * @tparam OUTPUT_FILTER_SHIFT  First-order output filter, alpha = 1 / 2^shift (0 = off)
+ * @tparam TRACKING_SHIFT    Back-calculation: fraction of the excess removed per step, 1 / 2^shift
+ * @tparam REVERSE_ACTING    Raising the output lowers the input (error = input - setpoint)
+ */
+template <bool D_ON_MEASUREMENT = true, PidWindup WINDUP = PID_WINDUP_CLAMP,
+          uint8_t OUTPUT_FILTER_SHIFT = 0, uint8_t TRACKING_SHIFT = 1, bool REVERSE_ACTING = false>
+struct PidOptions
+{
+    static constexpr bool D_ON_MEAS = D_ON_MEASUREMENT;
+    static constexpr PidWindup WINDUP_MODE = WINDUP;
+    static constexpr uint8_t FILTER_SHIFT = OUTPUT_FILTER_SHIFT;
+    static constexpr uint8_t TRACK_SHIFT = TRACKING_SHIFT;
+    static constexpr bool REVERSE = REVERSE_ACTING;
+};
+
+template <typename T, uint8_t N, typename Options = PidOptions<>>
+class PidBank
+{
+    static_assert(N >= 1 && N <= 32, "PidBank holds 1..32 controllers");
+
+public:
+    // Sample gaps outside this range restart every controller (I and D cleared)
+    static constexpr uint32_t MIN_DT_US = 1000;      // 1 kHz
+    static constexpr uint32_t MAX_DT_US = 500000;    // 2 Hz - e.g. WiFi stall
+
+    PidBank()
+        : _enabled(N == 32 ? 0xFFFFFFFFu : ((1u << (N & 31)) - 1)), _seeded(0), _lastUs(0), _started(false),
+          _filterAlpha(1.0f / (1u << Options::FILTER_SHIFT)),
+          _tracking(1.0f / (1u << Options::TRACK_SHIFT))
+    {
+        for (uint8_t i = 0; i < N; i++)
+        {
+            _kP[i] = T(1.0f);
+            _kI[i] = T(0.0f);
+            _kD[i] = T(0.0f);
+            _setpoint[i] = T(0.0f);
+            _outMin[i] = T(-255.0f);
+            _outMax[i] = T(255.0f);
+        }
+        resetAll();
+    }
+
+    // ========================================
+    // CONFIGURATION (float, converted once)
+    // ========================================
+
+    void setTunings(uint8_t i, float kP, float kI, float kD)
+    {
+        _kP[i] = T(kP);
+        _kI[i] = T(kI);
+        _kD[i] = T(kD);
+    }
+
+    /**
+     * Change gains without stepping the output
+     * The P and D contribution lost (or gained) moves into the I term.
+     */
+    void setTuningsBumpless(uint8_t i, float kP, float kI, float kD)
+    {
+        T newP = T(kP);
+        T newD = T(kD);
+        if (_seeded & (1u << i))
+        {
+            _iTerm[i] = clamp(_iTerm[i] + (_kP[i] - newP) * _error[i] + (_kD[i] - newD) * _dRate[i], i);
+        }
+        _kP[i] = newP;
+        _kI[i] = T(kI);
+        _kD[i] = newD;
+    }
+
+    void setOutputLimits(uint8_t i, float minOutput, float maxOutput)
+    {
+        if (minOutput > maxOutput) return;
+        _outMin[i] = T(minOutput);
+        _outMax[i] = T(maxOutput);
+        _iTerm[i] = clamp(_iTerm[i], i);
+    }
+
+    void setSetpoint(uint8_t i, T setpoint) { _setpoint[i] = setpoint; }
+
+    /**
+     * Disabled controllers are skipped by update() and output 0
+     * Re-enabling starts them fresh
+     */
+    void setEnabled(uint8_t i, bool enabled)
+    {
+        uint32_t bit = 1u << i;
+        if (enabled == ((_enabled & bit) != 0)) return;
+        if (enabled)
+            _enabled |= bit;
+        else
+            _enabled &= ~bit;
+        reset(i);
+    }
+
+    // ========================================
+    // COMPUTATION
+    // ========================================
+
+    /**
+     * Update every enabled controller
+     * @param nowUs Sample time in microseconds (wraps safely)
+     * @param inputs N measured values
+     */
+    void update(uint32_t nowUs, const T *inputs);
+
+    /**
+     * Clear one controller's I term, derivative history and filter
+     */
+    void reset(uint8_t i)
+    {
+        _iTerm[i] = T(0.0f);
+        _dRate[i] = T(0.0f);
+        _prev[i] = T(0.0f);
+        _error[i] = T(0.0f);
+        _output[i] = T(0.0f);
+        _seeded &= ~(1u << i);
+    }
+
+    void resetAll()
+    {
+        for (uint8_t i = 0; i < N; i++) reset(i);
+        _started = false;
+    }
+
+    // ========================================
+    // STATUS
+    // ========================================
+
+    T getOutput(uint8_t i) const { return _output[i]; }
+    T getSetpoint(uint8_t i) const { return _setpoint[i]; }
+    T getError(uint8_t i) const { return _error[i]; }
+    T getProportional(uint8_t i) const { return _kP[i] * _error[i]; }
+    T getIntegral(uint8_t i) const { return _iTerm[i]; }
+    T getDerivative(uint8_t i) const { return _kD[i] * _dRate[i]; }
+    bool isEnabled(uint8_t i) const { return (_enabled >> i) & 1u; }
+
+    bool atSetpoint(uint8_t i, T tolerance) const
+    {
+        return _error[i] <= tolerance && _error[i] >= -tolerance;
+    }
+
+private:
+    // Gains and limits
+    T _kP[N], _kI[N], _kD[N];
+    T _setpoint[N];
+    T _outMin[N], _outMax[N];
+
+    // State
+    T _iTerm[N];        // kI * integral(error)
+    T _dRate[N];        // d(error)/dt, or -d(input)/dt on measurement
+    T _prev[N];         // Last value _dRate is taken from
+    T _error[N];
+    T _output[N];
+
+    uint32_t _enabled;  // Bit per controller
+    uint32_t _seeded;   // Bit per controller: _prev is valid
+    uint32_t _lastUs;
+    bool _started;
+
+    const T _filterAlpha;
+    const T _tracking;
+
+    T clamp(T v, uint8_t i) const
+    {
+        if (v > _outMax[i]) return _outMax[i];
+        if (v < _outMin[i]) return _outMin[i];
+        return v;
+    }
+};
+
+template <typename T, uint8_t N, typename Options>
+void PidBank<T, N, Options>::update(uint32_t nowUs, const T *inputs)
+{
+    uint32_t dtUs = nowUs - _lastUs;
+    bool valid = _started && dtUs >= MIN_DT_US && dtUs <= MAX_DT_US;
+    _lastUs = nowUs;
+    _started = true;
+
+    // Once per bank: the loop below only multiplies
+    T dt = T(0.0f);
+    T invDt = T(0.0f);
+    if (valid)
+    {
+        dt = T(dtUs * 1e-6f);
+        invDt = T(1e6f / dtUs);
+    }
+    else
+    {
+        // First sample or a stall: restart I and D everywhere
+        for (uint8_t i = 0; i < N; i++) _iTerm[i] = T(0.0f);
+        _seeded = 0;
+    }
+
+    const T zero = T(0.0f);
+    for (uint8_t i = 0; i < N; i++)
+    {
+        const uint32_t bit = 1u << i;
+        if (!(_enabled & bit)) continue;
+
+        const T input = inputs[i];
+        const T error = Options::REVERSE ? input - _setpoint[i] : _setpoint[i] - input;
+        const T p = _kP[i] * error;
+
+        // On measurement: only the input's share of the error (no setpoint kick)
+        const T track = !Options::D_ON_MEAS ? error : Options::REVERSE ? input : -input;
+
+        T rate = zero;
+        T iStep = zero;
+        if (_seeded & bit)
+        {
+            rate = (track - _prev[i]) * invDt;
+            iStep = (_kI[i] * error) * dt;
+        }
+        const T d = _kD[i] * rate;
+        _prev[i] = track;
+        _seeded |= bit;
+
+        T iTerm = _iTerm[i];
+        if (Options::WINDUP_MODE == PID_WINDUP_CONDITIONAL)
+        {
+            // Don't integrate further into a saturated output
+            T trial = p + iTerm + d;
+            bool pushingHigh = trial >= _outMax[i] && iStep > zero;
+            bool pushingLow = trial <= _outMin[i] && iStep < zero;
+            if (!pushingHigh && !pushingLow) iTerm += iStep;
+        }
+        else
+        {
+            iTerm += iStep;
+        }
+        iTerm = clamp(iTerm, i);
+
+        T raw = p + iTerm + d;
+        T out = clamp(raw, i);
+
+        if (Options::WINDUP_MODE == PID_WINDUP_BACK_CALC)
+        {
+            // Remove part of what the output couldn't deliver
+            iTerm = clamp(iTerm + (out - raw) * _tracking, i);
+        }
+
+        if (Options::FILTER_SHIFT > 0 && valid)
+        {
+            out = _output[i] + (out - _output[i]) * _filterAlpha;
+        }
+
+        _iTerm[i] = iTerm;
+        _dRate[i] = rate;
+        _error[i] = error;
+        _output[i] = out;
+    }
+}
+
+/**
+ * Single controller with the PidBank maths and an explicit timestamp
+ */
+template <typename T, typename Options = PidOptions<>>
+class Pid
+{
+public:
+    Pid(float kP = 1.0f, float kI = 0.0f, float kD = 0.0f)
+    {
+        _bank.setTunings(0, kP, kI, kD);
+    }
+
+    void setTunings(float kP, float kI, float kD) { _bank.setTunings(0, kP, kI, kD); }
+    void setTuningsBumpless(float kP, float kI, float kD) { _bank.setTuningsBumpless(0, kP, kI, kD); }
+    void setOutputLimits(float minOutput, float maxOutput) { _bank.setOutputLimits(0, minOutput, maxOutput); }
+    void setSetpoint(T setpoint) { _bank.setSetpoint(0, setpoint); }
+
+    /**
+     * @param input Current measured value
+     * @param nowUs Sample time in microseconds
+     * @return Control output (clamped to output limits)
+     */
+    T compute(T input, uint32_t nowUs)
+    {
+        _bank.update(nowUs, &input);
+        return _bank.getOutput(0);
+    }
+
+    void reset() { _bank.resetAll(); }
+
+    T getSetpoint() const { return _bank.getSetpoint(0); }
+    T getError() const { return _bank.getError(0); }
+    T getOutput() const { return _bank.getOutput(0); }
+    T getProportional() const { return _bank.getProportional(0); }
+    T getIntegral() const { return _bank.getIntegral(0); }
+    T getDerivative() const { return _bank.getDerivative(0); }
+    bool atSetpoint(T tolerance) const { return _bank.atSetpoint(0, tolerance); }
+
+private:
+    PidBank<T, 1, Options> _bank;
+};
+
+#endif // PID_BANK_H
@@ -0,0 +1,226 @@
+#include "RelayAutotuner.h"
+#include <math.h>
+#include <string.h>
+
+// Acceptance: the last N cycles must agree this closely
+static const float MAX_PERIOD_SPREAD = 0.2f;
+static const float MAX_AMPLITUDE_SPREAD = 0.3f;
+
+// Cycles before this are transient (relay started from an arbitrary state)
+static const uint8_t SETTLE_CYCLES = 1;
+
+struct RuleCoefficients
+{
+    const char *name;
+    float kuFactor;     // kP = Ku * factor
+    float tiFactor;     // Ti = Pu * factor (0 = no I)
+    float tdFactor;     // Td = Pu * factor
+};
+
+static const RuleCoefficients RULES[RelayAutotuner::RULE_COUNT] = {
+    {"zn",             0.6f,         0.5f,         0.125f},
+    {"zn_pi",          0.45f,        1.0f / 1.2f,  0.0f},
+    {"tyreus_luyben",  1.0f / 2.2f,  2.2f,         1.0f / 6.3f},
+    {"pessen",         0.7f,         0.4f,         0.15f},
+    {"some_overshoot", 0.33f,        0.5f,         0.33f},
+    {"no_overshoot",   0.2f,         0.5f,         0.33f},
+};
+
+RelayAutotuner::RelayAutotuner()
+    : _config(), _state(TUNE_IDLE), _failure(TUNE_FAIL_NONE), _result(),
+      _relayHigh(false), _startMs(0), _lastRiseMs(0), _rises(0),
+      _peakMax(0), _peakMin(0), _cycleHead(0), _cycleCount(0)
+{
+}
+
+void RelayAutotuner::start(const Config &config, uint32_t nowMs)
+{
+    _config = config;
+    if (_config.cycles < 2) _config.cycles = 2;
+    if (_config.cycles > MAX_CYCLES) _config.cycles = MAX_CYCLES;
+    if (_config.rule >= RULE_COUNT) _config.rule = RULE_ZIEGLER_NICHOLS;
+    if (_config.hysteresis < 0) _config.hysteresis = 0;
+
+    _state = TUNE_RUNNING;
+    _failure = TUNE_FAIL_NONE;
+    _result = Result();
+    _result.rule = _config.rule;
+
+    _startMs = nowMs;
+    _lastRiseMs = nowMs;
+    _rises = 0;
+    _cycleHead = 0;
+    _cycleCount = 0;
+    _relayHigh = true;  // Settled by the first update()
+    _peakMax = -INFINITY;
+    _peakMin = INFINITY;
+}
+
+void RelayAutotuner::cancel()
+{
+    if (_state != TUNE_RUNNING) return;
+    _state = TUNE_FAILED;
+    _failure = TUNE_FAIL_CANCELLED;
+}
+
+// ============================================
+// RELAY
+// ============================================
+
+float RelayAutotuner::update(float input, uint32_t nowMs)
+{
+    if (_state != TUNE_RUNNING) return _config.outputBias;
+
+    if (nowMs - _startMs > _config.timeoutMs)
+    {
+        fail((_cycleCount >= _config.cycles) ? TUNE_FAIL_UNSTEADY : TUNE_FAIL_TIMEOUT, nowMs);
+        return _config.outputBias;
+    }
+
+    // Positive error: the output must go up to reach the setpoint
+    float error = _config.reverseActing ? (input - _config.setpoint) : (_config.setpoint - input);
+
+    if (input > _peakMax) _peakMax = input;
+    if (input < _peakMin) _peakMin = input;
+
+    if (!_relayHigh && error > _config.hysteresis)
+    {
+        _relayHigh = true;
+        if (_rises > 0) finishCycle(nowMs);
+        _rises++;
+        _lastRiseMs = nowMs;
+        _peakMax = input;
+        _peakMin = input;
+
+        if (_cycleCount >= _config.cycles && evaluate(nowMs)) return _config.outputBias;
+    }
+    else if (_relayHigh && error < -_config.hysteresis)
+    {
+        _relayHigh = false;
+    }
+
+    return _config.outputBias + (_relayHigh ? _config.relayAmplitude : -_config.relayAmplitude);
+}
+
+void RelayAutotuner::finishCycle(uint32_t nowMs)
+{
+    // Rise n closes cycle n-1; drop the settling cycles
+    if (_rises <= SETTLE_CYCLES) return;
+
+    _periods[_cycleHead] = (nowMs - _lastRiseMs) / 1000.0f;
+    _amplitudes[_cycleHead] = (_peakMax - _peakMin) / 2.0f;
+    _cycleHead = (_cycleHead + 1) % MAX_CYCLES;
+    if (_cycleCount < MAX_CYCLES) _cycleCount++;
+}
+
+bool RelayAutotuner::evaluate(uint32_t nowMs)
+{
+    // Last `cycles` entries of the ring
+    float pSum = 0, pMin = INFINITY, pMax = 0;
+    float aSum = 0, aMin = INFINITY, aMax = 0;
+    for (uint8_t k = 0; k < _config.cycles; k++)
+    {
+        uint8_t i = (_cycleHead + MAX_CYCLES - 1 - k) % MAX_CYCLES;
+        pSum += _periods[i];
+        aSum += _amplitudes[i];
+        if (_periods[i] < pMin) pMin = _periods[i];
+        if (_periods[i] > pMax) pMax = _periods[i];
+        if (_amplitudes[i] < aMin) aMin = _amplitudes[i];
+        if (_amplitudes[i] > aMax) aMax = _amplitudes[i];
+    }
+
+    float pu = pSum / _config.cycles;
+    float a = aSum / _config.cycles;
+    if (pu <= 0) return false;
+
+    float pSpread = (pMax - pMin) / pu;
+    float aSpread = (a > 0) ? (aMax - aMin) / a : 1.0f;
+    if (pSpread > MAX_PERIOD_SPREAD || aSpread > MAX_AMPLITUDE_SPREAD) return false;
+
+    if (a <= _config.hysteresis)
+    {
+        fail(TUNE_FAIL_NO_OSCILLATION, nowMs);
+        return true;
+    }
+
+    _result.puSec = pu;
+    _result.amplitude = a;
+    _result.periodSpread = pSpread;
+    _result.amplitudeSpread = aSpread;
+    _result.cycles = _config.cycles;
+    _result.durationMs = nowMs - _startMs;
+
+    // Describing function of a relay with hysteresis
+    float aEff = sqrtf(a * a - _config.hysteresis * _config.hysteresis);
+    _result.ku = 4.0f * _config.relayAmplitude / ((float)M_PI * aEff);
+
+    gainsFor(_config.rule, _result.ku, _result.puSec, _result.kP, _result.kI, _result.kD);
+    _state = TUNE_DONE;
+    return true;
+}
+
+void RelayAutotuner::fail(Failure failure, uint32_t nowMs)
+{
+    _state = TUNE_FAILED;
+    _failure = failure;
+    _result.cycles = _cycleCount;
+    _result.durationMs = nowMs - _startMs;
+}
+
+// ============================================
+// RULES
+// ============================================
+
+void RelayAutotuner::gainsFor(Rule rule, float ku, float puSec, float &kP, float &kI, float &kD)
+{
+    if (rule >= RULE_COUNT) rule = RULE_ZIEGLER_NICHOLS;
+    const RuleCoefficients &c = RULES[rule];
+
+    kP = c.kuFactor * ku;
+    kI = (c.tiFactor > 0) ? kP / (c.tiFactor * puSec) : 0.0f;
+    kD = kP * c.tdFactor * puSec;
+}
+
+const char *RelayAutotuner::ruleName(Rule rule)
+{
+    return (rule < RULE_COUNT) ? RULES[rule].name : "?";
+}
+
+bool RelayAutotuner::ruleFromName(const char *name, Rule &rule)
+{
+    if (!name) return false;
+    for (uint8_t i = 0; i < RULE_COUNT; i++)
+    {
+        if (strcmp(name, RULES[i].name) == 0)
+        {
+            rule = (Rule)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *RelayAutotuner::stateName(State state)
+{
+    switch (state)
+    {
+    case TUNE_IDLE: return "idle";
+    case TUNE_RUNNING: return "running";
+    case TUNE_DONE: return "done";
+    case TUNE_FAILED: return "failed";
+    default: return "?";
+    }
+}
+
+const char *RelayAutotuner::failureName(Failure failure)
+{
+    switch (failure)
+    {
+    case TUNE_FAIL_NONE: return "none";
+    case TUNE_FAIL_TIMEOUT: return "timeout";
+    case TUNE_FAIL_NO_OSCILLATION: return "no_oscillation";
+    case TUNE_FAIL_UNSTEADY: return "unsteady";
+    case TUNE_FAIL_CANCELLED: return "cancelled";
+    default: return "?";
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef RELAY_AUTOTUNER_H
+#define RELAY_AUTOTUNER_H
+
+#include <stdint.h>
+
+/**
+ * Relay-feedback PID autotuner (Astrom-Hagglund)
+ *
+ * Replaces the controller with a relay around a bias output. The loop
+ * settles into a limit cycle whose amplitude and period give the ultimate
+ * gain and period:
+ *
+ *   Ku = 4 d / (pi * sqrt(a^2 - eps^2))     d = relay amplitude
+ *   Pu = limit cycle period                 a = input amplitude, eps = hysteresis
+ *
+ * Gains are then proposed by a selectable rule (Ziegler-Nichols, Tyreus-
+ * Luyben, ...). The hysteresis keeps sensor noise from chattering the
+ * relay; the first cycle is discarded as transient and the result is only
+ * accepted once the last N cycles agree.
+ *
+ * Works with any loop (PIDController, Pid<T>, a PidBank channel): the
+ * caller feeds the measurement and applies the returned output.
+ * Pure logic - no Arduino dependencies.
+ */
+class RelayAutotuner
+{
+public:
+    enum State : uint8_t
+    {
+        TUNE_IDLE,
+        TUNE_RUNNING,
+        TUNE_DONE,
+        TUNE_FAILED
+    };
+
+    enum Failure : uint8_t
+    {
+        TUNE_FAIL_NONE,
+        TUNE_FAIL_TIMEOUT,        // Never oscillated
+        TUNE_FAIL_NO_OSCILLATION, // Amplitude within the hysteresis band
+        TUNE_FAIL_UNSTEADY,       // Oscillated, but cycles never agreed
+        TUNE_FAIL_CANCELLED
+    };
+
+    enum Rule : uint8_t
+    {
+        RULE_ZIEGLER_NICHOLS,   // Fast, ~25% overshoot
+        RULE_ZIEGLER_NICHOLS_PI,
+        RULE_TYREUS_LUYBEN,     // Conservative, robust to model error
+        RULE_PESSEN,            // Pessen integral: faster disturbance rejection
+        RULE_SOME_OVERSHOOT,
+        RULE_NO_OVERSHOOT,
+        RULE_COUNT
+    };
+
+    struct Config
+    {
+        float setpoint;
+        float outputBias;       // Output the relay switches around
+        float relayAmplitude;   // d: output = bias +- d
+        float hysteresis;       // eps, in input units
+        bool reverseActing;     // Raising the output lowers the input
+        uint8_t cycles;         // Consistent cycles required (2..MAX_CYCLES)
+        uint32_t timeoutMs;
+        Rule rule;
+    };
+
+    struct Result
+    {
+        float ku;
+        float puSec;
+        float amplitude;        // Input half peak-to-peak, averaged
+        float periodSpread;     // (max - min) / mean over the measured cycles
+        float amplitudeSpread;
+        uint8_t cycles;
+        uint32_t durationMs;
+        Rule rule;
+        float kP, kI, kD;
+    };
+
+    static const uint8_t MAX_CYCLES = 8;
+
+    RelayAutotuner();
+
+    void start(const Config &config, uint32_t nowMs);
+    void cancel();
+
+    /**
+     * Feed one measurement
+     * @return Output to apply (the bias once finished)
+     */
+    float update(float input, uint32_t nowMs);
+
+    State getState() const { return _state; }
+    bool isRunning() const { return _state == TUNE_RUNNING; }
+    Failure getFailure() const { return _failure; }
+    uint8_t getCyclesMeasured() const { return _cycleCount; }
+    const Result &getResult() const { return _result; }
+
+    /**
+     * Gains for a rule from Ku/Pu (parallel form: kI = kP / Ti, kD = kP * Td)
+     */
+    static void gainsFor(Rule rule, float ku, float puSec, float &kP, float &kI, float &kD);
+
+    static const char *stateName(State state);
+    static const char *failureName(Failure failure);
+    static const char *ruleName(Rule rule);
+    static bool ruleFromName(const char *name, Rule &rule);
+
+private:
+    Config _config;
+    State _state;
+    Failure _failure;
+    Result _result;
+
+    bool _relayHigh;
+    uint32_t _startMs;
+    uint32_t _lastRiseMs;   // Last low -> high switch
+    uint8_t _rises;
+    float _peakMax;
+    float _peakMin;
+
+    // Ring of the most recent complete cycles
+    float _periods[MAX_CYCLES];
+    float _amplitudes[MAX_CYCLES];
+    uint8_t _cycleHead;
+    uint8_t _cycleCount;
+
+    void finishCycle(uint32_t nowMs);
+    bool evaluate(uint32_t nowMs);
+    void fail(Failure failure, uint32_t nowMs);
+};
+
+#endif // RELAY_AUTOTUNER_H
@@ -1,85 +1,128 @@
 #include "StateMachine.h"
 
-StateMachine::StateMachine() 
-    : _currentState(STATE_INIT), _emergencyLatched(false)
+// ============================================
+// TRANSITION TABLE
+// ============================================
+
+constexpr FsmTransition<StateMachine, RobotEvent> RobotFsmTraits::TRANSITIONS[] = {
+    // from               event              to                 guard                          action
+    {STATE_INIT,          ROBOT_EV_READY,    STATE_IDLE,        nullptr,                       nullptr},
+
+    {STATE_IDLE,          ROBOT_EV_AUTO_ON,  STATE_AUTONOMOUS,  &StateMachine::autonomyAllowed, nullptr},
+    {STATE_IDLE,          ROBOT_EV_DRIVE,    STATE_MANUAL,      nullptr,                       &StateMachine::applyDrive},
+    {STATE_IDLE,          ROBOT_EV_STOP,     STATE_IDLE,        nullptr,                       &StateMachine::holdStop},
+
+    {STATE_AUTONOMOUS,    ROBOT_EV_AUTO_OFF, STATE_IDLE,        nullptr,                       nullptr},
+    {STATE_AUTONOMOUS,    ROBOT_EV_STOP,     STATE_IDLE,        nullptr,                       nullptr},
+    {STATE_AUTONOMOUS,    ROBOT_EV_DRIVE,    STATE_MANUAL,      nullptr,                       &StateMachine::applyDrive},
+
+    {STATE_MANUAL,        ROBOT_EV_DRIVE,    STATE_MANUAL,      nullptr,                       &StateMachine::applyDrive},
+    {STATE_MANUAL,        ROBOT_EV_AUTO_ON,  STATE_AUTONOMOUS,  &StateMachine::autonomyAllowed, nullptr},
+    {STATE_MANUAL,        ROBOT_EV_AUTO_OFF, STATE_IDLE,        nullptr,                       nullptr},
+    {STATE_MANUAL,        ROBOT_EV_STOP,     STATE_IDLE,        nullptr,                       nullptr},
+
+    // Latched: only an operator reset leaves EMERGENCY
+    {STATE_EMERGENCY,     ROBOT_EV_HAZARD,   STATE_EMERGENCY,   nullptr,                       nullptr},
+    {STATE_EMERGENCY,     ROBOT_EV_CLEAR,    STATE_IDLE,        nullptr,                       nullptr},
+    {FSM_ANY_STATE,       ROBOT_EV_HAZARD,   STATE_EMERGENCY,   nullptr,                       nullptr},
+};
+
+constexpr uint8_t RobotFsmTraits::TRANSITION_COUNT = sizeof(TRANSITIONS) / sizeof(TRANSITIONS[0]);
+
+constexpr FsmStateDef<StateMachine> RobotFsmTraits::STATES[] = {
+    // name           entry                            exit                              during
+    {"INIT",          nullptr,                         nullptr,                          nullptr},
+    {"IDLE",          &StateMachine::enterIdle,        nullptr,                          nullptr},
+    {"AUTONOMOUS",    &StateMachine::enterAutonomous,  &StateMachine::exitAutonomous,    nullptr},
+    {"MANUAL",        nullptr,                         &StateMachine::exitManual,        nullptr},
+    {"EMERGENCY",     &StateMachine::enterEmergency,   &StateMachine::exitEmergency,     nullptr},
+    {"ERROR",         nullptr,                         nullptr,                          nullptr},
+};
+
+constexpr const char *const RobotFsmTraits::EVENT_NAMES[] = {
+    "ready", "auto_on", "auto_off", "drive", "stop", "hazard", "clear",
+};
+
+static_assert(sizeof(RobotFsmTraits::STATES) / sizeof(RobotFsmTraits::STATES[0]) == ROBOT_STATE_COUNT,
+              "One state definition per RobotState");
+static_assert(sizeof(RobotFsmTraits::EVENT_NAMES) / sizeof(RobotFsmTraits::EVENT_NAMES[0]) == ROBOT_EV_COUNT,
+              "One name per RobotEventId");
+
+// ============================================
+// EVENTS
+// ============================================
+
+StateMachine::StateMachine()
+    : _machine(STATE_INIT), _hooks()
 {
-    // Start in IDLE after init
-    _currentState = STATE_IDLE;
 }
 
-void StateMachine::transitionTo(RobotState newState)
+bool StateMachine::dispatch(uint8_t eventId, int left, int right)
 {
-    // Block transitions if in emergency (unless clearing)
-    if (_emergencyLatched && newState != STATE_IDLE && newState != STATE_EMERGENCY) {
-        return;
-    }
-    
-    _currentState = newState;
+    RobotEvent ev = {eventId, (int16_t)left, (int16_t)right};
+    return _machine.dispatch(*this, ev, millis());
 }
 
-void StateMachine::setIdle()
+const char *StateMachine::getStateName() const
 {
-    transitionTo(STATE_IDLE);
+    return _machine.getStateName();
 }
 
-void StateMachine::setManual()
+const char *StateMachine::stateName(uint8_t state)
 {
-    transitionTo(STATE_MANUAL);
+    return Machine::stateName(state);
 }
 
-void StateMachine::setAutonomous()
+const char *StateMachine::eventName(uint8_t event)
+{
+    return Machine::eventName(event);
+}
+
+// ============================================
+// GUARDS & ACTIONS
+// ============================================
+
+bool StateMachine::autonomyAllowed(const StateMachine &, const RobotEvent &)
 {
-    transitionTo(STATE_AUTONOMOUS);
+    return ENABLE_AUTONOMOUS != 0;
 }
 
-void StateMachine::triggerEmergency()
+void StateMachine::applyDrive(StateMachine &sm, const RobotEvent &ev)
 {
-    _emergencyLatched = true;
-    _currentState = STATE_EMERGENCY;
+    if (sm._hooks.drive) sm._hooks.drive(ev.left, ev.right);
 }
 
-void StateMachine::clearEmergency()
+void StateMachine::holdStop(StateMachine &sm, const RobotEvent &)
 {
-    // Only way to exit emergency
-    _emergencyLatched = false;
-    _currentState = STATE_IDLE;
+    if (sm._hooks.stopDrive) sm._hooks.stopDrive();
 }
 
-RobotState StateMachine::getState() const
+void StateMachine::enterIdle(StateMachine &sm)
 {
-    return _currentState;
+    if (sm._hooks.stopDrive) sm._hooks.stopDrive();
 }
 
-bool StateMachine::isAutonomous() const
+void StateMachine::exitManual(StateMachine &sm)
 {
-    return _currentState == STATE_AUTONOMOUS;
+    if (sm._hooks.stopDrive) sm._hooks.stopDrive();
 }
 
-bool StateMachine::isManual() const
+void StateMachine::enterAutonomous(StateMachine &sm)
 {
-    return _currentState == STATE_MANUAL;
+    if (sm._hooks.startAutonomy) sm._hooks.startAutonomy();
 }
 
-bool StateMachine::isEmergency() const
+void StateMachine::exitAutonomous(StateMachine &sm)
 {
-    return _currentState == STATE_EMERGENCY;
+    if (sm._hooks.stopAutonomy) sm._hooks.stopAutonomy();
 }
 
-bool StateMachine::isIdle() const
+void StateMachine::enterEmergency(StateMachine &sm)
 {
-    return _currentState == STATE_IDLE;
+    if (sm._hooks.enterEmergency) sm._hooks.enterEmergency();
 }
 
-String StateMachine::getStateName() const
+void StateMachine::exitEmergency(StateMachine &sm)
 {
-    switch (_currentState)
-    {
-        case STATE_INIT: return "INIT";
-        case STATE_IDLE: return "IDLE";
-        case STATE_AUTONOMOUS: return "AUTONOMOUS";
-        case STATE_MANUAL: return "MANUAL";
-        case STATE_EMERGENCY: return "EMERGENCY";
-        case STATE_ERROR: return "ERROR";
-        default: return "UNKNOWN";
-    }
+    if (sm._hooks.clearEmergency) sm._hooks.clearEmergency();
 }
@@ -3,35 +3,109 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "TableFsm.h"
 
+/**
+ * Robot mode events (dispatched by loop() only)
+ */
+enum RobotEventId : uint8_t
+{
+    ROBOT_EV_READY,     // Init done
+    ROBOT_EV_AUTO_ON,
+    ROBOT_EV_AUTO_OFF,
+    ROBOT_EV_DRIVE,     // Manual drive command (left/right)
+    ROBOT_EV_STOP,
+    ROBOT_EV_HAZARD,    // Safety trip - latched until ROBOT_EV_CLEAR
+    ROBOT_EV_CLEAR,     // Operator reset
+    ROBOT_EV_COUNT
+};
+
+struct RobotEvent
+{
+    uint8_t id;
+    int16_t left;       // ROBOT_EV_DRIVE only
+    int16_t right;
+};
+
+class StateMachine;
+
+struct RobotFsmTraits
+{
+    using Context = StateMachine;
+    using Event = RobotEvent;
+    static constexpr uint8_t STATE_COUNT = ROBOT_STATE_COUNT;
+    static constexpr uint8_t EVENT_COUNT = ROBOT_EV_COUNT;
+    static const FsmTransition<StateMachine, RobotEvent> TRANSITIONS[];
+    static const uint8_t TRANSITION_COUNT;
+    static const FsmStateDef<StateMachine> STATES[];
+    static const char *const EVENT_NAMES[];
+};
+
+/**
+ * Robot mode machine (idle / manual / autonomous / emergency)
+ *
+ * - Compile-time transition table (StateMachine.cpp) with guards and
+ *   entry/exit actions; the emergency latch is structural - EMERGENCY has
+ *   no way out except ROBOT_EV_CLEAR
+ * - Only loop() calls dispatch(), so the mode never changes under loop's
+ *   feet; WebSocket callbacks queue their commands for loop() instead
+ * - Side effects (stop drive, start autonomy, ...) are the owner's hooks,
+ *   run from the entry/exit actions in loop() context
+ * - Transition trace for telemetry
+ */
 class StateMachine
 {
 public:
+    typedef TableFsm<RobotFsmTraits> Machine;
+
+    struct Hooks
+    {
+        void (*stopDrive)();                    // Entry IDLE, exit MANUAL
+        void (*drive)(int left, int right);     // ROBOT_EV_DRIVE
+        void (*startAutonomy)();                // Entry AUTONOMOUS
+        void (*stopAutonomy)();                 // Exit AUTONOMOUS
+        void (*enterEmergency)();               // Entry EMERGENCY
+        void (*clearEmergency)();               // Exit EMERGENCY
+    };
+
     StateMachine();
 
-    // State Transitions (Events)
-    void setIdle();
-    void setManual();
-    void setAutonomous();
-    
-    void triggerEmergency();
-    void clearEmergency(); // Explicit reset required
+    void setHooks(const Hooks &hooks) { _hooks = hooks; }
+
+    /**
+     * Apply an event (loop() only)
+     */
+    bool dispatch(uint8_t eventId, int left = 0, int right = 0);
 
     // State Queries
-    RobotState getState() const;
-    bool isAutonomous() const;
-    bool isManual() const;
-    bool isEmergency() const;
-    bool isIdle() const;
+    RobotState getState() const { return (RobotState)_machine.getState(); }
+    bool isAutonomous() const { return getState() == STATE_AUTONOMOUS; }
+    bool isManual() const { return getState() == STATE_MANUAL; }
+    bool isEmergency() const { return getState() == STATE_EMERGENCY; }
+    bool isIdle() const { return getState() == STATE_IDLE; }
 
     // Helper for telemetry/logging
-    String getStateName() const;
+    const char *getStateName() const;
+    const Machine &getMachine() const { return _machine; }
+    static const char *stateName(uint8_t state);
+    static const char *eventName(uint8_t event);
 
 private:
-    RobotState _currentState;
-    bool _emergencyLatched;
+    friend struct RobotFsmTraits;
+
+    Machine _machine;
+    Hooks _hooks;
 
-    void transitionTo(RobotState newState);
+    // Table callbacks
+    static bool autonomyAllowed(const StateMachine &sm, const RobotEvent &ev);
+    static void applyDrive(StateMachine &sm, const RobotEvent &ev);
+    static void holdStop(StateMachine &sm, const RobotEvent &ev);
+    static void enterIdle(StateMachine &sm);
+    static void exitManual(StateMachine &sm);
+    static void enterAutonomous(StateMachine &sm);
+    static void exitAutonomous(StateMachine &sm);
+    static void enterEmergency(StateMachine &sm);
+    static void exitEmergency(StateMachine &sm);
 };
 
 #endif
@@ -0,0 +1,256 @@
+#ifndef TABLE_FSM_H
+#define TABLE_FSM_H
+
+#include <stdint.h>
+#include <array>
+
+/**
+ * Table-driven finite state machine core
+ *
+ * A machine is described by a Traits struct:
+ *
+ *   struct Traits {
+ *       using Context = ...;        // Object the actions operate on
+ *       using Event = ...;          // Struct with a uint8_t `id` field
+ *       static constexpr uint8_t STATE_COUNT, EVENT_COUNT;
+ *       static const FsmTransition<Context, Event> TRANSITIONS[];
+ *       static const uint8_t TRANSITION_COUNT;
+ *       static const FsmStateDef<Context> STATES[];     // One per state
+ *       static const char *const EVENT_NAMES[];         // One per event
+ *   };
+ *
+ * The arrays are defined constexpr in the owning .cpp, so the
+ * (state, event) -> transition index is built at compile time and lookup
+ * is O(1). Everything that reads the arrays (dispatch, names) must be
+ * called from that .cpp - the owner exports names through its own
+ * functions.
+ *
+ * - Transitions sharing (from, event) must be adjacent; they are tried in
+ *   table order and the first whose guard passes is taken
+ * - from = FSM_ANY_STATE matches every state without its own entry for
+ *   that event
+ * - to == current state is an internal transition: action only, no
+ *   exit/entry, not traced
+ * - Order on a transition: exit(from), action, entry(to)
+ * - Actions must not dispatch (post to a queue instead)
+ *
+ * Every transition is recorded with its timestamp in a small ring for
+ * telemetry. Pure logic - no Arduino dependencies.
+ */
+
+static constexpr uint8_t FSM_ANY_STATE = 0xFF;
+
+template <typename Ctx, typename Ev>
+struct FsmTransition
+{
+    uint8_t from;       // State, or FSM_ANY_STATE
+    uint8_t event;
+    uint8_t to;
+    bool (*guard)(const Ctx &, const Ev &);   // nullptr = always
+    void (*action)(Ctx &, const Ev &);        // nullptr = none
+};
+
+template <typename Ctx>
+struct FsmStateDef
+{
+    const char *name;
+    void (*onEntry)(Ctx &);
+    void (*onExit)(Ctx &);
+    void (*during)(Ctx &);  // Called by run() while in the state
+};
+
+struct FsmTraceEntry
+{
+    uint32_t timeMs;
+    uint8_t from;
+    uint8_t to;
+    uint8_t event;
+};
+
+template <typename Traits>
+class TableFsm
+{
+public:
+    using Context = typename Traits::Context;
+    using Event = typename Traits::Event;
+
+    static constexpr uint8_t STATE_COUNT = Traits::STATE_COUNT;
+    static constexpr uint8_t EVENT_COUNT = Traits::EVENT_COUNT;
+    static constexpr uint8_t TRACE_SIZE = 16;
+    static constexpr uint8_t NONE = 0xFF;
+
+    explicit TableFsm(uint8_t initial)
+        : _state(initial), _enteredMs(0), _transitions(0), _rejected(0),
+          _traceHead(0), _traceCount(0)
+    {
+    }
+
+    /**
+     * Run the entry action of the initial state
+     */
+    void start(Context &ctx, uint32_t nowMs)
+    {
+        _enteredMs = nowMs;
+        if (Traits::STATES[_state].onEntry) Traits::STATES[_state].onEntry(ctx);
+    }
+
+    /**
+     * Feed one event
+     * @return true if a transition (or internal action) was taken
+     */
+    bool dispatch(Context &ctx, const Event &ev, uint32_t nowMs);
+
+    /**
+     * Run the current state's `during` action
+     */
+    void run(Context &ctx)
+    {
+        if (Traits::STATES[_state].during) Traits::STATES[_state].during(ctx);
+    }
+
+    uint8_t getState() const { return _state; }
+    const char *getStateName() const { return stateName(_state); }
+    uint32_t getTimeInState(uint32_t nowMs) const { return nowMs - _enteredMs; }
+
+    static const char *stateName(uint8_t s) { return (s < STATE_COUNT) ? Traits::STATES[s].name : "?"; }
+    static const char *eventName(uint8_t e) { return (e < EVENT_COUNT) ? Traits::EVENT_NAMES[e] : "?"; }
+
+    // Statistics
+    uint32_t getTransitionCount() const { return _transitions; }
+    uint32_t getRejectedCount() const { return _rejected; }
+
+    // Transition trace (0 = newest)
+    uint8_t getTraceCount() const { return _traceCount; }
+    const FsmTraceEntry &getTrace(uint8_t i) const
+    {
+        return _trace[(uint8_t)(_traceHead + TRACE_SIZE - 1 - i) % TRACE_SIZE];
+    }
+
+private:
+    uint8_t _state;
+    uint32_t _enteredMs;
+    uint32_t _transitions;
+    uint32_t _rejected;
+
+    FsmTraceEntry _trace[TRACE_SIZE];
+    uint8_t _traceHead;
+    uint8_t _traceCount;
+
+    using Index = std::array<uint8_t, STATE_COUNT * EVENT_COUNT>;
+
+    static constexpr Index buildIndex()
+    {
+        Index idx{};
+        uint8_t anyFirst[EVENT_COUNT] = {};
+        for (uint8_t e = 0; e < EVENT_COUNT; e++) anyFirst[e] = NONE;
+        for (size_t k = 0; k < idx.size(); k++) idx[k] = NONE;
+
+        // Walk backwards so each slot ends up at the first entry of its run
+        for (uint8_t i = Traits::TRANSITION_COUNT; i-- > 0;)
+        {
+            const auto &t = Traits::TRANSITIONS[i];
+            if (t.from == FSM_ANY_STATE)
+                anyFirst[t.event] = i;
+            else
+                idx[t.from * EVENT_COUNT + t.event] = i;
+        }
+
+        for (uint8_t s = 0; s < STATE_COUNT; s++)
+        {
+            for (uint8_t e = 0; e < EVENT_COUNT; e++)
+            {
+                if (idx[s * EVENT_COUNT + e] == NONE) idx[s * EVENT_COUNT + e] = anyFirst[e];
+            }
+        }
+        return idx;
+    }
+
+    // Entries sharing (from, event) must be adjacent for the run scan
+    static constexpr bool tableGrouped()
+    {
+        for (uint8_t i = 0; i < Traits::TRANSITION_COUNT; i++)
+        {
+            for (uint8_t j = i + 2; j < Traits::TRANSITION_COUNT; j++)
+            {
+                const auto &a = Traits::TRANSITIONS[i];
+                const auto &b = Traits::TRANSITIONS[j];
+                const auto &m = Traits::TRANSITIONS[j - 1];
+                bool same = a.from == b.from && a.event == b.event;
+                bool brokenRun = !(m.from == a.from && m.event == a.event);
+                if (same && brokenRun) return false;
+            }
+        }
+        return true;
+    }
+
+    static constexpr bool tableValid()
+    {
+        for (uint8_t i = 0; i < Traits::TRANSITION_COUNT; i++)
+        {
+            const auto &t = Traits::TRANSITIONS[i];
+            if (t.from != FSM_ANY_STATE && t.from >= STATE_COUNT) return false;
+            if (t.to >= STATE_COUNT || t.event >= EVENT_COUNT) return false;
+        }
+        return true;
+    }
+
+    void record(uint8_t from, uint8_t to, uint8_t event, uint32_t nowMs)
+    {
+        _trace[_traceHead] = {nowMs, from, to, event};
+        _traceHead = (_traceHead + 1) % TRACE_SIZE;
+        if (_traceCount < TRACE_SIZE) _traceCount++;
+    }
+};
+
+template <typename Traits>
+bool TableFsm<Traits>::dispatch(Context &ctx, const Event &ev, uint32_t nowMs)
+{
+    static_assert(tableValid(), "Transition table references an unknown state or event");
+    static_assert(tableGrouped(), "Transitions sharing (from, event) must be adjacent");
+    static constexpr Index INDEX = buildIndex();
+
+    if (ev.id >= EVENT_COUNT)
+    {
+        _rejected++;
+        return false;
+    }
+
+    uint8_t i = INDEX[_state * EVENT_COUNT + ev.id];
+    if (i == NONE)
+    {
+        _rejected++;
+        return false;
+    }
+
+    const uint8_t runFrom = Traits::TRANSITIONS[i].from;
+    for (; i < Traits::TRANSITION_COUNT; i++)
+    {
+        const auto &t = Traits::TRANSITIONS[i];
+        if (t.from != runFrom || t.event != ev.id) break;
+        if (t.guard && !t.guard(ctx, ev)) continue;
+
+        // Internal transition
+        if (t.to == _state)
+        {
+            if (t.action) t.action(ctx, ev);
+            return true;
+        }
+
+        uint8_t from = _state;
+        if (Traits::STATES[from].onExit) Traits::STATES[from].onExit(ctx);
+        if (t.action) t.action(ctx, ev);
+        _state = t.to;
+        _enteredMs = nowMs;
+        if (Traits::STATES[_state].onEntry) Traits::STATES[_state].onEntry(ctx);
+
+        _transitions++;
+        record(from, _state, ev.id, nowMs);
+        return true;
+    }
+
+    // Every guard refused
+    _rejected++;
+    return false;
+}
+
+#endif // TABLE_FSM_H
@@ -11,6 +11,7 @@ EncoderManager::EncoderManager()
         _wheels[i].enabled = false;
         _wheels[i].lastPcntCount = 0;
         _wheels[i].totalCount = 0;
+        _wheels[i].rpmCount = 0;
         _wheels[i].rpm = 0.0f;
         _wheels[i].rpmBufferIndex = 0;
         _wheels[i].lastUpdate = 0;
@@ -131,10 +132,10 @@ void EncoderManager::calculateRPM(WheelID wheel, float dt)
 {
     WheelState &w = _wheels[wheel];
 
-    // Get count delta since last update
-    int16_t currentCount;
-    pcnt_get_counter_value(w.pcntUnit, &currentCount);
-    int16_t delta = currentCount - w.lastPcntCount;
+    // Count delta since the last RPM sample (update() has already folded
+    // the hardware counter into totalCount)
+    int32_t delta = w.totalCount - w.rpmCount;
+    w.rpmCount = w.totalCount;
 
     // RPM = (counts / CPR) × (60 / dt) × gear_ratio
     // CPR = counts per revolution (ENCODER_PPR × 4 for quadrature)
@@ -217,6 +218,7 @@ void EncoderManager::resetCounts(WheelID wheel)
 
     // Reset total count
     _wheels[wheel].totalCount = 0;
+    _wheels[wheel].rpmCount = 0;
 
     // Reset PCNT hardware counter
     pcnt_counter_pause(_wheels[wheel].pcntUnit);
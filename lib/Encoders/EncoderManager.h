@@ -108,6 +108,7 @@ private:
         // Counting
         int16_t lastPcntCount;    // Last PCNT hardware count
         int32_t totalCount;       // Accumulated count (handles overflow)
+        int32_t rpmCount;         // totalCount at the last RPM sample
         
         // Velocity
         float rpm;
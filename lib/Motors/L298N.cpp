@@ -1,4 +1,6 @@
 #include "L298N.h"
+#include <driver/ledc.h>
+#include <soc/soc_caps.h>
 
 /**
  * L298N Motor Driver Implementation (REFACTORED - Dual Motor Only)
@@ -12,45 +14,116 @@
  * Result: Leaner code, ~25% smaller binary footprint
  */
 
+// Longest single hardware fade; a new target waits at most this long
+static const uint16_t FADE_SEGMENT_MS = 100;
+
+// ledc_fade_func_install() is global to the LEDC peripheral
+static bool s_fadeInstalled = false;
+
+// Arduino LEDC channel -> IDF speed mode / channel (same split as ledcSetup)
+static ledc_mode_t fadeMode(uint8_t channel)
+{
+    return (ledc_mode_t)(channel / SOC_LEDC_CHANNEL_NUM);
+}
+
+static ledc_channel_t fadeChannel(uint8_t channel)
+{
+    return (ledc_channel_t)(channel % SOC_LEDC_CHANNEL_NUM);
+}
+
+static bool IRAM_ATTR onFadeEnd(const ledc_cb_param_t *param, void *arg)
+{
+    if (param->event == LEDC_FADE_END_EVT)
+    {
+        *static_cast<volatile bool *>(arg) = false;
+    }
+    return false;
+}
+
 // Constructor for dual motor only
 L298N::L298N(uint8_t ena1, uint8_t in1a, uint8_t in1b,
              uint8_t ena2, uint8_t in2a, uint8_t in2b,
              uint8_t channel1, uint8_t channel2)
     : _ena1(ena1), _in1a(in1a), _in1b(in1b), _channel1(channel1), _speed1(0), _target1(0),
       _ena2(ena2), _in2a(in2a), _in2b(in2b), _channel2(channel2), _speed2(0), _target2(0),
-      _rampRate(10)  // Default: 10 PWM units per update (~1.25s full ramp at 20Hz)
+      _rampRate(10),  // Default: 10 PWM units per update (~1.25s full ramp at 20Hz)
+      _backend(RAMP_SOFTWARE), _rampTimeMs(500), _wasRamping(false), _rampDone(false),
+      _maxDuty(255), _cut(false), _mux(portMUX_INITIALIZER_UNLOCKED)
 {
+    for (uint8_t m = 0; m < 2; m++)
+    {
+        _lin[m].fillTable(_dutyLut[m], _maxDuty);
+        _fade[m].active = false;
+        _fade[m].instant = false;
+        _fade[m].dir = 0;
+    }
 }
 
-void L298N::begin()
+bool L298N::begin(uint32_t pwmFreqHz, uint8_t pwmBits)
 {
     // Configure Motor 1
     pinMode(_ena1, OUTPUT);
     pinMode(_in1a, OUTPUT);
     pinMode(_in1b, OUTPUT);
-    ledcSetup(_channel1, 5000, 8); // 5kHz, 8-bit resolution
+    bool ok = ledcSetup(_channel1, pwmFreqHz, pwmBits) != 0;  // 0 = unreachable freq/bits
     ledcAttachPin(_ena1, _channel1);
 
     // Configure Motor 2
     pinMode(_ena2, OUTPUT);
     pinMode(_in2a, OUTPUT);
     pinMode(_in2b, OUTPUT);
-    ledcSetup(_channel2, 5000, 8); // 5kHz, 8-bit resolution
+    ok &= ledcSetup(_channel2, pwmFreqHz, pwmBits) != 0;
     ledcAttachPin(_ena2, _channel2);
+
+    // Re-expand the duty tables at the new resolution
+    _maxDuty = (1u << pwmBits) - 1;
+    _lin[0].fillTable(_dutyLut[0], _maxDuty);
+    _lin[1].fillTable(_dutyLut[1], _maxDuty);
+    return ok;
+}
+
+void L298N::setLinearizer(uint8_t motor, const MotorLinearizer &linearizer)
+{
+    if (motor > 1) return;
+
+    // Built aside and copied under the lock so a write never sees half a table
+    uint16_t table[MotorLinearizer::FULL_SCALE + 1];
+    linearizer.fillTable(table, _maxDuty);
+
+    portENTER_CRITICAL(&_mux);
+    _lin[motor] = linearizer;
+    memcpy(_dutyLut[motor], table, sizeof(table));
+    portEXIT_CRITICAL(&_mux);
 }
 
 void L298N::setMotor1Speed(int speed)
 {
     speed = constrain(speed, -255, 255);
-    _speed1 = speed;
-    setSingleMotorSpeed(_ena1, _in1a, _in1b, speed, _channel1);
+    if (_backend == RAMP_HW_FADE)
+    {
+        _target1 = speed;
+        _fade[0].instant = true;
+        if (speed == 0) setDirection(0, 0);
+        fadeStep(0);
+        return;
+    }
+    _speed1 = _target1 = _cut ? 0 : speed;  // An instant set ends any ramp
+    setSingleMotorSpeed(0, speed);
 }
 
 void L298N::setMotor2Speed(int speed)
 {
     speed = constrain(speed, -255, 255);
-    _speed2 = speed;
-    setSingleMotorSpeed(_ena2, _in2a, _in2b, speed, _channel2);
+    if (_backend == RAMP_HW_FADE)
+    {
+        _target2 = speed;
+        _fade[1].instant = true;
+        if (speed == 0) setDirection(1, 0);
+        fadeStep(1);
+        return;
+    }
+    _speed2 = _target2 = _cut ? 0 : speed;
+    setSingleMotorSpeed(1, speed);
 }
 
 void L298N::setMotors(int speed1, int speed2)
@@ -95,6 +168,50 @@ bool L298N::isMoving()
     return (_speed1 != 0) || (_speed2 != 0);
 }
 
+// ============================================
+// EMERGENCY CUT
+// ============================================
+
+void L298N::cutOutputs()
+{
+    bool fading = _backend == RAMP_HW_FADE;
+
+    portENTER_CRITICAL(&_mux);
+    _cut = true;
+    digitalWrite(_in1a, LOW);
+    digitalWrite(_in1b, LOW);
+    digitalWrite(_in2a, LOW);
+    digitalWrite(_in2b, LOW);
+    // The fade driver blocks while a fade runs, so with the hardware
+    // backend the inputs alone stop the drive; update() zeroes the duty
+    if (!fading)
+    {
+        ledcWrite(_channel1, 0);
+        ledcWrite(_channel2, 0);
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    _target1 = 0;
+    _target2 = 0;
+    if (fading)
+    {
+        _fade[0].dir = 0;
+        _fade[1].dir = 0;
+    }
+    else
+    {
+        _speed1 = 0;
+        _speed2 = 0;
+    }
+}
+
+void L298N::releaseCut()
+{
+    portENTER_CRITICAL(&_mux);
+    _cut = false;
+    portEXIT_CRITICAL(&_mux);
+}
+
 /**
  * Helper: Set individual motor speed with direction
  *
@@ -103,26 +220,33 @@ bool L298N::isMoving()
  * - Backward: in1=LOW, in2=HIGH, pwm=speed
  * - Stop:     in1=LOW, in2=LOW, pwm=0
  */
-void L298N::setSingleMotorSpeed(uint8_t ena, uint8_t in1, uint8_t in2,
-                                int speed, uint8_t channel)
+void L298N::setSingleMotorSpeed(uint8_t motor, int speed)
 {
+    uint8_t in1 = motor ? _in2a : _in1a;
+    uint8_t in2 = motor ? _in2b : _in1b;
+    uint8_t channel = motor ? _channel2 : _channel1;
+
     // Clamp speed
     speed = constrain(speed, -255, 255);
 
+    // Held low while cut; the lock keeps a cut from landing mid-update
+    portENTER_CRITICAL(&_mux);
+    if (_cut) speed = 0;
+
     // Set direction and PWM
     if (speed > 0)
     {
         // Forward
         digitalWrite(in1, HIGH);
         digitalWrite(in2, LOW);
-        ledcWrite(channel, speed);
+        ledcWrite(channel, dutyFor(motor, speed));
     }
     else if (speed < 0)
     {
         // Backward
         digitalWrite(in1, LOW);
         digitalWrite(in2, HIGH);
-        ledcWrite(channel, -speed);
+        ledcWrite(channel, dutyFor(motor, speed));
     }
     else
     {
@@ -131,6 +255,7 @@ void L298N::setSingleMotorSpeed(uint8_t ena, uint8_t in1, uint8_t in2,
         digitalWrite(in2, LOW);
         ledcWrite(channel, 0);
     }
+    portEXIT_CRITICAL(&_mux);
 }
 
 // ============================================
@@ -141,6 +266,15 @@ void L298N::setMotorsRamped(int target1, int target2)
 {
     _target1 = constrain(target1, -255, 255);
     _target2 = constrain(target2, -255, 255);
+
+    if (_backend == RAMP_HW_FADE)
+    {
+        // Start now if the hardware is idle, else at the segment boundary
+        _fade[0].instant = false;
+        _fade[1].instant = false;
+        fadeStep(0);
+        fadeStep(1);
+    }
 }
 
 void L298N::setRampRate(uint8_t rate)
@@ -148,8 +282,46 @@ void L298N::setRampRate(uint8_t rate)
     _rampRate = (rate > 0) ? rate : 1;  // Minimum rate of 1
 }
 
+bool L298N::setRampBackend(RampBackend backend)
+{
+    if (backend == _backend) return true;
+
+    if (backend == RAMP_SOFTWARE)
+    {
+        if (_fade[0].active || _fade[1].active) return false;
+        _backend = RAMP_SOFTWARE;
+        return true;
+    }
+
+    if (!s_fadeInstalled)
+    {
+        if (ledc_fade_func_install(0) != ESP_OK) return false;
+        s_fadeInstalled = true;
+    }
+
+    ledc_cbs_t cbs = {.fade_cb = onFadeEnd};
+    if (ledc_cb_register(fadeMode(_channel1), fadeChannel(_channel1), &cbs, (void *)&_fade[0].active) != ESP_OK ||
+        ledc_cb_register(fadeMode(_channel2), fadeChannel(_channel2), &cbs, (void *)&_fade[1].active) != ESP_OK)
+    {
+        return false;
+    }
+
+    // Pick up from whatever the software path left on the bridge
+    _fade[0].dir = (_speed1 > 0) - (_speed1 < 0);
+    _fade[1].dir = (_speed2 > 0) - (_speed2 < 0);
+    _backend = RAMP_HW_FADE;
+    return true;
+}
+
 bool L298N::update()
 {
+    if (_backend == RAMP_HW_FADE)
+    {
+        fadeStep(0);
+        fadeStep(1);
+        return trackRamp();
+    }
+
     // Move current speeds towards targets
     int newSpeed1 = moveTowards(_speed1, _target1, _rampRate);
     int newSpeed2 = moveTowards(_speed2, _target2, _rampRate);
@@ -158,22 +330,129 @@ bool L298N::update()
     if (newSpeed1 != _speed1)
     {
         _speed1 = newSpeed1;
-        setSingleMotorSpeed(_ena1, _in1a, _in1b, _speed1, _channel1);
+        setSingleMotorSpeed(0, _speed1);
     }
     
     if (newSpeed2 != _speed2)
     {
         _speed2 = newSpeed2;
-        setSingleMotorSpeed(_ena2, _in2a, _in2b, _speed2, _channel2);
+        setSingleMotorSpeed(1, _speed2);
     }
     
     // Return true if still ramping
-    return isRamping();
+    return trackRamp();
 }
 
 bool L298N::isRamping() const
 {
-    return (_speed1 != _target1) || (_speed2 != _target2);
+    return (_speed1 != _target1) || (_speed2 != _target2) ||
+           _fade[0].active || _fade[1].active;
+}
+
+bool L298N::consumeRampDone()
+{
+    bool done = _rampDone;
+    _rampDone = false;
+    return done;
+}
+
+// Latch the ramping -> settled edge for consumeRampDone()
+bool L298N::trackRamp()
+{
+    bool ramping = isRamping();
+    if (_wasRamping && !ramping) _rampDone = true;
+    _wasRamping = ramping;
+    return ramping;
+}
+
+// ============================================
+// HARDWARE FADE
+// ============================================
+
+void L298N::setDirection(uint8_t motor, int8_t dir)
+{
+    uint8_t inA = motor ? _in2a : _in1a;
+    uint8_t inB = motor ? _in2b : _in1b;
+
+    // Same lock as cutOutputs(): a cut can't be overwritten mid-change
+    portENTER_CRITICAL(&_mux);
+    if (_cut) dir = 0;
+    digitalWrite(inA, dir > 0 ? HIGH : LOW);
+    digitalWrite(inB, dir < 0 ? HIGH : LOW);
+    portEXIT_CRITICAL(&_mux);
+
+    _fade[motor].dir = dir;
+}
+
+/**
+ * One fade segment for one motor
+ *
+ * The duty only ever fades in magnitude; direction changes happen at zero
+ * with the duty at 0, so the bridge never reverses under load. Segments
+ * are capped at FADE_SEGMENT_MS so a retarget mid-ramp is picked up
+ * quickly. No LEDC call is made while a fade runs (the driver would block).
+ */
+void L298N::fadeStep(uint8_t motor)
+{
+    FadeChannel &f = _fade[motor];
+    if (f.active) return;
+
+    int &speed = motor ? _speed2 : _speed1;
+    int target = _cut ? 0 : (motor ? _target2 : _target1);
+    uint8_t channel = motor ? _channel2 : _channel1;
+    int8_t speedDir = (speed > 0) - (speed < 0);
+
+    // Inputs dropped under a running duty (cut or stop): nothing is being
+    // driven, so restart from zero
+    if (speed != 0 && f.dir != speedDir)
+    {
+        ledcWrite(channel, 0);
+        speed = 0;
+        speedDir = 0;
+    }
+
+    // At zero the bridge takes the direction of the next leg
+    if (speed == 0)
+    {
+        int8_t targetDir = (target > 0) - (target < 0);
+        if (f.dir != targetDir) setDirection(motor, targetDir);
+    }
+
+    if (speed == target)
+    {
+        f.instant = false;
+        return;
+    }
+
+    // Reversal: this leg ends at zero
+    int leg = (speed != 0 && speedDir != ((target > 0) - (target < 0))) ? 0 : target;
+
+    int next = leg;
+    uint32_t fadeMs = 0;
+    if (!f.instant && !_cut && _rampTimeMs > 0)
+    {
+        int maxStep = max(1, (int)(255L * FADE_SEGMENT_MS / _rampTimeMs));
+        next = moveTowards(speed, leg, maxStep);
+        fadeMs = (uint32_t)abs(next - speed) * _rampTimeMs / 255;
+    }
+
+    // The hardware interpolates duty linearly between table points
+    uint32_t duty = dutyFor(motor, next);
+    if (fadeMs == 0)
+    {
+        ledcWrite(channel, duty);
+    }
+    else
+    {
+        f.active = true;
+        if (ledc_set_fade_time_and_start(fadeMode(channel), fadeChannel(channel), duty,
+                                         fadeMs, LEDC_FADE_NO_WAIT) != ESP_OK)
+        {
+            f.active = false;
+            ledcWrite(channel, duty);
+        }
+    }
+    speed = next;
 }
 
 int L298N::moveTowards(int current, int target, int step)
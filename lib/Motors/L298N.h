@@ -2,16 +2,21 @@
 #define L298N_H
 
 #include <Arduino.h>
+#include "MotorLinearizer.h"
 
 /**
  * L298N Motor Driver Abstraction (REFACTORED - Dual Motor Only)
  *
  * Supports 2 motors per driver via PWM speed control + direction pins
+ *
+ * Speeds are linear commands (-255..255, see MotorLinearizer), mapped per
+ * motor through a calibrated duty table at the configured PWM resolution.
  * 
  * Features:
  * - Instant speed control (setMotors)
  * - Ramped speed control (setMotorsRamped + update)
  * - Configurable ramp rate for smooth acceleration/deceleration
+ * - Optional LEDC hardware fade backend for time-based ramps
  */
 class L298N
 {
@@ -32,7 +37,22 @@ public:
           uint8_t ena2, uint8_t in2a, uint8_t in2b,
           uint8_t channel1, uint8_t channel2);
 
-    void begin();
+    /**
+     * Configure both PWM channels and the bridge pins
+     * The two channels share one LEDC timer (Arduino pairs channels 2n and
+     * 2n+1), so frequency and resolution are per driver. 80 MHz / freq must
+     * leave room for the resolution: 20 kHz allows up to 11 bits.
+     * @return false if the LEDC timer rejected the combination
+     */
+    bool begin(uint32_t pwmFreqHz = 5000, uint8_t pwmBits = 8);
+
+    /**
+     * Command -> duty calibration for one motor (0 or 1)
+     * Safe to call before or after begin().
+     */
+    void setLinearizer(uint8_t motor, const MotorLinearizer &linearizer);
+    const MotorLinearizer &getLinearizer(uint8_t motor) const { return _lin[motor]; }
+    uint32_t getMaxDuty() const { return _maxDuty; }
 
     // ========================================
     // INSTANT SPEED CONTROL (immediate change)
@@ -48,9 +68,49 @@ public:
     void turnRight(uint8_t speed = 150);
     void stopMotors();
 
+    // ========================================
+    // EMERGENCY CUT (callable from another task)
+    // ========================================
+    /**
+     * Drive all bridge inputs low and zero both duties immediately, then
+     * ignore drive commands until releaseCut(). Serialised with the normal
+     * setters, so a command already in flight can't re-energise the bridge.
+     */
+    void cutOutputs();
+    void releaseCut();
+    bool isCut() const { return _cut; }
+
     // ========================================
     // RAMPED SPEED CONTROL (gradual change)
     // ========================================
+    enum RampBackend : uint8_t
+    {
+        RAMP_SOFTWARE,  // update() steps the duty by the ramp rate per call
+        RAMP_HW_FADE    // LEDC hardware fade, rate set by setRampTime()
+    };
+
+    /**
+     * Select the ramp backend
+     *
+     * RAMP_HW_FADE programs ledc_set_fade_with_time, so the slope is set in
+     * milliseconds and runs between loop() calls without CPU or GPIO writes.
+     * A ramp is issued as fades of at most ~100 ms, so a new target is
+     * picked up at the next segment boundary. A fade that is running can't
+     * be interrupted: instant setters also wait for that boundary, except
+     * a stop, which drops the bridge inputs at once.
+     *
+     * @return false if the fade driver couldn't be installed (backend unchanged)
+     *         or if switching back to software while a fade is running
+     */
+    bool setRampBackend(RampBackend backend);
+    RampBackend getRampBackend() const { return _backend; }
+
+    /**
+     * Hardware fade slope: ms for a full 0 -> 255 change (0 = instant)
+     * Default: 500
+     */
+    void setRampTime(uint16_t fullScaleMs) { _rampTimeMs = fullScaleMs; }
+
     /**
      * Set target speeds with ramping. Call update() in loop to apply.
      * @param target1 Target speed for motor 1 (-255 to 255)
@@ -59,13 +119,16 @@ public:
     void setMotorsRamped(int target1, int target2);
     
     /**
-     * Set ramp rate (PWM units per update call)
+     * Set ramp rate (PWM units per update call, software backend)
      * Default: 10 (reaches 255 in ~25 updates at 20Hz = 1.25s ramp)
      */
     void setRampRate(uint8_t rate);
     
     /**
      * Update motor speeds towards targets. Call every loop iteration.
+     * With the hardware backend this only chains the next fade segment
+     * once the previous one has finished - a flag check otherwise.
+     * Reversals run down to zero, flip the direction pins, then run up.
      * @return true if motors are still ramping, false if at target
      */
     bool update();
@@ -75,6 +138,12 @@ public:
      */
     bool isRamping() const;
 
+    /**
+     * True once after both motors have reached their targets
+     * (edge seen by update())
+     */
+    bool consumeRampDone();
+
     // ========================================
     // STATUS QUERIES
     // ========================================
@@ -99,11 +168,38 @@ private:
     
     // Ramping
     uint8_t _rampRate;
+    RampBackend _backend;
+    uint16_t _rampTimeMs;
+    bool _wasRamping;
+    bool _rampDone;
+
+    // Hardware fade, per motor
+    struct FadeChannel
+    {
+        volatile bool active;   // Fade running; cleared by the fade-end ISR
+        bool instant;           // Next step jumps straight to the target
+        int8_t dir;             // Direction the bridge inputs are set to
+    };
+    FadeChannel _fade[2];
 
-    // Helper: control individual motor with direction and PWM
-    void setSingleMotorSpeed(uint8_t ena, uint8_t in1, uint8_t in2,
-                             int speed, uint8_t channel);
+    // PWM duty per command magnitude, per motor
+    MotorLinearizer _lin[2];
+    uint16_t _dutyLut[2][MotorLinearizer::FULL_SCALE + 1];
+    uint32_t _maxDuty;
+
+    // Emergency cut
+    volatile bool _cut;
+    portMUX_TYPE _mux;
+
+    // Helper: control individual motor (0 or 1) with direction and PWM
+    void setSingleMotorSpeed(uint8_t motor, int speed);
+    uint32_t dutyFor(uint8_t motor, int speed) const { return _dutyLut[motor][abs(speed)]; }
     
+    // Hardware fade: start the next segment for one motor (0 or 1)
+    void fadeStep(uint8_t motor);
+    void setDirection(uint8_t motor, int8_t dir);
+    bool trackRamp();
+
     // Helper: move value towards target by step
     static int moveTowards(int current, int target, int step);
 };
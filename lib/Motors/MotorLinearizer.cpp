@@ -0,0 +1,115 @@
+#include "MotorLinearizer.h"
+#include <Preferences.h>
+#include <math.h>
+#include <string.h>
+
+// NVS blob layout - bump on any change to Blob
+static const uint32_t BLOB_MAGIC = 0x4D4C494E;  // "MLIN"
+static const uint8_t BLOB_VERSION = 1;
+
+struct Blob
+{
+    uint32_t magic;
+    uint8_t version;
+    uint8_t points;
+    float curve[MotorLinearizer::CURVE_POINTS];
+};
+
+MotorLinearizer::MotorLinearizer()
+{
+    setDeadband(0.0f);
+}
+
+bool MotorLinearizer::setDeadband(float dutyFraction)
+{
+    if (!(dutyFraction >= 0.0f && dutyFraction < 1.0f)) return false;
+    for (uint8_t i = 0; i < CURVE_POINTS; i++)
+    {
+        _curve[i] = dutyFraction + (1.0f - dutyFraction) * i / (CURVE_POINTS - 1);
+    }
+    return true;
+}
+
+bool MotorLinearizer::setCurve(const float *dutyFractions)
+{
+    if (!validCurve(dutyFractions)) return false;
+    memcpy(_curve, dutyFractions, sizeof(_curve));
+    return true;
+}
+
+bool MotorLinearizer::validCurve(const float *curve)
+{
+    if (!(curve[0] >= 0.0f && curve[0] < 1.0f)) return false;
+    if (curve[CURVE_POINTS - 1] != 1.0f) return false;
+    for (uint8_t i = 1; i < CURVE_POINTS; i++)
+    {
+        if (!(curve[i] >= curve[i - 1])) return false;
+    }
+    return true;
+}
+
+// ============================================
+// MAPPING
+// ============================================
+
+float MotorLinearizer::dutyFraction(int command) const
+{
+    if (command < 0) command = -command;
+    if (command == 0) return 0.0f;
+    if (command >= FULL_SCALE) return _curve[CURVE_POINTS - 1];
+
+    float x = (float)command * (CURVE_POINTS - 1) / FULL_SCALE;
+    uint8_t i = (uint8_t)x;
+    float t = x - i;
+    return _curve[i] + (_curve[i + 1] - _curve[i]) * t;
+}
+
+void MotorLinearizer::fillTable(uint16_t *table, uint32_t maxDuty) const
+{
+    for (int c = 0; c <= FULL_SCALE; c++)
+    {
+        table[c] = (uint16_t)lroundf(dutyFraction(c) * maxDuty);
+    }
+}
+
+// ============================================
+// PERSISTENCE
+// ============================================
+
+bool MotorLinearizer::load(const char *nvsNamespace, const char *key)
+{
+    Preferences prefs;
+    if (!prefs.begin(nvsNamespace, true)) return false;
+
+    Blob blob;
+    size_t len = prefs.getBytes(key, &blob, sizeof(blob));
+    prefs.end();
+
+    if (len != sizeof(blob) || blob.magic != BLOB_MAGIC || blob.version != BLOB_VERSION ||
+        blob.points != CURVE_POINTS)
+        return false;
+    return setCurve(blob.curve);
+}
+
+bool MotorLinearizer::save(const char *nvsNamespace, const char *key) const
+{
+    Blob blob;
+    blob.magic = BLOB_MAGIC;
+    blob.version = BLOB_VERSION;
+    blob.points = CURVE_POINTS;
+    memcpy(blob.curve, _curve, sizeof(_curve));
+
+    Preferences prefs;
+    if (!prefs.begin(nvsNamespace, false)) return false;
+    size_t written = prefs.putBytes(key, &blob, sizeof(blob));
+    prefs.end();
+    return written == sizeof(blob);
+}
+
+void MotorLinearizer::erase(const char *nvsNamespace, const char *key)
+{
+    Preferences prefs;
+    if (!prefs.begin(nvsNamespace, false)) return;
+    prefs.remove(key);
+    prefs.end();
+}
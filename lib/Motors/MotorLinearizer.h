@@ -0,0 +1,69 @@
+#ifndef MOTOR_LINEARIZER_H
+#define MOTOR_LINEARIZER_H
+
+#include <stdint.h>
+
+/**
+ * Per-motor command -> PWM duty calibration (deadband + nonlinearity)
+ *
+ * Commands are linear in wheel speed: +-255 is full speed, 0 is off and
+ * any other command lands above the deadband, so a small controller output
+ * still turns the wheel. The curve holds CURVE_POINTS duty fractions
+ * measured at evenly spaced speed fractions 0, 1/(N-1) ... 1; the first
+ * point is the deadband (the duty at which the wheel just starts to turn).
+ *
+ * L298N expands this into a per-command duty table at its PWM resolution,
+ * so the write path stays a table lookup. Curves are persisted in NVS
+ * (Preferences) as one versioned blob per motor.
+ */
+class MotorLinearizer
+{
+public:
+    static const uint8_t CURVE_POINTS = 9;
+    static const int FULL_SCALE = 255;
+
+    /**
+     * Identity: duty proportional to the command, no deadband
+     */
+    MotorLinearizer();
+
+    /**
+     * Straight line from the deadband to full duty
+     * @param dutyFraction 0 .. <1
+     */
+    bool setDeadband(float dutyFraction);
+
+    /**
+     * Calibrated curve: CURVE_POINTS duty fractions, non-decreasing, 0..1,
+     * ending at 1 so full scale stays full duty
+     */
+    bool setCurve(const float *dutyFractions);
+
+    float getDeadband() const { return _curve[0]; }
+    float getCurvePoint(uint8_t i) const { return _curve[i]; }
+
+    /**
+     * Duty fraction for a command (sign ignored; 0 is exactly 0)
+     */
+    float dutyFraction(int command) const;
+
+    /**
+     * Fill table[0..FULL_SCALE] with the duty for each command magnitude
+     */
+    void fillTable(uint16_t *table, uint32_t maxDuty) const;
+
+    // ========================================
+    // PERSISTENCE
+    // ========================================
+
+    bool load(const char *nvsNamespace, const char *key);
+    bool save(const char *nvsNamespace, const char *key) const;
+    static void erase(const char *nvsNamespace, const char *key);
+
+private:
+    float _curve[CURVE_POINTS];
+
+    static bool validCurve(const float *curve);
+};
+
+#endif // MOTOR_LINEARIZER_H
@@ -1,228 +1,646 @@
 #include "Autonomy.h"
 
 // Timing constants for maneuvers
-static const unsigned long TURN_DURATION_MS = 400;    // Time to turn when avoiding obstacle
-static const unsigned long BACKUP_DURATION_MS = 300;  // Time to reverse before turn
+static const unsigned long TURN_DURATION_MS = 400;    // Time to turn when avoiding obstacle (no encoders)
+static const unsigned long BACKUP_DURATION_MS = 300;  // Time to reverse before turn (no encoders)
 static const int STUCK_THRESHOLD = 3;                 // Obstacle hits before trying backup
+static const unsigned long STUCK_RETRY_MS = 1000;     // Wait before retrying when boxed in
 
 // PID tuning for distance-based approach control
-// Setpoint is the safe distance, output is speed adjustment
+// Setpoint is the obstacle distance, output is speed adjustment
 static const float APPROACH_KP = 4.0f;   // Proportional: higher = more aggressive
 static const float APPROACH_KI = 0.0f;   // Integral: usually 0 for distance control
 static const float APPROACH_KD = 1.0f;   // Derivative: dampens oscillation
 
+// Default gain schedule axes (every cell starts at the gains above)
+static const float APPROACH_SCHEDULE_SPEEDS[GainSchedule::SPEED_POINTS] = {0.0f, 10.0f, 25.0f, 40.0f};   // cm/s
+static const float APPROACH_SCHEDULE_RANGES[GainSchedule::RANGE_POINTS] = {20.0f, 25.0f, 30.0f, 50.0f};  // cm
+
+// Map-based turn selection
+static const float TURN_SECTOR_HALF_WIDTH = 0.785f;  // 45 degrees either side of the side heading
+static const float TURN_SECTOR_RANGE_CM = 100.0f;    // How far ahead to score each side
+static const float TURN_SCORE_MARGIN = 0.05f;        // Smaller differences fall back to alternating
+
+// Planner following
+static const float PLAN_STEER_GAIN = 100.0f;         // PWM difference per radian of heading error
+static const float PLAN_ROTATE_THRESHOLD = 1.05f;    // ~60 deg: rotate in place instead of arcing
+static const float PLAN_ALIGN_TOLERANCE = 0.26f;     // ~15 deg: avoidance turn is done
+static const unsigned long MAX_ALIGN_TURN_MS = 1500; // Give up aligning after this long
+
+// Degraded range handling
+static const int RANGE_CREEP_SPEED = 70;             // Speed cap while range confidence is low
+
+// Encoder-closed maneuvers (speeds and accelerations at the wheel)
+static const float AVOID_TURN_ANGLE_RAD = 1.05f;     // ~60 deg per avoidance turn
+static const float BACKUP_DISTANCE_CM = 10.0f;       // Reverse before turning away
+static const MotionPrimitive::Limits TURN_LIMITS = {45.0f, 250.0f, PROFILE_S_CURVE, MOTOR_TURN_SPEED};
+static const MotionPrimitive::Limits BACKUP_LIMITS = {35.0f, 200.0f, PROFILE_S_CURVE, MOTOR_NORMAL_SPEED / 2};
+
+// Traction
+static const float SLIP_SPEED_SCALE = 0.7f;          // Cruise speed while a wheel is slipping
+
+// Climbing (rear wheel ratios are measured / modelled counts, see StallDetector)
+static const float CLIMB_LOAD_RATIO = 0.8f;           // Wheel this far below the model is labouring
+static const unsigned long CLIMB_LOAD_MEMORY_MS = 500; // Load seen this recently still counts
+static const float CLIMB_SLIP_RATIO = 1.2f;           // Rear wheel this far above the model is spinning out
+static const float CLIMB_GRIP_RATIO = 1.05f;          // At or below this it has grip again
+static const float CLIMB_SHARE_DROP = 0.15f;          // Rear share shed per update while spinning out
+static const float CLIMB_SHARE_RISE = 0.05f;          // Rear share restored per update with grip
+static const float CLIMB_MIN_REAR_SHARE = 0.4f;       // Rear keeps pushing at least this hard
+static const float CLIMB_PROGRESS_CM = 12.0f;         // Covered with grip, edge gone: climbed
+static const unsigned long CLIMB_TIMEOUT_MS = 4000;   // Give up and go round
+static const unsigned long CLIMB_STALL_GRACE_MS = 600; // Still wedged this far in: give up
+static const int CLIMB_MAX_ATTEMPTS = 2;              // Per edge, then it is avoided like any obstacle
+
+// ============================================
+// TRANSITION TABLE
+// ============================================
+
+constexpr FsmTransition<Autonomy, NavEvent> NavFsmTraits::TRANSITIONS[] = {
+    // from                  event                  to                      guard                          action
+    {NAV_IDLE,               NAV_EV_START,          NAV_FORWARD,            nullptr,                       nullptr},
+
+    // Cruising: an edge we are already pushing on first, then wedged wheels,
+    // then obstacles, then a plan that turned away from us
+    {NAV_FORWARD,            NAV_EV_TICK,           NAV_CLIMBING,           &Autonomy::climbableEdge,      &Autonomy::startClimb},
+    {NAV_FORWARD,            NAV_EV_TICK,           NAV_BACKING_UP,         &Autonomy::wheelsStalled,      &Autonomy::startRecovery},
+    {NAV_FORWARD,            NAV_EV_TICK,           NAV_BACKING_UP,         &Autonomy::obstacleStuck,      &Autonomy::countObstacle},
+    {NAV_FORWARD,            NAV_EV_TICK,           NAV_OBSTACLE_DETECTED,  &Autonomy::obstacleAhead,      &Autonomy::countObstacle},
+    {NAV_FORWARD,            NAV_EV_TICK,           NAV_AVOID_RIGHT,        &Autonomy::planDivergedRight,  &Autonomy::alignToPlan},
+    {NAV_FORWARD,            NAV_EV_TICK,           NAV_AVOID_LEFT,         &Autonomy::planDivergedLeft,   &Autonomy::alignToPlan},
+
+    // Direction was picked on entry
+    {NAV_OBSTACLE_DETECTED,  NAV_EV_TICK,           NAV_AVOID_RIGHT,        &Autonomy::avoidRightChosen,   nullptr},
+    {NAV_OBSTACLE_DETECTED,  NAV_EV_TICK,           NAV_AVOID_LEFT,         nullptr,                       nullptr},
+
+    // Turns end on the primitive, or on the timer without encoders
+    {NAV_AVOID_LEFT,         NAV_EV_TICK,           NAV_STUCK,              &Autonomy::wheelsStalled,      nullptr},
+    {NAV_AVOID_LEFT,         NAV_EV_TICK,           NAV_FORWARD,            &Autonomy::turnDone,           nullptr},
+    {NAV_AVOID_LEFT,         NAV_EV_PRIMITIVE_DONE, NAV_FORWARD,            nullptr,                       nullptr},
+    {NAV_AVOID_RIGHT,        NAV_EV_TICK,           NAV_STUCK,              &Autonomy::wheelsStalled,      nullptr},
+    {NAV_AVOID_RIGHT,        NAV_EV_TICK,           NAV_FORWARD,            &Autonomy::turnDone,           nullptr},
+    {NAV_AVOID_RIGHT,        NAV_EV_PRIMITIVE_DONE, NAV_FORWARD,            nullptr,                       nullptr},
+
+    {NAV_BACKING_UP,         NAV_EV_TICK,           NAV_STUCK,              &Autonomy::wheelsStalled,      nullptr},
+    {NAV_BACKING_UP,         NAV_EV_TICK,           NAV_STUCK,              &Autonomy::rearBlocked,        nullptr},
+    {NAV_BACKING_UP,         NAV_EV_TICK,           NAV_AVOID_RIGHT,        &Autonomy::backupDoneRight,    &Autonomy::finishBackup},
+    {NAV_BACKING_UP,         NAV_EV_TICK,           NAV_AVOID_LEFT,         &Autonomy::backupDone,         &Autonomy::finishBackup},
+    {NAV_BACKING_UP,         NAV_EV_PRIMITIVE_DONE, NAV_AVOID_RIGHT,        &Autonomy::turnRightNext,      &Autonomy::finishBackup},
+    {NAV_BACKING_UP,         NAV_EV_PRIMITIVE_DONE, NAV_AVOID_LEFT,         nullptr,                       &Autonomy::finishBackup},
+
+    {NAV_STUCK,              NAV_EV_TICK,           NAV_FORWARD,            &Autonomy::stuckTimedOut,      &Autonomy::clearStuck},
+
+    // Over the edge, or back off and go round it
+    {NAV_CLIMBING,           NAV_EV_TICK,           NAV_FORWARD,            &Autonomy::climbDone,          &Autonomy::finishClimb},
+    {NAV_CLIMBING,           NAV_EV_TICK,           NAV_BACKING_UP,         &Autonomy::climbFailed,        &Autonomy::startRecovery},
+
+    {NAV_IDLE,               NAV_EV_RESET,          NAV_IDLE,               nullptr,                       &Autonomy::resetManeuver},
+    {FSM_ANY_STATE,          NAV_EV_RESET,          NAV_IDLE,               nullptr,                       &Autonomy::resetManeuver},
+};
+
+constexpr uint8_t NavFsmTraits::TRANSITION_COUNT = sizeof(TRANSITIONS) / sizeof(TRANSITIONS[0]);
+
+constexpr FsmStateDef<Autonomy> NavFsmTraits::STATES[] = {
+    // name           entry                         exit                   during
+    {"forward",       nullptr,                      nullptr,               &Autonomy::cruise},
+    {"obstacle",      &Autonomy::chooseAvoidance,   nullptr,               &Autonomy::holdStill},
+    {"avoid_left",    &Autonomy::startTurnLeft,     &Autonomy::stopMotion, &Autonomy::spinLeft},
+    {"avoid_right",   &Autonomy::startTurnRight,    &Autonomy::stopMotion, &Autonomy::spinRight},
+    {"backing_up",    &Autonomy::startBackup,       &Autonomy::stopMotion, &Autonomy::backUp},
+    {"climbing",      nullptr,                      nullptr,               &Autonomy::climb},
+    {"stuck",         nullptr,                      nullptr,               &Autonomy::holdStill},
+    {"idle",          &Autonomy::holdStill,         nullptr,               &Autonomy::holdStill},
+};
+
+constexpr const char *const NavFsmTraits::EVENT_NAMES[] = {"start", "tick", "reset", "primitive_done"};
+
+static_assert(sizeof(NavFsmTraits::STATES) / sizeof(NavFsmTraits::STATES[0]) == NAV_STATE_COUNT,
+              "One state definition per NavigationState");
+static_assert(sizeof(NavFsmTraits::EVENT_NAMES) / sizeof(NavFsmTraits::EVENT_NAMES[0]) == NAV_EV_COUNT,
+              "One name per NavEventId");
+
 Autonomy::Autonomy() 
-    : _frontDistance(0), _rearDistance(0), 
-      _leftSpeed(0), _rightSpeed(0), _navState(NAV_IDLE),
-      _maneuverStartTime(0), _turnDirection(1), _stuckCounter(0),
-      _approachPID(APPROACH_KP, APPROACH_KI, APPROACH_KD), _pidEnabled(true)
+    : _fsm(NAV_IDLE), _now(0), _nowUs(0), _frontObstacle(false), _frontClose(false), _rearClear(true),
+      _frontDistance(0), _rearDistance(0), _frontConfidence(1.0f), _rearConfidence(1.0f),
+      _measuredSpeed(-1.0f), _traction{TRACTION_OK, TRACTION_OK}, _tractionRatio{1.0f, 1.0f},
+      _lastLoadedMs(0), _everLoaded(false),
+      _leftSpeed(0), _rightSpeed(0), _frontLeftSpeed(0), _frontRightSpeed(0),
+      _climbRearShare{1.0f, 1.0f}, _climbProgressCm(0), _climbLastMs(0), _climbAttempts(0),
+      _turnDirection(1), _stuckCounter(0),
+      _motion(ROBOT_TRACK_WIDTH_CM, DRIVE_FULL_SCALE_CM_S), _wheelLeftCm(0), _wheelRightCm(0), _wheelsValid(false),
+      _approachPID(APPROACH_KP, APPROACH_KI, APPROACH_KD), _pidEnabled(true),
+      _fixedGains{APPROACH_KP, APPROACH_KI, APPROACH_KD}, _approachGains{APPROACH_KP, APPROACH_KI, APPROACH_KD},
+      _map(nullptr), _planner(nullptr), _alignToPlan(false)
 {
     // Configure PID for approach control
-    // Setpoint: target distance (safe zone)
+    // Setpoint: stopping distance (obstacle threshold)
     // Input: current distance
-    // Output: speed (0 to MOTOR_NORMAL_SPEED)
-    _approachPID.setSetpoint(ULTRASONIC_THRESHOLD_SAFE);
+    // Output: speed (0 to MOTOR_NORMAL_SPEED), rising with the distance left
+    _approachPID.setSetpoint(ULTRASONIC_THRESHOLD_OBSTACLE);
     _approachPID.setOutputLimits(0, MOTOR_NORMAL_SPEED);
+    resetApproachSchedule();
 }
 
 void Autonomy::update(float frontDistance, float rearDistance)
 {
     _frontDistance = frontDistance;
     _rearDistance = rearDistance;
-    updateLogic();
+    _now = millis();
+    _nowUs = micros();
+
+    // Distance checks
+    _frontObstacle = (_frontDistance > 0 && _frontDistance < ULTRASONIC_THRESHOLD_OBSTACLE);
+    _frontClose = (_frontDistance > 0 && _frontDistance < ULTRASONIC_THRESHOLD_SAFE);
+    _rearClear = (_rearDistance <= 0 || _rearDistance > ULTRASONIC_THRESHOLD_OBSTACLE);
+
+    // A labouring wheel: remembered briefly, the collision guard may have
+    // stopped us by the time the edge is in range
+    for (uint8_t i = 0; i < StallDetector::WHEELS; i++)
+    {
+        if (_traction[i] != TRACTION_FREE_SPIN && _tractionRatio[i] < CLIMB_LOAD_RATIO)
+        {
+            _lastLoadedMs = _now;
+            _everLoaded = true;
+        }
+    }
+
+    // Pick the next state, then let it drive
+    NavEvent ev = {(uint8_t)((_fsm.getState() == NAV_IDLE) ? NAV_EV_START : NAV_EV_TICK)};
+    _fsm.dispatch(*this, ev, _now);
+    _fsm.run(*this);
+    syncFrontBank();
 }
 
-void Autonomy::setState(NavigationState newState)
+bool Autonomy::updateMotion(float leftCm, float rightCm, bool valid)
 {
-    if (_navState != newState)
+    _wheelLeftCm = leftCm;
+    _wheelRightCm = rightCm;
+    _wheelsValid = valid;
+    if (!_motion.isRunning()) return false;
+
+    int left = _leftSpeed;
+    int right = _rightSpeed;
+    _now = millis();
+    _nowUs = micros();
+
+    // The maneuver ends now, not at the next update()
+    if (_motion.update(leftCm, rightCm, valid, _now))
     {
-        _navState = newState;
-        _maneuverStartTime = millis();
+        NavEvent ev = {NAV_EV_PRIMITIVE_DONE};
+        _fsm.dispatch(*this, ev, _now);
     }
+    _fsm.run(*this);
+    syncFrontBank();
+
+    return _leftSpeed != left || _rightSpeed != right;
 }
 
-void Autonomy::updateLogic()
+void Autonomy::syncFrontBank()
 {
-    unsigned long now = millis();
-    unsigned long elapsed = now - _maneuverStartTime;
-    
-    // Distance checks
-    bool frontObstacle = (_frontDistance > 0 && _frontDistance < ULTRASONIC_THRESHOLD_OBSTACLE);
-    bool frontClose = (_frontDistance > 0 && _frontDistance < ULTRASONIC_THRESHOLD_SAFE);
-    bool rearClear = (_rearDistance <= 0 || _rearDistance > ULTRASONIC_THRESHOLD_OBSTACLE);
-    
-    switch (_navState)
+    // Both banks drive alike unless the climb split them
+    if (_fsm.getState() != NAV_CLIMBING)
     {
-        // ========================================
-        // IDLE - Waiting to start
-        // ========================================
-        case NAV_IDLE:
-            _leftSpeed = 0;
-            _rightSpeed = 0;
-            // External trigger starts movement (set by main when autonomous enabled)
-            setState(NAV_FORWARD);
-            break;
-            
-        // ========================================
-        // FORWARD - Normal cruising
-        // ========================================
-        case NAV_FORWARD:
-            if (frontObstacle)
-            {
-                // Obstacle detected - decide action
-                _stuckCounter++;
-                
-                if (_stuckCounter >= STUCK_THRESHOLD)
-                {
-                    // Been stuck too many times, try backing up
-                    setState(NAV_BACKING_UP);
-                }
-                else
-                {
-                    // Normal obstacle - turn to avoid
-                    setState(NAV_OBSTACLE_DETECTED);
-                }
-            }
-            else
-            {
-                // Path clear - drive forward
-                if (frontClose)
-                {
-                    if (_pidEnabled)
-                    {
-                        // PID approach: smooth speed based on distance to safe zone
-                        // Input = current distance, Setpoint = safe distance
-                        // Output = speed (clamped 0 to MOTOR_NORMAL_SPEED)
-                        float pidSpeed = _approachPID.compute(_frontDistance);
-                        int approachSpeed = (int)constrain(pidSpeed, 40, MOTOR_NORMAL_SPEED);
-                        _leftSpeed = approachSpeed;
-                        _rightSpeed = approachSpeed;
-                    }
-                    else
-                    {
-                        // Fallback: simple proportional control (for comparison)
-                        float speedFactor = _frontDistance / (float)ULTRASONIC_THRESHOLD_SAFE;
-                        speedFactor = constrain(speedFactor, 0.4f, 1.0f);
-                        int approachSpeed = (int)(MOTOR_NORMAL_SPEED * speedFactor);
-                        _leftSpeed = approachSpeed;
-                        _rightSpeed = approachSpeed;
-                    }
-                }
-                else
-                {
-                    // Full speed ahead - reset PID for next approach
-                    _approachPID.reset();
-                    _leftSpeed = MOTOR_NORMAL_SPEED;
-                    _rightSpeed = MOTOR_NORMAL_SPEED;
-                    _stuckCounter = 0;  // Reset stuck counter on clear path
-                }
-            }
-            break;
-            
-        // ========================================
-        // OBSTACLE_DETECTED - Brief pause before turn
-        // ========================================
-        case NAV_OBSTACLE_DETECTED:
-            _leftSpeed = 0;
-            _rightSpeed = 0;
-            
-            // Alternate turn direction each time
-            _turnDirection = -_turnDirection;
-            
-            // Immediately start turning
-            if (_turnDirection > 0)
-            {
-                setState(NAV_AVOID_RIGHT);
-            }
-            else
-            {
-                setState(NAV_AVOID_LEFT);
-            }
-            break;
-            
-        // ========================================
-        // AVOID_LEFT - Turning left to avoid obstacle
-        // ========================================
-        case NAV_AVOID_LEFT:
-            // Spin left: left motor backward, right motor forward
-            _leftSpeed = -MOTOR_TURN_SPEED;
-            _rightSpeed = MOTOR_TURN_SPEED;
-            
-            if (elapsed >= TURN_DURATION_MS)
-            {
-                // Turn complete, try forward again
-                setState(NAV_FORWARD);
-            }
-            break;
-            
-        // ========================================
-        // AVOID_RIGHT - Turning right to avoid obstacle
-        // ========================================
-        case NAV_AVOID_RIGHT:
-            // Spin right: left motor forward, right motor backward
-            _leftSpeed = MOTOR_TURN_SPEED;
-            _rightSpeed = -MOTOR_TURN_SPEED;
-            
-            if (elapsed >= TURN_DURATION_MS)
-            {
-                setState(NAV_FORWARD);
-            }
-            break;
-            
-        // ========================================
-        // BACKING_UP - Reverse when stuck
-        // ========================================
-        case NAV_BACKING_UP:
-            if (rearClear)
-            {
-                _leftSpeed = -MOTOR_NORMAL_SPEED / 2;
-                _rightSpeed = -MOTOR_NORMAL_SPEED / 2;
-                
-                if (elapsed >= BACKUP_DURATION_MS)
-                {
-                    _stuckCounter = 0;  // Reset stuck counter
-                    // After backing up, turn to avoid
-                    _turnDirection = -_turnDirection;
-                    setState(_turnDirection > 0 ? NAV_AVOID_RIGHT : NAV_AVOID_LEFT);
-                }
-            }
-            else
-            {
-                // Can't back up either - truly stuck
-                setState(NAV_STUCK);
-            }
-            break;
-            
-        // ========================================
-        // STUCK - Cannot move forward or backward
-        // ========================================
-        case NAV_STUCK:
-            _leftSpeed = 0;
-            _rightSpeed = 0;
-            
-            // Try to recover after a moment
-            if (elapsed >= 1000)
-            {
-                _stuckCounter = 0;
-                setState(NAV_FORWARD);  // Retry
-            }
-            break;
-            
-        // ========================================
-        // CLIMBING - Reserved for future use
-        // ========================================
-        case NAV_CLIMBING:
-            // Not implemented yet - future: detect incline and boost torque
-            _leftSpeed = MOTOR_CLIMB_SPEED;
-            _rightSpeed = MOTOR_CLIMB_SPEED;
-            break;
-            
-        default:
-            setState(NAV_IDLE);
-            break;
+        _frontLeftSpeed = _leftSpeed;
+        _frontRightSpeed = _rightSpeed;
     }
 }
 
+// ============================================
+// GUARDS
+// ============================================
+
+bool Autonomy::wheelsStalled(const Autonomy &a, const NavEvent &)
+{
+    return a.tractionLost();
+}
+
+bool Autonomy::obstacleStuck(const Autonomy &a, const NavEvent &)
+{
+    // Been stuck too many times, try backing up
+    return a._frontObstacle && a._stuckCounter + 1 >= STUCK_THRESHOLD;
+}
+
+bool Autonomy::obstacleAhead(const Autonomy &a, const NavEvent &)
+{
+    return a._frontObstacle;
+}
+
+bool Autonomy::planDivergedRight(const Autonomy &a, const NavEvent &)
+{
+    return a.planDiverged() && a._planner->getOutput().relHeading < 0;
+}
+
+bool Autonomy::planDivergedLeft(const Autonomy &a, const NavEvent &)
+{
+    return a.planDiverged();
+}
+
+bool Autonomy::avoidRightChosen(const Autonomy &a, const NavEvent &)
+{
+    return a._turnDirection > 0;
+}
+
+bool Autonomy::turnDone(const Autonomy &a, const NavEvent &)
+{
+    // A running primitive reports its own end
+    return !a._motion.isRunning() && a.turnComplete();
+}
+
+bool Autonomy::turnRightNext(const Autonomy &a, const NavEvent &)
+{
+    return a.chooseTurnDirection() > 0;
+}
+
+bool Autonomy::rearBlocked(const Autonomy &a, const NavEvent &)
+{
+    // Can't back up either - truly stuck
+    return !a._rearClear;
+}
+
+bool Autonomy::backupDoneRight(const Autonomy &a, const NavEvent &ev)
+{
+    return backupDone(a, ev) && turnRightNext(a, ev);
+}
+
+bool Autonomy::backupDone(const Autonomy &a, const NavEvent &)
+{
+    return !a._motion.isRunning() && a.elapsed() >= BACKUP_DURATION_MS;
+}
+
+bool Autonomy::stuckTimedOut(const Autonomy &a, const NavEvent &)
+{
+    // Try to recover after a moment
+    return a.elapsed() >= STUCK_RETRY_MS;
+}
+
+bool Autonomy::climbableEdge(const Autonomy &a, const NavEvent &)
+{
+    // The wheels already feel what the range only now reports. Judged in
+    // the obstacle band: cruising never gets any closer than that, it
+    // turns away first (this row is checked before obstacleAhead)
+    return a._frontDistance > 0 && a._frontDistance < ULTRASONIC_THRESHOLD_OBSTACLE &&
+           a.wheelsLoaded() && a._climbAttempts < CLIMB_MAX_ATTEMPTS;
+}
+
+bool Autonomy::climbDone(const Autonomy &a, const NavEvent &)
+{
+    bool edgeAhead = a._frontDistance > 0 && a._frontDistance <= ULTRASONIC_THRESHOLD_CLIFF;
+    return a._climbProgressCm >= CLIMB_PROGRESS_CM && !edgeAhead;
+}
+
+bool Autonomy::climbFailed(const Autonomy &a, const NavEvent &)
+{
+    if (a.elapsed() >= CLIMB_TIMEOUT_MS) return true;
+    return a.tractionLost() && a.elapsed() >= CLIMB_STALL_GRACE_MS;
+}
+
+// ============================================
+// TRANSITION ACTIONS
+// ============================================
+
+void Autonomy::countObstacle(Autonomy &a, const NavEvent &)
+{
+    a._stuckCounter++;
+}
+
+void Autonomy::startRecovery(Autonomy &a, const NavEvent &)
+{
+    // Wedged: no point counting obstacle hits first
+    a._stuckCounter = 0;
+}
+
+void Autonomy::alignToPlan(Autonomy &a, const NavEvent &)
+{
+    // Large heading error: rotate in place until aligned
+    a._alignToPlan = true;
+    a._turnDirection = (a._planner->getOutput().relHeading > 0) ? -1 : 1;
+}
+
+void Autonomy::finishBackup(Autonomy &a, const NavEvent &)
+{
+    // After backing up, turn to avoid
+    a._stuckCounter = 0;
+    a._turnDirection = a.chooseTurnDirection();
+    a._alignToPlan = false;
+}
+
+void Autonomy::clearStuck(Autonomy &a, const NavEvent &)
+{
+    a._stuckCounter = 0;
+}
+
+void Autonomy::resetManeuver(Autonomy &a, const NavEvent &)
+{
+    a._leftSpeed = 0;
+    a._rightSpeed = 0;
+    a._stuckCounter = 0;
+    a._turnDirection = 1;
+    a._alignToPlan = false;
+    a._approachPID.reset();
+    a._frontLeftSpeed = 0;
+    a._frontRightSpeed = 0;
+    a._climbAttempts = 0;
+    a._motion.cancel();
+}
+
+void Autonomy::startClimb(Autonomy &a, const NavEvent &)
+{
+    a._climbAttempts++;
+    a._climbProgressCm = 0;
+    a._climbLastMs = a._now;
+    for (uint8_t i = 0; i < StallDetector::WHEELS; i++) a._climbRearShare[i] = 1.0f;
+}
+
+void Autonomy::finishClimb(Autonomy &a, const NavEvent &)
+{
+    a._climbAttempts = 0;
+    a._stuckCounter = 0;
+}
+
+// ============================================
+// STATE ACTIONS
+// ============================================
+
+void Autonomy::startTurnLeft(Autonomy &a)
+{
+    a.startTurn(1);
+}
+
+void Autonomy::startTurnRight(Autonomy &a)
+{
+    a.startTurn(-1);
+}
+
+void Autonomy::startBackup(Autonomy &a)
+{
+    if (!a._wheelsValid) return;   // Timed backup
+
+    // Reverse blind (stale rear range) only at creep speed
+    MotionPrimitive::Limits limits = BACKUP_LIMITS;
+    if (a._rearConfidence < US_MIN_CONFIDENCE && limits.maxPwm > RANGE_CREEP_SPEED)
+    {
+        limits.maxPwm = RANGE_CREEP_SPEED;
+        limits.vMax = RANGE_CREEP_SPEED * DRIVE_FULL_SCALE_CM_S / 255.0f;
+    }
+    a._motion.startDrive(-BACKUP_DISTANCE_CM, limits, a._wheelLeftCm, a._wheelRightCm, a._now);
+}
+
+void Autonomy::stopMotion(Autonomy &a)
+{
+    a._motion.cancel();
+}
+
+void Autonomy::holdStill(Autonomy &a)
+{
+    a._leftSpeed = 0;
+    a._rightSpeed = 0;
+}
+
+void Autonomy::chooseAvoidance(Autonomy &a)
+{
+    a._leftSpeed = 0;
+    a._rightSpeed = 0;
+
+    // Turn towards the planned heading; without a plan (or when the
+    // plan still points straight at the obstacle) use the freer side
+    a._alignToPlan = a.plannerActive() &&
+                     fabsf(a._planner->getOutput().relHeading) >= PLAN_ALIGN_TOLERANCE;
+    if (a._alignToPlan)
+    {
+        a._turnDirection = (a._planner->getOutput().relHeading > 0) ? -1 : 1;
+    }
+    else
+    {
+        a._turnDirection = a.chooseTurnDirection();
+    }
+}
+
+void Autonomy::cruise(Autonomy &a)
+{
+    // The approach loop tracks the range the whole time we cruise (no reset
+    // when the path clears), so closing in starts from a settled controller
+    if (a._pidEnabled && a._frontDistance > 0)
+    {
+        a.scheduleApproachGains();
+        a._approachPID.compute(a._frontDistance, a._nowUs);
+    }
+
+    if (a._frontClose)
+    {
+        if (a._pidEnabled)
+        {
+            // PID approach: speed from the distance left to the stopping point.
+            // Commands are linear (the driver compensates the deadband), so
+            // a small output still creeps forward - no minimum speed here
+            int approachSpeed = (int)lroundf(a._approachPID.getOutput());
+            a._leftSpeed = approachSpeed;
+            a._rightSpeed = approachSpeed;
+        }
+        else
+        {
+            // Fallback: simple proportional control (for comparison)
+            float speedFactor = a._frontDistance / (float)ULTRASONIC_THRESHOLD_SAFE;
+            speedFactor = constrain(speedFactor, 0.4f, 1.0f);
+            int approachSpeed = (int)(MOTOR_NORMAL_SPEED * speedFactor);
+            a._leftSpeed = approachSpeed;
+            a._rightSpeed = approachSpeed;
+        }
+    }
+    else
+    {
+        // Full speed ahead
+        a._leftSpeed = MOTOR_NORMAL_SPEED;
+        a._rightSpeed = MOTOR_NORMAL_SPEED;
+        a._stuckCounter = 0;  // Reset stuck counter on clear path
+        a._climbAttempts = 0;
+    }
+
+    // Steer the cruise speed along the planned path
+    if (a.plannerActive())
+    {
+        a.followPlan();
+    }
+
+    // Ease off while a wheel is slipping
+    if (a._traction[0] == TRACTION_SLIP || a._traction[1] == TRACTION_SLIP)
+    {
+        a._leftSpeed = (int)(a._leftSpeed * SLIP_SPEED_SCALE);
+        a._rightSpeed = (int)(a._rightSpeed * SLIP_SPEED_SCALE);
+    }
+
+    // Don't drive into what we can't see
+    if (a._frontConfidence <= 0.0f)
+    {
+        a._leftSpeed = 0;
+        a._rightSpeed = 0;
+    }
+    else if (a._frontConfidence < US_MIN_CONFIDENCE)
+    {
+        a._leftSpeed = constrain(a._leftSpeed, -RANGE_CREEP_SPEED, RANGE_CREEP_SPEED);
+        a._rightSpeed = constrain(a._rightSpeed, -RANGE_CREEP_SPEED, RANGE_CREEP_SPEED);
+    }
+}
+
+void Autonomy::spinLeft(Autonomy &a)
+{
+    if (a._motion.isRunning())
+    {
+        a._leftSpeed = a._motion.getLeftCommand();
+        a._rightSpeed = a._motion.getRightCommand();
+        return;
+    }
+
+    // Spin left: left motor backward, right motor forward
+    a._leftSpeed = -MOTOR_TURN_SPEED;
+    a._rightSpeed = MOTOR_TURN_SPEED;
+}
+
+void Autonomy::spinRight(Autonomy &a)
+{
+    if (a._motion.isRunning())
+    {
+        a._leftSpeed = a._motion.getLeftCommand();
+        a._rightSpeed = a._motion.getRightCommand();
+        return;
+    }
+
+    // Spin right: left motor forward, right motor backward
+    a._leftSpeed = MOTOR_TURN_SPEED;
+    a._rightSpeed = -MOTOR_TURN_SPEED;
+}
+
+void Autonomy::backUp(Autonomy &a)
+{
+    if (a._motion.isRunning())
+    {
+        a._leftSpeed = a._motion.getLeftCommand();
+        a._rightSpeed = a._motion.getRightCommand();
+        return;
+    }
+
+    // Reverse blind (stale rear range) only at creep speed
+    int backSpeed = MOTOR_NORMAL_SPEED / 2;
+    if (a._rearConfidence < US_MIN_CONFIDENCE && backSpeed > RANGE_CREEP_SPEED)
+    {
+        backSpeed = RANGE_CREEP_SPEED;
+    }
+    a._leftSpeed = -backSpeed;
+    a._rightSpeed = -backSpeed;
+}
+
+void Autonomy::climb(Autonomy &a)
+{
+    // Only the rear wheels have encoders. A rear wheel spinning out sheds
+    // its share of the torque to the front bank, which keeps full drive to
+    // pull over the edge; with grip back the rear share is restored.
+    bool gripping = true;
+    for (uint8_t i = 0; i < StallDetector::WHEELS; i++)
+    {
+        bool spinning = a._traction[i] == TRACTION_SLIP || a._traction[i] == TRACTION_FREE_SPIN ||
+                        a._tractionRatio[i] > CLIMB_SLIP_RATIO;
+        float &share = a._climbRearShare[i];
+        if (spinning)
+        {
+            share = constrain(share - CLIMB_SHARE_DROP, CLIMB_MIN_REAR_SHARE, 1.0f);
+            gripping = false;
+        }
+        else if (a._tractionRatio[i] <= CLIMB_GRIP_RATIO)
+        {
+            share = constrain(share + CLIMB_SHARE_RISE, CLIMB_MIN_REAR_SHARE, 1.0f);
+        }
+    }
+
+    a._leftSpeed = (int)(MOTOR_CLIMB_SPEED * a._climbRearShare[0]);
+    a._rightSpeed = (int)(MOTOR_CLIMB_SPEED * a._climbRearShare[1]);
+    a._frontLeftSpeed = MOTOR_CLIMB_SPEED;
+    a._frontRightSpeed = MOTOR_CLIMB_SPEED;
+
+    // Progress only counts while the wheel speed is ground speed
+    unsigned long dt = a._now - a._climbLastMs;
+    a._climbLastMs = a._now;
+    if (gripping && a._measuredSpeed > 0)
+    {
+        a._climbProgressCm += a._measuredSpeed * dt / 1000.0f;
+    }
+}
+
+void Autonomy::startTurn(int ccw)
+{
+    if (!_wheelsValid) return;   // Timed turn
+
+    // Aligning with the plan: the whole heading error in one move
+    float angle = AVOID_TURN_ANGLE_RAD;
+    if (_alignToPlan && plannerActive())
+    {
+        angle = fabsf(_planner->getOutput().relHeading);
+    }
+    _motion.startRotate(ccw * angle, TURN_LIMITS, _wheelLeftCm, _wheelRightCm, _now);
+}
+
+int Autonomy::chooseTurnDirection() const
+{
+    if (_map)
+    {
+        // Heading is CCW-positive: +90 deg = left, -90 deg = right
+        float leftScore = _map->freeSpaceInSector(PI / 2, TURN_SECTOR_HALF_WIDTH, TURN_SECTOR_RANGE_CM);
+        float rightScore = _map->freeSpaceInSector(-PI / 2, TURN_SECTOR_HALF_WIDTH, TURN_SECTOR_RANGE_CM);
+
+        if (leftScore > rightScore + TURN_SCORE_MARGIN) return -1;
+        if (rightScore > leftScore + TURN_SCORE_MARGIN) return 1;
+    }
+
+    // No map or no clear preference: alternate as before
+    return -_turnDirection;
+}
+
+void Autonomy::setRangeQuality(float frontConfidence, float rearConfidence)
+{
+    _frontConfidence = frontConfidence;
+    _rearConfidence = rearConfidence;
+}
+
+void Autonomy::setLocalMap(const OccupancyGrid *map)
+{
+    _map = map;
+}
+
+void Autonomy::setPlanner(const LocalPlanner *planner)
+{
+    _planner = planner;
+}
+
+bool Autonomy::plannerActive() const
+{
+    return _planner && _planner->getOutput().valid;
+}
+
+bool Autonomy::planDiverged() const
+{
+    // Large heading error: rotate in place instead of arcing
+    return plannerActive() && fabsf(_planner->getOutput().relHeading) > PLAN_ROTATE_THRESHOLD;
+}
+
+void Autonomy::followPlan()
+{
+    const LocalPlanner::Output &plan = _planner->getOutput();
+
+    // Arc along the plan: + heading error (left) speeds up the right side
+    int base = (int)(_leftSpeed * plan.speedScale);
+    int steer = (int)(PLAN_STEER_GAIN * plan.relHeading);
+    _leftSpeed = constrain(base - steer, -MOTOR_NORMAL_SPEED, MOTOR_NORMAL_SPEED);
+    _rightSpeed = constrain(base + steer, -MOTOR_NORMAL_SPEED, MOTOR_NORMAL_SPEED);
+}
+
+bool Autonomy::turnComplete() const
+{
+    if (_alignToPlan && plannerActive())
+    {
+        return fabsf(_planner->getOutput().relHeading) < PLAN_ALIGN_TOLERANCE ||
+               elapsed() >= MAX_ALIGN_TURN_MS;
+    }
+    return elapsed() >= TURN_DURATION_MS;
+}
+
 int Autonomy::getLeftSpeed() const
 {
     return _leftSpeed;
@@ -235,38 +653,86 @@ int Autonomy::getRightSpeed() const
 
 NavigationState Autonomy::getNavState() const
 {
-    return _navState;
+    return (NavigationState)_fsm.getState();
 }
 
 const char* Autonomy::getNavStateName() const
 {
-    switch (_navState)
+    return _fsm.getStateName();
+}
+
+const char *Autonomy::stateName(uint8_t state)
+{
+    return Machine::stateName(state);
+}
+
+const char *Autonomy::eventName(uint8_t event)
+{
+    return Machine::eventName(event);
+}
+
+void Autonomy::reset()
+{
+    NavEvent ev = {NAV_EV_RESET};
+    _fsm.dispatch(*this, ev, millis());
+}
+
+void Autonomy::setMeasuredSpeed(float speedCmS)
+{
+    _measuredSpeed = speedCmS;
+}
+
+void Autonomy::setTraction(const StallDetector &detector)
+{
+    for (uint8_t i = 0; i < StallDetector::WHEELS; i++)
     {
-        case NAV_FORWARD:           return "forward";
-        case NAV_OBSTACLE_DETECTED: return "obstacle";
-        case NAV_AVOID_LEFT:        return "avoid_left";
-        case NAV_AVOID_RIGHT:       return "avoid_right";
-        case NAV_BACKING_UP:        return "backing_up";
-        case NAV_CLIMBING:          return "climbing";
-        case NAV_STUCK:             return "stuck";
-        case NAV_IDLE:              return "idle";
-        default:                    return "unknown";
+        _traction[i] = detector.getState(i);
+        _tractionRatio[i] = detector.getRatio(i);
     }
 }
 
-void Autonomy::reset()
+bool Autonomy::tractionLost() const
+{
+    // One wheel blocked, or nothing touching the ground (high-centred)
+    bool stalled = _traction[0] == TRACTION_STALL || _traction[1] == TRACTION_STALL;
+    bool airborne = _traction[0] == TRACTION_FREE_SPIN && _traction[1] == TRACTION_FREE_SPIN;
+    return stalled || airborne;
+}
+
+bool Autonomy::wheelsLoaded() const
 {
-    _leftSpeed = 0;
-    _rightSpeed = 0;
-    _navState = NAV_IDLE;
-    _stuckCounter = 0;
-    _turnDirection = 1;
-    _approachPID.reset();
+    return _everLoaded && _now - _lastLoadedMs <= CLIMB_LOAD_MEMORY_MS;
 }
 
 void Autonomy::setApproachPID(float kP, float kI, float kD)
 {
-    _approachPID.setTunings(kP, kI, kD);
+    _fixedGains = {kP, kI, kD};
+    _approachSchedule.setEnabled(false);
+    scheduleApproachGains();
+}
+
+void Autonomy::setApproachSchedule(const GainSchedule &schedule)
+{
+    _approachSchedule = schedule;
+    scheduleApproachGains();
+}
+
+void Autonomy::resetApproachSchedule()
+{
+    const GainSchedule::Gains defaults = {APPROACH_KP, APPROACH_KI, APPROACH_KD};
+    _approachSchedule.setUniform(defaults, APPROACH_SCHEDULE_SPEEDS, APPROACH_SCHEDULE_RANGES);
+    scheduleApproachGains();
+}
+
+void Autonomy::scheduleApproachGains()
+{
+    GainSchedule::Gains g = _approachSchedule.isEnabled()
+                                ? _approachSchedule.lookup(_measuredSpeed, _frontDistance)
+                                : _fixedGains;
+    if (g.kP == _approachGains.kP && g.kI == _approachGains.kI && g.kD == _approachGains.kD) return;
+
+    _approachGains = g;
+    _approachPID.setTuningsBumpless(g.kP, g.kI, g.kD);
 }
 
 void Autonomy::setPIDEnabled(bool enabled)
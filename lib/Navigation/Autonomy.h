@@ -3,29 +3,146 @@
 
 #include <Arduino.h>
 #include "config.h"
-#include "PIDController.h"
+#include "PidBank.h"
+#include "GainSchedule.h"
+#include "OccupancyGrid.h"
+#include "LocalPlanner.h"
+#include "TableFsm.h"
+#include "StallDetector.h"
+#include "MotionPrimitive.h"
 
+enum NavEventId : uint8_t
+{
+    NAV_EV_START,   // First tick after (re)start
+    NAV_EV_TICK,    // Periodic evaluation - transitions are guarded
+    NAV_EV_RESET,
+    NAV_EV_PRIMITIVE_DONE,  // Turn / backup primitive finished (or gave up)
+    NAV_EV_COUNT
+};
+
+struct NavEvent
+{
+    uint8_t id;
+};
+
+class Autonomy;
+
+// Approach loop: more range -> more speed, so the controller is reverse acting
+typedef PidOptions<true, PID_WINDUP_CLAMP, 0, 1, true> ApproachPidOptions;
+
+struct NavFsmTraits
+{
+    using Context = Autonomy;
+    using Event = NavEvent;
+    static constexpr uint8_t STATE_COUNT = NAV_STATE_COUNT;
+    static constexpr uint8_t EVENT_COUNT = NAV_EV_COUNT;
+    static const FsmTransition<Autonomy, NavEvent> TRANSITIONS[];
+    static const uint8_t TRANSITION_COUNT;
+    static const FsmStateDef<Autonomy> STATES[];
+    static const char *const EVENT_NAMES[];
+};
+
+/**
+ * Autonomous navigation behaviour
+ *
+ * Table-driven (Autonomy.cpp): every update() dispatches one event, the
+ * guarded transitions pick the next state from the current inputs, then
+ * the state's `during` action computes the wheel speeds.
+ */
 class Autonomy
 {
 public:
+    typedef TableFsm<NavFsmTraits> Machine;
+
     Autonomy();
 
     // Inputs
     void update(float frontDistance, float rearDistance);
 
+    /**
+     * Step the running motion primitive (call at the encoder rate)
+     * With fresh encoders, avoidance turns and backups are encoder-closed
+     * primitives (rotate N degrees, reverse N cm) and their end is
+     * dispatched from here as NAV_EV_PRIMITIVE_DONE. Without encoders the
+     * timed maneuvers are used.
+     * @param leftCm/rightCm Cumulative rear wheel distances
+     * @return true when the wheel speeds changed
+     */
+    bool updateMotion(float leftCm, float rightCm, bool valid);
+    const MotionPrimitive &getMotion() const { return _motion; }
+
     // Outputs
     int getLeftSpeed() const;
     int getRightSpeed() const;
+
+    /**
+     * Front bank commands - the rear ones above except while climbing,
+     * where torque is split between the banks
+     */
+    int getFrontLeftSpeed() const { return _frontLeftSpeed; }
+    int getFrontRightSpeed() const { return _frontRightSpeed; }
     NavigationState getNavState() const;
     
     // Status
     const char* getNavStateName() const;
+    const Machine &getMachine() const { return _fsm; }
+    static const char *stateName(uint8_t state);
+    static const char *eventName(uint8_t event);
     
     // Command
     void reset();
+
+    /**
+     * Attach the local occupancy grid (optional)
+     * When set, avoidance turns go towards the side with more free space
+     * instead of blindly alternating.
+     */
+    void setLocalMap(const OccupancyGrid *map);
+
+    /**
+     * Attach the local path planner (optional)
+     * When it has a valid plan, forward driving steers along the planned
+     * heading and avoidance turns rotate until aligned with it instead of
+     * spinning for a fixed time.
+     */
+    void setPlanner(const LocalPlanner *planner);
+
+    /**
+     * Range quality from the sensor filters (0.0 = stale .. 1.0)
+     * Forward cruising holds position while the front range is stale and
+     * creeps while it is low-confidence; backing up creeps when the rear
+     * range is stale.
+     */
+    void setRangeQuality(float frontConfidence, float rearConfidence);
+
+    /**
+     * Measured ground speed from the encoders (< 0 = unknown)
+     * Selects the approach gains from the schedule.
+     */
+    void setMeasuredSpeed(float speedCmS);
+
+    /**
+     * Per-wheel traction from the StallDetector (rear left, rear right)
+     * A stall (or both wheels free-spinning) starts recovery at once
+     * instead of waiting for repeated obstacle hits; slip eases off the
+     * cruise speed. Wheels still loaded when the range enters the obstacle
+     * band start a climb instead of an avoidance turn, and while climbing the slip ratios split the torque between banks.
+     */
+    void setTraction(const StallDetector &detector);
     
     // PID tuning (for runtime adjustment)
+    // Fixed gains; turns the schedule off until setApproachSchedule()
     void setApproachPID(float kP, float kI, float kD);
+
+    /**
+     * Approach gains over (measured speed, front range)
+     * Gains move bumplessly as the robot speeds up or closes in.
+     */
+    const GainSchedule &getApproachSchedule() const { return _approachSchedule; }
+    void setApproachSchedule(const GainSchedule &schedule);
+    void resetApproachSchedule();
+    const GainSchedule::Gains &getApproachGains() const { return _approachGains; }
+
     void setPIDEnabled(bool enabled);
     bool isPIDEnabled() const;
     
@@ -38,24 +155,114 @@ public:
     float getPIDDerivative() const;
 
 private:
+    friend struct NavFsmTraits;
+
+    Machine _fsm;
+    unsigned long _now;     // Time of the current update()
+    uint32_t _nowUs;        // Same, for the control loops
+
+    // Inputs classified once per update()
+    bool _frontObstacle;
+    bool _frontClose;
+    bool _rearClear;
+
     float _frontDistance;
     float _rearDistance;
+    float _frontConfidence;
+    float _rearConfidence;
+    float _measuredSpeed;
+    TractionState _traction[StallDetector::WHEELS];
+    float _tractionRatio[StallDetector::WHEELS];
+    unsigned long _lastLoadedMs;    // Last update() a wheel was labouring
+    bool _everLoaded;
     
     int _leftSpeed;
     int _rightSpeed;
-    NavigationState _navState;
-    
-    // Timing for maneuvers
-    unsigned long _maneuverStartTime;
+    int _frontLeftSpeed;
+    int _frontRightSpeed;
+
+    // Climbing
+    float _climbRearShare[StallDetector::WHEELS];   // Rear command / climb speed, per side
+    float _climbProgressCm;         // Ground covered with grip since the climb started
+    unsigned long _climbLastMs;
+    int _climbAttempts;             // Climbs since the path was last clear
+
+    // Maneuvers
     int _turnDirection;  // -1 = left, +1 = right
     int _stuckCounter;   // Counts consecutive obstacle detections
+
+    // Encoder-closed turns and backups
+    MotionPrimitive _motion;
+    float _wheelLeftCm;
+    float _wheelRightCm;
+    bool _wheelsValid;
     
     // PID for smooth distance-based speed control
-    PIDController _approachPID;
+    Pid<float, ApproachPidOptions> _approachPID;
     bool _pidEnabled;
+    GainSchedule _approachSchedule;
+    GainSchedule::Gains _fixedGains;      // Used while the schedule is off
+    GainSchedule::Gains _approachGains;   // In use
+
+    // Local map for turn decisions (may be null)
+    const OccupancyGrid *_map;
+
+    // Local planner for heading targets (may be null)
+    const LocalPlanner *_planner;
+    bool _alignToPlan;   // Current avoidance turn ends when aligned with the plan
+
+    int chooseTurnDirection() const;
+    bool plannerActive() const;
+    bool planDiverged() const;
+    void followPlan();
+    bool turnComplete() const;
+    void scheduleApproachGains();
+    unsigned long elapsed() const { return _fsm.getTimeInState(_now); }
+
+    bool tractionLost() const;
+    bool wheelsLoaded() const;
+    void startTurn(int ccw);
+    void syncFrontBank();
+
+    // Guards
+    static bool wheelsStalled(const Autonomy &a, const NavEvent &ev);
+    static bool obstacleStuck(const Autonomy &a, const NavEvent &ev);
+    static bool obstacleAhead(const Autonomy &a, const NavEvent &ev);
+    static bool planDivergedRight(const Autonomy &a, const NavEvent &ev);
+    static bool planDivergedLeft(const Autonomy &a, const NavEvent &ev);
+    static bool avoidRightChosen(const Autonomy &a, const NavEvent &ev);
+    static bool turnDone(const Autonomy &a, const NavEvent &ev);
+    static bool turnRightNext(const Autonomy &a, const NavEvent &ev);
+    static bool rearBlocked(const Autonomy &a, const NavEvent &ev);
+    static bool backupDoneRight(const Autonomy &a, const NavEvent &ev);
+    static bool backupDone(const Autonomy &a, const NavEvent &ev);
+    static bool stuckTimedOut(const Autonomy &a, const NavEvent &ev);
+    static bool climbableEdge(const Autonomy &a, const NavEvent &ev);
+    static bool climbDone(const Autonomy &a, const NavEvent &ev);
+    static bool climbFailed(const Autonomy &a, const NavEvent &ev);
+
+    // Transition actions
+    static void countObstacle(Autonomy &a, const NavEvent &ev);
+    static void startRecovery(Autonomy &a, const NavEvent &ev);
+    static void alignToPlan(Autonomy &a, const NavEvent &ev);
+    static void finishBackup(Autonomy &a, const NavEvent &ev);
+    static void clearStuck(Autonomy &a, const NavEvent &ev);
+    static void resetManeuver(Autonomy &a, const NavEvent &ev);
+    static void startClimb(Autonomy &a, const NavEvent &ev);
+    static void finishClimb(Autonomy &a, const NavEvent &ev);
 
-    void updateLogic();
-    void setState(NavigationState newState);
+    // State actions
+    static void startTurnLeft(Autonomy &a);
+    static void startTurnRight(Autonomy &a);
+    static void startBackup(Autonomy &a);
+    static void stopMotion(Autonomy &a);
+    static void holdStill(Autonomy &a);
+    static void chooseAvoidance(Autonomy &a);
+    static void cruise(Autonomy &a);
+    static void spinLeft(Autonomy &a);
+    static void spinRight(Autonomy &a);
+    static void backUp(Autonomy &a);
+    static void climb(Autonomy &a);
 };
 
 #endif
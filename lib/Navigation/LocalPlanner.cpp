@@ -0,0 +1,497 @@
+#include "LocalPlanner.h"
+#include <math.h>
+#include <string.h>
+
+// Goal placement
+static const float GOAL_DISTANCE_CM = 120.0f;  // Carrot distance ahead along mission heading
+static const float GOAL_REACHED_CM = 20.0f;    // Push the goal out once this close
+
+// Edge costs (scaled: 10 = one node straight)
+static const uint16_t COST_STRAIGHT = 10;
+static const uint16_t COST_DIAGONAL = 14;
+static const uint16_t NEAR_OBSTACLE_PENALTY = 10; // Prefer paths with one node of clearance
+
+// Output shaping
+static const uint8_t LOOKAHEAD_NODES = 3;         // Steer towards the node this far along the path
+static const float NEAR_OBSTACLE_SPEED = 0.6f;    // Speed scale when hugging obstacles
+
+static const uint16_t NOT_IN_HEAP = 0xFFFF;
+
+static const int8_t NEIGHBOR_DX[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+static const int8_t NEIGHBOR_DY[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+static inline uint16_t satAdd(uint16_t a, uint16_t b)
+{
+    uint32_t sum = (uint32_t)a + b;
+    return (sum >= LocalPlanner::INF) ? LocalPlanner::INF : (uint16_t)sum;
+}
+
+static inline float wrapAngle(float a)
+{
+    while (a > (float)M_PI) a -= 2.0f * (float)M_PI;
+    while (a <= -(float)M_PI) a += 2.0f * (float)M_PI;
+    return a;
+}
+
+LocalPlanner::LocalPlanner()
+    : _heapSize(0), _originX(0), _originY(0),
+      _start(0), _lastStart(0), _goal(0), _km(0),
+      _initialized(false), _hasGoal(false),
+      _goalHeading(0), _goalX(0), _goalY(0),
+      _lastExpansions(0), _fullReplans(0), _repairedCells(0)
+{
+    _out = {false, false, false, 0.0f, 0.0f};
+}
+
+void LocalPlanner::setGoalHeading(float worldHeadingRad)
+{
+    _goalHeading = worldHeadingRad;
+    _hasGoal = true;
+    _initialized = false; // Full replan on next update
+}
+
+void LocalPlanner::clearGoal()
+{
+    _hasGoal = false;
+    _initialized = false;
+    _out = {false, false, false, 0.0f, 0.0f};
+}
+
+// ============================================
+// LATTICE HELPERS
+// ============================================
+
+void LocalPlanner::setBlocked(uint16_t n, bool b)
+{
+    if (b)
+        _blocked[n >> 3] |= (1 << (n & 7));
+    else
+        _blocked[n >> 3] &= ~(1 << (n & 7));
+}
+
+bool LocalPlanner::isNearObstacle(uint16_t n) const
+{
+    int32_t nx = n % SIDE, ny = n / SIDE;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        int32_t x = nx + NEIGHBOR_DX[i], y = ny + NEIGHBOR_DY[i];
+        if (x < 0 || y < 0 || x >= SIDE || y >= SIDE) continue;
+        if (isBlocked((uint16_t)(y * SIDE + x))) return true;
+    }
+    return false;
+}
+
+bool LocalPlanner::sampleBlocked(const OccupancyGrid &grid, int32_t nx, int32_t ny) const
+{
+    int32_t wx = _originX + nx * CELL_SCALE;
+    int32_t wy = _originY + ny * CELL_SCALE;
+
+    for (int32_t dy = 0; dy < CELL_SCALE; dy++)
+    {
+        for (int32_t dx = 0; dx < CELL_SCALE; dx++)
+        {
+            if (grid.getCell(wx + dx, wy + dy) >= OccupancyGrid::OCCUPIED_THRESHOLD)
+                return true;
+        }
+    }
+    return false;
+}
+
+uint16_t LocalPlanner::nodeAt(float xCm, float yCm) const
+{
+    int32_t nx = (OccupancyGrid::toCell(xCm) - _originX) / CELL_SCALE;
+    int32_t ny = (OccupancyGrid::toCell(yCm) - _originY) / CELL_SCALE;
+    if (nx < 0) nx = 0;
+    if (ny < 0) ny = 0;
+    if (nx >= SIDE) nx = SIDE - 1;
+    if (ny >= SIDE) ny = SIDE - 1;
+    return (uint16_t)(ny * SIDE + nx);
+}
+
+void LocalPlanner::nodeCenter(uint16_t n, float &xCm, float &yCm) const
+{
+    xCm = (_originX + (n % SIDE) * CELL_SCALE) * OccupancyGrid::CELL_CM + NODE_CM * 0.5f;
+    yCm = (_originY + (n / SIDE) * CELL_SCALE) * OccupancyGrid::CELL_CM + NODE_CM * 0.5f;
+}
+
+uint16_t LocalPlanner::cost(uint16_t from, uint16_t to) const
+{
+    if (isBlocked(from) || isBlocked(to)) return INF;
+
+    int32_t fx = from % SIDE, fy = from / SIDE;
+    int32_t tx = to % SIDE, ty = to / SIDE;
+    bool diagonal = (fx != tx) && (fy != ty);
+
+    // No corner cutting past a blocked node
+    if (diagonal && (isBlocked((uint16_t)(fy * SIDE + tx)) || isBlocked((uint16_t)(ty * SIDE + fx))))
+        return INF;
+
+    uint16_t c = diagonal ? COST_DIAGONAL : COST_STRAIGHT;
+    if (isNearObstacle(to)) c += NEAR_OBSTACLE_PENALTY;
+    return c;
+}
+
+uint16_t LocalPlanner::heuristic(uint16_t a, uint16_t b)
+{
+    // Octile distance - admissible for 10/14 edge costs
+    int32_t dx = (int32_t)(a % SIDE) - (int32_t)(b % SIDE);
+    int32_t dy = (int32_t)(a / SIDE) - (int32_t)(b / SIDE);
+    if (dx < 0) dx = -dx;
+    if (dy < 0) dy = -dy;
+    int32_t lo = (dx < dy) ? dx : dy;
+    int32_t hi = (dx < dy) ? dy : dx;
+    return (uint16_t)(COST_STRAIGHT * hi + (COST_DIAGONAL - COST_STRAIGHT) * lo);
+}
+
+// ============================================
+// D* LITE
+// ============================================
+
+void LocalPlanner::calcKey(uint16_t n, uint16_t &k1, uint16_t &k2) const
+{
+    uint16_t m = (_g[n] < _rhs[n]) ? _g[n] : _rhs[n];
+    k1 = satAdd(satAdd(m, heuristic(_start, n)), _km);
+    k2 = m;
+}
+
+void LocalPlanner::placeGoal(float xCm, float yCm, float headingRad)
+{
+    _goalX = xCm + GOAL_DISTANCE_CM * cosf(headingRad);
+    _goalY = yCm + GOAL_DISTANCE_CM * sinf(headingRad);
+
+    // nodeAt() clamps into the window; walk back towards the robot until free
+    _goal = nodeAt(_goalX, _goalY);
+    int32_t gx = _goal % SIDE, gy = _goal / SIDE;
+    int32_t sx = _start % SIDE, sy = _start / SIDE;
+
+    while (isBlocked(_goal) && (gx != sx || gy != sy))
+    {
+        gx += (sx > gx) - (sx < gx);
+        gy += (sy > gy) - (sy < gy);
+        _goal = (uint16_t)(gy * SIDE + gx);
+    }
+    nodeCenter(_goal, _goalX, _goalY);
+}
+
+void LocalPlanner::initialize(const OccupancyGrid &grid)
+{
+    _originX = grid.getOriginX();
+    _originY = grid.getOriginY();
+
+    for (int32_t ny = 0; ny < SIDE; ny++)
+    {
+        for (int32_t nx = 0; nx < SIDE; nx++)
+        {
+            setBlocked((uint16_t)(ny * SIDE + nx), sampleBlocked(grid, nx, ny));
+        }
+    }
+
+    for (int32_t i = 0; i < NODES; i++)
+    {
+        _g[i] = INF;
+        _rhs[i] = INF;
+        _heapPos[i] = NOT_IN_HEAP;
+    }
+    _heapSize = 0;
+    _km = 0;
+    _initialized = true;
+    _fullReplans++;
+}
+
+void LocalPlanner::updateVertex(uint16_t n)
+{
+    if (n != _goal)
+    {
+        int32_t nx = n % SIDE, ny = n / SIDE;
+        uint16_t best = INF;
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            int32_t x = nx + NEIGHBOR_DX[i], y = ny + NEIGHBOR_DY[i];
+            if (x < 0 || y < 0 || x >= SIDE || y >= SIDE) continue;
+            uint16_t s = (uint16_t)(y * SIDE + x);
+            uint16_t c = satAdd(cost(n, s), _g[s]);
+            if (c < best) best = c;
+        }
+        _rhs[n] = best;
+    }
+
+    if (_heapPos[n] != NOT_IN_HEAP) heapRemove(n);
+
+    if (_g[n] != _rhs[n])
+    {
+        uint16_t k1, k2;
+        calcKey(n, k1, k2);
+        heapInsert(n, k1, k2);
+    }
+}
+
+bool LocalPlanner::computeShortestPath(uint16_t budget)
+{
+    uint16_t expansions = 0;
+
+    while (_heapSize > 0)
+    {
+        uint16_t startK1, startK2;
+        calcKey(_start, startK1, startK2);
+
+        uint16_t u = heapTop();
+        if (!keyLess(_keyPrimary[u], _keySecondary[u], startK1, startK2) && _rhs[_start] == _g[_start])
+            break; // Start is consistent - path is optimal
+
+        if (expansions >= budget)
+        {
+            _lastExpansions = expansions;
+            return false; // Resume next tick
+        }
+        expansions++;
+
+        uint16_t oldK1 = _keyPrimary[u], oldK2 = _keySecondary[u];
+        uint16_t newK1, newK2;
+        calcKey(u, newK1, newK2);
+
+        int32_t ux = u % SIDE, uy = u / SIDE;
+
+        if (keyLess(oldK1, oldK2, newK1, newK2))
+        {
+            // Key outdated by km change - reinsert with fresh key
+            heapRemove(u);
+            heapInsert(u, newK1, newK2);
+        }
+        else if (_g[u] > _rhs[u])
+        {
+            // Overconsistent: settle and propagate to predecessors
+            _g[u] = _rhs[u];
+            heapRemove(u);
+            for (uint8_t i = 0; i < 8; i++)
+            {
+                int32_t x = ux + NEIGHBOR_DX[i], y = uy + NEIGHBOR_DY[i];
+                if (x < 0 || y < 0 || x >= SIDE || y >= SIDE) continue;
+                updateVertex((uint16_t)(y * SIDE + x));
+            }
+        }
+        else
+        {
+            // Underconsistent: invalidate and re-evaluate neighbourhood
+            _g[u] = INF;
+            updateVertex(u);
+            for (uint8_t i = 0; i < 8; i++)
+            {
+                int32_t x = ux + NEIGHBOR_DX[i], y = uy + NEIGHBOR_DY[i];
+                if (x < 0 || y < 0 || x >= SIDE || y >= SIDE) continue;
+                updateVertex((uint16_t)(y * SIDE + x));
+            }
+        }
+    }
+
+    _lastExpansions = expansions;
+    return true;
+}
+
+void LocalPlanner::repairChanges(const OccupancyGrid &grid)
+{
+    for (int32_t ny = 0; ny < SIDE; ny++)
+    {
+        for (int32_t nx = 0; nx < SIDE; nx++)
+        {
+            uint16_t n = (uint16_t)(ny * SIDE + nx);
+            // The robot's own node is never an obstacle
+            bool blocked = (n != _start) && sampleBlocked(grid, nx, ny);
+            if (blocked == isBlocked(n)) continue;
+
+            setBlocked(n, blocked);
+            _repairedCells++;
+
+            // Edge costs change for the node, its neighbours (clearance
+            // penalty) and diagonals passing by it: re-evaluate radius 2
+            for (int32_t y = ny - 2; y <= ny + 2; y++)
+            {
+                for (int32_t x = nx - 2; x <= nx + 2; x++)
+                {
+                    if (x < 0 || y < 0 || x >= SIDE || y >= SIDE) continue;
+                    updateVertex((uint16_t)(y * SIDE + x));
+                }
+            }
+        }
+    }
+}
+
+// ============================================
+// TICK
+// ============================================
+
+const LocalPlanner::Output &LocalPlanner::update(const OccupancyGrid &grid, float xCm, float yCm,
+                                                 float headingRad, uint16_t maxExpansions)
+{
+    if (!_hasGoal)
+    {
+        _out = {false, false, false, 0.0f, 0.0f};
+        return _out;
+    }
+
+    bool reachedGoal = _initialized &&
+                       hypotf(_goalX - xCm, _goalY - yCm) < GOAL_REACHED_CM;
+    bool scrolled = _initialized &&
+                    (grid.getOriginX() != _originX || grid.getOriginY() != _originY);
+
+    if (!_initialized || reachedGoal || scrolled)
+    {
+        initialize(grid);
+        _start = nodeAt(xCm, yCm);
+        _lastStart = _start;
+        setBlocked(_start, false);
+        placeGoal(xCm, yCm, _goalHeading);
+
+        _rhs[_goal] = 0;
+        heapInsert(_goal, heuristic(_start, _goal), 0);
+    }
+    else
+    {
+        uint16_t start = nodeAt(xCm, yCm);
+        if (start != _start)
+        {
+            // Robot moved: bias future keys instead of re-sorting the queue
+            _km = satAdd(_km, heuristic(_lastStart, start));
+            _lastStart = start;
+            _start = start;
+        }
+        repairChanges(grid);
+    }
+
+    bool complete = computeShortestPath(maxExpansions);
+    _out.searching = !complete;
+    extractOutput(xCm, yCm, headingRad);
+    if (!complete) _out.noPath = false; // Not known yet
+
+    return _out;
+}
+
+void LocalPlanner::extractOutput(float xCm, float yCm, float headingRad)
+{
+    if (_g[_start] == INF && _rhs[_start] == INF)
+    {
+        _out.valid = false;
+        _out.noPath = true;
+        _out.relHeading = 0.0f;
+        _out.speedScale = 0.0f;
+        return;
+    }
+
+    // Follow the cost-to-go gradient a few nodes ahead
+    uint16_t cur = _start;
+    bool hugging = isNearObstacle(_start);
+    for (uint8_t step = 0; step < LOOKAHEAD_NODES && cur != _goal; step++)
+    {
+        int32_t cx = cur % SIDE, cy = cur / SIDE;
+        uint16_t best = INF, next = cur;
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            int32_t x = cx + NEIGHBOR_DX[i], y = cy + NEIGHBOR_DY[i];
+            if (x < 0 || y < 0 || x >= SIDE || y >= SIDE) continue;
+            uint16_t s = (uint16_t)(y * SIDE + x);
+            uint16_t c = satAdd(cost(cur, s), _g[s]);
+            if (c < best)
+            {
+                best = c;
+                next = s;
+            }
+        }
+        if (best == INF) break;
+        cur = next;
+        if (isNearObstacle(cur)) hugging = true;
+    }
+
+    float tx, ty;
+    if (cur == _start)
+    {
+        tx = _goalX;
+        ty = _goalY;
+    }
+    else
+    {
+        nodeCenter(cur, tx, ty);
+    }
+
+    float rel = wrapAngle(atan2f(ty - yCm, tx - xCm) - headingRad);
+    float scale = cosf(rel);
+    if (scale < 0.0f) scale = 0.0f;
+    if (hugging) scale *= NEAR_OBSTACLE_SPEED;
+
+    _out.valid = true;
+    _out.noPath = false;
+    _out.relHeading = rel;
+    _out.speedScale = scale;
+}
+
+// ============================================
+// HEAP
+// ============================================
+
+bool LocalPlanner::keyLess(uint16_t a1, uint16_t a2, uint16_t b1, uint16_t b2)
+{
+    return (a1 < b1) || (a1 == b1 && a2 < b2);
+}
+
+bool LocalPlanner::heapLess(uint16_t i, uint16_t j) const
+{
+    uint16_t a = _heap[i], b = _heap[j];
+    return keyLess(_keyPrimary[a], _keySecondary[a], _keyPrimary[b], _keySecondary[b]);
+}
+
+void LocalPlanner::heapSwap(uint16_t i, uint16_t j)
+{
+    uint16_t tmp = _heap[i];
+    _heap[i] = _heap[j];
+    _heap[j] = tmp;
+    _heapPos[_heap[i]] = i;
+    _heapPos[_heap[j]] = j;
+}
+
+void LocalPlanner::heapUp(uint16_t i)
+{
+    while (i > 0)
+    {
+        uint16_t parent = (i - 1) / 2;
+        if (!heapLess(i, parent)) break;
+        heapSwap(i, parent);
+        i = parent;
+    }
+}
+
+void LocalPlanner::heapDown(uint16_t i)
+{
+    while (true)
+    {
+        uint16_t left = 2 * i + 1, right = left + 1, smallest = i;
+        if (left < _heapSize && heapLess(left, smallest)) smallest = left;
+        if (right < _heapSize && heapLess(right, smallest)) smallest = right;
+        if (smallest == i) break;
+        heapSwap(i, smallest);
+        i = smallest;
+    }
+}
+
+void LocalPlanner::heapInsert(uint16_t n, uint16_t k1, uint16_t k2)
+{
+    _keyPrimary[n] = k1;
+    _keySecondary[n] = k2;
+    _heap[_heapSize] = n;
+    _heapPos[n] = _heapSize;
+    _heapSize++;
+    heapUp(_heapSize - 1);
+}
+
+void LocalPlanner::heapRemove(uint16_t n)
+{
+    uint16_t i = _heapPos[n];
+    if (i == NOT_IN_HEAP) return;
+
+    _heapSize--;
+    if (i != _heapSize)
+    {
+        heapSwap(i, _heapSize);
+        uint16_t moved = _heap[i];
+        heapUp(i);
+        heapDown(_heapPos[moved]);
+    }
+    _heapPos[n] = NOT_IN_HEAP;
+}
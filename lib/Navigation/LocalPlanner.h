@@ -0,0 +1,130 @@
+#ifndef LOCAL_PLANNER_H
+#define LOCAL_PLANNER_H
+
+#include <stdint.h>
+#include "OccupancyGrid.h"
+
+/**
+ * Incremental local path planner (D* Lite) over the occupancy grid window
+ *
+ * - Plans on a 32x32 lattice of 10 cm nodes (2x2 grid cells each),
+ *   8-connected, with an extra cost next to obstacles to keep clearance
+ * - Goal is a point ahead of the robot along a mission heading; it is
+ *   pushed further out each time the robot reaches it
+ * - Only cells whose blocked state changed are repaired between ticks;
+ *   a full re-initialisation happens only when the goal moves or the
+ *   grid window scrolls
+ * - Bounded work: at most maxExpansions node expansions per update(),
+ *   a search that runs out of budget resumes on the next tick
+ * - Static memory (~12 KB), no heap
+ *
+ * Output is a heading (relative to the robot) and a speed scale for the
+ * drive layer. Pure logic - no Arduino dependencies.
+ */
+class LocalPlanner
+{
+public:
+    static constexpr int32_t CELL_SCALE = 2; // Grid cells per node side
+    static constexpr int32_t SIDE = OccupancyGrid::SIZE / CELL_SCALE;
+    static constexpr int32_t NODES = SIDE * SIDE;
+    static constexpr float NODE_CM = OccupancyGrid::CELL_CM * CELL_SCALE;
+    static constexpr uint16_t INF = 0xFFFF;
+
+    struct Output
+    {
+        bool valid;         // Heading/speed below can be used
+        bool noPath;        // Search finished and the goal is unreachable
+        bool searching;     // Search ran out of budget this tick
+        float relHeading;   // Radians, + = left of current heading
+        float speedScale;   // 0..1 of cruise speed
+    };
+
+    LocalPlanner();
+
+    /**
+     * Start planning towards a goal ahead along a world heading (radians)
+     */
+    void setGoalHeading(float worldHeadingRad);
+
+    /**
+     * Stop planning (output becomes invalid)
+     */
+    void clearGoal();
+
+    bool hasGoal() const { return _hasGoal; }
+
+    /**
+     * Run one planning tick
+     * @param grid Local occupancy grid (pose must already be updated)
+     * @param xCm,yCm,headingRad Robot pose in the grid's world frame
+     * @param maxExpansions Node expansion budget for this tick
+     */
+    const Output &update(const OccupancyGrid &grid, float xCm, float yCm, float headingRad,
+                         uint16_t maxExpansions);
+
+    const Output &getOutput() const { return _out; }
+
+    // Statistics
+    uint16_t getLastExpansions() const { return _lastExpansions; }
+    uint32_t getFullReplans() const { return _fullReplans; }
+    uint32_t getRepairedCells() const { return _repairedCells; }
+
+private:
+    // D* Lite state
+    uint16_t _g[NODES];
+    uint16_t _rhs[NODES];
+    uint16_t _keyPrimary[NODES];
+    uint16_t _keySecondary[NODES];
+
+    // Binary min-heap of node ids with position index for O(log n) updates
+    uint16_t _heap[NODES];
+    uint16_t _heapPos[NODES];
+    uint16_t _heapSize;
+
+    // Blocked snapshot the current search is based on
+    uint8_t _blocked[NODES / 8];
+
+    int32_t _originX, _originY; // Grid origin the node lattice is anchored to
+    uint16_t _start, _lastStart, _goal;
+    uint16_t _km;
+    bool _initialized;
+    bool _hasGoal;
+    float _goalHeading;
+    float _goalX, _goalY;
+
+    Output _out;
+    uint16_t _lastExpansions;
+    uint32_t _fullReplans;
+    uint32_t _repairedCells;
+
+    // Lattice helpers
+    bool isBlocked(uint16_t n) const { return _blocked[n >> 3] & (1 << (n & 7)); }
+    void setBlocked(uint16_t n, bool b);
+    bool isNearObstacle(uint16_t n) const;
+    bool sampleBlocked(const OccupancyGrid &grid, int32_t nx, int32_t ny) const;
+    uint16_t nodeAt(float xCm, float yCm) const;
+    void nodeCenter(uint16_t n, float &xCm, float &yCm) const;
+    uint16_t cost(uint16_t from, uint16_t to) const;
+    static uint16_t heuristic(uint16_t a, uint16_t b);
+
+    // D* Lite
+    void initialize(const OccupancyGrid &grid);
+    void placeGoal(float xCm, float yCm, float headingRad);
+    void calcKey(uint16_t n, uint16_t &k1, uint16_t &k2) const;
+    void updateVertex(uint16_t n);
+    bool computeShortestPath(uint16_t budget);
+    void repairChanges(const OccupancyGrid &grid);
+    void extractOutput(float xCm, float yCm, float headingRad);
+
+    // Heap
+    static bool keyLess(uint16_t a1, uint16_t a2, uint16_t b1, uint16_t b2);
+    bool heapLess(uint16_t i, uint16_t j) const;
+    void heapSwap(uint16_t i, uint16_t j);
+    void heapUp(uint16_t i);
+    void heapDown(uint16_t i);
+    void heapInsert(uint16_t n, uint16_t k1, uint16_t k2);
+    void heapRemove(uint16_t n);
+    uint16_t heapTop() const { return _heap[0]; }
+};
+
+#endif // LOCAL_PLANNER_H
@@ -0,0 +1,283 @@
+#include "OccupancyGrid.h"
+#include <math.h>
+#include <string.h>
+
+// Recentre once the robot drifts this many cells from the window centre
+static const int32_t RECENTER_SLACK = OccupancyGrid::TILE;
+
+// Query ray marching
+static const float SECTOR_RAY_STEP_RAD = 0.087f;   // ~5 degrees between rays
+static const float MARCH_STEP_CM = OccupancyGrid::CELL_CM * 0.5f;
+
+OccupancyGrid::OccupancyGrid()
+    : _dirty(0), _originX(-SIZE / 2), _originY(-SIZE / 2),
+      _x(0), _y(0), _heading(0)
+{
+    memset(_cells, 0, sizeof(_cells));
+}
+
+int32_t OccupancyGrid::toCell(float cm)
+{
+    return (int32_t)floorf(cm / CELL_CM);
+}
+
+// ============================================
+// POSE & WINDOW SCROLLING
+// ============================================
+
+void OccupancyGrid::setPose(float xCm, float yCm, float headingRad)
+{
+    _x = xCm;
+    _y = yCm;
+    _heading = headingRad;
+
+    int32_t cx = toCell(xCm);
+    int32_t cy = toCell(yCm);
+
+    int32_t offX = cx - (_originX + SIZE / 2);
+    int32_t offY = cy - (_originY + SIZE / 2);
+
+    if (offX > RECENTER_SLACK || offX < -RECENTER_SLACK ||
+        offY > RECENTER_SLACK || offY < -RECENTER_SLACK)
+    {
+        // New origin keeps the robot in the centre tile, aligned to tile grid
+        int32_t newOriginX = ((cx - SIZE / 2) >> TILE_BITS) << TILE_BITS;
+        int32_t newOriginY = ((cy - SIZE / 2) >> TILE_BITS) << TILE_BITS;
+        scrollTo(newOriginX, newOriginY);
+    }
+}
+
+void OccupancyGrid::scrollTo(int32_t newOriginX, int32_t newOriginY)
+{
+    // Columns entering the window reuse storage of columns leaving it
+    if (newOriginX != _originX)
+    {
+        for (int32_t wx = newOriginX; wx < newOriginX + SIZE; wx++)
+        {
+            if (wx < _originX || wx >= _originX + SIZE)
+                clearColumn(wx);
+        }
+        _originX = newOriginX;
+    }
+
+    if (newOriginY != _originY)
+    {
+        for (int32_t wy = newOriginY; wy < newOriginY + SIZE; wy++)
+        {
+            if (wy < _originY || wy >= _originY + SIZE)
+                clearRow(wy);
+        }
+        _originY = newOriginY;
+    }
+}
+
+void OccupancyGrid::clearColumn(int32_t wx)
+{
+    for (int32_t wy = _originY; wy < _originY + SIZE; wy++)
+    {
+        _cells[index(wx, wy)] = 0;
+    }
+    for (int32_t ty = 0; ty < TILES_PER_SIDE; ty++)
+    {
+        _dirty |= 1ULL << (ty * TILES_PER_SIDE + ((wx >> TILE_BITS) & (TILES_PER_SIDE - 1)));
+    }
+}
+
+void OccupancyGrid::clearRow(int32_t wy)
+{
+    memset(&_cells[(wy & MASK) << SIZE_BITS], 0, SIZE);
+    for (int32_t tx = 0; tx < TILES_PER_SIDE; tx++)
+    {
+        _dirty |= 1ULL << (((wy >> TILE_BITS) & (TILES_PER_SIDE - 1)) * TILES_PER_SIDE + tx);
+    }
+}
+
+void OccupancyGrid::clear()
+{
+    memset(_cells, 0, sizeof(_cells));
+    _dirty = ~0ULL;
+}
+
+// ============================================
+// RANGE INTEGRATION
+// ============================================
+
+bool OccupancyGrid::isInWindow(int32_t wx, int32_t wy) const
+{
+    return wx >= _originX && wx < _originX + SIZE &&
+           wy >= _originY && wy < _originY + SIZE;
+}
+
+int8_t OccupancyGrid::getCell(int32_t wx, int32_t wy) const
+{
+    if (!isInWindow(wx, wy)) return 0;
+    return _cells[index(wx, wy)];
+}
+
+void OccupancyGrid::updateCell(int32_t wx, int32_t wy, int8_t delta)
+{
+    int8_t &cell = _cells[index(wx, wy)];
+    int16_t value = (int16_t)cell + delta;
+    if (value > LOGODDS_MAX) value = LOGODDS_MAX;
+    if (value < LOGODDS_MIN) value = LOGODDS_MIN;
+
+    if (value != cell)
+    {
+        cell = (int8_t)value;
+        _dirty |= 1ULL << tileSlot(wx, wy);
+    }
+}
+
+void OccupancyGrid::integrateRange(float sensorOffsetCm, float sensorAngleRad, float rangeCm, float maxRangeCm)
+{
+    if (rangeCm <= 0.0f) return;
+
+    bool hit = rangeCm < maxRangeCm;
+    if (!hit) rangeCm = maxRangeCm;
+
+    // Sensor position and beam direction in world frame
+    float mountDir = _heading + sensorAngleRad;
+    float sx = _x + sensorOffsetCm * cosf(mountDir);
+    float sy = _y + sensorOffsetCm * sinf(mountDir);
+    float ex = sx + rangeCm * cosf(mountDir);
+    float ey = sy + rangeCm * sinf(mountDir);
+
+    int32_t x0 = toCell(sx), y0 = toCell(sy);
+    int32_t x1 = toCell(ex), y1 = toCell(ey);
+
+    // Bresenham from sensor cell to end cell; every cell before the end is free
+    int32_t dx = (x1 > x0) ? (x1 - x0) : (x0 - x1);
+    int32_t dy = (y1 > y0) ? -(y1 - y0) : -(y0 - y1);
+    int32_t stepX = (x0 < x1) ? 1 : -1;
+    int32_t stepY = (y0 < y1) ? 1 : -1;
+    int32_t err = dx + dy;
+
+    while (true)
+    {
+        if (!isInWindow(x0, y0)) return; // Ray left the window
+
+        if (x0 == x1 && y0 == y1)
+        {
+            updateCell(x0, y0, hit ? LOGODDS_HIT : LOGODDS_MISS);
+            return;
+        }
+
+        updateCell(x0, y0, LOGODDS_MISS);
+
+        int32_t e2 = 2 * err;
+        if (e2 >= dy)
+        {
+            err += dy;
+            x0 += stepX;
+        }
+        if (e2 <= dx)
+        {
+            err += dx;
+            y0 += stepY;
+        }
+    }
+}
+
+// ============================================
+// QUERIES
+// ============================================
+
+float OccupancyGrid::clearDistance(float relHeadingRad, float maxRangeCm) const
+{
+    float dir = _heading + relHeadingRad;
+    float c = cosf(dir), s = sinf(dir);
+
+    for (float d = MARCH_STEP_CM; d < maxRangeCm; d += MARCH_STEP_CM)
+    {
+        int32_t wx = toCell(_x + d * c);
+        int32_t wy = toCell(_y + d * s);
+        if (!isInWindow(wx, wy)) break;
+        if (_cells[index(wx, wy)] >= OCCUPIED_THRESHOLD) return d;
+    }
+    return maxRangeCm;
+}
+
+float OccupancyGrid::freeSpaceInSector(float relHeadingRad, float halfWidthRad, float rangeCm) const
+{
+    if (rangeCm <= 0.0f) return 0.0f;
+
+    float total = 0.0f;
+    int rays = 0;
+
+    for (float a = -halfWidthRad; a <= halfWidthRad + 1e-4f; a += SECTOR_RAY_STEP_RAD)
+    {
+        float dir = _heading + relHeadingRad + a;
+        float c = cosf(dir), s = sinf(dir);
+        float score = 0.0f;
+
+        for (float d = MARCH_STEP_CM; d <= rangeCm; d += MARCH_STEP_CM)
+        {
+            int32_t wx = toCell(_x + d * c);
+            int32_t wy = toCell(_y + d * s);
+            int8_t v = isInWindow(wx, wy) ? _cells[index(wx, wy)] : 0;
+
+            if (v >= OCCUPIED_THRESHOLD) break;        // Blocked: rest of ray scores 0
+            score += (v <= FREE_THRESHOLD) ? 1.0f : 0.5f;
+        }
+
+        // Normalise against the full ray length, not just the marched part
+        int fullSteps = (int)(rangeCm / MARCH_STEP_CM);
+        total += (fullSteps > 0) ? score / fullSteps : 0.0f;
+        rays++;
+    }
+
+    return (rays > 0) ? total / rays : 0.0f;
+}
+
+// ============================================
+// DELTA STREAMING
+// ============================================
+
+int OccupancyGrid::popDirtyTile()
+{
+    if (_dirty == 0) return -1;
+
+    int slot = __builtin_ctzll(_dirty);
+    _dirty &= ~(1ULL << slot);
+    return slot;
+}
+
+size_t OccupancyGrid::encodeTile(int slot, uint8_t *out, int32_t &tileX, int32_t &tileY) const
+{
+    int32_t slotX = slot % TILES_PER_SIDE;
+    int32_t slotY = slot / TILES_PER_SIDE;
+
+    // World tile in the current window that maps onto this storage slot
+    int32_t originTileX = _originX >> TILE_BITS;
+    int32_t originTileY = _originY >> TILE_BITS;
+    tileX = originTileX + ((slotX - originTileX) & (TILES_PER_SIDE - 1));
+    tileY = originTileY + ((slotY - originTileY) & (TILES_PER_SIDE - 1));
+
+    size_t len = 0;
+    uint8_t run = 0;
+    int8_t runValue = 0;
+
+    for (int32_t cy = 0; cy < TILE; cy++)
+    {
+        for (int32_t cx = 0; cx < TILE; cx++)
+        {
+            int8_t v = _cells[index((tileX << TILE_BITS) + cx, (tileY << TILE_BITS) + cy)];
+            if (run > 0 && v == runValue && run < 255)
+            {
+                run++;
+                continue;
+            }
+            if (run > 0)
+            {
+                out[len++] = run;
+                out[len++] = (uint8_t)runValue;
+            }
+            run = 1;
+            runValue = v;
+        }
+    }
+    out[len++] = run;
+    out[len++] = (uint8_t)runValue;
+
+    return len;
+}
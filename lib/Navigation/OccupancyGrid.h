@@ -0,0 +1,134 @@
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Rolling local occupancy grid built from ultrasonic returns + odometry
+ *
+ * - Fixed 64x64 window of 5 cm cells (3.2 m square, 4 KB) centred on the robot
+ * - Log-odds per cell in int8_t (0 = unknown, > 0 occupied, < 0 free)
+ * - Toroidal storage: scrolling the window only clears the rows/columns
+ *   that enter it, nothing is copied
+ * - Window origin moves in whole tiles (8x8 cells) so tiles stay aligned
+ *   to world coordinates for delta streaming
+ *
+ * Frame matches Odometry: x forward at start, y left, heading CCW (radians).
+ * Pure logic - no Arduino dependencies.
+ */
+class OccupancyGrid
+{
+public:
+    static constexpr uint8_t SIZE_BITS = 6;
+    static constexpr int32_t SIZE = 1 << SIZE_BITS; // Cells per side
+    static constexpr int32_t MASK = SIZE - 1;
+    static constexpr uint8_t TILE_BITS = 3;
+    static constexpr int32_t TILE = 1 << TILE_BITS; // Cells per tile side
+    static constexpr int32_t TILES_PER_SIDE = SIZE / TILE;
+    static constexpr int32_t TILE_COUNT = TILES_PER_SIDE * TILES_PER_SIDE;
+    static constexpr float CELL_CM = 5.0f;
+
+    // Log-odds model (scaled integers)
+    static constexpr int8_t LOGODDS_HIT = 24;
+    static constexpr int8_t LOGODDS_MISS = -6;
+    static constexpr int8_t LOGODDS_MIN = -100;
+    static constexpr int8_t LOGODDS_MAX = 100;
+    static constexpr int8_t OCCUPIED_THRESHOLD = 20;
+    static constexpr int8_t FREE_THRESHOLD = -10;
+
+    // Worst-case RLE size of one tile (run, value pairs)
+    static constexpr size_t MAX_TILE_ENCODED = TILE * TILE * 2;
+
+    OccupancyGrid();
+
+    /**
+     * Update robot pose (cm, radians). Scrolls the window when the robot
+     * leaves the central region.
+     */
+    void setPose(float xCm, float yCm, float headingRad);
+
+    /**
+     * Ray-cast one range sample from a sensor mounted on the robot
+     * @param sensorOffsetCm Mount distance from robot centre along sensorAngle
+     * @param sensorAngleRad Mount direction relative to robot heading (0 = front, PI = rear)
+     * @param rangeCm Measured range (<= 0 ignored)
+     * @param maxRangeCm Ranges at/above this are treated as "no echo": free ray, no hit
+     */
+    void integrateRange(float sensorOffsetCm, float sensorAngleRad, float rangeCm, float maxRangeCm);
+
+    // ========================================
+    // QUERIES (relative to current pose)
+    // ========================================
+
+    /**
+     * Free-space score of a sector around relHeadingRad (0 = straight ahead, + = left)
+     * @return 0.0 (blocked right in front) .. 1.0 (known free out to rangeCm).
+     *         Unknown cells count half.
+     */
+    float freeSpaceInSector(float relHeadingRad, float halfWidthRad, float rangeCm) const;
+
+    /**
+     * Distance to the first occupied cell along relHeadingRad (maxRangeCm if none)
+     */
+    float clearDistance(float relHeadingRad, float maxRangeCm) const;
+
+    /**
+     * Log-odds of a world cell (0 when outside the window)
+     */
+    int8_t getCell(int32_t wx, int32_t wy) const;
+    bool isInWindow(int32_t wx, int32_t wy) const;
+
+    int32_t getOriginX() const { return _originX; }
+    int32_t getOriginY() const { return _originY; }
+
+    /**
+     * World cell index containing a coordinate in cm
+     */
+    static int32_t toCell(float cm);
+
+    // ========================================
+    // DELTA STREAMING
+    // ========================================
+
+    bool hasDirtyTiles() const { return _dirty != 0; }
+
+    /**
+     * Pop the next changed tile
+     * @return storage slot (0..TILE_COUNT-1) or -1 if nothing changed
+     */
+    int popDirtyTile();
+
+    /**
+     * RLE-encode a tile as (run length, value) byte pairs, row-major
+     * @param slot Storage slot from popDirtyTile()
+     * @param out Buffer of at least MAX_TILE_ENCODED bytes
+     * @param tileX,tileY World tile coordinates of the slot (output)
+     * @return number of bytes written
+     */
+    size_t encodeTile(int slot, uint8_t *out, int32_t &tileX, int32_t &tileY) const;
+
+    /**
+     * Forget everything (window keeps its position)
+     */
+    void clear();
+
+private:
+    int8_t _cells[SIZE * SIZE];
+    uint64_t _dirty;
+    int32_t _originX, _originY; // World cell of the window's lower-left corner
+    float _x, _y, _heading;
+
+    static inline int32_t index(int32_t wx, int32_t wy) { return ((wy & MASK) << SIZE_BITS) | (wx & MASK); }
+    static inline int tileSlot(int32_t wx, int32_t wy)
+    {
+        return (int)((((wy >> TILE_BITS) & (TILES_PER_SIDE - 1)) * TILES_PER_SIDE) + ((wx >> TILE_BITS) & (TILES_PER_SIDE - 1)));
+    }
+
+    void updateCell(int32_t wx, int32_t wy, int8_t delta);
+    void scrollTo(int32_t newOriginX, int32_t newOriginY);
+    void clearColumn(int32_t wx);
+    void clearRow(int32_t wy);
+};
+
+#endif // OCCUPANCY_GRID_H
@@ -0,0 +1,54 @@
+#include "Odometry.h"
+#include <math.h>
+
+// Larger per-update wheel jumps are treated as glitches (PCNT reset, etc.)
+static const float MAX_STEP_CM = 20.0f;
+
+Odometry::Odometry(float trackWidthCm)
+    : _trackWidth(trackWidthCm),
+      _x(0), _y(0), _heading(0), _pathLength(0),
+      _lastLeft(0), _lastRight(0), _initialized(false)
+{
+}
+
+void Odometry::update(float leftDistCm, float rightDistCm)
+{
+    if (!_initialized)
+    {
+        reset(leftDistCm, rightDistCm);
+        return;
+    }
+
+    float dLeft = leftDistCm - _lastLeft;
+    float dRight = rightDistCm - _lastRight;
+    _lastLeft = leftDistCm;
+    _lastRight = rightDistCm;
+
+    if (fabsf(dLeft) > MAX_STEP_CM || fabsf(dRight) > MAX_STEP_CM) return;
+
+    float dCenter = (dLeft + dRight) * 0.5f;
+    float dTheta = (dRight - dLeft) / _trackWidth;
+
+    // Midpoint integration: advance along the average heading of this step
+    float midHeading = _heading + dTheta * 0.5f;
+    _x += dCenter * cosf(midHeading);
+    _y += dCenter * sinf(midHeading);
+    _heading += dTheta;
+
+    // Keep heading in (-PI, PI]
+    if (_heading > (float)M_PI) _heading -= 2.0f * (float)M_PI;
+    else if (_heading <= -(float)M_PI) _heading += 2.0f * (float)M_PI;
+
+    _pathLength += fabsf(dCenter);
+}
+
+void Odometry::reset(float leftDistCm, float rightDistCm)
+{
+    _x = 0;
+    _y = 0;
+    _heading = 0;
+    _pathLength = 0;
+    _lastLeft = leftDistCm;
+    _lastRight = rightDistCm;
+    _initialized = true;
+}
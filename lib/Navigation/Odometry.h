@@ -0,0 +1,46 @@
+#ifndef ODOMETRY_H
+#define ODOMETRY_H
+
+/**
+ * Differential-drive dead reckoning from the rear wheel encoders
+ *
+ * Integrates cumulative left/right wheel travel into a planar pose.
+ * Frame: x forward at start, y to the left, heading CCW-positive (radians).
+ * Pure logic - feed it EncoderManager::getDistanceCm() at encoder rate.
+ */
+class Odometry
+{
+public:
+    /**
+     * @param trackWidthCm Distance between left and right wheel contact patches
+     */
+    explicit Odometry(float trackWidthCm);
+
+    /**
+     * Integrate new cumulative wheel distances (cm since encoder reset)
+     */
+    void update(float leftDistCm, float rightDistCm);
+
+    /**
+     * Reset pose to origin and re-reference wheel distances
+     */
+    void reset(float leftDistCm = 0.0f, float rightDistCm = 0.0f);
+
+    float getX() const { return _x; }
+    float getY() const { return _y; }
+    float getHeading() const { return _heading; }
+
+    /**
+     * Total path length travelled (cm, always increasing)
+     */
+    float getPathLength() const { return _pathLength; }
+
+private:
+    float _trackWidth;
+    float _x, _y, _heading;
+    float _pathLength;
+    float _lastLeft, _lastRight;
+    bool _initialized;
+};
+
+#endif // ODOMETRY_H
@@ -0,0 +1,285 @@
+#include "CollisionGuard.h"
+
+// Response thresholds
+static const float TTC_CAP_S = 1.5f;          // Start limiting speed below this TTC
+static const float TTC_STOP_S = 0.5f;         // Controlled stop below this TTC
+static const float CAP_MARGIN_CM = 15.0f;     // Gap beyond braking distance before capping
+static const float STOP_MARGIN_CM = 5.0f;     // Gap beyond braking distance before stopping
+static const float LATCH_MARGIN_CM = 2.0f;    // Gap beyond braking distance before latching
+static const float MIN_STANDOFF_CM = 4.0f;    // Absolute floor while moving towards obstacle
+static const float MIN_CLOSING_CM_S = 2.0f;   // Below this we treat the robot as not closing
+static const float TTC_INFINITE_S = 99.0f;
+
+// Range-rate estimation
+static const unsigned long RATE_MIN_DT_MS = 20;   // Ignore samples closer than this
+static const unsigned long RATE_MAX_DT_MS = 500;  // Older history is discarded
+static const float RATE_EMA_ALPHA = 0.5f;
+static const float RATE_LIMIT_CM_S = 300.0f;      // Physical plausibility clamp
+
+// De-escalation only after the lower level held this long
+static const unsigned long RELAX_HOLD_MS = 250;
+
+// Default drive calibration (rear L298N, 6.5 cm wheels, flat floor)
+// Stop distance = 100 ms reaction (sensor + loop) + braking at ~300 cm/s^2
+static const CollisionGuard::BrakePoint DEFAULT_BRAKE_TABLE[] = {
+    {0, 0.0f, 0.0f},
+    {60, 10.0f, 1.2f},
+    {100, 30.0f, 4.5f},
+    {150, 55.0f, 10.5f},
+    {180, 70.0f, 15.2f},
+    {255, 100.0f, 26.7f},
+};
+
+CollisionGuard::CollisionGuard()
+    : _tableSize(0),
+      _level(COLLISION_CLEAR), _speedLimit(255),
+      _closingSpeed(0), _brakingDist(0), _ttc(TTC_INFINITE_S),
+      _contact(false), _contactMaxClosing(0),
+      _lastDist(0), _lastDistTime(0), _rangeRate(0), _haveLastDist(false),
+      _relaxSince(0), _relaxing(false)
+{
+    setBrakeTable(DEFAULT_BRAKE_TABLE, sizeof(DEFAULT_BRAKE_TABLE) / sizeof(DEFAULT_BRAKE_TABLE[0]));
+}
+
+void CollisionGuard::setBrakeTable(const BrakePoint *points, uint8_t count)
+{
+    if (count < 2) return;  // Need at least two points to interpolate
+    if (count > MAX_BRAKE_POINTS) count = MAX_BRAKE_POINTS;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        _table[i] = points[i];
+    }
+    _tableSize = count;
+}
+
+// ============================================
+// EVALUATION
+// ============================================
+
+CollisionLevel CollisionGuard::update(float frontDistCm, unsigned long nowMs,
+                                      int commandedPwm, float measuredSpeedCmS)
+{
+    // Latched until operator reset
+    if (_level == COLLISION_LATCH) return _level;
+
+    bool validDist = frontDistCm > 0.0f;
+
+    // ----------------------------------------
+    // Range rate from consecutive samples
+    // ----------------------------------------
+    if (validDist)
+    {
+        if (_haveLastDist)
+        {
+            unsigned long dt = nowMs - _lastDistTime;
+            if (dt > RATE_MAX_DT_MS)
+            {
+                // History too old to differentiate - start over
+                _rangeRate = 0;
+                _lastDist = frontDistCm;
+                _lastDistTime = nowMs;
+            }
+            else if (dt >= RATE_MIN_DT_MS && frontDistCm != _lastDist)
+            {
+                float rate = (_lastDist - frontDistCm) * 1000.0f / dt;
+                if (rate > RATE_LIMIT_CM_S) rate = RATE_LIMIT_CM_S;
+                if (rate < -RATE_LIMIT_CM_S) rate = -RATE_LIMIT_CM_S;
+                _rangeRate = RATE_EMA_ALPHA * rate + (1.0f - RATE_EMA_ALPHA) * _rangeRate;
+                _lastDist = frontDistCm;
+                _lastDistTime = nowMs;
+            }
+        }
+        else
+        {
+            _lastDist = frontDistCm;
+            _lastDistTime = nowMs;
+            _haveLastDist = true;
+        }
+    }
+
+    // ----------------------------------------
+    // Closing velocity (most pessimistic estimate)
+    // ----------------------------------------
+    // The command counts even when the encoders read slower: the wheels
+    // lag a fresh command, and a zero reading may be a sensor fault. Only
+    // what this guard lets through reaches the wheels
+    int appliedPwm = (commandedPwm < _speedLimit) ? commandedPwm : _speedLimit;
+    float wheelSpeed = speedForPwm(appliedPwm);
+    if (measuredSpeedCmS > wheelSpeed) wheelSpeed = measuredSpeedCmS;
+    float closing = (_rangeRate > wheelSpeed || _contact) ? _rangeRate : wheelSpeed;
+    if (closing < 0.0f) closing = 0.0f;
+    _closingSpeed = closing;
+    _brakingDist = stopDistanceForSpeed(closing);
+
+    // No valid range: keep current response, nothing new to act on
+    if (!validDist)
+    {
+        _ttc = TTC_INFINITE_S;
+        return _level;
+    }
+
+    _ttc = (closing > MIN_CLOSING_CM_S) ? frontDistCm / closing : TTC_INFINITE_S;
+
+    CollisionLevel wanted = classify(frontDistCm, closing, commandedPwm);
+
+    // Stopped with forward still requested: the still wheels say nothing
+    // about the request. Release only if the request itself would be safe,
+    // else stop/go steps creep up on the obstacle
+    if (_level == COLLISION_STOP && wanted < COLLISION_STOP && commandedPwm > 0 && !_contact)
+    {
+        float resumed = speedForPwm(commandedPwm);
+        if (resumed > closing && classify(frontDistCm, resumed, commandedPwm) >= COLLISION_STOP)
+            wanted = COLLISION_STOP;
+    }
+
+    // ----------------------------------------
+    // Escalate immediately, relax with hold time
+    // ----------------------------------------
+    if (wanted >= _level)
+    {
+        _level = wanted;
+        _relaxing = false;
+    }
+    else if (!_relaxing)
+    {
+        _relaxing = true;
+        _relaxSince = nowMs;
+    }
+    else if (nowMs - _relaxSince >= RELAX_HOLD_MS)
+    {
+        _level = wanted;
+        _relaxing = false;
+    }
+
+    switch (_level)
+    {
+        case COLLISION_CLEAR:
+            _speedLimit = 255;
+            break;
+        case COLLISION_CAP:
+        {
+            // Fastest speed that still stops outside the STOP margin and
+            // keeps TTC above the cap threshold
+            int byGap = maxPwmForGap(frontDistCm - STOP_MARGIN_CM);
+            int bySpeed = maxPwmForGap(stopDistanceForSpeed(frontDistCm / TTC_CAP_S));
+            _speedLimit = (byGap < bySpeed) ? byGap : bySpeed;
+            break;
+        }
+        default:
+            _speedLimit = 0;
+            break;
+    }
+
+    return _level;
+}
+
+CollisionLevel CollisionGuard::classify(float distCm, float closingSpeed, int commandedPwm) const
+{
+    // Only react when we are (or are about to be) moving towards the obstacle.
+    // A stationary robot parked close to a wall may still back away.
+    bool approaching = (closingSpeed > MIN_CLOSING_CM_S) || (commandedPwm > 0);
+    if (!approaching) return COLLISION_CLEAR;
+
+    // Climbing: only an approach faster than any climb is still a collision
+    if (_contact) return (closingSpeed > _contactMaxClosing) ? COLLISION_LATCH : COLLISION_CLEAR;
+
+    float gap = distCm - stopDistanceForSpeed(closingSpeed);
+    float ttc = (closingSpeed > MIN_CLOSING_CM_S) ? distCm / closingSpeed : TTC_INFINITE_S;
+
+    if (distCm < MIN_STANDOFF_CM) return COLLISION_LATCH;
+    if (closingSpeed > MIN_CLOSING_CM_S && gap < LATCH_MARGIN_CM) return COLLISION_LATCH;
+
+    if (ttc < TTC_STOP_S || gap < STOP_MARGIN_CM) return COLLISION_STOP;
+    if (ttc < TTC_CAP_S || gap < CAP_MARGIN_CM) return COLLISION_CAP;
+
+    return COLLISION_CLEAR;
+}
+
+void CollisionGuard::setContactMode(bool enabled, float maxClosingCmS)
+{
+    _contactMaxClosing = maxClosingCmS;
+    if (enabled == _contact) return;
+    _contact = enabled;
+
+    // Entering: drop a CAP/STOP at once instead of after the relax hold.
+    // Leaving: the next update() escalates again as needed
+    if (enabled && _level != COLLISION_LATCH)
+    {
+        _level = COLLISION_CLEAR;
+        _speedLimit = 255;
+        _relaxing = false;
+    }
+}
+
+void CollisionGuard::reset()
+{
+    _level = COLLISION_CLEAR;
+    _speedLimit = 255;
+    _closingSpeed = 0;
+    _brakingDist = 0;
+    _ttc = TTC_INFINITE_S;
+    _rangeRate = 0;
+    _haveLastDist = false;
+    _relaxing = false;
+    _contact = false;
+}
+
+// ============================================
+// CALIBRATION TABLE LOOKUPS
+// ============================================
+
+float CollisionGuard::speedForPwm(int pwm) const
+{
+    if (pwm <= _table[0].pwm) return _table[0].speedCmS;
+
+    for (uint8_t i = 1; i < _tableSize; i++)
+    {
+        if (pwm <= _table[i].pwm)
+        {
+            const BrakePoint &a = _table[i - 1];
+            const BrakePoint &b = _table[i];
+            float t = (float)(pwm - a.pwm) / (float)(b.pwm - a.pwm);
+            return a.speedCmS + t * (b.speedCmS - a.speedCmS);
+        }
+    }
+    return _table[_tableSize - 1].speedCmS;
+}
+
+float CollisionGuard::stopDistanceForSpeed(float speedCmS) const
+{
+    if (speedCmS <= _table[0].speedCmS) return _table[0].stopDistCm;
+
+    for (uint8_t i = 1; i < _tableSize; i++)
+    {
+        if (speedCmS <= _table[i].speedCmS)
+        {
+            const BrakePoint &a = _table[i - 1];
+            const BrakePoint &b = _table[i];
+            float t = (speedCmS - a.speedCmS) / (b.speedCmS - a.speedCmS);
+            return a.stopDistCm + t * (b.stopDistCm - a.stopDistCm);
+        }
+    }
+
+    // Beyond calibrated range: extrapolate quadratically from the last point
+    const BrakePoint &last = _table[_tableSize - 1];
+    float ratio = speedCmS / last.speedCmS;
+    return last.stopDistCm * ratio * ratio;
+}
+
+int CollisionGuard::maxPwmForGap(float gapCm) const
+{
+    if (gapCm <= _table[0].stopDistCm) return _table[0].pwm;
+
+    for (uint8_t i = 1; i < _tableSize; i++)
+    {
+        if (gapCm <= _table[i].stopDistCm)
+        {
+            const BrakePoint &a = _table[i - 1];
+            const BrakePoint &b = _table[i];
+            float t = (gapCm - a.stopDistCm) / (b.stopDistCm - a.stopDistCm);
+            return a.pwm + (int)(t * (b.pwm - a.pwm));
+        }
+    }
+    return 255;
+}
@@ -0,0 +1,139 @@
+#ifndef COLLISION_GUARD_H
+#define COLLISION_GUARD_H
+
+#include <stdint.h>
+
+/**
+ * Time-to-collision (TTC) guard for the front ultrasonic range
+ *
+ * Replaces the fixed "closer than 10 cm" emergency stop with a model that
+ * knows how fast the robot is closing on an obstacle and how far it needs
+ * to stop from that speed.
+ *
+ * Closing velocity is the larger of:
+ * - Wheel speed measured by the encoders (if available)
+ * - Range rate from consecutive front samples
+ * - Speed predicted from the commanded PWM (calibration table)
+ *
+ * Braking distance is interpolated from a per-PWM calibration table
+ * (steady speed + measured stopping distance for the L298N drive).
+ *
+ * Graded responses (see CollisionLevel):
+ * - CAP:   limit forward PWM so the robot can still stop in the remaining gap
+ * - STOP:  controlled stop, released automatically once the gap opens up
+ * - LATCH: cannot stop in time - latched emergency, operator reset required
+ *
+ * Pure logic (no Arduino calls) so approach scenarios can be scripted on host.
+ */
+
+enum CollisionLevel
+{
+    COLLISION_CLEAR,
+    COLLISION_CAP,
+    COLLISION_STOP,
+    COLLISION_LATCH
+};
+
+class CollisionGuard
+{
+public:
+    /**
+     * One calibration point for the drive: at this forward PWM the robot
+     * settles at speedCmS and needs stopDistCm to come to rest after a
+     * stop command (reaction + braking).
+     */
+    struct BrakePoint
+    {
+        int pwm;
+        float speedCmS;
+        float stopDistCm;
+    };
+
+    static constexpr uint8_t MAX_BRAKE_POINTS = 8;
+
+    CollisionGuard();
+
+    /**
+     * Replace the braking calibration table
+     * Points must be sorted by ascending pwm (and speed). Extra points are ignored.
+     */
+    void setBrakeTable(const BrakePoint *points, uint8_t count);
+
+    /**
+     * Evaluate one control tick
+     * @param frontDistCm      Latest front range (<= 0 = no valid reading)
+     * @param nowMs            Timestamp of this evaluation
+     * @param commandedPwm     Requested forward drive, before any limit (negative = reversing)
+     * @param measuredSpeedCmS Forward wheel speed from encoders, < 0 if unavailable
+     * @return Current response level
+     */
+    CollisionLevel update(float frontDistCm, unsigned long nowMs,
+                          int commandedPwm, float measuredSpeedCmS = -1.0f);
+
+    /**
+     * Deliberate contact (climbing an edge)
+     * Pushing on what is in front is the point, so the standoff floor and
+     * the CAP/STOP margins are waived and closing speed comes from the
+     * range rate alone (the wheels may be slipping). A range closing faster
+     * than maxClosingCmS still latches.
+     */
+    void setContactMode(bool enabled, float maxClosingCmS);
+    bool isContactMode() const { return _contact; }
+
+    // ========================================
+    // STATUS
+    // ========================================
+    CollisionLevel getLevel() const { return _level; }
+    bool isLatched() const { return _level == COLLISION_LATCH; }
+
+    /**
+     * Maximum forward PWM allowed right now (255 when clear, 0 when stopping)
+     */
+    int getSpeedLimit() const { return _speedLimit; }
+
+    float getClosingSpeed() const { return _closingSpeed; }
+    float getBrakingDistance() const { return _brakingDist; }
+
+    /**
+     * Time to collision in seconds (large value when not closing)
+     */
+    float getTimeToCollision() const { return _ttc; }
+
+    /**
+     * Clear latch and motion history (operator reset)
+     */
+    void reset();
+
+    // Conversions against the calibration table
+    float speedForPwm(int pwm) const;
+    float stopDistanceForSpeed(float speedCmS) const;
+    int maxPwmForGap(float gapCm) const;
+
+private:
+    BrakePoint _table[MAX_BRAKE_POINTS];
+    uint8_t _tableSize;
+
+    CollisionLevel _level;
+    int _speedLimit;
+    float _closingSpeed;
+    float _brakingDist;
+    float _ttc;
+
+    // Deliberate contact
+    bool _contact;
+    float _contactMaxClosing;
+
+    // Range-rate estimation
+    float _lastDist;
+    unsigned long _lastDistTime;
+    float _rangeRate;
+    bool _haveLastDist;
+
+    // Hysteresis: time the condition has been below current level
+    unsigned long _relaxSince;
+    bool _relaxing;
+
+    CollisionLevel classify(float distCm, float closingSpeed, int commandedPwm) const;
+};
+
+#endif // COLLISION_GUARD_H
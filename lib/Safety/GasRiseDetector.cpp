@@ -0,0 +1,201 @@
+#include "GasRiseDetector.h"
+
+// Binning
+static const unsigned long BIN_MS = 250;
+
+// Baseline tracking
+static const float BASELINE_WARMUP_TAU_S = 2.0f;    // Converge fast while warming up
+static const float BASELINE_FALL_TAU_S = 30.0f;     // Follow drops (sensor recovering)
+static const float BASELINE_RISE_TAU_S = 300.0f;    // Creep up with slow drift only
+static const float DRIFT_BAND = 15.0f;              // Above baseline+this, baseline is frozen
+
+// CUSUM (counts above baseline beyond the allowance, integrated over time)
+static const float CUSUM_ALLOWANCE = 10.0f;
+static const float CUSUM_WATCH = 100.0f;
+static const float CUSUM_WARNING = 400.0f;
+
+// Slope (counts/s over the window); a rise must also clear the baseline
+static const float SLOPE_WATCH = 3.0f;
+static const float SLOPE_WARNING = 8.0f;
+static const float MIN_EXCESS = 10.0f;
+
+// Projection to the absolute threshold
+static const float ALARM_TIME_TO_THRESHOLD_S = 10.0f;
+static const float TTT_INFINITE_S = 999.0f;
+
+// De-escalation only after the lower level held this long
+static const unsigned long RELAX_HOLD_MS = 5000;
+
+GasRiseDetector::GasRiseDetector(float absoluteThreshold, unsigned long warmupMs)
+    : _threshold(absoluteThreshold), _warmupMs(warmupMs)
+{
+    reset();
+}
+
+void GasRiseDetector::reset()
+{
+    _started = false;
+    _startTime = 0;
+    _binStart = 0;
+    _binSum = 0;
+    _binCount = 0;
+    _binHead = 0;
+    _binFill = 0;
+    _warmedUp = false;
+    _baseline = 0;
+    _slope = 0;
+    _cusum = 0;
+    _timeToThreshold = TTT_INFINITE_S;
+    _level = GAS_RISE_NONE;
+    _relaxSince = 0;
+    _relaxing = false;
+}
+
+GasRiseLevel GasRiseDetector::update(float reading, unsigned long nowMs)
+{
+    if (!_started)
+    {
+        _started = true;
+        _startTime = nowMs;
+        _binStart = nowMs;
+        _baseline = reading;
+    }
+
+    _binSum += reading;
+    _binCount++;
+
+    unsigned long binAge = nowMs - _binStart;
+    if (binAge >= BIN_MS)
+    {
+        float value = _binSum / _binCount;
+        float centreS = ((_binStart - _startTime) + binAge * 0.5f) / 1000.0f;
+        processBin(value, centreS, binAge / 1000.0f, nowMs);
+
+        _binStart = nowMs;
+        _binSum = 0;
+        _binCount = 0;
+    }
+
+    return _level;
+}
+
+void GasRiseDetector::processBin(float value, float timeS, float dtS, unsigned long nowMs)
+{
+    _binValue[_binHead] = value;
+    _binTime[_binHead] = timeS;
+    _binHead = (_binHead + 1) % WINDOW_BINS;
+    if (_binFill < WINDOW_BINS) _binFill++;
+
+    _slope = windowSlope();
+
+    // ----------------------------------------
+    // Warm-up: heater still settling, just learn the baseline
+    // ----------------------------------------
+    if (!_warmedUp)
+    {
+        _baseline += (value - _baseline) * (dtS / (BASELINE_WARMUP_TAU_S + dtS));
+        if (nowMs - _startTime >= _warmupMs && _binFill == WINDOW_BINS)
+        {
+            _warmedUp = true;
+            _cusum = 0;
+        }
+        return;
+    }
+
+    // ----------------------------------------
+    // Baseline drift tracking
+    // ----------------------------------------
+    if (value < _baseline)
+    {
+        _baseline += (value - _baseline) * (dtS / (BASELINE_FALL_TAU_S + dtS));
+    }
+    else if (_level == GAS_RISE_NONE && value - _baseline < DRIFT_BAND)
+    {
+        _baseline += (value - _baseline) * (dtS / (BASELINE_RISE_TAU_S + dtS));
+    }
+
+    // ----------------------------------------
+    // CUSUM of excess over baseline
+    // ----------------------------------------
+    _cusum += (value - _baseline - CUSUM_ALLOWANCE) * dtS;
+    if (_cusum < 0) _cusum = 0;
+
+    // ----------------------------------------
+    // Projection to the absolute threshold
+    // ----------------------------------------
+    if (_slope > 0.1f && value < _threshold)
+        _timeToThreshold = (_threshold - value) / _slope;
+    else
+        _timeToThreshold = (value >= _threshold) ? 0.0f : TTT_INFINITE_S;
+
+    // ----------------------------------------
+    // Escalate immediately, relax with hold time
+    // ----------------------------------------
+    GasRiseLevel wanted = classify(value);
+    if (wanted >= _level)
+    {
+        _level = wanted;
+        _relaxing = false;
+    }
+    else if (!_relaxing)
+    {
+        _relaxing = true;
+        _relaxSince = nowMs;
+    }
+    else if (nowMs - _relaxSince >= RELAX_HOLD_MS)
+    {
+        // Step down one level at a time
+        _level = (GasRiseLevel)(_level - 1);
+        _relaxSince = nowMs;
+        if (_level == wanted) _relaxing = false;
+    }
+}
+
+float GasRiseDetector::windowSlope() const
+{
+    if (_binFill < 3) return 0.0f;
+
+    // Least squares over the filled part of the ring
+    float meanT = 0, meanV = 0;
+    for (uint8_t i = 0; i < _binFill; i++)
+    {
+        meanT += _binTime[i];
+        meanV += _binValue[i];
+    }
+    meanT /= _binFill;
+    meanV /= _binFill;
+
+    float num = 0, den = 0;
+    for (uint8_t i = 0; i < _binFill; i++)
+    {
+        float dt = _binTime[i] - meanT;
+        num += dt * (_binValue[i] - meanV);
+        den += dt * dt;
+    }
+    return (den > 0) ? num / den : 0.0f;
+}
+
+GasRiseLevel GasRiseDetector::classify(float value) const
+{
+    float excess = value - _baseline;
+    bool rising = excess > MIN_EXCESS;
+
+    if (rising && _slope >= SLOPE_WATCH && _timeToThreshold < ALARM_TIME_TO_THRESHOLD_S)
+        return GAS_RISE_ALARM;
+    if ((rising && _slope >= SLOPE_WARNING) || _cusum >= CUSUM_WARNING)
+        return GAS_RISE_WARNING;
+    if ((rising && _slope >= SLOPE_WATCH) || _cusum >= CUSUM_WATCH)
+        return GAS_RISE_WATCH;
+    return GAS_RISE_NONE;
+}
+
+const char *GasRiseDetector::getLevelName() const
+{
+    switch (_level)
+    {
+        case GAS_RISE_WATCH:   return "watch";
+        case GAS_RISE_WARNING: return "warning";
+        case GAS_RISE_ALARM:   return "alarm";
+        default:               return "none";
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef GAS_RISE_DETECTOR_H
+#define GAS_RISE_DETECTOR_H
+
+#include <stdint.h>
+
+/**
+ * Streaming rate-of-rise detector for the MQ-2 gas reading
+ *
+ * In a fire the rise rate shows up well before the absolute emergency
+ * threshold. Three detectors run on 250 ms bins of the reading:
+ * - Slope: least-squares fit over a sliding 4 s window (counts/s)
+ * - CUSUM: accumulated excess over the baseline beyond an allowance,
+ *   catches slow sustained rises the slope window misses
+ * - Projection: time until the absolute threshold at the current slope
+ *
+ * The baseline tracks sensor drift (heater, humidity, temperature): it
+ * follows drops quickly, creeps up slowly only while nothing is flagged,
+ * and is frozen during a rise so a slow fire isn't absorbed into it.
+ *
+ * No warnings during the heater warm-up period; the baseline converges
+ * quickly instead. Escalation is immediate, de-escalation needs a hold.
+ *
+ * Pure logic (no Arduino calls) so gas curves can be replayed on host.
+ */
+
+enum GasRiseLevel
+{
+    GAS_RISE_NONE,
+    GAS_RISE_WATCH,     // Sustained rise above baseline
+    GAS_RISE_WARNING,   // Fast rise
+    GAS_RISE_ALARM      // Threshold projected within seconds
+};
+
+class GasRiseDetector
+{
+public:
+    static constexpr uint8_t WINDOW_BINS = 16;
+
+    /**
+     * @param absoluteThreshold Emergency level the projection aims at (counts)
+     * @param warmupMs Heater warm-up period without warnings
+     */
+    GasRiseDetector(float absoluteThreshold, unsigned long warmupMs = 30000);
+
+    /**
+     * Feed one reading (any rate; samples are binned by timestamp)
+     */
+    GasRiseLevel update(float reading, unsigned long nowMs);
+
+    GasRiseLevel getLevel() const { return _level; }
+    bool isWarmedUp() const { return _warmedUp; }
+
+    float getBaseline() const { return _baseline; }
+    float getSlope() const { return _slope; }             // counts/s
+    float getCusum() const { return _cusum; }             // counts*s
+    float getTimeToThreshold() const { return _timeToThreshold; } // s, large if not rising
+
+    /**
+     * Short description of the current level
+     */
+    const char *getLevelName() const;
+
+    void reset();
+
+private:
+    float _threshold;
+    unsigned long _warmupMs;
+
+    // Binning
+    bool _started;
+    unsigned long _startTime;
+    unsigned long _binStart;
+    float _binSum;
+    uint16_t _binCount;
+
+    // Sliding window of bin means
+    float _binValue[WINDOW_BINS];
+    float _binTime[WINDOW_BINS];  // Seconds since start (bin centre)
+    uint8_t _binHead;
+    uint8_t _binFill;
+
+    // Detector state
+    bool _warmedUp;
+    float _baseline;
+    float _slope;
+    float _cusum;
+    float _timeToThreshold;
+
+    GasRiseLevel _level;
+    unsigned long _relaxSince;
+    bool _relaxing;
+
+    void processBin(float value, float timeS, float dtS, unsigned long nowMs);
+    float windowSlope() const;
+    GasRiseLevel classify(float value) const;
+};
+
+#endif // GAS_RISE_DETECTOR_H
@@ -1,16 +1,148 @@
 #include "SafetyManager.h"
 
+// Forward speed allowed while the front range cannot be trusted
+static const int RANGE_BLIND_SPEED_LIMIT = 70;
+
+// Stall protection (stall current heats the motors and the L298N)
+static const unsigned long STALL_DERATE_MS = 250;    // Stalled this long -> derate that direction
+static const int STALL_DERATE_LIMIT = 90;            // PWM cap while derated
+static const unsigned long STALL_HOLD_MS = 1500;     // Still stalled -> hold that direction
+static const unsigned long STALL_COOLDOWN_MS = 2000; // Hold time before a retry is allowed
+
 SafetyManager::SafetyManager() 
-    : _emergencyActive(false), _currentHazard(HAZARD_NONE), _hazardDesc("OK")
+    : _emergencyActive(false), _currentHazard(HAZARD_NONE), _hazardDesc("OK"),
+      _gasRise(GAS_THRESHOLD_EMERGENCY), _reportedGasLevel(GAS_RISE_NONE), _gasWarningPending(false),
+      _commandedPwm(0), _measuredSpeed(-1.0f), _frontConfidence(1.0f),
+      _linkLimit(255), _linkChanged(false), _linkDesc(""),
+      _stallDir(0), _stallMs(0), _stallHoldDir(0), _stallHoldSince(0), _stallChanged(false)
+{
+}
+
+void SafetyManager::setMotion(int commandedPwm, float measuredSpeedCmS)
+{
+    _commandedPwm = commandedPwm;
+    _measuredSpeed = measuredSpeedCmS;
+}
+
+void SafetyManager::setRangeQuality(float frontConfidence)
+{
+    _frontConfidence = frontConfidence;
+}
+
+void SafetyManager::setLinkStates(LinkState front, LinkState dashboard)
+{
+    int limit = 255;
+    String desc = "";
+
+    struct { bool required; LinkState state; const char *name; } links[] = {
+        {LINK_REQUIRE_FRONT != 0, front, "front"},
+        {LINK_REQUIRE_DASHBOARD != 0, dashboard, "dashboard"},
+    };
+
+    for (auto &link : links)
+    {
+        if (!link.required) continue;
+
+        if (link.state == LINK_LOST)
+        {
+            limit = 0;
+            desc = String("LINK LOST - ") + link.name;
+        }
+        else if (link.state == LINK_DEGRADED && limit > LINK_DEGRADED_SPEED_LIMIT)
+        {
+            limit = LINK_DEGRADED_SPEED_LIMIT;
+            if (desc.length() == 0) desc = String("LINK DEGRADED - ") + link.name;
+        }
+    }
+
+    if (limit != _linkLimit) _linkChanged = true;
+    _linkLimit = limit;
+    _linkDesc = desc;
+}
+
+void SafetyManager::setStall(int8_t direction, unsigned long stalledMs)
+{
+    _stallDir = direction;
+    _stallMs = stalledMs;
+}
+
+void SafetyManager::updateStall(unsigned long nowMs)
+{
+    if (_stallHoldDir != 0)
+    {
+        if (nowMs - _stallHoldSince >= STALL_COOLDOWN_MS)
+        {
+            _stallHoldDir = 0;
+            _stallChanged = true;
+        }
+    }
+    else if (_stallDir != 0 && _stallMs >= STALL_HOLD_MS)
+    {
+        _stallHoldDir = _stallDir;
+        _stallHoldSince = nowMs;
+        _stallChanged = true;
+    }
+}
+
+int SafetyManager::stallLimit(int8_t direction) const
+{
+    if (_stallHoldDir == direction) return 0;
+    if (_stallDir == direction && _stallMs >= STALL_DERATE_MS) return STALL_DERATE_LIMIT;
+    return 255;
+}
+
+bool SafetyManager::consumeStallChange()
+{
+    bool changed = _stallChanged;
+    _stallChanged = false;
+    return changed;
+}
+
+bool SafetyManager::consumeLinkChange()
+{
+    bool changed = _linkChanged;
+    _linkChanged = false;
+    return changed;
+}
+
+int SafetyManager::getSpeedLimit() const
 {
+    int limit = _collision.getSpeedLimit();
+    if (_linkLimit < limit) limit = _linkLimit;
+    if (stallLimit(1) < limit) limit = stallLimit(1);
+
+    // Degraded range: scale from blind creep (stale) up to full at the confidence floor
+    if (_frontConfidence < US_MIN_CONFIDENCE)
+    {
+        float t = (_frontConfidence > 0.0f) ? _frontConfidence / US_MIN_CONFIDENCE : 0.0f;
+        int rangeLimit = RANGE_BLIND_SPEED_LIMIT + (int)(t * (255 - RANGE_BLIND_SPEED_LIMIT));
+        if (rangeLimit < limit) limit = rangeLimit;
+    }
+    return limit;
+}
+
+int SafetyManager::getReverseLimit() const
+{
+    int limit = stallLimit(-1);
+    return (_linkLimit < limit) ? _linkLimit : limit;
 }
 
 bool SafetyManager::check(int gasLevel, float frontDist)
+{
+    return check(gasLevel, frontDist, millis());
+}
+
+bool SafetyManager::check(int gasLevel, float frontDist, unsigned long nowMs)
 {
     // If already in emergency, stay there unless reset manually (latched safety)
     if (_emergencyActive) return false;
 
     // Check 1: Gas/Smoke Detection
+    // Rate-of-rise detector runs first so it keeps its history across the trip
+    GasRiseLevel rise = _gasRise.update(gasLevel, nowMs);
+    if (rise > _reportedGasLevel) _gasWarningPending = true;
+    _reportedGasLevel = rise;
+
     if (gasLevel >= GAS_THRESHOLD_EMERGENCY) {
         _emergencyActive = true;
         _currentHazard = HAZARD_GAS;
@@ -18,23 +150,52 @@ bool SafetyManager::check(int gasLevel, float frontDist)
         return false;
     }
 
-    // Check 2: Critical Distance - Collision Imminent
-    // P1 Fix #4: Increased to 10cm to account for EMA filter lag
-    // At 2m/s approach speed, 100ms filter lag = 20cm positioning error
-    // frontDist > 0 ensures we have a valid reading (not timeout/error)
-    if (frontDist > 0.0f && frontDist < 10.0f) {
+    // Check 2: Time-to-collision - latch only when we can no longer stop in time
+    // Lower levels (speed cap, controlled stop) are exposed via getSpeedLimit()
+    // frontDist > 0 ensures we have a valid reading (not timeout/error/stale)
+    if (_collision.update(frontDist, nowMs, _commandedPwm, _measuredSpeed) == COLLISION_LATCH) {
         _emergencyActive = true;
         _currentHazard = HAZARD_OBSTACLE_CRITICAL;
         _hazardDesc = "COLLISION IMMINENT - EMERGENCY STOP";
         return false;
     }
 
+    updateStall(nowMs);
+
+    // Lost link: motion held by the speed limits, released on recovery
+    if (_linkLimit == 0) {
+        _currentHazard = HAZARD_CONNECTION_LOST;
+        _hazardDesc = _linkDesc;
+        return true;
+    }
+
+    // Stalled wheels: one direction held by the speed limits, retried after a cool-down
+    if (_stallHoldDir != 0) {
+        _currentHazard = HAZARD_MOTOR_STALL;
+        _hazardDesc = (_stallHoldDir > 0) ? "MOTOR STALL - forward held" : "MOTOR STALL - reverse held";
+        return true;
+    }
+
+    // Graded gas warning: reported, not latched
+    if (rise != GAS_RISE_NONE) {
+        _currentHazard = HAZARD_GAS;
+        _hazardDesc = String("GAS RISING - ") + _gasRise.getLevelName();
+        return true;
+    }
+
     // All clear
     _currentHazard = HAZARD_NONE;
     _hazardDesc = "OK";
     return true;
 }
 
+bool SafetyManager::consumeGasWarning()
+{
+    bool pending = _gasWarningPending;
+    _gasWarningPending = false;
+    return pending;
+}
+
 bool SafetyManager::isEmergency() const
 {
     return _emergencyActive;
@@ -52,7 +213,10 @@ String SafetyManager::getHazardDescription() const
 
 void SafetyManager::reset()
 {
+    _collision.reset();
+    // Gas rise detector keeps its baseline - no second warm-up after a reset
     _emergencyActive = false;
+    _stallHoldDir = 0;
     _currentHazard = HAZARD_NONE;
     _hazardDesc = "OK";
 }
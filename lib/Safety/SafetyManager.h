@@ -3,12 +3,17 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "CollisionGuard.h"
+#include "GasRiseDetector.h"
+#include "LinkSupervisor.h"
 
 enum HazardType {
     HAZARD_NONE,
     HAZARD_GAS,
     HAZARD_OBSTACLE_CRITICAL, // Too close to move
-    HAZARD_CONNECTION_LOST    // Future usage
+    HAZARD_CONNECTION_LOST,   // Required link lost - motion held until it recovers
+    HAZARD_CONTROL_STALL,     // loop() stopped servicing the drive - outputs cut by the supervisor
+    HAZARD_MOTOR_STALL        // Wheels stalled too long - that direction held while the motors cool
 };
 
 class SafetyManager
@@ -17,19 +22,120 @@ public:
     SafetyManager();
 
     // Main check method
-    // Returns true if SAFE, false if HAZARD
+    // Returns true if SAFE, false if HAZARD (latched)
     bool check(int gasLevel, float frontDist = 100.0f);
+    bool check(int gasLevel, float frontDist, unsigned long nowMs);
+
+    /**
+     * Feed drive state for time-to-collision evaluation (call before check)
+     * @param commandedPwm Requested forward drive before any limit (average of both sides)
+     * @param measuredSpeedCmS Forward speed from encoders, < 0 if unavailable
+     */
+    void setMotion(int commandedPwm, float measuredSpeedCmS = -1.0f);
+
+    /**
+     * Feed front range quality (call before check)
+     * A stale or low-confidence range caps forward speed to a creep instead
+     * of trusting a distance that may be frozen.
+     * @param frontConfidence 0.0 (stale) .. 1.0 (fresh and consistent)
+     */
+    void setRangeQuality(float frontConfidence);
 
     bool isEmergency() const;
     HazardType getHazardType() const;
     String getHazardDescription() const;
 
+    /**
+     * Feed link health (call before check)
+     * Policy (config.h LINK_REQUIRE_*): a degraded required link caps speed,
+     * a lost one holds all motion. Not latched - resumes on recovery.
+     */
+    void setLinkStates(LinkState front, LinkState dashboard);
+
+    /**
+     * Motion is held because a required link is lost
+     */
+    bool isLinkLost() const { return _linkLimit == 0; }
+    int getLinkLimit() const { return _linkLimit; }     // PWM cap from link health alone
+
+    /**
+     * True once per change of the link policy output (lost / degraded / ok)
+     */
+    bool consumeLinkChange();
+    String getLinkDescription() const { return _linkDesc.length() ? _linkDesc : String("LINK OK"); }
+
+    /**
+     * Feed wheel stall state from the StallDetector (call before check)
+     * A stall derates the stalled direction after a moment; one that keeps
+     * going holds that direction for a cool-down, then allows a retry.
+     * The other direction stays free so recovery can back out.
+     * @param direction Direction the stalled wheels push (+1 / -1, 0 = none)
+     */
+    void setStall(int8_t direction, unsigned long stalledMs);
+
+    /**
+     * Direction currently held for a stall (+1 / -1, 0 = none)
+     */
+    int8_t getStallHold() const { return _stallHoldDir; }
+
+    /**
+     * True once per start / end of a stall hold
+     */
+    bool consumeStallChange();
+
+    /**
+     * Navigation is climbing an edge (call before check)
+     * The collision guard allows contact with the edge ahead; only a range
+     * closing faster than CLIMB_MAX_CLOSING_CM_S still latches.
+     */
+    void setClimbing(bool climbing) { _collision.setContactMode(climbing, CLIMB_MAX_CLOSING_CM_S); }
+
+    // Graded gas warnings (rate of rise, before the absolute threshold)
+    GasRiseLevel getGasRiseLevel() const { return _gasRise.getLevel(); }
+    const GasRiseDetector &getGasRiseDetector() const { return _gasRise; }
+
+    /**
+     * True once per escalation of the gas rise level (for broadcasting a
+     * non-critical warning); de-escalation is silent
+     */
+    bool consumeGasWarning();
+
+    // Graded collision response (non-latched levels)
+    CollisionLevel getCollisionLevel() const { return _collision.getLevel(); }
+    int getSpeedLimit() const;      // Forward PWM limit (collision, range, link)
+    int getReverseLimit() const;    // Reverse PWM limit (link, stall)
+    bool isRangeDegraded() const { return _frontConfidence < US_MIN_CONFIDENCE; }
+    const CollisionGuard &getCollisionGuard() const { return _collision; }
+
     void reset();
 
 private:
     bool _emergencyActive;
     HazardType _currentHazard;
     String _hazardDesc;
+
+    CollisionGuard _collision;
+    GasRiseDetector _gasRise;
+    GasRiseLevel _reportedGasLevel;
+    bool _gasWarningPending;
+    int _commandedPwm;
+    float _measuredSpeed;
+    float _frontConfidence;
+
+    // Link policy
+    int _linkLimit;
+    bool _linkChanged;
+    String _linkDesc;
+
+    // Stall protection
+    int8_t _stallDir;
+    unsigned long _stallMs;
+    int8_t _stallHoldDir;
+    unsigned long _stallHoldSince;
+    bool _stallChanged;
+
+    void updateStall(unsigned long nowMs);
+    int stallLimit(int8_t direction) const;
 };
 
 #endif
@@ -0,0 +1,150 @@
+#include "SafetySupervisor.h"
+
+static const uint32_t TASK_STACK_BYTES = 4096;
+
+SafetySupervisor::SafetySupervisor()
+    : _motors(nullptr), _sensors(nullptr), _task(nullptr),
+      _commandedPwm(0), _measuredSpeed(-1.0f), _climbing(false), _lastFeedMs(0), _resetRequested(false),
+      _tripped(false), _tripPending(false), _stallPending(false), _tripHazard(HAZARD_NONE),
+      _stallCut(false), _lastTickUs(0), _stats()
+{
+    _tripDesc[0] = '\0';
+}
+
+bool SafetySupervisor::begin(L298N *motors, SensorManager *sensors)
+{
+    _motors = motors;
+    _sensors = sensors;
+    _lastFeedMs = millis();
+
+    BaseType_t ok = xTaskCreatePinnedToCore(taskEntry, "safety", TASK_STACK_BYTES, this,
+                                            SAFETY_TASK_PRIORITY, &_task, SAFETY_TASK_CORE);
+    if (ok != pdPASS)
+    {
+        DEBUG_PRINTLN("[Safety] ERROR: supervisor task not created");
+        return false;
+    }
+
+    DEBUG_PRINTF("[Safety] Supervisor running every %d ms (prio %d, core %d)\n",
+                 SAFETY_SUPERVISOR_PERIOD_MS, SAFETY_TASK_PRIORITY, SAFETY_TASK_CORE);
+    return true;
+}
+
+void SafetySupervisor::setMotion(int commandedPwm, float measuredSpeedCmS)
+{
+    _commandedPwm = commandedPwm;
+    _measuredSpeed = measuredSpeedCmS;
+}
+
+bool SafetySupervisor::consumeTrip()
+{
+    bool pending = _tripPending;
+    _tripPending = false;
+    return pending;
+}
+
+bool SafetySupervisor::consumeStallCut()
+{
+    bool pending = _stallPending;
+    _stallPending = false;
+    return pending;
+}
+
+// ============================================
+// SUPERVISOR TASK
+// ============================================
+
+void SafetySupervisor::taskEntry(void *arg)
+{
+    static_cast<SafetySupervisor *>(arg)->taskLoop();
+}
+
+void SafetySupervisor::taskLoop()
+{
+    TickType_t lastWake = xTaskGetTickCount();
+    for (;;)
+    {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(SAFETY_SUPERVISOR_PERIOD_MS));
+        tick();
+    }
+}
+
+void SafetySupervisor::tick()
+{
+    uint32_t nowUs = micros();
+    if (_stats.ticks > 0 && nowUs - _lastTickUs > _stats.maxPeriodUs)
+    {
+        _stats.maxPeriodUs = nowUs - _lastTickUs;
+    }
+    _lastTickUs = nowUs;
+    _stats.ticks++;
+
+    if (_resetRequested)
+    {
+        _resetRequested = false;
+        _rules.reset();
+        _tripped = false;
+        _tripHazard = HAZARD_NONE;
+        _tripDesc[0] = '\0';
+        if (!_stallCut) _motors->releaseCut();
+    }
+
+    // ----------------------------------------
+    // Rules on the latest raw readings
+    // ----------------------------------------
+    SensorManager::SafetySnapshot snap;
+    _sensors->getSafetySnapshot(snap);
+
+    if (!_tripped && snap.gasLevel >= 0)
+    {
+        _rules.setMotion(_commandedPwm, _measuredSpeed);
+        _rules.setClimbing(_climbing);
+        if (!_rules.check(snap.gasLevel, snap.frontCm, millis()))
+        {
+            HazardType hazard = _rules.getHazardType();
+            uint32_t sampleUs = (hazard == HAZARD_GAS) ? snap.gasUs : snap.frontUs;
+            trip(hazard, _rules.getHazardDescription().c_str(), sampleUs);
+        }
+    }
+
+    // ----------------------------------------
+    // loop() stall while driving
+    // ----------------------------------------
+    uint32_t gapMs = millis() - _lastFeedMs;
+    if (gapMs > _stats.maxLoopGapMs) _stats.maxLoopGapMs = gapMs;
+
+    if (gapMs > SAFETY_LOOP_STALL_MS)
+    {
+        if (!_stallCut && _motors->isMoving())
+        {
+            _motors->cutOutputs();
+            _stallCut = true;
+            _stats.stalls++;
+            _stallPending = true;
+        }
+    }
+    else if (_stallCut)
+    {
+        _stallCut = false;
+        if (!_tripped) _motors->releaseCut();
+    }
+}
+
+void SafetySupervisor::trip(HazardType hazard, const char *description, uint32_t sampleUs)
+{
+    uint32_t decideUs = micros();
+    _motors->cutOutputs();
+    uint32_t cutUs = micros();
+
+    uint32_t latency = cutUs - sampleUs;
+    _stats.trips++;
+    _stats.lastLatencyUs = latency;
+    if (latency > _stats.maxLatencyUs) _stats.maxLatencyUs = latency;
+    if (cutUs - decideUs > _stats.maxCutUs) _stats.maxCutUs = cutUs - decideUs;
+
+    strncpy(_tripDesc, description, sizeof(_tripDesc) - 1);
+    _tripDesc[sizeof(_tripDesc) - 1] = '\0';
+    _tripHazard = hazard;
+    _tripped = true;
+    _tripPending = true;
+}
@@ -0,0 +1,125 @@
+#ifndef SAFETY_SUPERVISOR_H
+#define SAFETY_SUPERVISOR_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "SafetyManager.h"
+#include "SensorManager.h"
+#include "L298N.h"
+
+/**
+ * Independent safety supervisor (rear board)
+ *
+ * - Own FreeRTOS task, woken every SAFETY_SUPERVISOR_PERIOD_MS on the same
+ *   core as loop() at a higher priority, so a slow WebSocket callback or a
+ *   heap stall in loop() can't delay it
+ * - Reads SensorManager's safety snapshot (raw echoes + gas backend) and
+ *   evaluates the SafetyManager rules on its own instance
+ * - On a hazard it cuts the rear L298N outputs directly and flags the
+ *   trip for loop(), which tells the front board (the WebSocket server
+ *   is not safe to call from this task). Latched until reset().
+ * - If loop() stops checking in for SAFETY_LOOP_STALL_MS while driving,
+ *   the outputs are cut until it resumes (not latched)
+ *
+ * Latency is measured from the timestamp of the sample that tripped the
+ * rule to the moment the outputs are low.
+ */
+class SafetySupervisor
+{
+public:
+    struct Stats
+    {
+        uint32_t ticks;
+        uint32_t trips;
+        uint32_t stalls;
+        uint32_t lastLatencyUs;     // Sample -> outputs cut, last trip
+        uint32_t maxLatencyUs;      // Worst sample -> outputs cut
+        uint32_t maxCutUs;          // Worst decision -> outputs cut
+        uint32_t maxPeriodUs;       // Worst gap between supervisor ticks
+        uint32_t maxLoopGapMs;      // Longest loop() silence seen
+    };
+
+    SafetySupervisor();
+
+    /**
+     * Start the supervisor task
+     * @return false if the task could not be created
+     */
+    bool begin(L298N *motors, SensorManager *sensors);
+
+    /**
+     * Drive state from loop() (call whenever the motors are commanded)
+     * @param commandedPwm Requested forward drive before any limit (average of both sides)
+     * @param measuredSpeedCmS Forward speed from encoders, < 0 if unavailable
+     */
+    void setMotion(int commandedPwm, float measuredSpeedCmS = -1.0f);
+
+    /**
+     * Navigation is climbing an edge (see SafetyManager::setClimbing)
+     */
+    void setClimbing(bool climbing) { _climbing = climbing; }
+
+    /**
+     * loop() heartbeat (call once per pass)
+     */
+    void feedLoop() { _lastFeedMs = millis(); }
+
+    /**
+     * Latched trip active (outputs cut until reset())
+     */
+    bool isTripped() const { return _tripped; }
+
+    /**
+     * True once after each latched trip (for loop() to follow up)
+     */
+    bool consumeTrip();
+
+    /**
+     * True once after each loop-stall cut (seen when loop() runs again)
+     */
+    bool consumeStallCut();
+
+    HazardType getTripHazard() const { return _tripHazard; }
+    const char *getTripDescription() const { return _tripDesc; }
+
+    /**
+     * Operator reset - clears the latch and releases the outputs on the
+     * next supervisor tick
+     */
+    void reset() { _resetRequested = true; }
+
+    const Stats &getStats() const { return _stats; }
+
+private:
+    L298N *_motors;
+    SensorManager *_sensors;
+    TaskHandle_t _task;
+
+    // Rules - only touched by the supervisor task
+    SafetyManager _rules;
+
+    // loop() -> task
+    volatile int _commandedPwm;
+    volatile float _measuredSpeed;
+    volatile bool _climbing;
+    volatile uint32_t _lastFeedMs;
+    volatile bool _resetRequested;
+
+    // task -> loop()
+    volatile bool _tripped;
+    volatile bool _tripPending;
+    volatile bool _stallPending;
+    volatile HazardType _tripHazard;
+    char _tripDesc[48];
+
+    bool _stallCut;
+    uint32_t _lastTickUs;
+    Stats _stats;
+
+    static void taskEntry(void *arg);
+    void taskLoop();
+    void tick();
+    void trip(HazardType hazard, const char *description, uint32_t sampleUs);
+};
+
+#endif // SAFETY_SUPERVISOR_H
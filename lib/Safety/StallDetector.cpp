@@ -0,0 +1,234 @@
+#include "StallDetector.h"
+
+// Motor model
+static const float MODEL_TAU_S = 0.08f;         // Spin-up time constant, loaded
+
+// Judgement window
+static const uint32_t WINDOW_MS = 100;          // Counts are compared over this span
+static const uint32_t SETTLE_MS = 150;          // No verdict this soon after a (re)start
+static const float MIN_EXPECTED_COUNTS = 6.0f;  // Below this the counts are too coarse to judge
+static const uint32_t MAX_GAP_MS = 250;         // Longer sample gaps start every wheel fresh
+
+// Classification (measured / expected), with hysteresis on the way out
+static const float STALL_RATIO = 0.2f;
+static const float STALL_CLEAR_RATIO = 0.45f;
+static const float FREE_SPIN_RATIO = 1.5f;
+static const float FREE_SPIN_CLEAR_RATIO = 1.3f;
+static const float SLIP_MARGIN = 0.4f;          // Ratio lead over the partner wheel
+
+StallDetector::StallDetector(float fullScaleCountsPerSec)
+    : _fullScaleCps(fullScaleCountsPerSec), _started(false), _lastMs(0),
+      _stallEvents(0), _freeSpinEvents(0), _slipEvents(0)
+{
+    reset();
+}
+
+void StallDetector::reset()
+{
+    for (uint8_t i = 0; i < WHEELS; i++)
+    {
+        restart(_wheels[i], 0, 0);
+        _wheels[i].state = TRACTION_OK;
+        _wheels[i].stallSinceMs = 0;
+    }
+    _started = false;
+}
+
+void StallDetector::restart(Wheel &w, int8_t direction, int32_t counts)
+{
+    w.head = 0;
+    w.fill = 0;
+    w.coveredMs = 0;
+    w.modelCps = 0.0f;
+    w.direction = direction;
+    w.lastCounts = counts;
+    w.ratio = 1.0f;
+    w.judged = false;
+}
+
+void StallDetector::setState(Wheel &w, TractionState state, uint32_t nowMs)
+{
+    if (state == w.state) return;
+
+    if (state == TRACTION_STALL)
+    {
+        w.stallSinceMs = nowMs;
+        _stallEvents++;
+    }
+    else if (state == TRACTION_FREE_SPIN)
+    {
+        _freeSpinEvents++;
+    }
+    else if (state == TRACTION_SLIP)
+    {
+        _slipEvents++;
+    }
+    w.state = state;
+}
+
+// ============================================
+// UPDATE
+// ============================================
+
+void StallDetector::update(const int *commands, const int32_t *counts, bool valid, uint32_t nowMs)
+{
+    uint32_t dtMs = nowMs - _lastMs;
+    if (!_started || !valid || dtMs > MAX_GAP_MS)
+    {
+        for (uint8_t i = 0; i < WHEELS; i++)
+        {
+            restart(_wheels[i], (commands[i] > 0) - (commands[i] < 0), counts[i]);
+            setState(_wheels[i], TRACTION_OK, nowMs);
+        }
+        _started = valid;
+        _lastMs = nowMs;
+        return;
+    }
+    if (dtMs == 0) return;
+    _lastMs = nowMs;
+
+    float dt = dtMs / 1000.0f;
+    float alpha = dt / (MODEL_TAU_S + dt);
+
+    for (uint8_t i = 0; i < WHEELS; i++)
+    {
+        Wheel &w = _wheels[i];
+        int8_t direction = (commands[i] > 0) - (commands[i] < 0);
+
+        // Released or reversed: the old window says nothing about the new push
+        if (direction != w.direction || direction == 0)
+        {
+            restart(w, direction, counts[i]);
+            setState(w, TRACTION_OK, nowMs);
+            continue;
+        }
+
+        float target = commands[i] * _fullScaleCps / 255.0f;
+        w.modelCps += (target - w.modelCps) * alpha;
+
+        Sample &s = w.samples[w.head];
+        s.dtMs = (uint16_t)dtMs;
+        s.expected = w.modelCps * dt;
+        s.measured = counts[i] - w.lastCounts;
+        w.lastCounts = counts[i];
+        w.head = (w.head + 1) % MAX_SAMPLES;
+        if (w.fill < MAX_SAMPLES) w.fill++;
+        if (w.coveredMs < SETTLE_MS) w.coveredMs += dtMs;
+
+        // Newest samples back to the window length, in the push direction
+        float expected = 0.0f;
+        int32_t measured = 0;
+        uint32_t span = 0;
+        for (uint8_t k = 0; k < w.fill && span < WINDOW_MS; k++)
+        {
+            const Sample &old = w.samples[(w.head + MAX_SAMPLES - 1 - k) % MAX_SAMPLES];
+            expected += old.expected;
+            measured += old.measured;
+            span += old.dtMs;
+        }
+        expected *= direction;
+        measured *= direction;
+
+        w.judged = w.coveredMs >= SETTLE_MS && expected >= MIN_EXPECTED_COUNTS;
+        if (w.judged) w.ratio = measured / expected;
+    }
+
+    // Classify (unjudged wheels keep their verdict)
+    for (uint8_t i = 0; i < WHEELS; i++)
+    {
+        Wheel &w = _wheels[i];
+        if (!w.judged) continue;
+
+        TractionState next = TRACTION_OK;
+        float stallLimit = (w.state == TRACTION_STALL) ? STALL_CLEAR_RATIO : STALL_RATIO;
+        float spinLimit = (w.state == TRACTION_FREE_SPIN) ? FREE_SPIN_CLEAR_RATIO : FREE_SPIN_RATIO;
+        if (w.ratio < stallLimit)
+        {
+            next = TRACTION_STALL;
+        }
+        else if (w.ratio > spinLimit)
+        {
+            next = TRACTION_FREE_SPIN;
+        }
+        else
+        {
+            // Slip: clearly ahead of a partner pushing the same way
+            for (uint8_t j = 0; j < WHEELS; j++)
+            {
+                const Wheel &p = _wheels[j];
+                if (j == i || !p.judged || p.direction != w.direction) continue;
+                if (w.ratio - p.ratio > SLIP_MARGIN) next = TRACTION_SLIP;
+            }
+        }
+        setState(w, next, nowMs);
+    }
+}
+
+// ============================================
+// QUERIES
+// ============================================
+
+uint32_t StallDetector::getStallMs(uint8_t wheel, uint32_t nowMs) const
+{
+    const Wheel &w = _wheels[wheel];
+    return (w.state == TRACTION_STALL) ? nowMs - w.stallSinceMs : 0;
+}
+
+bool StallDetector::anyStalled() const
+{
+    for (uint8_t i = 0; i < WHEELS; i++)
+    {
+        if (_wheels[i].state == TRACTION_STALL) return true;
+    }
+    return false;
+}
+
+bool StallDetector::allFreeSpinning() const
+{
+    for (uint8_t i = 0; i < WHEELS; i++)
+    {
+        if (_wheels[i].state != TRACTION_FREE_SPIN) return false;
+    }
+    return true;
+}
+
+bool StallDetector::anySlipping() const
+{
+    for (uint8_t i = 0; i < WHEELS; i++)
+    {
+        if (_wheels[i].state == TRACTION_SLIP) return true;
+    }
+    return false;
+}
+
+uint32_t StallDetector::getLongestStallMs(uint32_t nowMs) const
+{
+    uint32_t longest = 0;
+    for (uint8_t i = 0; i < WHEELS; i++)
+    {
+        uint32_t ms = getStallMs(i, nowMs);
+        if (ms > longest) longest = ms;
+    }
+    return longest;
+}
+
+int8_t StallDetector::getStallDirection() const
+{
+    for (uint8_t i = 0; i < WHEELS; i++)
+    {
+        if (_wheels[i].state == TRACTION_STALL) return _wheels[i].direction;
+    }
+    return 0;
+}
+
+const char *StallDetector::stateName(TractionState state)
+{
+    switch (state)
+    {
+    case TRACTION_OK: return "ok";
+    case TRACTION_STALL: return "stall";
+    case TRACTION_FREE_SPIN: return "free_spin";
+    case TRACTION_SLIP: return "slip";
+    default: return "?";
+    }
+}
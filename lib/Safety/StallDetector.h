@@ -0,0 +1,119 @@
+#ifndef STALL_DETECTOR_H
+#define STALL_DETECTOR_H
+
+#include <stdint.h>
+
+/**
+ * Per-wheel traction monitor: commanded drive vs encoder counts
+ *
+ * Each wheel's command drives a first-order model of the speed it should
+ * reach (commands are linear, so full scale is one calibration constant).
+ * Expected and measured counts are summed over a short sliding window and
+ * their ratio classifies the wheel:
+ * - Stall: commanded but (almost) not turning - wedged or blocked
+ * - Free-spin: turning well above the loaded model - wheel unloaded
+ * - Slip: turning clearly faster than its partner on the same command
+ *
+ * The model's lag covers motor spin-up, and a wheel is only judged once the
+ * window expects enough counts to be meaningful; below that (slow creep)
+ * the last verdict is held while the command keeps its sign. Reversing or
+ * releasing the command starts the wheel fresh.
+ *
+ * Pure logic (no Arduino calls) so encoder logs can be replayed on host.
+ */
+
+enum TractionState : uint8_t
+{
+    TRACTION_OK,
+    TRACTION_STALL,
+    TRACTION_FREE_SPIN,
+    TRACTION_SLIP
+};
+
+class StallDetector
+{
+public:
+    static const uint8_t WHEELS = 2;    // Rear left, rear right
+    static const uint8_t MAX_SAMPLES = 16;
+
+    /**
+     * @param fullScaleCountsPerSec Loaded wheel speed at command 255
+     */
+    explicit StallDetector(float fullScaleCountsPerSec);
+
+    /**
+     * Feed one sample for every wheel
+     * @param commands Applied drive command per wheel (-255..255)
+     * @param counts Cumulative encoder counts per wheel
+     * @param valid False when the encoders are stale (wheels start fresh)
+     */
+    void update(const int *commands, const int32_t *counts, bool valid, uint32_t nowMs);
+
+    TractionState getState(uint8_t wheel) const { return _wheels[wheel].state; }
+
+    /**
+     * Measured / expected counts over the window (1.0 = as modelled)
+     */
+    float getRatio(uint8_t wheel) const { return _wheels[wheel].ratio; }
+
+    /**
+     * How long the wheel has been stalled (0 if not)
+     */
+    uint32_t getStallMs(uint8_t wheel, uint32_t nowMs) const;
+
+    bool anyStalled() const;
+    bool allFreeSpinning() const;
+    bool anySlipping() const;
+
+    /**
+     * Longest current stall and the direction it was pushing (+1 / -1, 0 = none)
+     */
+    uint32_t getLongestStallMs(uint32_t nowMs) const;
+    int8_t getStallDirection() const;
+
+    // Entries into each state since start
+    uint32_t getStallEvents() const { return _stallEvents; }
+    uint32_t getFreeSpinEvents() const { return _freeSpinEvents; }
+    uint32_t getSlipEvents() const { return _slipEvents; }
+
+    static const char *stateName(TractionState state);
+
+    void reset();
+
+private:
+    struct Sample
+    {
+        uint16_t dtMs;
+        float expected;     // Model counts over dt
+        int32_t measured;   // Counts over dt, signed
+    };
+
+    struct Wheel
+    {
+        Sample samples[MAX_SAMPLES];
+        uint8_t head;
+        uint8_t fill;
+        uint32_t coveredMs;     // Time since the wheel last started fresh (capped)
+        float modelCps;         // Modelled speed, counts/s (signed)
+        int8_t direction;       // Sign of the command
+        int32_t lastCounts;
+        float ratio;
+        bool judged;            // ratio is meaningful
+        TractionState state;
+        uint32_t stallSinceMs;
+    };
+
+    float _fullScaleCps;
+    Wheel _wheels[WHEELS];
+    bool _started;
+    uint32_t _lastMs;
+
+    uint32_t _stallEvents;
+    uint32_t _freeSpinEvents;
+    uint32_t _slipEvents;
+
+    void restart(Wheel &w, int8_t direction, int32_t counts);
+    void setState(Wheel &w, TractionState state, uint32_t nowMs);
+};
+
+#endif // STALL_DETECTOR_H
@@ -0,0 +1,57 @@
+#include "CicDecimator.h"
+
+CicDecimator::CicDecimator(uint8_t log2Ratio)
+    : _log2Ratio(log2Ratio > 12 ? 12 : log2Ratio)
+{
+    reset();
+}
+
+void CicDecimator::reset()
+{
+    _phase = 0;
+    _output = 0;
+    _warmup = ORDER;
+    for (uint8_t i = 0; i < ORDER; i++)
+    {
+        _integrator[i] = 0;
+        _combDelay[i] = 0;
+    }
+}
+
+bool CicDecimator::push(int32_t sample)
+{
+    // Integrators (input rate). They grow without bound and wrap after a
+    // few hundred thousand samples; modulo 2^64 arithmetic makes that
+    // harmless, since the combs only take differences
+    _integrator[0] += (uint64_t)(int64_t)sample;
+    _integrator[1] += _integrator[0];
+    _integrator[2] += _integrator[1];
+
+    if (++_phase < getRatio()) return false;
+    _phase = 0;
+
+    // Combs (output rate), differential delay 1
+    uint64_t diff = _integrator[2];
+    for (uint8_t i = 0; i < ORDER; i++)
+    {
+        uint64_t delayed = _combDelay[i];
+        _combDelay[i] = diff;
+        diff -= delayed;
+    }
+
+    // The true result (input * R^3 at most, 12 + 36 bits) fits in 64 bits,
+    // so the modular difference read as two's complement is exact
+    int64_t value = (int64_t)diff;
+
+    // The step response settles after ORDER output periods
+    if (_warmup > 0)
+    {
+        _warmup--;
+        return false;
+    }
+
+    // Remove DC gain R^3, keep 4 fractional bits
+    int shift = ORDER * _log2Ratio - 4;
+    _output = (shift >= 0) ? (int32_t)(value >> shift) : (int32_t)(value * (1 << -shift));
+    return true;
+}
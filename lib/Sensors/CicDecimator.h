@@ -0,0 +1,54 @@
+#ifndef CIC_DECIMATOR_H
+#define CIC_DECIMATOR_H
+
+#include <stdint.h>
+
+/**
+ * Third-order CIC (cascaded integrator-comb) decimator
+ *
+ * - Integer only: three integrators at the input rate, three combs at the
+ *   output rate, no multiplies
+ * - Decimation ratio is a power of two so the DC gain (R^3) is removed
+ *   with a shift
+ * - Attenuates everything above the output Nyquist band far better than a
+ *   plain block average (first null at fs/R, sinc^3 roll-off)
+ *
+ * Pure logic - no Arduino dependencies.
+ */
+class CicDecimator
+{
+public:
+    static constexpr uint8_t ORDER = 3;
+
+    /**
+     * @param log2Ratio Decimation ratio as a power of two (R = 1 << log2Ratio, max 2^12)
+     */
+    explicit CicDecimator(uint8_t log2Ratio = 8);
+
+    /**
+     * Push one input sample
+     * @return true when a new output sample is ready (getOutput())
+     */
+    bool push(int32_t sample);
+
+    /**
+     * Latest output, scaled back to input units with 4 fractional bits
+     */
+    int32_t getOutputQ4() const { return _output; }
+
+    uint16_t getRatio() const { return (uint16_t)(1u << _log2Ratio); }
+
+    void reset();
+
+private:
+    uint8_t _log2Ratio;
+    uint16_t _phase;
+
+    // Unsigned so the integrators wrap (modulo 2^64) instead of overflowing
+    uint64_t _integrator[ORDER];
+    uint64_t _combDelay[ORDER];
+    int32_t _output;
+    uint8_t _warmup; // Outputs still affected by the zero start-up history
+};
+
+#endif // CIC_DECIMATOR_H
@@ -0,0 +1,145 @@
+#include "ContinuousAdc.h"
+#include "config.h"
+
+// DMA framing: results per read, driver-side ring buffer
+static const uint32_t FRAME_SAMPLES = 128;
+static const uint32_t RESULT_BYTES = sizeof(adc_digi_output_data_t);
+static const uint32_t FRAME_BYTES = FRAME_SAMPLES * RESULT_BYTES;
+static const uint32_t DRIVER_BUFFER_BYTES = FRAME_BYTES * 8;
+
+// Used only when the eFuse holds no Vref / two-point calibration
+static const uint32_t DEFAULT_VREF_MV = 1100;
+
+// Acquisition task (core 0 with the WiFi stack, below it in priority)
+static const uint32_t TASK_STACK = 3072;
+static const UBaseType_t TASK_PRIORITY = 2;
+static const BaseType_t TASK_CORE = 0;
+
+ContinuousAdc::ContinuousAdc(uint8_t pin, uint32_t sampleRateHz, uint8_t log2Decimation)
+    : _pin(pin), _channel(ADC1_CHANNEL_MAX), _sampleRate(sampleRateHz), _running(false),
+      _cic(log2Decimation), _calSource(ESP_ADC_CAL_VAL_DEFAULT_VREF),
+      _mux(portMUX_INITIALIZER_UNLOCKED), _latest{0, 0, 0, 0}, _overruns(0),
+      _task(nullptr)
+{
+}
+
+bool ContinuousAdc::begin()
+{
+    // Arduino numbers ADC1 channels 0-7, ADC2 from 10 up
+    int8_t channel = digitalPinToAnalogChannel(_pin);
+    if (channel < 0 || channel >= ADC1_CHANNEL_MAX)
+    {
+        DEBUG_PRINTF("[ADC] GPIO%u is not an ADC1 channel\n", _pin);
+        return false;
+    }
+    _channel = (adc1_channel_t)channel;
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = DRIVER_BUFFER_BYTES;
+    init.conv_num_each_intr = FRAME_BYTES;
+    init.adc1_chan_mask = BIT(_channel);
+    init.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&init) != ESP_OK)
+    {
+        DEBUG_PRINTLN("[ADC] ERROR: adc_digi_initialize failed");
+        return false;
+    }
+
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten = ADC_ATTEN_DB_11;
+    pattern.channel = _channel;
+    pattern.unit = 0; // ADC1
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = true;    // Required on ESP32
+    config.conv_limit_num = 250;
+    config.pattern_num = 1;
+    config.adc_pattern = &pattern;
+    config.sample_freq_hz = _sampleRate;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    if (adc_digi_controller_configure(&config) != ESP_OK)
+    {
+        DEBUG_PRINTLN("[ADC] ERROR: adc_digi_controller_configure failed");
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    _calSource = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12,
+                                          DEFAULT_VREF_MV, &_chars);
+
+    if (adc_digi_start() != ESP_OK)
+    {
+        DEBUG_PRINTLN("[ADC] ERROR: adc_digi_start failed");
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    _running = true;
+    xTaskCreatePinnedToCore(taskEntry, "adc_cont", TASK_STACK, this, TASK_PRIORITY, &_task, TASK_CORE);
+
+    DEBUG_PRINTF("[ADC] GPIO%u continuous @ %lu Hz, /%u -> %lu Hz, cal=%d\n",
+                 _pin, (unsigned long)_sampleRate, _cic.getRatio(),
+                 (unsigned long)getOutputRateHz(), (int)_calSource);
+    return true;
+}
+
+bool ContinuousAdc::read(Sample &out) const
+{
+    portENTER_CRITICAL(&_mux);
+    out = _latest;
+    portEXIT_CRITICAL(&_mux);
+    return out.seq != 0;
+}
+
+// ============================================
+// ACQUISITION TASK
+// ============================================
+
+void ContinuousAdc::taskEntry(void *arg)
+{
+    static_cast<ContinuousAdc *>(arg)->taskLoop();
+}
+
+void ContinuousAdc::taskLoop()
+{
+    uint8_t frame[FRAME_BYTES];
+
+    while (true)
+    {
+        uint32_t length = 0;
+        esp_err_t err = adc_digi_read_bytes(frame, FRAME_BYTES, &length, ADC_MAX_DELAY);
+
+        if (err == ESP_ERR_INVALID_STATE)
+        {
+            // Driver buffer overflowed while we were descheduled; the data
+            // returned is still valid, only older samples were lost
+            _overruns++;
+        }
+        else if (err != ESP_OK)
+        {
+            continue;
+        }
+
+        for (uint32_t i = 0; i + RESULT_BYTES <= length; i += RESULT_BYTES)
+        {
+            const adc_digi_output_data_t *result = (const adc_digi_output_data_t *)&frame[i];
+            if (result->type1.channel != _channel) continue;
+
+            if (!_cic.push(result->type1.data)) continue;
+
+            // New decimated output: calibrate and publish
+            int32_t rawQ4 = _cic.getOutputQ4();
+            uint32_t raw = (uint32_t)((rawQ4 + 8) >> 4);
+            uint32_t mv = esp_adc_cal_raw_to_voltage(raw, &_chars);
+
+            portENTER_CRITICAL(&_mux);
+            _latest.rawQ4 = rawQ4;
+            _latest.millivolts = mv;
+            _latest.timeMs = millis();
+            _latest.seq++;
+            portEXIT_CRITICAL(&_mux);
+        }
+    }
+}
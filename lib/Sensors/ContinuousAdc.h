@@ -0,0 +1,77 @@
+#ifndef CONTINUOUS_ADC_H
+#define CONTINUOUS_ADC_H
+
+#include <Arduino.h>
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+#include "CicDecimator.h"
+
+/**
+ * Background ADC1 acquisition for one channel (ESP32 continuous/DMA mode)
+ *
+ * - The ADC digital controller samples into DMA buffers at sampleRateHz
+ * - A low-priority task drains the buffers, decimates with a CIC filter
+ *   and converts to millivolts with esp_adc_cal (eFuse Vref / two-point)
+ * - The latest result is published under a spinlock; readers never block
+ *
+ * Uses the IDF 4.4 adc_digi_* driver (Arduino-ESP32 2.x). ADC1 only - ADC2
+ * is unavailable while WiFi is running.
+ */
+class ContinuousAdc
+{
+public:
+    struct Sample
+    {
+        int32_t rawQ4;          // Decimated raw counts, 4 fractional bits
+        uint32_t millivolts;    // Calibrated input voltage
+        uint32_t timeMs;        // When the sample was produced
+        uint32_t seq;           // Increments per decimated output
+    };
+
+    /**
+     * @param pin GPIO on ADC1
+     * @param sampleRateHz Conversion rate (ESP32: 20 kHz .. 2 MHz)
+     * @param log2Decimation CIC decimation ratio as a power of two
+     */
+    ContinuousAdc(uint8_t pin, uint32_t sampleRateHz, uint8_t log2Decimation);
+
+    /**
+     * Configure the driver and start the acquisition task
+     * @return false if the pin is not on ADC1 or the driver failed
+     */
+    bool begin();
+
+    bool isRunning() const { return _running; }
+
+    /**
+     * Copy the latest decimated sample
+     * @return false until the first output is available
+     */
+    bool read(Sample &out) const;
+
+    // Statistics
+    uint32_t getOverruns() const { return _overruns; }
+    uint32_t getOutputRateHz() const { return _sampleRate / _cic.getRatio(); }
+    esp_adc_cal_value_t getCalibrationSource() const { return _calSource; }
+
+private:
+    uint8_t _pin;
+    adc1_channel_t _channel;
+    uint32_t _sampleRate;
+    bool _running;
+
+    CicDecimator _cic;
+    esp_adc_cal_characteristics_t _chars;
+    esp_adc_cal_value_t _calSource;
+
+    mutable portMUX_TYPE _mux;
+    Sample _latest;
+    volatile uint32_t _overruns;
+
+    TaskHandle_t _task;
+
+    static void taskEntry(void *arg);
+    void taskLoop();
+};
+
+#endif // CONTINUOUS_ADC_H
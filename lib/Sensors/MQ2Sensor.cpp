@@ -2,20 +2,36 @@
 
 MQ2Sensor::MQ2Sensor(uint8_t analogPin, uint8_t digitalPin)
     : _analogPin(analogPin), _digitalPin(digitalPin),
-      _lastReading(0), _smoothedReading(0),
-      _lastUpdateTime(0), _alert(false), _trend(0)
+      _lastReading(0), _smoothedReading(0), _millivolts(0),
+      _lastUpdateTime(0), _alert(false), _trend(0),
+      _adc(analogPin, GAS_ADC_SAMPLE_RATE_HZ, GAS_ADC_DECIMATION_LOG2),
+      _continuous(false), _lastSeq(0), _trendReference(0)
 {
 }
 
 void MQ2Sensor::begin()
 {
-    pinMode(_analogPin, INPUT);
     if (_digitalPin != 0xFF)
         pinMode(_digitalPin, INPUT);
 
-    // Initial reading
-    _lastReading = analogRead(_analogPin);
-    _smoothedReading = _lastReading;
+#if GAS_ADC_CONTINUOUS
+    _continuous = _adc.begin();
+    if (!_continuous)
+    {
+        DEBUG_PRINTLN("[MQ2] Continuous ADC unavailable - using analogRead");
+    }
+#endif
+
+    if (!_continuous)
+    {
+        pinMode(_analogPin, INPUT);
+
+        // Initial reading
+        _millivolts = analogReadMilliVolts(_analogPin);
+        _lastReading = millivoltsToCounts(_millivolts);
+        _smoothedReading = _lastReading;
+        _trendReference = _lastReading;
+    }
 }
 
 int MQ2Sensor::getReading()
@@ -23,25 +39,47 @@ int MQ2Sensor::getReading()
     return _lastReading;
 }
 
+int MQ2Sensor::millivoltsToCounts(uint32_t mv)
+{
+    uint32_t counts = (mv * 4095UL + GAS_ADC_FULL_SCALE_MV / 2) / GAS_ADC_FULL_SCALE_MV;
+    return (counts > 4095) ? 4095 : (int)counts;
+}
+
 void MQ2Sensor::update()
 {
     unsigned long now = millis();
 
+    if (_continuous)
+    {
+        // Background task already filtered - just pick up the latest output
+        ContinuousAdc::Sample sample;
+        if (_adc.read(sample) && sample.seq != _lastSeq)
+        {
+            bool first = (_lastSeq == 0);
+            _lastSeq = sample.seq;
+            _millivolts = sample.millivolts;
+            _lastReading = millivoltsToCounts(sample.millivolts);
+            _smoothedReading = _lastReading;
+            if (first) _trendReference = _lastReading;
+        }
+
+        if (now - _lastUpdateTime >= UPDATE_INTERVAL_MS)
+        {
+            _lastUpdateTime = now;
+            updateTrend(_smoothedReading);
+        }
+        return;
+    }
+
     if (now - _lastUpdateTime >= UPDATE_INTERVAL_MS)
     {
         _lastUpdateTime = now;
 
-        // Read new value
-        int reading = analogRead(_analogPin);
-
-        // Track trend
-        if (reading > _smoothedReading + 20)
-            _trend = 1; // increasing
-        else if (reading < _smoothedReading - 20)
-            _trend = -1; // decreasing
-        else
-            _trend = 0; // stable
+        // Read new value (calibrated by the core)
+        _millivolts = analogReadMilliVolts(_analogPin);
+        int reading = millivoltsToCounts(_millivolts);
 
+        updateTrend(reading);
         _lastReading = reading;
 
         // Running average
@@ -49,6 +87,38 @@ void MQ2Sensor::update()
     }
 }
 
+void MQ2Sensor::updateTrend(int reading)
+{
+    // Track trend over one UPDATE_INTERVAL_MS window
+    int reference = _continuous ? _trendReference : _smoothedReading;
+
+    if (reading > reference + 20)
+        _trend = 1; // increasing
+    else if (reading < reference - 20)
+        _trend = -1; // decreasing
+    else
+        _trend = 0; // stable
+
+    _trendReference = reading;
+}
+
+bool MQ2Sensor::peekLatest(int &counts, uint32_t &timeMs) const
+{
+    if (_continuous)
+    {
+        ContinuousAdc::Sample sample;
+        if (!_adc.read(sample)) return false;
+        counts = millivoltsToCounts(sample.millivolts);
+        timeMs = sample.timeMs;
+        return true;
+    }
+
+    if (_lastUpdateTime == 0) return false;
+    counts = _lastReading;
+    timeMs = _lastUpdateTime;
+    return true;
+}
+
 bool MQ2Sensor::isGasDetected(int threshold)
 {
     bool detected = _smoothedReading > threshold;
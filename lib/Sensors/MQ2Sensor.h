@@ -2,10 +2,17 @@
 #define MQ2_SENSOR_H
 
 #include <Arduino.h>
+#include "config.h"
+#include "ContinuousAdc.h"
 
 /**
  * MQ-2 Smoke/Gas Sensor Wrapper
  * Analog reading with filtering and threshold detection
+ *
+ * With GAS_ADC_CONTINUOUS the channel is oversampled by the DMA ADC in the
+ * background (CIC-decimated, esp_adc_cal calibrated) and update() only
+ * picks up the latest value. Falls back to polled analogRead if the
+ * continuous driver can't be started.
  */
 class MQ2Sensor
 {
@@ -25,10 +32,28 @@ public:
     void update();
 
     /**
-     * Get smoothed reading (running average)
+     * Get smoothed reading (running average / decimated value)
      */
     int getSmoothedReading() { return _smoothedReading; }
 
+    /**
+     * Calibrated sensor output voltage (0 until the first sample)
+     */
+    uint32_t getMillivolts() const { return _millivolts; }
+
+    /**
+     * Latest reading straight from the backend, without waiting for update()
+     * Safe to call from another task (continuous mode reads the ADC's
+     * published sample; polled mode returns the last update() value).
+     * @return false before the first sample
+     */
+    bool peekLatest(int &counts, uint32_t &timeMs) const;
+
+    /**
+     * True when readings come from the continuous DMA backend
+     */
+    bool isContinuous() const { return _continuous; }
+
     /**
      * Check if gas level exceeds threshold
      */
@@ -54,10 +79,20 @@ private:
     uint8_t _digitalPin;
     int _lastReading;
     int _smoothedReading;
+    uint32_t _millivolts;
     unsigned long _lastUpdateTime;
     bool _alert;
     int _trend;
 
+    // Continuous backend
+    ContinuousAdc _adc;
+    bool _continuous;
+    uint32_t _lastSeq;
+    int _trendReference;         // Reading at the start of the trend window
+
+    void updateTrend(int reading);
+    static int millivoltsToCounts(uint32_t mv);
+
     static constexpr unsigned long UPDATE_INTERVAL_MS = 500UL;
     static constexpr int SAMPLES = 5;
 };
@@ -0,0 +1,127 @@
+#include "RangeFilter.h"
+#include <math.h>
+
+// A sample this far from the current median counts as an outlier
+static const float OUTLIER_ABS_CM = 30.0f;
+static const float OUTLIER_REL = 0.3f;
+
+// Spread (MAD) at which consistency confidence reaches zero
+static const float SPREAD_ABS_CM = 5.0f;
+static const float SPREAD_REL = 0.2f;
+
+static float medianOf(float *values, uint8_t n)
+{
+    // Insertion sort - n <= MAX_WINDOW
+    for (uint8_t i = 1; i < n; i++)
+    {
+        float v = values[i];
+        int8_t j = i - 1;
+        while (j >= 0 && values[j] > v)
+        {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = v;
+    }
+    return (n & 1) ? values[n / 2] : 0.5f * (values[n / 2 - 1] + values[n / 2]);
+}
+
+RangeFilter::RangeFilter(uint8_t window, unsigned long staleMs)
+    : _window(window), _staleMs(staleMs)
+{
+    if (_window < 1) _window = 1;
+    if (_window > MAX_WINDOW) _window = MAX_WINDOW;
+    reset();
+}
+
+void RangeFilter::reset()
+{
+    _count = 0;
+    _next = 0;
+    _filtered = -1.0f;
+    _spread = 0.0f;
+    _lastValidTime = 0;
+    _hasValid = false;
+    _history = 0;
+    _dropouts = 0;
+    _consecutiveDropouts = 0;
+    _outliers = 0;
+}
+
+void RangeFilter::addSample(float rawCm, unsigned long nowMs)
+{
+    _history <<= 1;
+
+    if (rawCm <= 0.0f)
+    {
+        _history |= 1;
+        _dropouts++;
+        if (_consecutiveDropouts < 255) _consecutiveDropouts++;
+        return;
+    }
+
+    _consecutiveDropouts = 0;
+
+    if (_hasValid)
+    {
+        float limit = fmaxf(OUTLIER_ABS_CM, OUTLIER_REL * _filtered);
+        if (fabsf(rawCm - _filtered) > limit) _outliers++;
+    }
+
+    // Outliers still enter the window: a real step change wins the median
+    // after (window / 2 + 1) samples, a single spike never does
+    _samples[_next] = rawCm;
+    _next = (_next + 1) % _window;
+    if (_count < _window) _count++;
+
+    _lastValidTime = nowMs;
+    _hasValid = true;
+    recompute();
+}
+
+void RangeFilter::recompute()
+{
+    float sorted[MAX_WINDOW];
+    for (uint8_t i = 0; i < _count; i++) sorted[i] = _samples[i];
+    _filtered = medianOf(sorted, _count);
+
+    float deviations[MAX_WINDOW];
+    for (uint8_t i = 0; i < _count; i++) deviations[i] = fabsf(_samples[i] - _filtered);
+    _spread = medianOf(deviations, _count);
+}
+
+// ============================================
+// QUALITY
+// ============================================
+
+unsigned long RangeFilter::getAge(unsigned long nowMs) const
+{
+    if (!_hasValid) return 0xFFFFFFFFUL;
+    return nowMs - _lastValidTime;
+}
+
+bool RangeFilter::isStale(unsigned long nowMs) const
+{
+    return !_hasValid || getAge(nowMs) > _staleMs || _consecutiveDropouts >= _window;
+}
+
+float RangeFilter::getConfidence(unsigned long nowMs) const
+{
+    if (isStale(nowMs)) return 0.0f;
+
+    // Freshness: linear decay over the stale period
+    float freshness = 1.0f - (float)getAge(nowMs) / (float)_staleMs;
+
+    // Recent dropout rate over the last 16 attempts
+    float dropRate = __builtin_popcount(_history) / 16.0f;
+
+    // Consistency: spread relative to what is normal at this range
+    float spreadLimit = SPREAD_ABS_CM + SPREAD_REL * _filtered;
+    float consistency = 1.0f - fminf(1.0f, _spread / spreadLimit);
+
+    // Until the window fills, the median is less trustworthy
+    float fill = (float)_count / (float)_window;
+
+    float confidence = freshness * (1.0f - dropRate) * consistency * fill;
+    return (confidence < 0.0f) ? 0.0f : confidence;
+}
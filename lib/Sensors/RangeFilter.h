@@ -0,0 +1,83 @@
+#ifndef RANGE_FILTER_H
+#define RANGE_FILTER_H
+
+#include <stdint.h>
+
+/**
+ * Per-sensor range filtering stage
+ *
+ * - Median-of-N over the last valid samples (rejects single-shot outliers)
+ * - Timestamp of the last accepted sample, age and staleness flag
+ * - Dropout counters (timeouts / invalid echoes)
+ * - Confidence 0..1 combining freshness, recent dropout rate and spread
+ *
+ * A dead sensor therefore shows up as stale with falling confidence instead
+ * of a frozen but plausible distance. Pure logic - no Arduino dependencies.
+ */
+class RangeFilter
+{
+public:
+    static constexpr uint8_t MAX_WINDOW = 7;
+
+    /**
+     * @param window Median window size (odd, 1..MAX_WINDOW)
+     * @param staleMs Sample age after which the range is considered stale
+     */
+    RangeFilter(uint8_t window = 5, unsigned long staleMs = 300);
+
+    /**
+     * Feed one measurement attempt
+     * @param rawCm Measured distance, <= 0 for timeout/invalid echo
+     * @param nowMs Time of the measurement
+     */
+    void addSample(float rawCm, unsigned long nowMs);
+
+    /**
+     * Median-filtered distance (-1 if no valid sample yet)
+     */
+    float getDistance() const { return _filtered; }
+
+    /**
+     * Time of the last valid sample (0 if none)
+     */
+    unsigned long getTimestamp() const { return _lastValidTime; }
+
+    unsigned long getAge(unsigned long nowMs) const;
+    bool isStale(unsigned long nowMs) const;
+
+    /**
+     * 0.0 (no usable data) .. 1.0 (fresh, consistent, no dropouts)
+     */
+    float getConfidence(unsigned long nowMs) const;
+
+    uint32_t getDropouts() const { return _dropouts; }
+    uint8_t getConsecutiveDropouts() const { return _consecutiveDropouts; }
+
+    /**
+     * Samples that disagreed strongly with the median when they arrived
+     */
+    uint32_t getOutliers() const { return _outliers; }
+
+    void reset();
+
+private:
+    float _samples[MAX_WINDOW];
+    uint8_t _window;
+    uint8_t _count;     // Valid samples in buffer (<= _window)
+    uint8_t _next;      // Ring write index
+    unsigned long _staleMs;
+
+    float _filtered;
+    float _spread;      // Median absolute deviation of the window
+    unsigned long _lastValidTime;
+    bool _hasValid;
+
+    uint16_t _history;  // Last 16 attempts, bit set = dropout
+    uint32_t _dropouts;
+    uint8_t _consecutiveDropouts;
+    uint32_t _outliers;
+
+    void recompute();
+};
+
+#endif // RANGE_FILTER_H
@@ -1,72 +1,347 @@
 #include "SensorManager.h"
 
+// ============================================
+// ULTRASONIC LAYOUT
+// ============================================
+// Add corner/side sensors here; grouping and sector membership follow
+// from the mount angles (max UltrasonicScheduler::MAX_SENSORS)
+
+static const UltrasonicMount US_MOUNTS[] = {
+    {ULTRASONIC_FRONT_TRIG, ULTRASONIC_FRONT_ECHO, 0.0f, US_FRONT_OFFSET_CM, "front"},
+    {ULTRASONIC_REAR_TRIG, ULTRASONIC_REAR_ECHO, PI, US_REAR_OFFSET_CM, "rear"},
+};
+
+static const uint8_t US_MOUNT_COUNT = sizeof(US_MOUNTS) / sizeof(US_MOUNTS[0]);
+
+static UltrasonicSensor s_ultrasonics[] = {
+    UltrasonicSensor(US_MOUNTS[0].trigPin, US_MOUNTS[0].echoPin),
+    UltrasonicSensor(US_MOUNTS[1].trigPin, US_MOUNTS[1].echoPin),
+};
+
+static_assert(sizeof(s_ultrasonics) / sizeof(s_ultrasonics[0]) == sizeof(US_MOUNTS) / sizeof(US_MOUNTS[0]),
+              "One UltrasonicSensor per mount entry");
+
+static const float DEG_TO_RAD_F = PI / 180.0f;
+
 SensorManager::SensorManager()
-    : _frontSensor(ULTRASONIC_FRONT_TRIG, ULTRASONIC_FRONT_ECHO),
-      _rearSensor(ULTRASONIC_REAR_TRIG, ULTRASONIC_REAR_ECHO),
-      _gasSensor(GAS_SENSOR_ANALOG, GAS_SENSOR_DIGITAL),
-      _frontDist(0), _rearDist(0), _gasLevel(0), 
-      _lastUpdate(0), _readFrontNext(true)
+    : _gasSensor(GAS_SENSOR_ANALOG, GAS_SENSOR_DIGITAL),
+      _usCount(0), _frontMask(0), _rearMask(0),
+      _schedTimer(nullptr), _activeMask(0), _groupDoneUs(0), _groupCycles(0),
+      _queueDrops(0), _snapMux(portMUX_INITIALIZER_UNLOCKED),
+      _gasLevel(0)
 {
+    for (uint8_t i = 0; i < MAX_ULTRASONIC; i++)
+    {
+        _sensors[i] = nullptr;
+        _resultHead[i] = 0;
+        _resultTail[i] = 0;
+        _recentCount[i] = 0;
+        _recentUs[i] = 0;
+        _filters[i] = RangeFilter(US_MEDIAN_WINDOW, US_STALE_MS);
+        _sampleSeq[i] = 0;
+    }
 }
 
 void SensorManager::begin()
 {
-    _frontSensor.begin();
-    _rearSensor.begin();
+    float sectorHalfWidth = US_SECTOR_HALF_WIDTH_DEG * DEG_TO_RAD_F;
+
+    for (uint8_t i = 0; i < US_MOUNT_COUNT && i < MAX_ULTRASONIC; i++)
+    {
+        const UltrasonicMount &mount = US_MOUNTS[i];
+        _sensors[i] = &s_ultrasonics[i];
+        _sensors[i]->begin();
+        _scheduler.addSensor(mount.angleRad);
+
+        // Sector membership for the combined front/rear ranges
+        float a = fabsf(atan2f(sinf(mount.angleRad), cosf(mount.angleRad)));
+        if (a <= sectorHalfWidth) _frontMask |= 1 << i;
+        if (PI - a <= sectorHalfWidth) _rearMask |= 1 << i;
+
+        _usCount++;
+    }
+
+    _scheduler.buildGroups(US_GROUP_MIN_SEPARATION_DEG * DEG_TO_RAD_F);
+    _scheduler.setTravelBoost(US_TRAVEL_PRIORITY_BOOST);
+    DEBUG_PRINTF("[Sensors] %u ultrasonic sensors in %u firing groups\n",
+                 _usCount, _scheduler.getGroupCount());
+
     _gasSensor.begin();
+
+    esp_timer_create_args_t args = {};
+    args.callback = &SensorManager::schedulerCallback;
+    args.arg = this;
+    args.name = "us_sched";
+    if (esp_timer_create(&args, &_schedTimer) == ESP_OK)
+    {
+        esp_timer_start_periodic(_schedTimer, US_SCHED_TICK_MS * 1000ULL);
+    }
+    else
+    {
+        DEBUG_PRINTLN("[Sensors] ERROR: ultrasonic scheduler timer not created");
+    }
 }
 
-void SensorManager::update()
+// ============================================
+// FIRING SCHEDULE (esp_timer task)
+// ============================================
+
+void SensorManager::schedulerCallback(void *arg)
 {
-    unsigned long now = millis();
-    
-    // Staggered ultrasonic updates to prevent crosstalk
-    // Each sensor updates at half the rate, but they alternate
-    // Result: Same effective update rate per sensor, no interference
-    const unsigned long STAGGER_INTERVAL = SENSOR_UPDATE_INTERVAL_MS / 2;  // 50ms each
-    
-    if (now - _lastUpdate >= STAGGER_INTERVAL)
-    {
-        _lastUpdate = now;
-
-        // Alternate between front and rear ultrasonic
-        if (_readFrontNext)
+    static_cast<SensorManager *>(arg)->schedulerTick();
+}
+
+void SensorManager::schedulerTick()
+{
+    uint32_t nowUs = micros();
+
+    // Collect the group in flight
+    if (_activeMask)
+    {
+        for (uint8_t i = 0; i < _usCount; i++)
         {
-            _frontSensor.update();
-            float reading = _frontSensor.getDistance();
-            if (reading > 0) {
-                _frontDist = reading;
+            float distance;
+            if ((_activeMask & (1 << i)) && _sensors[i]->poll(nowUs, distance))
+            {
+                pushResult(i, distance);
+                _activeMask &= ~(1 << i);
             }
-            // else: keep last valid reading
+        }
+
+        if (_activeMask) return;
+        _groupDoneUs = nowUs;
+        _groupCycles++;
+    }
+
+    // Let stray echoes die down before the next group pings
+    if (nowUs - _groupDoneUs < US_GROUP_GAP_MS * 1000UL) return;
+
+    uint8_t mask = _scheduler.getGroupMask(_scheduler.nextGroup());
+    for (uint8_t i = 0; i < _usCount; i++)
+    {
+        if (!(mask & (1 << i))) continue;
+
+        if (_sensors[i]->trigger(nowUs))
+        {
+            _activeMask |= 1 << i;
         }
         else
         {
-            _rearSensor.update();
-            float reading = _rearSensor.getDistance();
-            if (reading > 0) {
-                _rearDist = reading;
-            }
+            // Echo line stuck high - report as a dropout
+            pushResult(i, -1.0f);
         }
-        
-        _readFrontNext = !_readFrontNext;  // Toggle for next update
-        
-        // Gas sensor updates every cycle (no interference with ultrasonics)
-        _gasSensor.update();
-        _gasLevel = _gasSensor.getSmoothedReading();
     }
+
+    if (!_activeMask) _groupDoneUs = nowUs;
+}
+
+void SensorManager::pushResult(uint8_t i, float distanceCm)
+{
+    if (distanceCm > 0)
+    {
+        portENTER_CRITICAL(&_snapMux);
+        for (uint8_t k = SNAPSHOT_DEPTH - 1; k > 0; k--)
+        {
+            _recent[i][k] = _recent[i][k - 1];
+        }
+        _recent[i][0] = distanceCm;
+        if (_recentCount[i] < SNAPSHOT_DEPTH) _recentCount[i]++;
+        _recentUs[i] = micros();
+        portEXIT_CRITICAL(&_snapMux);
+    }
+
+    uint8_t head = _resultHead[i];
+    uint8_t next = (head + 1) % RESULT_QUEUE_SIZE;
+    if (next == _resultTail[i])
+    {
+        _queueDrops++;  // Loop fell behind; keep the older samples
+        return;
+    }
+
+    _results[i][head].distanceCm = distanceCm;
+    _results[i][head].timeMs = millis();
+    __atomic_store_n(&_resultHead[i], next, __ATOMIC_RELEASE);
+}
+
+void SensorManager::setTravelDirection(float relAngleRad)
+{
+    _scheduler.setTravelDirection(relAngleRad, US_TRAVEL_CONE_DEG * DEG_TO_RAD_F);
+}
+
+void SensorManager::clearTravelDirection()
+{
+    _scheduler.clearTravelDirection();
+}
+
+// ============================================
+// MAIN LOOP
+// ============================================
+
+void SensorManager::update()
+{
+    // Feed every completed attempt into the filters, timeouts count as dropouts
+    for (uint8_t i = 0; i < _usCount; i++)
+    {
+        uint8_t head = __atomic_load_n(&_resultHead[i], __ATOMIC_ACQUIRE);
+        while (_resultTail[i] != head)
+        {
+            const RangeResult &r = _results[i][_resultTail[i]];
+            _filters[i].addSample(r.distanceCm, r.timeMs);
+            if (r.distanceCm > 0) _sampleSeq[i]++;
+            _resultTail[i] = (_resultTail[i] + 1) % RESULT_QUEUE_SIZE;
+        }
+    }
+
+    // Gas sensor: fresh decimated value every tick (continuous ADC), or
+    // rate-limited internally in polled mode
+    _gasSensor.update();
+    _gasLevel = _gasSensor.getSmoothedReading();
+}
+
+// ============================================
+// ACCESSORS
+// ============================================
+
+const UltrasonicMount &SensorManager::getMount(uint8_t i) const
+{
+    return US_MOUNTS[i];
+}
+
+float SensorManager::sectorDistance(uint8_t mask, float axisRad) const
+{
+    unsigned long now = millis();
+    float nearest = -1.0f;
+    float fallback = -1.0f;
+    float fallbackAngle = PI;
+
+    for (uint8_t i = 0; i < _usCount; i++)
+    {
+        if (!(mask & (1 << i))) continue;
+
+        float offAxis = US_MOUNTS[i].angleRad - axisRad;
+        float d = _filters[i].getDistance();
+
+        // Last value of the most on-axis sensor, for when all are stale
+        float absOff = fabsf(atan2f(sinf(offAxis), cosf(offAxis)));
+        if (absOff < fallbackAngle)
+        {
+            fallbackAngle = absOff;
+            fallback = d;
+        }
+
+        if (d <= 0 || _filters[i].isStale(now)) continue;
+
+        float projected = d * cosf(offAxis);
+        if (nearest < 0 || projected < nearest) nearest = projected;
+    }
+
+    return (nearest > 0) ? nearest : fallback;
+}
+
+bool SensorManager::sectorStale(uint8_t mask) const
+{
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < _usCount; i++)
+    {
+        if ((mask & (1 << i)) && !_filters[i].isStale(now)) return false;
+    }
+    return true;
+}
+
+float SensorManager::sectorConfidence(uint8_t mask) const
+{
+    unsigned long now = millis();
+    float best = 0.0f;
+    for (uint8_t i = 0; i < _usCount; i++)
+    {
+        if (!(mask & (1 << i))) continue;
+        float c = _filters[i].getConfidence(now);
+        if (c > best) best = c;
+    }
+    return best;
+}
+
+uint32_t SensorManager::sectorDropouts(uint8_t mask) const
+{
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < _usCount; i++)
+    {
+        if (mask & (1 << i)) total += _filters[i].getDropouts();
+    }
+    return total;
 }
 
 float SensorManager::getFrontDistance() const
 {
-    return _frontDist;
+    return sectorDistance(_frontMask, 0.0f);
 }
 
 float SensorManager::getRearDistance() const
 {
-    return _rearDist;
+    return sectorDistance(_rearMask, PI);
 }
 
 int SensorManager::getGasLevel() const
 {
     return _gasLevel;
 }
+
+uint32_t SensorManager::getGasMillivolts() const
+{
+    return _gasSensor.getMillivolts();
+}
+
+// ============================================
+// SAFETY SNAPSHOT (any task)
+// ============================================
+
+static float median3(float a, float b, float c)
+{
+    if (a > b) { float t = a; a = b; b = t; }
+    if (b > c) b = c;
+    return (a > b) ? a : b;
+}
+
+void SensorManager::getSafetySnapshot(SafetySnapshot &out) const
+{
+    float recent[MAX_ULTRASONIC][SNAPSHOT_DEPTH];
+    uint8_t count[MAX_ULTRASONIC];
+    uint32_t stampUs[MAX_ULTRASONIC];
+
+    portENTER_CRITICAL(&_snapMux);
+    memcpy(recent, _recent, sizeof(recent));
+    memcpy(count, _recentCount, sizeof(count));
+    memcpy(stampUs, _recentUs, sizeof(stampUs));
+    portEXIT_CRITICAL(&_snapMux);
+
+    uint32_t nowUs = micros();
+    out.frontCm = -1.0f;
+    out.frontUs = 0;
+
+    // A single stray echo can't trip the supervisor - median of three
+    for (uint8_t i = 0; i < _usCount; i++)
+    {
+        if (!(_frontMask & (1 << i)) || count[i] < SNAPSHOT_DEPTH) continue;
+        if (nowUs - stampUs[i] > US_STALE_MS * 1000UL) continue;
+
+        float d = median3(recent[i][0], recent[i][1], recent[i][2]) * cosf(US_MOUNTS[i].angleRad);
+        if (d > 0 && (out.frontCm < 0 || d < out.frontCm))
+        {
+            out.frontCm = d;
+            out.frontUs = stampUs[i];
+        }
+    }
+
+    int gas;
+    uint32_t gasMs;
+    if (_gasSensor.peekLatest(gas, gasMs))
+    {
+        out.gasLevel = gas;
+        out.gasUs = nowUs - (millis() - gasMs) * 1000UL;
+    }
+    else
+    {
+        out.gasLevel = -1;
+        out.gasUs = nowUs;
+    }
+}
@@ -2,38 +2,147 @@
 #define SENSOR_MANAGER_H
 
 #include <Arduino.h>
+#include <esp_timer.h>
 #include "config.h"
 #include "pins.h"
 #include "UltrasonicSensor.h"
+#include "UltrasonicScheduler.h"
+#include "RangeFilter.h"
 #include "MQ2Sensor.h"
 
+/**
+ * Where an ultrasonic sensor sits on the chassis
+ */
+struct UltrasonicMount
+{
+    uint8_t trigPin;
+    uint8_t echoPin;
+    float angleRad;     // Beam direction relative to robot heading (0 = front, CCW)
+    float offsetCm;     // Mount distance from robot centre along angleRad
+    const char *name;
+};
+
 class SensorManager
 {
 public:
+    static constexpr uint8_t MAX_ULTRASONIC = UltrasonicScheduler::MAX_SENSORS;
+
+    /**
+     * Latest readings for the safety supervisor, independent of update()
+     */
+    struct SafetySnapshot
+    {
+        float frontCm;      // Nearest fresh front-sector range, -1 if none
+        uint32_t frontUs;   // micros() when that echo was collected
+        int gasLevel;       // 0-4095, -1 before the first sample
+        uint32_t gasUs;     // micros() equivalent of the gas sample time
+    };
+
     SensorManager();
 
     void begin();
     void update(); // Non-blocking update loop
 
     // Thread-safe accessors (returns cached values)
+    // Distances are median-filtered; check staleness before trusting them.
+    // Front/rear combine every sensor within US_SECTOR_HALF_WIDTH_DEG of the
+    // axis (nearest fresh obstacle, projected onto the axis).
     float getFrontDistance() const;
     float getRearDistance() const;
     int getGasLevel() const;
+    uint32_t getGasMillivolts() const;
+
+    /**
+     * Fill a safety snapshot straight from the scheduler's results (median
+     * of the last three echoes per sensor) and the gas backend, so it stays
+     * fresh while update() is not running. Safe to call from another task.
+     */
+    void getSafetySnapshot(SafetySnapshot &out) const;
+
+    // Range quality (a sector is stale only when all of its sensors are)
+    bool isFrontStale() const { return sectorStale(_frontMask); }
+    bool isRearStale() const { return sectorStale(_rearMask); }
+    float getFrontConfidence() const { return sectorConfidence(_frontMask); }
+    float getRearConfidence() const { return sectorConfidence(_rearMask); }
+    uint32_t getFrontDropouts() const { return sectorDropouts(_frontMask); }
+    uint32_t getRearDropouts() const { return sectorDropouts(_rearMask); }
+
+    /**
+     * Direction of travel (radians, robot frame) - sensors facing it are
+     * fired more often. Clear when stopped or spinning in place.
+     */
+    void setTravelDirection(float relAngleRad);
+    void clearTravelDirection();
+
+    // ========================================
+    // PER-SENSOR ACCESS
+    // ========================================
+
+    uint8_t getUltrasonicCount() const { return _usCount; }
+    const UltrasonicMount &getMount(uint8_t i) const;
+    const RangeFilter &getFilter(uint8_t i) const { return _filters[i]; }
+    float getDistance(uint8_t i) const { return _filters[i].getDistance(); }
+
+    // Sample counter - increments on every new valid measurement
+    // (lets consumers such as the occupancy grid use each sample once)
+    uint32_t getSampleSeq(uint8_t i) const { return _sampleSeq[i]; }
+
+    // Scheduler statistics
+    uint8_t getGroupCount() const { return _scheduler.getGroupCount(); }
+    uint32_t getGroupCycles() const { return _groupCycles; }
+    uint32_t getQueueDrops() const { return _queueDrops; }
 
 private:
-    // Sensor Objects
-    UltrasonicSensor _frontSensor;
-    UltrasonicSensor _rearSensor;
     MQ2Sensor _gasSensor;
 
+    // Ultrasonic channels (sensor objects live in the mount table)
+    UltrasonicSensor *_sensors[MAX_ULTRASONIC];
+    uint8_t _usCount;
+    uint8_t _frontMask;
+    uint8_t _rearMask;
+
+    // Firing order, run from a periodic esp_timer so the scan rate does not
+    // depend on the main loop period
+    UltrasonicScheduler _scheduler;
+    esp_timer_handle_t _schedTimer;
+    uint8_t _activeMask;        // Sensors of the group currently in flight
+    uint32_t _groupDoneUs;
+    uint32_t _groupCycles;
+
+    // Completed measurements, timer task -> loop (SPSC ring per sensor)
+    struct RangeResult
+    {
+        float distanceCm;
+        uint32_t timeMs;
+    };
+    static constexpr uint8_t RESULT_QUEUE_SIZE = 8;
+    RangeResult _results[MAX_ULTRASONIC][RESULT_QUEUE_SIZE];
+    volatile uint8_t _resultHead[MAX_ULTRASONIC];
+    uint8_t _resultTail[MAX_ULTRASONIC];
+    volatile uint32_t _queueDrops;
+
+    // Raw echo history for the safety snapshot (timer task -> supervisor)
+    static constexpr uint8_t SNAPSHOT_DEPTH = 3;
+    float _recent[MAX_ULTRASONIC][SNAPSHOT_DEPTH];
+    uint8_t _recentCount[MAX_ULTRASONIC];
+    uint32_t _recentUs[MAX_ULTRASONIC];
+    mutable portMUX_TYPE _snapMux;
+
+    // Range filtering (median, age, dropouts)
+    RangeFilter _filters[MAX_ULTRASONIC];
+    uint32_t _sampleSeq[MAX_ULTRASONIC];
+
     // Cached Data
-    float _frontDist;
-    float _rearDist;
     int _gasLevel;
 
-    // Timing & Stagger
-    unsigned long _lastUpdate;
-    bool _readFrontNext;  // Alternates between front/rear to prevent crosstalk
+    static void schedulerCallback(void *arg);
+    void schedulerTick();
+    void pushResult(uint8_t i, float distanceCm);
+
+    float sectorDistance(uint8_t mask, float axisRad) const;
+    bool sectorStale(uint8_t mask) const;
+    float sectorConfidence(uint8_t mask) const;
+    uint32_t sectorDropouts(uint8_t mask) const;
 };
 
 #endif
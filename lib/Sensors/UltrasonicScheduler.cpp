@@ -0,0 +1,101 @@
+#include "UltrasonicScheduler.h"
+#include <math.h>
+
+UltrasonicScheduler::UltrasonicScheduler()
+    : _sensorCount(0), _groupCount(0), _boostMask(0), _boost(0)
+{
+    for (uint8_t i = 0; i < MAX_SENSORS; i++)
+    {
+        _angle[i] = 0.0f;
+        _groupMask[i] = 0;
+        _credit[i] = 0;
+    }
+}
+
+float UltrasonicScheduler::angleBetween(float a, float b)
+{
+    float d = fmodf(fabsf(a - b), 2.0f * (float)M_PI);
+    return (d > (float)M_PI) ? 2.0f * (float)M_PI - d : d;
+}
+
+int UltrasonicScheduler::addSensor(float mountAngleRad)
+{
+    if (_sensorCount >= MAX_SENSORS) return -1;
+    _angle[_sensorCount] = mountAngleRad;
+    return _sensorCount++;
+}
+
+void UltrasonicScheduler::buildGroups(float minSeparationRad)
+{
+    _groupCount = 0;
+
+    for (uint8_t s = 0; s < _sensorCount; s++)
+    {
+        uint8_t g = 0;
+        for (; g < _groupCount; g++)
+        {
+            bool fits = true;
+            for (uint8_t m = 0; m < _sensorCount && fits; m++)
+            {
+                if ((_groupMask[g] & (1 << m)) && angleBetween(_angle[s], _angle[m]) < minSeparationRad)
+                    fits = false;
+            }
+            if (fits) break;
+        }
+
+        if (g == _groupCount)
+        {
+            _groupMask[_groupCount++] = 0;
+        }
+        _groupMask[g] |= 1 << s;
+    }
+
+    for (uint8_t g = 0; g < MAX_SENSORS; g++) _credit[g] = 0;
+    _boostMask = 0;
+}
+
+// ============================================
+// TRAVEL PRIORITY
+// ============================================
+
+void UltrasonicScheduler::setTravelDirection(float relAngleRad, float coneRad)
+{
+    uint8_t mask = 0;
+    for (uint8_t g = 0; g < _groupCount; g++)
+    {
+        for (uint8_t s = 0; s < _sensorCount; s++)
+        {
+            if ((_groupMask[g] & (1 << s)) && angleBetween(_angle[s], relAngleRad) <= coneRad)
+            {
+                mask |= 1 << g;
+                break;
+            }
+        }
+    }
+    _boostMask = mask;
+}
+
+void UltrasonicScheduler::clearTravelDirection()
+{
+    _boostMask = 0;
+}
+
+uint8_t UltrasonicScheduler::nextGroup()
+{
+    if (_groupCount <= 1) return 0;
+
+    // Smooth weighted round-robin: every group earns its weight, the richest
+    // fires and pays back the total. Boosted groups fire (1 + boost) times as
+    // often, interleaved rather than in bursts.
+    int16_t total = 0;
+    uint8_t best = 0;
+    for (uint8_t g = 0; g < _groupCount; g++)
+    {
+        int16_t weight = 1 + ((_boostMask & (1 << g)) ? _boost : 0);
+        _credit[g] += weight;
+        total += weight;
+        if (_credit[g] > _credit[best]) best = g;
+    }
+    _credit[best] -= total;
+    return best;
+}
@@ -0,0 +1,72 @@
+#ifndef ULTRASONIC_SCHEDULER_H
+#define ULTRASONIC_SCHEDULER_H
+
+#include <stdint.h>
+
+/**
+ * Firing order for N ultrasonic sensors
+ *
+ * - Sensors whose beams point far enough apart can't hear each other's
+ *   pings, so they are grouped and fired together
+ * - Groups take turns by smooth weighted round-robin; the group holding
+ *   the sensor that faces the direction of travel gets extra weight
+ *
+ * Only decides *what* fires next - triggering and echo timing are left to
+ * the caller. Pure logic - no Arduino dependencies.
+ */
+class UltrasonicScheduler
+{
+public:
+    static constexpr uint8_t MAX_SENSORS = 8;
+
+    UltrasonicScheduler();
+
+    /**
+     * Register a sensor by its mount direction (radians, 0 = front, CCW)
+     * @return sensor index, or -1 if full
+     */
+    int addSensor(float mountAngleRad);
+
+    /**
+     * Greedily group sensors: a sensor joins the first group in which every
+     * member is at least minSeparationRad away from it
+     */
+    void buildGroups(float minSeparationRad);
+
+    /**
+     * Boost groups containing a sensor within coneRad of the travel
+     * direction (radians, robot frame)
+     */
+    void setTravelDirection(float relAngleRad, float coneRad);
+    void clearTravelDirection();
+
+    /**
+     * Extra round-robin weight for the travel-facing group (0 = plain rotation)
+     */
+    void setTravelBoost(uint8_t boost) { _boost = boost; }
+
+    /**
+     * Pick the group to fire next
+     */
+    uint8_t nextGroup();
+
+    uint8_t getGroupCount() const { return _groupCount; }
+    uint8_t getGroupMask(uint8_t group) const { return _groupMask[group]; }
+    uint8_t getSensorCount() const { return _sensorCount; }
+    float getMountAngle(uint8_t sensor) const { return _angle[sensor]; }
+
+private:
+    float _angle[MAX_SENSORS];
+    uint8_t _sensorCount;
+
+    uint8_t _groupMask[MAX_SENSORS];  // Bit n = sensor n
+    uint8_t _groupCount;
+
+    int16_t _credit[MAX_SENSORS];     // Weighted round-robin state per group
+    uint8_t _boostMask;               // Groups facing the travel direction
+    uint8_t _boost;
+
+    static float angleBetween(float a, float b);
+};
+
+#endif // ULTRASONIC_SCHEDULER_H
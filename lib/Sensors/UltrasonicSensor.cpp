@@ -3,8 +3,9 @@
 UltrasonicSensor::UltrasonicSensor(uint8_t trigPin, uint8_t echoPin)
     : _trigPin(trigPin), _echoPin(echoPin),
       _lastDistance(0), _smoothedDistance(0),
-      _lastMeasureTime(0), _pulseStart(0),
-      _state(IDLE)
+      _lastMeasureTime(0), _measurementCount(0), _attemptCount(0),
+      _pending(false), _triggerUs(0),
+      _echoRiseUs(0), _echoFallUs(0), _edges(0)
 {
 }
 
@@ -13,6 +14,7 @@ void UltrasonicSensor::begin()
     pinMode(_trigPin, OUTPUT);
     pinMode(_echoPin, INPUT);
     digitalWrite(_trigPin, LOW);
+    attachInterruptArg(digitalPinToInterrupt(_echoPin), echoISR, this, CHANGE);
 }
 
 float UltrasonicSensor::getDistance()
@@ -20,77 +22,99 @@ float UltrasonicSensor::getDistance()
     return _lastDistance;
 }
 
-void UltrasonicSensor::update()
+void IRAM_ATTR UltrasonicSensor::echoISR(void *arg)
 {
-    unsigned long now = micros();
+    UltrasonicSensor *self = static_cast<UltrasonicSensor *>(arg);
+    uint32_t now = micros();
 
-    switch (_state)
+    if (digitalRead(self->_echoPin) == HIGH)
+    {
+        self->_echoRiseUs = now;
+        self->_edges = EDGE_RISE;
+    }
+    else if (self->_edges & EDGE_RISE)
+    {
+        self->_echoFallUs = now;
+        self->_edges |= EDGE_FALL;
+    }
+}
+
+void UltrasonicSensor::update()
+{
+    if (!_pending)
     {
-    case IDLE:
         // Time to measure?
         if (millis() - _lastMeasureTime >= MEASURE_INTERVAL_MS)
         {
-            // Send trigger pulse
-            digitalWrite(_trigPin, HIGH);
-            delayMicroseconds(10);
-            digitalWrite(_trigPin, LOW);
-            _pulseStart = micros();
-            _state = WAITING_FOR_ECHO;
             _lastMeasureTime = millis();
+            trigger(micros());
         }
-        break;
+        return;
+    }
 
-    case WAITING_FOR_ECHO:
-        // Wait for echo to go HIGH
-        if (digitalRead(_echoPin) == HIGH)
-        {
-            _pulseStart = micros();
-            _state = MEASURING;
-        }
-        else if (now - _pulseStart > ECHO_TIMEOUT_US)
-        {
-            // Timeout
-            _lastDistance = -1;
-            _state = IDLE;
-        }
-        break;
+    float distance;
+    poll(micros(), distance);
+}
 
-    case MEASURING:
-        // Wait for echo to go LOW
-        if (digitalRead(_echoPin) == LOW)
-        {
-            unsigned long pulseDuration = micros() - _pulseStart;
-
-            // Check timeout
-            if (pulseDuration > ECHO_TIMEOUT_US)
-            {
-                _lastDistance = -1;
-            }
-            else
-            {
-                // Convert to cm (speed of sound = 343 m/s = 0.0343 cm/us)
-                float distance = (pulseDuration / 2.0f) * 0.0343f;
-
-                // Validate
-                if (distance > 2.0f && distance < 400.0f)
-                {
-                    _lastDistance = distance;
-                    // Apply EMA filter
-                    _smoothedDistance = EMA_ALPHA * distance + (1.0f - EMA_ALPHA) * _smoothedDistance;
-                }
-                else
-                {
-                    _lastDistance = -1;
-                }
-            }
-            _state = IDLE;
-        }
-        else if (now - _pulseStart > ECHO_TIMEOUT_US)
-        {
-            _lastDistance = -1;
-            _state = IDLE;
-        }
-        break;
+bool UltrasonicSensor::trigger(uint32_t nowUs)
+{
+    // Echo still high: the sensor hasn't finished its previous cycle
+    // (HC-SR04 holds echo ~38 ms when nothing comes back)
+    if (_pending || digitalRead(_echoPin) == HIGH) return false;
+
+    _edges = 0;
+    _pending = true;
+    _triggerUs = nowUs;
+
+    // Send trigger pulse
+    digitalWrite(_trigPin, HIGH);
+    delayMicroseconds(10);
+    digitalWrite(_trigPin, LOW);
+    return true;
+}
+
+bool UltrasonicSensor::poll(uint32_t nowUs, float &distanceCm)
+{
+    if (!_pending) return false;
+
+    uint8_t edges = _edges;
+    if (edges & EDGE_FALL)
+    {
+        uint32_t pulseDuration = _echoFallUs - _echoRiseUs;
+
+        // Convert to cm (speed of sound = 343 m/s = 0.0343 cm/us)
+        float distance = (pulseDuration / 2.0f) * 0.0343f;
+
+        // Validate
+        distanceCm = (pulseDuration <= ECHO_TIMEOUT_US && distance > 2.0f && distance < 400.0f)
+                         ? distance
+                         : -1.0f;
+        finish(distanceCm);
+        return true;
+    }
+
+    if (nowUs - _triggerUs > ECHO_TIMEOUT_US)
+    {
+        // Timeout (no echo, or echo beyond the valid range)
+        distanceCm = -1.0f;
+        finish(distanceCm);
+        return true;
+    }
+
+    return false;
+}
+
+void UltrasonicSensor::finish(float distanceCm)
+{
+    _pending = false;
+    _attemptCount++;
+    _lastDistance = distanceCm;
+
+    if (distanceCm > 0)
+    {
+        _measurementCount++;
+        // Apply EMA filter
+        _smoothedDistance = EMA_ALPHA * distanceCm + (1.0f - EMA_ALPHA) * _smoothedDistance;
     }
 }
 
@@ -103,5 +127,6 @@ void UltrasonicSensor::reset()
 {
     _lastDistance = 0;
     _smoothedDistance = 0;
-    _state = IDLE;
-}
\ No newline at end of file
+    _pending = false;
+    _edges = 0;
+}
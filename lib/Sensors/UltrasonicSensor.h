@@ -6,6 +6,10 @@
 /**
  * HC-SR04 Ultrasonic Sensor Wrapper
  * Non-blocking distance measurement with filtering
+ *
+ * Echo edges are timestamped in a pin-change interrupt, so a measurement
+ * completes correctly no matter how rarely poll() is called. The sensor can
+ * run self-timed via update(), or be fired by a scheduler via trigger()/poll().
  */
 class UltrasonicSensor
 {
@@ -21,10 +25,27 @@ public:
     float getDistance();
 
     /**
-     * Trigger a measurement (call periodically)
+     * Self-timed mode: trigger every MEASURE_INTERVAL_MS and collect results
+     * (call periodically)
      */
     void update();
 
+    /**
+     * Fire a ping now (10 us trigger pulse)
+     * @return false if a measurement is still pending or the echo line is
+     *         still high from a previous ping
+     */
+    bool trigger(uint32_t nowUs);
+
+    /**
+     * Collect the pending measurement
+     * @param distanceCm Result when complete: cm, or -1 on timeout/invalid
+     * @return true once the pending measurement has completed
+     */
+    bool poll(uint32_t nowUs, float &distanceCm);
+
+    bool isPending() const { return _pending; }
+
     /**
      * Check if obstacle detected below threshold
      */
@@ -35,29 +56,48 @@ public:
      */
     float getSmoothedDistance() { return _smoothedDistance; }
 
+    /**
+     * Number of valid measurements completed so far
+     * (changes only when a new echo was measured)
+     */
+    uint32_t getMeasurementCount() const { return _measurementCount; }
+
+    /**
+     * Number of completed measurement attempts (valid, invalid or timeout)
+     */
+    uint32_t getAttemptCount() const { return _attemptCount; }
+
     /**
      * Reset sensor state
      */
     void reset();
 
+    static constexpr unsigned long ECHO_TIMEOUT_US = 30000UL;
+
 private:
     uint8_t _trigPin, _echoPin;
     float _lastDistance;
     float _smoothedDistance;
     unsigned long _lastMeasureTime;
-    unsigned long _pulseStart;
+    uint32_t _measurementCount;
+    uint32_t _attemptCount;
 
-    // Non-blocking measurement states
-    enum MeasureState
-    {
-        IDLE,
-        WAITING_FOR_ECHO,
-        MEASURING
-    };
-    MeasureState _state;
+    // Pending measurement
+    bool _pending;
+    uint32_t _triggerUs;
+
+    // Written by the echo interrupt
+    volatile uint32_t _echoRiseUs;
+    volatile uint32_t _echoFallUs;
+    volatile uint8_t _edges;    // EDGE_RISE | EDGE_FALL seen since trigger
+
+    static constexpr uint8_t EDGE_RISE = 0x01;
+    static constexpr uint8_t EDGE_FALL = 0x02;
+
+    static void IRAM_ATTR echoISR(void *arg);
+    void finish(float distanceCm);
 
     static constexpr float EMA_ALPHA = 0.3f;
-    static constexpr unsigned long ECHO_TIMEOUT_US = 30000UL;
     static constexpr unsigned long MEASURE_INTERVAL_MS = 60UL;
 };
 
@@ -6,6 +6,7 @@ import {
 } from 'lucide-react';
 import { useNightfallWS } from './hooks/useNightfallWS';
 import PIDTuner from './components/PIDTuner';
+import LocalMap from './components/LocalMap';
 
 // --- Utility Components ---
 
@@ -124,7 +125,7 @@ const DistanceWidget = ({ front, rear, trend }) => {
 // --- Main App ---
 
 export default function RobotDashboard() {
-  const { telemetry, connectionStatus, connectionStats, sendUiCmd, lastPing } = useNightfallWS();
+  const { telemetry, connectionStatus, connectionStats, sendUiCmd, lastPing, localMap, autotune } = useNightfallWS();
   const { sensors, motors, state, network, server_clients } = telemetry;
   
   // Stats & Trends
@@ -261,6 +262,9 @@ export default function RobotDashboard() {
                 CAM: {network.camera ? 'OK' : 'LOST'}
              </span>
            </div>
+           <div className="absolute bottom-4 right-4 opacity-90">
+             <LocalMap map={localMap} />
+           </div>
            <div className="absolute inset-0 border-2 border-white/10 rounded-xl pointer-events-none group-hover:border-white/20 transition-all" />
         </div>
 
@@ -315,6 +319,7 @@ export default function RobotDashboard() {
           <PIDTuner 
             sendUiCmd={sendUiCmd} 
             telemetry={telemetry} 
+            autotune={autotune}
             isConnected={connectionStatus === 'connected'} 
           />
         </div>
@@ -0,0 +1,56 @@
+import { useEffect, useRef } from 'react';
+
+const WINDOW_CELLS = 64;
+const SCALE = 3; // Canvas pixels per cell
+
+// Renders the rear board's rolling occupancy grid (log-odds per cell)
+export default function LocalMap({ map }) {
+  const canvasRef = useRef(null);
+
+  useEffect(() => {
+    const canvas = canvasRef.current;
+    if (!canvas) return;
+    const ctx = canvas.getContext('2d');
+    const size = WINDOW_CELLS * SCALE;
+    const [ox, oy] = map.origin;
+
+    ctx.fillStyle = '#111827';
+    ctx.fillRect(0, 0, size, size);
+
+    for (const [key, cells] of map.tiles) {
+      const [tx, ty] = key.split(',').map(Number);
+      for (let i = 0; i < cells.length; i++) {
+        const v = cells[i];
+        if (v === 0) continue;
+        const cx = tx * map.tile + (i % map.tile) - ox;
+        const cy = ty * map.tile + Math.floor(i / map.tile) - oy;
+        // Occupied = red, free = dark green; intensity follows confidence
+        const a = Math.min(Math.abs(v) / 100, 1);
+        ctx.fillStyle = v > 0 ? `rgba(239,68,68,${a})` : `rgba(16,185,129,${a * 0.5})`;
+        // World y points left/up; flip so +y is up on screen
+        ctx.fillRect(cx * SCALE, size - (cy + 1) * SCALE, SCALE, SCALE);
+      }
+    }
+
+    // Robot pose marker
+    const [px, py, th] = map.pose;
+    const rx = (px / map.cellCm - ox) * SCALE;
+    const ry = size - (py / map.cellCm - oy) * SCALE;
+    ctx.strokeStyle = '#60a5fa';
+    ctx.lineWidth = 2;
+    ctx.beginPath();
+    ctx.arc(rx, ry, 4, 0, Math.PI * 2);
+    ctx.moveTo(rx, ry);
+    ctx.lineTo(rx + Math.cos(th) * 10, ry - Math.sin(th) * 10);
+    ctx.stroke();
+  }, [map.version]);
+
+  return (
+    <canvas
+      ref={canvasRef}
+      width={WINDOW_CELLS * SCALE}
+      height={WINDOW_CELLS * SCALE}
+      className="rounded border border-gray-700 bg-gray-900/80"
+    />
+  );
+}
@@ -1,11 +1,31 @@
-import { useState } from 'react';
+import { useState, useEffect } from 'react';
 
-export default function PIDTuner({ sendUiCmd, telemetry, isConnected }) {
+export default function PIDTuner({ sendUiCmd, telemetry, autotune, isConnected }) {
   const [kP, setKP] = useState(4.0);
   const [kI, setKI] = useState(0.0);
   const [kD, setKD] = useState(1.0);
   const [enabled, setEnabled] = useState(true);
   const [expanded, setExpanded] = useState(false);
+  const [tuneRule, setTuneRule] = useState('zn');
+
+  // Relay autotune rules (names match RelayAutotuner on the robot)
+  const tuneRules = {
+    zn: 'Ziegler-Nichols',
+    zn_pi: 'Ziegler-Nichols PI',
+    tyreus_luyben: 'Tyreus-Luyben',
+    pessen: 'Pessen integral',
+    some_overshoot: 'Some overshoot',
+    no_overshoot: 'No overshoot'
+  };
+
+  // Show gains the robot applied after an autotune
+  useEffect(() => {
+    if (autotune?.state === 'done' && autotune.applied) {
+      setKP(autotune.kP);
+      setKI(autotune.kI);
+      setKD(autotune.kD);
+    }
+  }, [autotune]);
 
   // Presets
   const presets = {
@@ -26,6 +46,22 @@ export default function PIDTuner({ sendUiCmd, telemetry, isConnected }) {
     setEnabled(newEnabled);
   };
 
+  // Fixed gains (Apply) switch the speed/range schedule off; this brings it back
+  const toggleSchedule = () => {
+    if (!isConnected) return;
+    sendUiCmd('gain_schedule_set', { enabled: !control.sched });
+  };
+
+  const startAutotune = () => {
+    if (!isConnected) return;
+    sendUiCmd('pid_autotune', { rule: tuneRule, apply: true });
+  };
+
+  const cancelAutotune = () => {
+    if (!isConnected) return;
+    sendUiCmd('pid_autotune_cancel');
+  };
+
   const loadPreset = (preset) => {
     setKP(preset.kP);
     setKI(preset.kI);
@@ -51,6 +87,9 @@ export default function PIDTuner({ sendUiCmd, telemetry, isConnected }) {
           {!enabled && (
             <span className="text-xs bg-red-600 px-2 py-0.5 rounded text-white">DISABLED</span>
           )}
+          {telemetry?.control?.sched && (
+            <span className="text-xs bg-indigo-600 px-2 py-0.5 rounded text-white">SCHEDULED</span>
+          )}
           <span className="text-xs text-gray-400">({timing.loop_us}μs)</span>
         </div>
         <span className="text-gray-400">{expanded ? '▼' : '▶'}</span>
@@ -126,6 +165,58 @@ export default function PIDTuner({ sendUiCmd, telemetry, isConnected }) {
             </div>
           </div>
 
+          {/* Gain schedule (gains follow measured speed and range) */}
+          <div className="flex justify-between items-center bg-gray-800 p-3 rounded mb-3 border border-gray-700 text-xs">
+            <span className="text-gray-400">
+              Gains in use: <span className="text-white font-mono">
+                P {control.kP?.toFixed(2) ?? '—'} I {control.kI?.toFixed(2) ?? '—'} D {control.kD?.toFixed(2) ?? '—'}
+              </span>
+            </span>
+            <button
+              onClick={toggleSchedule}
+              disabled={!isConnected}
+              className="bg-indigo-600 hover:bg-indigo-700 disabled:bg-gray-700 disabled:cursor-not-allowed px-3 py-1 rounded text-white transition-colors"
+            >
+              {control.sched ? 'Use fixed' : 'Use schedule'}
+            </button>
+          </div>
+
+          {/* Relay Autotune (robot idle, facing a wall) */}
+          <div className="bg-gray-800 p-3 rounded mb-3 border border-gray-700">
+            <div className="flex justify-between items-center text-xs mb-2">
+              <span className="text-gray-400">Autotune</span>
+              <span className="text-gray-300 font-mono">
+                {control.tune === 'running' ? `running (${control.tune_cyc} cycles)` : (control.tune || 'idle')}
+              </span>
+            </div>
+            <div className="flex gap-2">
+              <select
+                value={tuneRule}
+                onChange={e => setTuneRule(e.target.value)}
+                disabled={!isConnected || control.tune === 'running'}
+                className="flex-1 bg-gray-900 border border-gray-700 rounded px-2 py-1 text-sm text-white disabled:opacity-50"
+              >
+                {Object.entries(tuneRules).map(([key, label]) => (
+                  <option key={key} value={key}>{label}</option>
+                ))}
+              </select>
+              <button
+                onClick={control.tune === 'running' ? cancelAutotune : startAutotune}
+                disabled={!isConnected}
+                className="bg-purple-600 hover:bg-purple-700 disabled:bg-gray-700 disabled:cursor-not-allowed px-3 py-1 rounded text-sm text-white transition-colors"
+              >
+                {control.tune === 'running' ? 'Cancel' : 'Autotune'}
+              </button>
+            </div>
+            {autotune && (
+              <div className="text-xs font-mono mt-2 text-gray-300">
+                {autotune.state === 'done'
+                  ? `Ku ${autotune.ku.toFixed(2)}  Pu ${autotune.pu.toFixed(2)}s  amp ${autotune.amp.toFixed(1)}cm  spread ${(autotune.p_spread * 100).toFixed(0)}%`
+                  : `Failed: ${autotune.reason}`}
+              </div>
+            )}
+          </div>
+
           {/* Live Readout */}
           <div className="bg-gray-800 p-3 rounded mb-3 border border-gray-700">
             <div className="text-xs text-gray-400 mb-2">Live Control Data</div>
@@ -3,7 +3,24 @@ import { useState, useEffect, useRef, useCallback } from 'react';
 const PACKET_TYPES = {
   TELEMETRY: 'telemetry',
   STATUS: 'status',
-  PING: 'ping'
+  PING: 'ping',
+  MAP_DELTA: 'map_delta',
+  AUTOTUNE: 'autotune'
+};
+
+const MAP_WINDOW_CELLS = 64;
+
+// Expand base64 RLE (run, value) byte pairs into signed log-odds cells
+const decodeTile = (b64, cellCount) => {
+  const bytes = Uint8Array.from(atob(b64), c => c.charCodeAt(0));
+  const cells = new Int8Array(cellCount);
+  let pos = 0;
+  for (let i = 0; i + 1 < bytes.length && pos < cellCount; i += 2) {
+    const value = (bytes[i + 1] << 24) >> 24; // uint8 -> int8
+    cells.fill(value, pos, Math.min(pos + bytes[i], cellCount));
+    pos += bytes[i];
+  }
+  return cells;
 };
 
 const WS_URL = 'ws://192.168.4.1:8888';
@@ -48,6 +65,15 @@ export const useNightfallWS = () => {
 
   const [connectionStatus, setConnectionStatus] = useState('disconnected'); // disconnected, connected, error
   const [lastPing, setLastPing] = useState(0);
+  const [localMap, setLocalMap] = useState({
+    cellCm: 5,
+    tile: 8,
+    origin: [0, 0],
+    pose: [0, 0, 0],
+    tiles: new Map(),
+    version: 0
+  });
+  const [autotune, setAutotune] = useState(null); // Last relay autotune outcome
   const [connectionStats, setConnectionStats] = useState({
     msgRate: 0,
     msgsReceived: 0,
@@ -61,6 +87,7 @@ export const useNightfallWS = () => {
   const reconnectTimeoutRef = useRef(null);
   const msgCountRef = useRef(0);
   const lastRateCheckRef = useRef(Date.now());
+  const mapTilesRef = useRef(new Map());
 
   // Calculate Message Rate
   useEffect(() => {
@@ -86,6 +113,9 @@ export const useNightfallWS = () => {
 
     ws.onopen = () => {
       console.log('[WS] Connected');
+      // Registers as the dashboard link (LinkSupervisor) - until then the
+      // robot can't tell this socket from a board that hasn't registered yet
+      ws.send(JSON.stringify({ type: PACKET_TYPES.STATUS, role: 'dashboard', status: 'connected' }));
       setConnectionStatus('connected');
       setConnectionStats(prev => ({ 
         ...prev, 
@@ -123,6 +153,33 @@ export const useNightfallWS = () => {
           if (data.ts) {
              setLastPing(now - data.ts); // Approximate latency if clocks synced roughly (or just purely interval)
           }
+        } else if (data.type === PACKET_TYPES.MAP_DELTA) {
+          const tiles = mapTilesRef.current;
+          const tileCells = data.tile * data.tile;
+          for (const [tx, ty, b64] of data.tiles || []) {
+            tiles.set(`${tx},${ty}`, decodeTile(b64, tileCells));
+          }
+
+          // Drop tiles that scrolled out of the robot's window
+          const [ox, oy] = data.origin;
+          for (const key of tiles.keys()) {
+            const [tx, ty] = key.split(',').map(Number);
+            const cx = tx * data.tile, cy = ty * data.tile;
+            if (cx < ox || cy < oy || cx >= ox + MAP_WINDOW_CELLS || cy >= oy + MAP_WINDOW_CELLS) {
+              tiles.delete(key);
+            }
+          }
+
+          setLocalMap(prev => ({
+            cellCm: data.cell_cm,
+            tile: data.tile,
+            origin: data.origin,
+            pose: data.pose,
+            tiles,
+            version: prev.version + 1
+          }));
+        } else if (data.type === PACKET_TYPES.AUTOTUNE) {
+          setAutotune({ ...data, receivedAt: now });
         }
       } catch (err) {
         console.error('[WS] Parse error:', err);
@@ -185,6 +242,8 @@ export const useNightfallWS = () => {
     connectionStatus,
     connectionStats,
     sendUiCmd,
-    lastPing
+    lastPing,
+    localMap,
+    autotune
   };
 };
@@ -34,7 +34,7 @@ L298N frontMotorsBank2(
 
 // WS Client
 // Connects to Back ESP32 (AP: ProjectNightfall, IP: 192.168.4.1)
-WSClient_Manager wsClient(WIFI_SSID, WIFI_PASSWORD, "192.168.4.1", WIFI_SERVER_PORT, "front");
+WSClient_Manager wsClient(WIFI_SSID, WIFI_PASSWORD, WIFI_SERVER_IP, WIFI_SERVER_PORT, "front");
 
 // ============================================
 // STATE VARIABLES
@@ -71,7 +71,8 @@ void setup()
 
     initMotors();
 
-    // Start WebSocket Client
+    // Start WebSocket Client (fixed address: no DHCP on reconnect)
+    wsClient.setStaticIP(WIFI_FRONT_STATIC_IP);
     wsClient.begin();
     wsClient.setMessageHandler(handleWebSocketMessage);
 
@@ -90,6 +91,10 @@ void loop()
     // Must call update() for arduinoWebSockets
     wsClient.update();
 
+    // Chain hardware fade segments (no-op when ramping is off)
+    frontMotorsBank1.update();
+    frontMotorsBank2.update();
+
     unsigned long now = millis();
 
     // ========================================
@@ -134,10 +139,37 @@ void loop()
 void initMotors()
 {
     DEBUG_PRINTLN("[Motors] Initializing...");
-    frontMotorsBank1.begin();
-    frontMotorsBank2.begin();
+    if (!frontMotorsBank1.begin(MOTOR_PWM_FREQ, MOTOR_PWM_RESOLUTION) ||
+        !frontMotorsBank2.begin(MOTOR_PWM_FREQ, MOTOR_PWM_RESOLUTION))
+    {
+        DEBUG_PRINTF("[Motors] ERROR: LEDC can't do %d Hz at %d bits\n", MOTOR_PWM_FREQ, MOTOR_PWM_RESOLUTION);
+    }
+
+    // Uncalibrated: plain deadband on all four
+    MotorLinearizer lin;
+    lin.setDeadband(MOTOR_DEADBAND_DUTY);
+    for (uint8_t m = 0; m < 2; m++)
+    {
+        frontMotorsBank1.setLinearizer(m, lin);
+        frontMotorsBank2.setLinearizer(m, lin);
+    }
+
     frontMotorsBank1.stopMotors();
     frontMotorsBank2.stopMotors();
+
+#if FRONT_MOTOR_RAMP_MS > 0
+    frontMotorsBank1.setRampTime(FRONT_MOTOR_RAMP_MS);
+    frontMotorsBank2.setRampTime(FRONT_MOTOR_RAMP_MS);
+    if (frontMotorsBank1.setRampBackend(L298N::RAMP_HW_FADE) &&
+        frontMotorsBank2.setRampBackend(L298N::RAMP_HW_FADE))
+    {
+        DEBUG_PRINTF("[Motors] LEDC fade ramping, %d ms full scale\n", FRONT_MOTOR_RAMP_MS);
+    }
+    else
+    {
+        DEBUG_PRINTLN("[Motors] WARNING: LEDC fade unavailable, commands applied instantly");
+    }
+#endif
 }
 
 void handleWebSocketMessage(const JsonDocument &doc)
@@ -147,7 +179,14 @@ void handleWebSocketMessage(const JsonDocument &doc)
     // P0 Fix #3: Handle emergency broadcasts immediately
     if (strcmp(msgType, "hazard_alert") == 0)
     {
-        // Immediate stop on any hazard from master
+        // Advisory warnings (e.g. gas rising) don't stop the motors
+        if (!(doc["critical"] | true))
+        {
+            DEBUG_PRINTLN("[SAFETY] Hazard warning received");
+            return;
+        }
+
+        // Immediate stop on any critical hazard from master
         frontMotorsBank1.stopMotors();
         frontMotorsBank2.stopMotors();
         lastMotorCmdTime = 0; // Reset timeout so motors stay stopped
@@ -174,8 +213,16 @@ void handleMotorCommand(int left, int right)
     lastMotorCmdTime = millis();
 
     // Apply to both banks (4 motors total)
-    frontMotorsBank1.setMotors(left, right);
-    frontMotorsBank2.setMotors(left, right);
+    if (frontMotorsBank1.getRampBackend() == L298N::RAMP_HW_FADE)
+    {
+        frontMotorsBank1.setMotorsRamped(left, right);
+        frontMotorsBank2.setMotorsRamped(left, right);
+    }
+    else
+    {
+        frontMotorsBank1.setMotors(left, right);
+        frontMotorsBank2.setMotors(left, right);
+    }
     // DEBUG_PRINTF("[Motors] Cmd: %d %d\n", left, right);
 }
 
@@ -2,7 +2,8 @@
  * Project Nightfall - Back ESP32 (Master Brain)
  *
  * Responsibilities:
- * - Sensor acquisition (2x ultrasonic, gas sensor)
+ * - Sensor acquisition (scheduled ultrasonic array, gas sensor)
+ * - Odometry & local occupancy grid (streamed to dashboard)
  * - Safety monitoring & hazard detection
  * - Obstacle avoidance & auto-climb logic
  * - Autonomous navigation
@@ -15,6 +16,7 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <esp_task_wdt.h>
+#include <LittleFS.h>
 
 #include "config.h"
 #include "pins.h"
@@ -23,12 +25,20 @@
 #include "UltrasonicSensor.h"
 #include "MQ2Sensor.h"
 #include "WiFiManager.h"
+#include "DashboardAssets.h"
 #include "MessageProtocol.h"
 #include "Autonomy.h"
 #include "SafetyManager.h"
+#include "SafetySupervisor.h"
 #include "SensorManager.h"
 #include "StateMachine.h"
+#include "EventQueue.h"
+#include "RelayAutotuner.h"
 #include "EncoderManager.h"
+#include "StallDetector.h"
+#include "Odometry.h"
+#include "OccupancyGrid.h"
+#include "LocalPlanner.h"
 
 // ============================================
 // GLOBAL OBJECTS
@@ -43,14 +53,23 @@ L298N rearMotors(
 // Modules
 Autonomy autonomyModule;
 SafetyManager safetyManager;
+SafetySupervisor safetySupervisor;
 SensorManager sensorManager;
 StateMachine fsm;
+RelayAutotuner autotuner;
 
 // Encoders (Phase 3.1)
 EncoderManager encoderManager;
+StallDetector stallDetector(DRIVE_FULL_SCALE_CM_S / WHEEL_CIRCUMFERENCE_CM * ENCODER_CPR);
+
+// Local mapping
+Odometry odometry(ROBOT_TRACK_WIDTH_CM);
+OccupancyGrid localMap;
+LocalPlanner localPlanner;
 
 // WebSocket Server (AP + Server)
 WSServer_Manager wsServer(WIFI_SERVER_PORT);
+DashboardAssets dashboardAssets(LittleFS, DASHBOARD_FS_ROOT);
 
 // ============================================
 // STATE VARIABLES
@@ -58,7 +77,11 @@ WSServer_Manager wsServer(WIFI_SERVER_PORT);
 
 NavigationState navState = NAV_FORWARD;
 
-// Motor speeds
+// Motor speeds (requested = before safety speed limit)
+int requestedLeftSpeed = 0;
+int requestedRightSpeed = 0;
+int requestedFrontLeftSpeed = 0;
+int requestedFrontRightSpeed = 0;
 int rearLeftSpeed = 0;
 int rearRightSpeed = 0;
 int frontLeftSpeed = 0;
@@ -68,9 +91,88 @@ int frontRightSpeed = 0;
 unsigned long lastNavUpdate = 0;
 unsigned long lastTelemetryBroadcast = 0;
 unsigned long lastEncoderUpdate = 0; // Phase 3.1: Encoder update timing
+unsigned long lastMotionUpdate = 0;
+unsigned long lastMapStream = 0;
+uint32_t lastSampleSeq[SensorManager::MAX_ULTRASONIC] = {0}; // Last ultrasonic samples integrated into the map
 uint16_t g_lastLoopTimeUs = 0;       // Phase 2.5: Loop timing for telemetry
 
+// ui_cmd messages, decoded on the WebSocket task and applied by loop()
+enum UiCommandType : uint8_t
+{
+    UI_CMD_MODE,            // Mode machine event (auto on/off, drive, stop, clear)
+    UI_CMD_PID_TUNE,
+    UI_CMD_PID_ENABLE,
+    UI_CMD_AUTOTUNE_CANCEL
+};
+
+struct UiCommand
+{
+    UiCommandType type;
+    uint8_t event;          // UI_CMD_MODE: RobotEventId
+    int16_t left, right;    // ROBOT_EV_DRIVE speeds
+    float gains[3];         // UI_CMD_PID_TUNE: kP, kI, kD
+    bool enable;            // UI_CMD_PID_ENABLE
+    uint32_t postedMs;
+};
+
+static const uint8_t UI_COMMAND_DEPTH = 16;
+EventQueue<UiCommand, UI_COMMAND_DEPTH> uiCommands;
+uint32_t uiCommandsCoalesced = 0;   // Drive commands superseded before they were applied
+uint32_t uiCommandMaxLatencyMs = 0; // Worst post -> applied delay
+
+// Autotune request, set by loop() from a UiEdit and started by updateAutotune()
+RelayAutotuner::Config autotuneRequest;
+bool autotuneStartRequested = false;
+bool autotuneCancelRequested = false;
+bool autotuneApply = false;
+
+// Gain schedule edit, applied (and saved) by loop()
+struct ScheduleEdit
+{
+    bool setSpeeds, setRanges, setGains, setEnabled, setCell;
+    bool save, reset;
+    float speeds[GainSchedule::SPEED_POINTS];
+    float ranges[GainSchedule::RANGE_POINTS];
+    GainSchedule::Gains gains[GainSchedule::SPEED_POINTS][GainSchedule::RANGE_POINTS];
+    bool enabled;
+    uint8_t cellSpeed, cellRange;
+    GainSchedule::Gains cell;
+};
+
+// Motor calibration edit, applied by loop()
+struct MotorCalEdit
+{
+    uint8_t motor;          // 0 = left, 1 = right, 0xFF = none (get)
+    bool setDeadband, setCurve;
+    bool save, reset;
+    float deadband;
+    float curve[MotorLinearizer::CURVE_POINTS];
+};
+static const char *MOTOR_CAL_KEYS[2] = {"rear_l", "rear_r"};
+
+// ui_cmd messages too bulky for a UiCommand slot; same path, own queue
+enum UiEditType : uint8_t
+{
+    UI_EDIT_AUTOTUNE,
+    UI_EDIT_SCHEDULE,
+    UI_EDIT_MOTOR_CAL
+};
+
+struct UiEdit
+{
+    UiEditType type;
+    RelayAutotuner::Config autotune;    // UI_EDIT_AUTOTUNE
+    bool autotuneApply;
+    ScheduleEdit schedule;              // UI_EDIT_SCHEDULE
+    MotorCalEdit motorCal;              // UI_EDIT_MOTOR_CAL
+    uint32_t postedMs;
+};
+
+static const uint8_t UI_EDIT_DEPTH = 4;
+EventQueue<UiEdit, UI_EDIT_DEPTH> uiEdits;
+
 #define ENCODER_UPDATE_INTERVAL_MS 5 // 200Hz
+#define MOTION_UPDATE_INTERVAL_MS 20 // 50Hz - encoder-closed turns and backups
 
 // ============================================
 // FUNCTION DECLARATIONS
@@ -78,11 +180,31 @@ uint16_t g_lastLoopTimeUs = 0;       // Phase 2.5: Loop timing for telemetry
 
 void initMotors();
 void initComms();
+void reportSupervisorTrip(HazardType hazard, const char *description, bool latched);
+void initModeHooks();
 void updateAutonomousNav();
 void broadcastTelemetry();
+void updateLocalMap();
+void broadcastMapDelta();
 void sendMotorCommandToFront(int leftSpeed, int rightSpeed);
-void sendMotorCommandToFront(int leftSpeed, int rightSpeed);
+void driveMotors(int leftSpeed, int rightSpeed);
+void driveMotors(int leftSpeed, int rightSpeed, int frontLeft, int frontRight);
+void enforceSpeedLimit();
+void updateAutotune();
+void reportAutotune(const char *reason);
+void setApproachGains(float &kP, float &kI, float &kD);
+void applyScheduleEdit(const ScheduleEdit &e);
+void reportSchedule(bool ok, bool saved);
+void applyMotorCalEdit(const MotorCalEdit &e);
+void reportMotorCal(bool ok, bool saved);
+float getRearSpeedCmS();
 void handleWebSocketMessage(const JsonDocument &doc, AsyncWebSocketClient *client);
+bool postUiCommand(UiCommand cmd);
+bool postUiEdit(UiEdit &edit);
+void rejectUiCommand(AsyncWebSocketClient *client, const char *cmd);
+void processUiCommands();
+void applyUiCommand(const UiCommand &cmd);
+void processUiEdits();
 
 // ============================================
 // SETUP
@@ -102,7 +224,23 @@ void setup()
     encoderManager.begin(); // Phase 3.1: Initialize PCNT encoders
     initComms();
 
-    fsm.setIdle();
+    autonomyModule.setLocalMap(&localMap);
+    autonomyModule.setPlanner(&localPlanner);
+
+    // Tuned approach gains survive a reboot
+    GainSchedule schedule = autonomyModule.getApproachSchedule();
+    if (schedule.load(GAIN_SCHEDULE_NVS_NAMESPACE))
+    {
+        autonomyModule.setApproachSchedule(schedule);
+        DEBUG_PRINTLN("[PID] Approach gain schedule loaded from NVS");
+    }
+
+    initModeHooks();
+    fsm.dispatch(ROBOT_EV_READY);
+
+    // Independent of loop() from here on
+    safetySupervisor.begin(&rearMotors, &sensorManager);
+
     DEBUG_PRINTLN("INIT COMPLETE - Ready for connections");
 
     esp_task_wdt_init(WATCHDOG_TIMEOUT_MS / 1000, true);
@@ -118,13 +256,26 @@ void loop()
     unsigned long loopStart = millis();
     unsigned long loopStartUs = micros(); // Phase 2.5: Microsecond timing
     esp_task_wdt_reset();
+    safetySupervisor.feedLoop();
 
     // WS Server Cleanup (Keep Alive)
     wsServer.update();
 
+    // Apply commands, mode changes and gain edits queued by WebSocket callbacks
+    processUiCommands();
+    processUiEdits();
+
     // Update Sensors (Non-blocking internal)
     sensorManager.update();
 
+    // Fire the sensors facing the way we're moving more often
+    if (rearLeftSpeed > 0 && rearRightSpeed > 0)
+        sensorManager.setTravelDirection(0.0f);
+    else if (rearLeftSpeed < 0 && rearRightSpeed < 0)
+        sensorManager.setTravelDirection(PI);
+    else
+        sensorManager.clearTravelDirection();
+
     // ========================================
     // ENCODERS (Phase 3.1) - 200Hz update
     // ========================================
@@ -132,22 +283,60 @@ void loop()
     {
         lastEncoderUpdate = loopStart;
         encoderManager.update();
+        odometry.update(encoderManager.getDistanceCm(WHEEL_REAR_LEFT),
+                        encoderManager.getDistanceCm(WHEEL_REAR_RIGHT));
+
+        // Applied duty vs wheel counts: stall / free-spin / slip per wheel
+        int commands[StallDetector::WHEELS] = {rearMotors.getMotor1Speed(), rearMotors.getMotor2Speed()};
+        int32_t counts[StallDetector::WHEELS] = {encoderManager.getCounts(WHEEL_REAR_LEFT),
+                                                 encoderManager.getCounts(WHEEL_REAR_RIGHT)};
+        bool fresh = !encoderManager.isStale(WHEEL_REAR_LEFT) && !encoderManager.isStale(WHEEL_REAR_RIGHT);
+        stallDetector.update(commands, counts, fresh, loopStart);
     }
 
+    // Integrate fresh range samples into the local map
+    updateLocalMap();
+
     // ========================================
     // SAFETY FIRST - Check before any control logic
     // ========================================
-    if (!safetyManager.check(sensorManager.getGasLevel(), sensorManager.getFrontDistance()))
+    // The guard judges the request, not what its own limit let through
+    safetyManager.setMotion((requestedLeftSpeed + requestedRightSpeed) / 2, getRearSpeedCmS());
+    safetyManager.setRangeQuality(sensorManager.getFrontConfidence());
+    safetyManager.setStall(stallDetector.getStallDirection(), stallDetector.getLongestStallMs(loopStart));
+
+    // A climb pushes on the edge ahead on purpose
+    bool climbing = fsm.isAutonomous() && autonomyModule.getNavState() == NAV_CLIMBING;
+    safetyManager.setClimbing(climbing);
+    safetySupervisor.setClimbing(climbing);
+    safetyManager.setLinkStates(wsServer.getLinkState(LINK_ROLE_FRONT),
+                                wsServer.getLinkState(LINK_ROLE_DASHBOARD));
+
+    // A stale range is passed as invalid so the guard can't act on a frozen value
+    float guardDist = sensorManager.isFrontStale() ? -1.0f : sensorManager.getFrontDistance();
+
+    // The supervisor task may already have cut the outputs - tell the front from here
+    if (safetySupervisor.consumeTrip())
+    {
+        reportSupervisorTrip(safetySupervisor.getTripHazard(), safetySupervisor.getTripDescription(), true);
+        if (!fsm.isEmergency()) fsm.dispatch(ROBOT_EV_HAZARD);
+
+        DEBUG_PRINTF("[Safety] Supervisor trip: %s (%lu us)\n", safetySupervisor.getTripDescription(),
+                     (unsigned long)safetySupervisor.getStats().lastLatencyUs);
+    }
+    if (safetySupervisor.consumeStallCut())
+    {
+        reportSupervisorTrip(HAZARD_CONTROL_STALL, "CONTROL LOOP STALLED - OUTPUTS CUT", false);
+        DEBUG_PRINTLN("[Safety] Loop stalled - supervisor cut the outputs");
+    }
+    if (safetySupervisor.isTripped()) goto end_loop;
+
+    if (!safetyManager.check(sensorManager.getGasLevel(), guardDist))
     {
         if (!fsm.isEmergency())
         {
-            // Transition to Emergency
-            fsm.triggerEmergency();
-
-            rearMotors.stopMotors();
-            autonomyModule.reset();
-            autonomyModule.setPIDEnabled(false); // P1 Fix #1: Disable PID during emergency
-            sendMotorCommandToFront(0, 0);
+            // Transition to Emergency (entry action stops the drive)
+            fsm.dispatch(ROBOT_EV_HAZARD);
 
             // P0 Fix #12: Use correct hazard type
             const char *hazardType = (safetyManager.getHazardType() == HAZARD_GAS)
@@ -166,9 +355,97 @@ void loop()
         goto end_loop;
     }
 
+    // Graded gas warning (rate of rise) - advisory, front keeps driving
+    if (safetyManager.consumeGasWarning())
+    {
+        // From the detector itself: the manager's hazard text may be a
+        // higher-priority hazard evaluated on the same tick
+        const GasRiseDetector &gasRise = safetyManager.getGasRiseDetector();
+        String desc = String("GAS RISING - ") + gasRise.getLevelName() + " (" + String(gasRise.getSlope(), 1) + "/s)";
+
+        StaticJsonDocument<256> alert;
+        Msg::buildHazardAlert(alert, Msg::HAZARD_GAS, desc.c_str(), false);
+        alert["level"] = gasRise.getLevelName();
+        wsServer.broadcast(alert);
+
+        DEBUG_PRINTLN("[Safety] Gas warning: " + desc);
+    }
+
+    // Link policy change (lost / degraded / recovered)
+    if (safetyManager.consumeLinkChange())
+    {
+        // A manual command must not resume by itself after a lost link
+        if (safetyManager.isLinkLost() && !fsm.isAutonomous())
+        {
+            requestedLeftSpeed = 0;
+            requestedRightSpeed = 0;
+            requestedFrontLeftSpeed = 0;
+            requestedFrontRightSpeed = 0;
+        }
+
+        StaticJsonDocument<256> alert;
+        String desc = safetyManager.getLinkDescription();
+        Msg::buildHazardAlert(alert, Msg::HAZARD_CONNECTION, desc.c_str(), false);
+        alert["limit"] = safetyManager.getLinkLimit();
+        wsServer.broadcast(alert);
+
+        DEBUG_PRINTLN("[Safety] " + desc);
+    }
+
+    // Stall hold started or ended - advisory, the limits do the holding
+    if (safetyManager.consumeStallChange())
+    {
+        // From the stall state itself: the manager's hazard text may be a
+        // higher-priority hazard (lost link) evaluated on the same tick
+        int8_t hold = safetyManager.getStallHold();
+        bool held = hold != 0;
+        String desc = "MOTOR STALL CLEARED";
+        if (held)
+        {
+            desc = String("MOTOR STALL - ") + ((hold > 0) ? "forward" : "reverse") + " held (left " +
+                   StallDetector::stateName(stallDetector.getState(WHEEL_REAR_LEFT)) + ", right " +
+                   StallDetector::stateName(stallDetector.getState(WHEEL_REAR_RIGHT)) + ")";
+        }
+
+        StaticJsonDocument<256> alert;
+        Msg::buildHazardAlert(alert, Msg::HAZARD_MOTOR_STALL, desc.c_str(), false);
+        alert["held"] = held;
+        wsServer.broadcast(alert);
+
+        DEBUG_PRINTLN("[Safety] " + desc);
+    }
+
+    // Graded collision response: cap or stop forward motion without latching
+    enforceSpeedLimit();
+
+    // Relay autotune drives the robot itself while it runs (IDLE only)
+    updateAutotune();
+
     // ========================================
     // NAVIGATION - Only if safe
     // ========================================
+
+    // Local planner runs every tick with a fixed budget; nav reads its output
+    if (fsm.isAutonomous())
+    {
+        localPlanner.update(localMap, odometry.getX(), odometry.getY(), odometry.getHeading(),
+                            PLANNER_MAX_EXPANSIONS);
+    }
+
+    // Turn / backup primitives close on the encoders faster than the nav rate
+    if (fsm.isAutonomous() && (loopStart - lastMotionUpdate >= MOTION_UPDATE_INTERVAL_MS))
+    {
+        lastMotionUpdate = loopStart;
+        bool fresh = !encoderManager.isStale(WHEEL_REAR_LEFT) && !encoderManager.isStale(WHEEL_REAR_RIGHT);
+        if (autonomyModule.updateMotion(encoderManager.getDistanceCm(WHEEL_REAR_LEFT),
+                                        encoderManager.getDistanceCm(WHEEL_REAR_RIGHT), fresh))
+        {
+            navState = autonomyModule.getNavState();
+            driveMotors(autonomyModule.getLeftSpeed(), autonomyModule.getRightSpeed(),
+                        autonomyModule.getFrontLeftSpeed(), autonomyModule.getFrontRightSpeed());
+        }
+    }
+
     if (fsm.isAutonomous() && (loopStart - lastNavUpdate >= NAVIGATION_UPDATE_INTERVAL_MS))
     {
         lastNavUpdate = loopStart;
@@ -182,6 +459,13 @@ void loop()
         broadcastTelemetry();
     }
 
+    // Stream changed map tiles
+    if (loopStart - lastMapStream >= MAP_STREAM_INTERVAL_MS)
+    {
+        lastMapStream = loopStart;
+        broadcastMapDelta();
+    }
+
 end_loop:
     // Phase 2.5: Track loop execution time
     unsigned long loopEndUs = micros();
@@ -202,7 +486,25 @@ end_loop:
 void initMotors()
 {
     DEBUG_PRINTLN("[Motors] Initializing rear L298N driver...");
-    rearMotors.begin();
+    if (!rearMotors.begin(MOTOR_PWM_FREQ, MOTOR_PWM_RESOLUTION))
+    {
+        DEBUG_PRINTF("[Motors] ERROR: LEDC can't do %d Hz at %d bits\n", MOTOR_PWM_FREQ, MOTOR_PWM_RESOLUTION);
+    }
+
+    // Calibrated duty curves, else a plain deadband
+    for (uint8_t m = 0; m < 2; m++)
+    {
+        MotorLinearizer lin;
+        if (lin.load(MOTOR_CAL_NVS_NAMESPACE, MOTOR_CAL_KEYS[m]))
+        {
+            DEBUG_PRINTF("[Motors] %s duty curve loaded from NVS\n", MOTOR_CAL_KEYS[m]);
+        }
+        else
+        {
+            lin.setDeadband(MOTOR_DEADBAND_DUTY);
+        }
+        rearMotors.setLinearizer(m, lin);
+    }
     rearMotors.stopMotors();
 }
 
@@ -211,14 +513,92 @@ void initComms()
     // Start AP and WebSocket Server
     wsServer.begin();
 
+    // Dashboard from the filesystem image, if one was uploaded (pio run -t uploadfs)
+    if (LittleFS.begin(false) && dashboardAssets.begin())
+    {
+        wsServer.addHandler(&dashboardAssets);
+        DEBUG_PRINTF("[Dashboard] Serving on http://%s:%d/\n", WiFi.softAPIP().toString().c_str(), WIFI_SERVER_PORT);
+    }
+    else
+    {
+        DEBUG_PRINTLN("[Dashboard] No packed dashboard on LittleFS - WebSocket only");
+    }
+
     // Register Callback
     wsServer.setMessageHandler([](const JsonDocument &doc, AsyncWebSocketClient *client)
                                { handleWebSocketMessage(doc, client); });
 }
 
-// ============================================
-// AUTONOMOUS NAVIGATION
-// ============================================
+// Mode machine side effects - run from its entry/exit actions in loop()
+void initModeHooks()
+{
+    StateMachine::Hooks hooks = {};
+
+    hooks.stopDrive = []()
+    { driveMotors(0, 0); };
+
+    hooks.drive = [](int left, int right)
+    { driveMotors(left, right); };
+
+    hooks.startAutonomy = []()
+    {
+        // Explore along the heading we are facing when autonomy starts
+        localPlanner.setGoalHeading(odometry.getHeading());
+    };
+
+    hooks.stopAutonomy = []()
+    {
+        driveMotors(0, 0);
+        autonomyModule.reset(); // Clear PID integral/state
+        localPlanner.clearGoal();
+    };
+
+    hooks.enterEmergency = []()
+    {
+        driveMotors(0, 0);
+        autonomyModule.reset();
+        autonomyModule.setPIDEnabled(false); // P1 Fix #1: Disable PID during emergency
+
+        if (autotuner.isRunning())
+        {
+            autotuner.cancel();
+            reportAutotune("emergency");
+        }
+    };
+
+    hooks.clearEmergency = []()
+    {
+        DEBUG_PRINTLN("[SAFETY] Emergency cleared by operator");
+
+        // Reset safety manager latch (and the supervisor's motor cut)
+        safetyManager.reset();
+        safetySupervisor.reset();
+
+        // Re-enable PID for next autonomous run
+        autonomyModule.setPIDEnabled(true);
+
+        // Broadcast status update
+        StaticJsonDocument<256> alert;
+        Msg::buildStatus(alert, Msg::ROLE_BACK, "emergency_cleared", "Operator reset");
+        wsServer.broadcast(alert);
+    };
+
+    fsm.setHooks(hooks);
+}
+
+// Supervisor cut the rear outputs (in its own task) - loop() tells everyone
+void reportSupervisorTrip(HazardType hazard, const char *description, bool latched)
+{
+    const char *hazardType = (hazard == HAZARD_GAS)             ? Msg::HAZARD_GAS
+                             : (hazard == HAZARD_CONTROL_STALL) ? Msg::HAZARD_STALL
+                                                                : Msg::HAZARD_COLLISION;
+
+    // Critical either way: the front stops now and resumes on its next motor_cmd
+    StaticJsonDocument<256> alert;
+    Msg::buildHazardAlert(alert, hazardType, description);
+    alert["latched"] = latched;
+    wsServer.broadcast(alert);
+}
 
 // ============================================
 // AUTONOMOUS NAVIGATION
@@ -230,29 +610,327 @@ void updateAutonomousNav()
     {
         navState = NAV_IDLE;
         autonomyModule.reset();
-        rearMotors.stopMotors();
+        localPlanner.clearGoal();
+        driveMotors(0, 0);
         return;
     }
 
     // Update Autonomy Module
+    autonomyModule.setRangeQuality(sensorManager.getFrontConfidence(), sensorManager.getRearConfidence());
+    autonomyModule.setMeasuredSpeed(getRearSpeedCmS());
+    autonomyModule.setTraction(stallDetector);
     autonomyModule.update(sensorManager.getFrontDistance(), sensorManager.getRearDistance());
 
     // Get Results
     navState = autonomyModule.getNavState();
-    int leftSpd = autonomyModule.getLeftSpeed();
-    int rightSpd = autonomyModule.getRightSpeed();
 
-    // Apply to Rear Motors
+    // Apply to rear motors and sync to front (speed-limited)
+    driveMotors(autonomyModule.getLeftSpeed(), autonomyModule.getRightSpeed(),
+                autonomyModule.getFrontLeftSpeed(), autonomyModule.getFrontRightSpeed());
+}
+
+// ============================================
+// MOTOR OUTPUT (speed-limited)
+// ============================================
+
+static int limitSpeed(int speed)
+{
+    // Forward: collision/range/link limits. Reverse: link limit only -
+    // reversing doesn't close on the front obstacle
+    int forward = safetyManager.getSpeedLimit();
+    int reverse = safetyManager.getReverseLimit();
+    if (speed > forward) return forward;
+    if (speed < -reverse) return -reverse;
+    return speed;
+}
+
+void driveMotors(int leftSpeed, int rightSpeed)
+{
+    driveMotors(leftSpeed, rightSpeed, leftSpeed, rightSpeed);
+}
+
+void driveMotors(int leftSpeed, int rightSpeed, int frontLeft, int frontRight)
+{
+    requestedLeftSpeed = leftSpeed;
+    requestedRightSpeed = rightSpeed;
+    requestedFrontLeftSpeed = frontLeft;
+    requestedFrontRightSpeed = frontRight;
+
+    int leftSpd = limitSpeed(leftSpeed);
+    int rightSpd = limitSpeed(rightSpeed);
+    int frontLeftSpd = limitSpeed(frontLeft);
+    int frontRightSpd = limitSpeed(frontRight);
+
     rearMotors.setMotors(leftSpd, rightSpd);
+    safetySupervisor.setMotion((leftSpeed + rightSpeed) / 2, getRearSpeedCmS());
 
-    // Sync state to variables for telemetry (redundant but keeps compatibility for now)
+    // Sync state to variables for telemetry
     rearLeftSpeed = leftSpd;
     rearRightSpeed = rightSpd;
-    frontLeftSpeed = leftSpd;
-    frontRightSpeed = rightSpd;
+    frontLeftSpeed = frontLeftSpd;
+    frontRightSpeed = frontRightSpd;
+
+    sendMotorCommandToFront(frontLeftSpd, frontRightSpd);
+}
+
+void enforceSpeedLimit()
+{
+    int leftSpd = limitSpeed(requestedLeftSpeed);
+    int rightSpd = limitSpeed(requestedRightSpeed);
+
+    int frontLeftSpd = limitSpeed(requestedFrontLeftSpeed);
+    int frontRightSpd = limitSpeed(requestedFrontRightSpeed);
+
+    // Re-apply only when the limit changes the output (e.g. manual drive
+    // commands that are set once and never refreshed)
+    if (leftSpd != rearLeftSpeed || rightSpd != rearRightSpeed ||
+        frontLeftSpd != frontLeftSpeed || frontRightSpd != frontRightSpeed)
+    {
+        driveMotors(requestedLeftSpeed, requestedRightSpeed, requestedFrontLeftSpeed, requestedFrontRightSpeed);
+    }
+}
+
+float getRearSpeedCmS()
+{
+    if (encoderManager.isStale(WHEEL_REAR_LEFT) || encoderManager.isStale(WHEEL_REAR_RIGHT))
+        return -1.0f;
+
+    float rpm = (encoderManager.getRPM(WHEEL_REAR_LEFT) + encoderManager.getRPM(WHEEL_REAR_RIGHT)) / 2.0f;
+    return rpm * WHEEL_CIRCUMFERENCE_CM / 60.0f;
+}
+
+// ============================================
+// APPROACH LOOP TUNING
+// ============================================
+
+// Clamp to the safe ranges and apply to the approach controller
+void setApproachGains(float &kP, float &kI, float &kD)
+{
+    kP = constrain(kP, 0.0f, 20.0f); // Max P prevents oscillation
+    kI = constrain(kI, 0.0f, 2.0f);  // Max I prevents overshoot
+    kD = constrain(kD, 0.0f, 10.0f); // Max D prevents noise amplification
+
+    autonomyModule.setApproachPID(kP, kI, kD);
+}
+
+void updateAutotune()
+{
+    if (autotuneCancelRequested)
+    {
+        autotuneCancelRequested = false;
+        if (autotuner.isRunning())
+        {
+            autotuner.cancel();
+            driveMotors(0, 0);
+            reportAutotune("cancelled");
+        }
+    }
+
+    if (autotuneStartRequested)
+    {
+        autotuneStartRequested = false;
+        if (!fsm.isIdle() || sensorManager.isFrontStale())
+        {
+            reportAutotune(fsm.isIdle() ? "no_range" : "not_idle");
+        }
+        else
+        {
+            autotuner.start(autotuneRequest, millis());
+            DEBUG_PRINTF("[PID] Autotune started (relay +-%.0f, rule %s)\n", autotuneRequest.relayAmplitude,
+                         RelayAutotuner::ruleName(autotuneRequest.rule));
+        }
+    }
+
+    if (!autotuner.isRunning()) return;
+
+    // A drive or autonomy command took over - it owns the motors now
+    if (!fsm.isIdle())
+    {
+        autotuner.cancel();
+        reportAutotune("mode_change");
+        return;
+    }
+
+    if (sensorManager.isFrontStale())
+    {
+        autotuner.cancel();
+        driveMotors(0, 0);
+        reportAutotune("no_range");
+        return;
+    }
+
+    float output = autotuner.update(sensorManager.getFrontDistance(), millis());
+    if (autotuner.isRunning())
+    {
+        driveMotors((int)output, (int)output);
+        return;
+    }
+
+    driveMotors(0, 0);
+    reportAutotune(nullptr);
+}
+
+void applyScheduleEdit(const ScheduleEdit &e)
+{
+    bool ok = true;
+    bool saved = false;
+
+    if (e.reset)
+    {
+        autonomyModule.resetApproachSchedule();
+        GainSchedule::erase(GAIN_SCHEDULE_NVS_NAMESPACE);
+    }
+    else
+    {
+        GainSchedule schedule = autonomyModule.getApproachSchedule();
+        if (e.setSpeeds) ok &= schedule.setSpeedBreakpoints(e.speeds);
+        if (e.setRanges) ok &= schedule.setRangeBreakpoints(e.ranges);
+        if (e.setGains)
+        {
+            for (uint8_t s = 0; s < GainSchedule::SPEED_POINTS; s++)
+            {
+                for (uint8_t r = 0; r < GainSchedule::RANGE_POINTS; r++) ok &= schedule.setGains(s, r, e.gains[s][r]);
+            }
+        }
+        if (e.setCell) ok &= schedule.setGains(e.cellSpeed, e.cellRange, e.cell);
+        if (e.setEnabled) schedule.setEnabled(e.enabled);
+
+        // All or nothing
+        if (ok)
+        {
+            autonomyModule.setApproachSchedule(schedule);
+            if (e.save) saved = schedule.save(GAIN_SCHEDULE_NVS_NAMESPACE);
+        }
+    }
+
+    reportSchedule(ok, saved);
+}
+
+void reportSchedule(bool ok, bool saved)
+{
+    const GainSchedule &schedule = autonomyModule.getApproachSchedule();
+
+    StaticJsonDocument<2048> msg;
+    msg["type"] = "gain_schedule";
+    msg["ok"] = ok;
+    msg["saved"] = saved;
+    msg["enabled"] = schedule.isEnabled();
+
+    JsonArray speeds = msg.createNestedArray("speeds");
+    for (uint8_t s = 0; s < GainSchedule::SPEED_POINTS; s++) speeds.add(schedule.getSpeedBreakpoint(s));
+    JsonArray ranges = msg.createNestedArray("ranges");
+    for (uint8_t r = 0; r < GainSchedule::RANGE_POINTS; r++) ranges.add(schedule.getRangeBreakpoint(r));
+
+    // gains[speed][range] = [kP, kI, kD]
+    JsonArray gains = msg.createNestedArray("gains");
+    for (uint8_t s = 0; s < GainSchedule::SPEED_POINTS; s++)
+    {
+        JsonArray row = gains.createNestedArray();
+        for (uint8_t r = 0; r < GainSchedule::RANGE_POINTS; r++)
+        {
+            const GainSchedule::Gains &g = schedule.getGains(s, r);
+            JsonArray cell = row.createNestedArray();
+            cell.add(g.kP);
+            cell.add(g.kI);
+            cell.add(g.kD);
+        }
+    }
+
+    wsServer.publish(msg);
+}
+
+void applyMotorCalEdit(const MotorCalEdit &e)
+{
+    bool ok = true;
+    bool saved = false;
+
+    if (e.motor < 2)
+    {
+        MotorLinearizer lin = rearMotors.getLinearizer(e.motor);
+        if (e.reset)
+        {
+            MotorLinearizer::erase(MOTOR_CAL_NVS_NAMESPACE, MOTOR_CAL_KEYS[e.motor]);
+            lin.setDeadband(MOTOR_DEADBAND_DUTY);
+        }
+        if (e.setDeadband) ok &= lin.setDeadband(e.deadband);
+        if (e.setCurve) ok &= lin.setCurve(e.curve);
+
+        // All or nothing
+        if (ok)
+        {
+            rearMotors.setLinearizer(e.motor, lin);
+            if (e.save && !e.reset) saved = lin.save(MOTOR_CAL_NVS_NAMESPACE, MOTOR_CAL_KEYS[e.motor]);
+        }
+    }
+    else
+    {
+        ok = !(e.setDeadband || e.setCurve || e.reset);  // Edit without a valid motor
+    }
 
-    // Sync to front
-    sendMotorCommandToFront(frontLeftSpeed, frontRightSpeed);
+    reportMotorCal(ok, saved);
+}
+
+void reportMotorCal(bool ok, bool saved)
+{
+    StaticJsonDocument<768> msg;
+    msg["type"] = "motor_cal";
+    msg["ok"] = ok;
+    msg["saved"] = saved;
+    msg["freq"] = MOTOR_PWM_FREQ;
+    msg["bits"] = MOTOR_PWM_RESOLUTION;
+
+    // motors[left, right] = {deadband, curve[]}
+    JsonArray motors = msg.createNestedArray("motors");
+    for (uint8_t m = 0; m < 2; m++)
+    {
+        const MotorLinearizer &lin = rearMotors.getLinearizer(m);
+        JsonObject entry = motors.createNestedObject();
+        entry["deadband"] = lin.getDeadband();
+        JsonArray curve = entry.createNestedArray("curve");
+        for (uint8_t i = 0; i < MotorLinearizer::CURVE_POINTS; i++) curve.add(lin.getCurvePoint(i));
+    }
+
+    wsServer.publish(msg);
+}
+
+// Broadcast the outcome (and apply the proposed gains when asked to)
+void reportAutotune(const char *reason)
+{
+    const RelayAutotuner::Result &r = autotuner.getResult();
+    bool done = !reason && autotuner.getState() == RelayAutotuner::TUNE_DONE;
+
+    StaticJsonDocument<384> msg;
+    msg["type"] = "autotune";
+    msg["state"] = reason ? "failed" : RelayAutotuner::stateName(autotuner.getState());
+    msg["reason"] = reason ? reason : RelayAutotuner::failureName(autotuner.getFailure());
+    msg["cycles"] = r.cycles;
+    msg["ms"] = r.durationMs;
+
+    if (done)
+    {
+        float kP = r.kP, kI = r.kI, kD = r.kD;
+        if (autotuneApply) setApproachGains(kP, kI, kD);
+
+        msg["rule"] = RelayAutotuner::ruleName(r.rule);
+        msg["ku"] = r.ku;
+        msg["pu"] = r.puSec;
+        msg["amp"] = r.amplitude;
+        msg["p_spread"] = r.periodSpread;
+        msg["a_spread"] = r.amplitudeSpread;
+        msg["kP"] = kP;
+        msg["kI"] = kI;
+        msg["kD"] = kD;
+        msg["applied"] = autotuneApply;
+
+        DEBUG_PRINTF("[PID] Autotune: Ku=%.2f Pu=%.2fs -> P=%.2f I=%.2f D=%.2f%s\n", r.ku, r.puSec, kP, kI, kD,
+                     autotuneApply ? " (applied)" : "");
+    }
+    else
+    {
+        DEBUG_PRINTF("[PID] Autotune failed: %s\n", msg["reason"].as<const char *>());
+    }
+
+    wsServer.publish(msg);
 }
 
 // ============================================
@@ -268,29 +946,73 @@ void sendMotorCommandToFront(int leftSpeed, int rightSpeed)
     cmd.target = "front";
 
     Msg::buildMotorCmd(doc, cmd);
-    wsServer.broadcast(doc);
+
+    // Front only - dashboards see the speeds in telemetry
+    wsServer.sendToRole(LINK_ROLE_FRONT, doc);
 }
 
 void broadcastTelemetry()
 {
-    StaticJsonDocument<1024> doc; // P2 Fix #9: Increased to 1KB for safety margin
+    StaticJsonDocument<3072> doc; // P2 Fix #9: ~130 slots x 16 B with traces and control/tune - keep margin
     Msg::TelemetryData data;
 
     // Populate Data
     data.frontDist = sensorManager.getFrontDistance();
     data.rearDist = sensorManager.getRearDistance();
     data.gasLevel = sensorManager.getGasLevel();
+    data.gasMillivolts = sensorManager.getGasMillivolts();
+    data.frontConfidence = sensorManager.getFrontConfidence();
+    data.rearConfidence = sensorManager.getRearConfidence();
+    data.frontDropouts = sensorManager.getFrontDropouts();
+    data.rearDropouts = sensorManager.getRearDropouts();
     data.frontLeftSpeed = frontLeftSpeed;
     data.frontRightSpeed = frontRightSpeed;
     data.rearLeftSpeed = rearLeftSpeed;
     data.rearRightSpeed = rearRightSpeed;
     data.isAutonomous = fsm.isAutonomous();
     data.navState = autonomyModule.getNavStateName();
+
+    // State machine audit trail
+    const StateMachine::Machine &mode = fsm.getMachine();
+    data.mode = fsm.getStateName();
+    data.modeTransitions = mode.getTransitionCount();
+    data.modeRejected = mode.getRejectedCount();
+    data.cmdDrops = uiCommands.getDrops() + uiEdits.getDrops();
+    data.cmdCoalesced = uiCommandsCoalesced;
+    data.cmdLatencyMs = uiCommandMaxLatencyMs;
+    data.modeTraceCount = (mode.getTraceCount() < Msg::TelemetryData::TRACE_LEN) ? mode.getTraceCount() : Msg::TelemetryData::TRACE_LEN;
+    for (uint8_t i = 0; i < data.modeTraceCount; i++)
+    {
+        const FsmTraceEntry &e = mode.getTrace(i);
+        data.modeTrace[i] = {e.timeMs, StateMachine::stateName(e.from),
+                             StateMachine::stateName(e.to), StateMachine::eventName(e.event)};
+    }
+
+    const Autonomy::Machine &nav = autonomyModule.getMachine();
+    data.navTraceCount = (nav.getTraceCount() < Msg::TelemetryData::TRACE_LEN) ? nav.getTraceCount() : Msg::TelemetryData::TRACE_LEN;
+    for (uint8_t i = 0; i < data.navTraceCount; i++)
+    {
+        const FsmTraceEntry &e = nav.getTrace(i);
+        data.navTrace[i] = {e.timeMs, Autonomy::stateName(e.from),
+                            Autonomy::stateName(e.to), Autonomy::eventName(e.event)};
+    }
     data.clientCount = wsServer.getClientCount();
 
     // Check specific roles
-    data.frontOnline = wsServer.isRoleConnected("front");
-    data.cameraOnline = wsServer.isRoleConnected("camera");
+    data.frontOnline = wsServer.isRoleConnected(LINK_ROLE_FRONT);
+    data.cameraOnline = wsServer.isRoleConnected(LINK_ROLE_CAMERA);
+
+    // Link supervision
+    LinkSupervisor::RoleHealth frontLink = wsServer.getLinkHealth(LINK_ROLE_FRONT);
+    LinkSupervisor::RoleHealth dashLink = wsServer.getLinkHealth(LINK_ROLE_DASHBOARD);
+    data.frontLink = LinkSupervisor::stateName(frontLink.state);
+    data.frontRttMs = frontLink.rttMs;
+    data.frontAgeMs = frontLink.ageMs;
+    data.dashboardLink = LinkSupervisor::stateName(dashLink.state);
+    data.dashboardRttMs = dashLink.rttMs;
+    data.dashboardAgeMs = dashLink.ageMs;
+    data.rxAssembled = wsServer.getAssembledMessages();
+    data.rxDropped = wsServer.getDroppedMessages();
 
     // Phase 2.5: PID telemetry
     data.pidOutput = autonomyModule.getPIDOutput();
@@ -299,6 +1021,41 @@ void broadcastTelemetry()
     data.pidP = autonomyModule.getPIDProportional();
     data.pidI = autonomyModule.getPIDIntegral();
     data.pidD = autonomyModule.getPIDDerivative();
+    const GainSchedule::Gains &gains = autonomyModule.getApproachGains();
+    data.pidKp = gains.kP;
+    data.pidKi = gains.kI;
+    data.pidKd = gains.kD;
+    data.gainScheduled = autonomyModule.getApproachSchedule().isEnabled();
+    data.tuneState = RelayAutotuner::stateName(autotuner.getState());
+    data.tuneCycles = autotuner.getCyclesMeasured();
+
+    // Local planner
+    const LocalPlanner::Output &plan = localPlanner.getOutput();
+    data.planValid = plan.valid;
+    data.planHeading = plan.relHeading;
+    data.planExpansions = localPlanner.getLastExpansions();
+
+    // Collision guard status
+    const CollisionGuard &guard = safetyManager.getCollisionGuard();
+    data.collisionLevel = guard.getLevel();
+    data.speedLimit = safetyManager.getSpeedLimit(); // Includes degraded-range cap
+    data.ttc = guard.getTimeToCollision();
+    data.closingSpeed = guard.getClosingSpeed();
+
+    // Gas rate-of-rise
+    const GasRiseDetector &gasRise = safetyManager.getGasRiseDetector();
+    data.gasRiseLevel = gasRise.getLevel();
+    data.gasBaseline = gasRise.getBaseline();
+    data.gasSlope = gasRise.getSlope();
+
+    // Safety supervisor
+    const SafetySupervisor::Stats &sup = safetySupervisor.getStats();
+    data.supervisorTrips = sup.trips;
+    data.supervisorStalls = sup.stalls;
+    data.stopLatencyUs = sup.lastLatencyUs;
+    data.maxStopLatencyUs = sup.maxLatencyUs;
+    data.maxSupervisorPeriodUs = sup.maxPeriodUs;
+    data.maxLoopGapMs = sup.maxLoopGapMs;
 
     // Phase 2.5: Loop timing (from global variable set in loop)
     extern uint16_t g_lastLoopTimeUs;
@@ -314,6 +1071,11 @@ void broadcastTelemetry()
     data.wheelRearRight.rpm = encoderManager.getRPM(WHEEL_REAR_RIGHT);
     data.wheelRearRight.distanceCm = encoderManager.getDistanceCm(WHEEL_REAR_RIGHT);
     data.wheelRearRight.stale = encoderManager.isStale(WHEEL_REAR_RIGHT);
+    data.wheelRearLeft.traction = StallDetector::stateName(stallDetector.getState(0));
+    data.wheelRearLeft.tractionRatio = stallDetector.getRatio(0);
+    data.wheelRearRight.traction = StallDetector::stateName(stallDetector.getState(1));
+    data.wheelRearRight.tractionRatio = stallDetector.getRatio(1);
+    data.wheelStalls = stallDetector.getStallEvents();
 
     // Build & Send
     Msg::buildTelemetry(doc, data);
@@ -325,7 +1087,69 @@ void broadcastTelemetry()
         return; // Don't broadcast corrupted data
     }
 
-    wsServer.broadcast(doc);
+    wsServer.publish(doc);
+}
+
+// ============================================
+// LOCAL MAP
+// ============================================
+
+void updateLocalMap()
+{
+    localMap.setPose(odometry.getX(), odometry.getY(), odometry.getHeading());
+
+    // Each measurement is ray-cast exactly once, at the pose when it is consumed
+    for (uint8_t i = 0; i < sensorManager.getUltrasonicCount(); i++)
+    {
+        uint32_t seq = sensorManager.getSampleSeq(i);
+        if (seq == lastSampleSeq[i])
+            continue;
+
+        lastSampleSeq[i] = seq;
+        const UltrasonicMount &mount = sensorManager.getMount(i);
+        localMap.integrateRange(mount.offsetCm, mount.angleRad, sensorManager.getDistance(i), US_MAP_MAX_RANGE_CM);
+    }
+}
+
+void broadcastMapDelta()
+{
+    if (!localMap.hasDirtyTiles())
+        return;
+
+    static uint8_t rle[MAP_TILES_PER_MESSAGE][OccupancyGrid::MAX_TILE_ENCODED];
+    Msg::MapTile tiles[MAP_TILES_PER_MESSAGE];
+    uint8_t count = 0;
+
+    // Remaining dirty tiles go out in the next interval
+    int slot;
+    while (count < MAP_TILES_PER_MESSAGE && (slot = localMap.popDirtyTile()) >= 0)
+    {
+        tiles[count].rle = rle[count];
+        tiles[count].len = localMap.encodeTile(slot, rle[count], tiles[count].x, tiles[count].y);
+        count++;
+    }
+
+    Msg::MapDelta delta;
+    delta.cellCm = OccupancyGrid::CELL_CM;
+    delta.tileCells = OccupancyGrid::TILE;
+    delta.originX = localMap.getOriginX();
+    delta.originY = localMap.getOriginY();
+    delta.poseX = odometry.getX();
+    delta.poseY = odometry.getY();
+    delta.poseHeading = odometry.getHeading();
+    delta.tiles = tiles;
+    delta.tileCount = count;
+
+    StaticJsonDocument<1536> doc;
+    Msg::buildMapDelta(doc, delta);
+
+    if (doc.overflowed())
+    {
+        DEBUG_PRINTLN("[MAP] ERROR: JSON overflow!");
+        return;
+    }
+
+    wsServer.publish(doc);
 }
 
 void handleWebSocketMessage(const JsonDocument &doc, AsyncWebSocketClient *client)
@@ -339,105 +1163,318 @@ void handleWebSocketMessage(const JsonDocument &doc, AsyncWebSocketClient *clien
     {
         const char *cmd = doc["cmd"] | "";
 
+        // Decoded here, applied by loop() - this task never touches the
+        // motors, the mode machine or the controllers. The mode table
+        // decides what each mode command does (e.g. nothing in EMERGENCY).
+        UiCommand c = {};
+        c.type = UI_CMD_MODE;
+        bool posted = true;
+
         if (strcmp(cmd, "auto_on") == 0)
         {
-            fsm.setAutonomous();
+            c.event = ROBOT_EV_AUTO_ON;
+            posted = postUiCommand(c);
         }
         else if (strcmp(cmd, "auto_off") == 0)
         {
-            fsm.setIdle();
-            rearMotors.stopMotors();
-            sendMotorCommandToFront(0, 0);
-            autonomyModule.reset(); // Clear PID integral/state
+            c.event = ROBOT_EV_AUTO_OFF;
+            posted = postUiCommand(c);
         }
         else if (strcmp(cmd, "forward") == 0)
         {
-            autonomyModule.reset(); // Clear stale PID state
-            fsm.setManual();
-            rearMotors.setMotorsForward(MOTOR_NORMAL_SPEED);
-            sendMotorCommandToFront(MOTOR_NORMAL_SPEED, MOTOR_NORMAL_SPEED);
+            c.event = ROBOT_EV_DRIVE;
+            c.left = MOTOR_NORMAL_SPEED;
+            c.right = MOTOR_NORMAL_SPEED;
+            posted = postUiCommand(c);
         }
         else if (strcmp(cmd, "backward") == 0)
         {
-            fsm.setManual();
-            rearMotors.setMotorsBackward(MOTOR_NORMAL_SPEED);
-            sendMotorCommandToFront(-MOTOR_NORMAL_SPEED, -MOTOR_NORMAL_SPEED);
+            c.event = ROBOT_EV_DRIVE;
+            c.left = -MOTOR_NORMAL_SPEED;
+            c.right = -MOTOR_NORMAL_SPEED;
+            posted = postUiCommand(c);
         }
         else if (strcmp(cmd, "left") == 0)
         {
-            fsm.setManual();
             // Spin Left: Left Back, Right Forward
-            rearMotors.setMotors(-MOTOR_TURN_SPEED, MOTOR_TURN_SPEED);
-            sendMotorCommandToFront(-MOTOR_TURN_SPEED, MOTOR_TURN_SPEED);
+            c.event = ROBOT_EV_DRIVE;
+            c.left = -MOTOR_TURN_SPEED;
+            c.right = MOTOR_TURN_SPEED;
+            posted = postUiCommand(c);
         }
         else if (strcmp(cmd, "right") == 0)
         {
-            fsm.setManual();
             // Spin Right: Left Forward, Right Back
-            rearMotors.setMotors(MOTOR_TURN_SPEED, -MOTOR_TURN_SPEED);
-            sendMotorCommandToFront(MOTOR_TURN_SPEED, -MOTOR_TURN_SPEED);
+            c.event = ROBOT_EV_DRIVE;
+            c.left = MOTOR_TURN_SPEED;
+            c.right = -MOTOR_TURN_SPEED;
+            posted = postUiCommand(c);
         }
         else if (strcmp(cmd, "stop") == 0)
         {
-            fsm.setIdle();
-            rearMotors.stopMotors();
-            sendMotorCommandToFront(0, 0);
+            c.event = ROBOT_EV_STOP;
+            posted = postUiCommand(c);
         }
         else if (strcmp(cmd, "clear_emergency") == 0)
         {
-            // Only allow reset if actually in emergency state
-            if (fsm.isEmergency())
+            // Only accepted in EMERGENCY (exit action resets the latches)
+            c.event = ROBOT_EV_CLEAR;
+            posted = postUiCommand(c);
+        }
+        else if (strcmp(cmd, "pid_tune") == 0)
+        {
+            // Extract with defaults; clamped when applied
+            c.type = UI_CMD_PID_TUNE;
+            c.gains[0] = doc["kP"] | 4.0f;
+            c.gains[1] = doc["kI"] | 0.0f;
+            c.gains[2] = doc["kD"] | 1.0f;
+            posted = postUiCommand(c);
+        }
+        else if (strcmp(cmd, "pid_autotune") == 0)
+        {
+            // Relay experiment on the approach loop; started by loop() from IDLE
+            UiEdit edit = {};
+            edit.type = UI_EDIT_AUTOTUNE;
+            RelayAutotuner::Config &cfg = edit.autotune;
+            cfg.outputBias = 0;
+            cfg.relayAmplitude = constrain(doc["amplitude"] | (float)AUTOTUNE_RELAY_PWM, 40.0f, (float)MOTOR_NORMAL_SPEED);
+            cfg.hysteresis = doc["hysteresis"] | AUTOTUNE_HYSTERESIS_CM;
+            cfg.reverseActing = true; // Driving forward shortens the range
+            cfg.cycles = doc["cycles"] | AUTOTUNE_CYCLES;
+            cfg.timeoutMs = AUTOTUNE_TIMEOUT_MS;
+            cfg.rule = RelayAutotuner::RULE_ZIEGLER_NICHOLS;
+            RelayAutotuner::ruleFromName(doc["rule"] | "zn", cfg.rule);
+            edit.autotuneApply = doc["apply"] | false;
+            posted = postUiEdit(edit);
+        }
+        else if (strcmp(cmd, "gain_schedule_set") == 0 || strcmp(cmd, "gain_schedule_get") == 0 ||
+                 strcmp(cmd, "gain_schedule_reset") == 0)
+        {
+            UiEdit edit = {};
+            edit.type = UI_EDIT_SCHEDULE;
+            ScheduleEdit &e = edit.schedule;
+            e.reset = strcmp(cmd, "gain_schedule_reset") == 0;
+            e.save = doc["save"] | true;
+
+            JsonArrayConst speeds = doc["speeds"];
+            if (speeds && speeds.size() == GainSchedule::SPEED_POINTS)
+            {
+                for (uint8_t s = 0; s < GainSchedule::SPEED_POINTS; s++) e.speeds[s] = speeds[s] | -1.0f;
+                e.setSpeeds = true;
+            }
+
+            JsonArrayConst ranges = doc["ranges"];
+            if (ranges && ranges.size() == GainSchedule::RANGE_POINTS)
             {
-                DEBUG_PRINTLN("[SAFETY] Emergency cleared by operator");
+                for (uint8_t r = 0; r < GainSchedule::RANGE_POINTS; r++) e.ranges[r] = ranges[r] | -1.0f;
+                e.setRanges = true;
+            }
 
-                // Reset safety manager latch
-                safetyManager.reset();
+            // gains[speed][range] = [kP, kI, kD]
+            JsonArrayConst gains = doc["gains"];
+            if (gains && gains.size() == GainSchedule::SPEED_POINTS)
+            {
+                e.setGains = true;
+                for (uint8_t s = 0; s < GainSchedule::SPEED_POINTS; s++)
+                {
+                    for (uint8_t r = 0; r < GainSchedule::RANGE_POINTS; r++)
+                    {
+                        JsonArrayConst cell = gains[s][r];
+                        e.gains[s][r] = {cell[0] | -1.0f, cell[1] | -1.0f, cell[2] | -1.0f};
+                    }
+                }
+            }
+
+            // One cell: [speedIdx, rangeIdx, kP, kI, kD]
+            JsonArrayConst cell = doc["cell"];
+            if (cell && cell.size() == 5)
+            {
+                e.cellSpeed = cell[0] | 0xFF;
+                e.cellRange = cell[1] | 0xFF;
+                e.cell = {cell[2] | -1.0f, cell[3] | -1.0f, cell[4] | -1.0f};
+                e.setCell = true;
+            }
 
-                // Reset FSM to idle
-                fsm.clearEmergency();
+            if (doc.containsKey("enabled"))
+            {
+                e.enabled = doc["enabled"].as<bool>();
+                e.setEnabled = true;
+            }
 
-                // Re-enable PID for next autonomous run
-                autonomyModule.setPIDEnabled(true);
+            // A get is an empty edit: loop() replies with the table
+            if (strcmp(cmd, "gain_schedule_get") == 0) e.save = false;
+            posted = postUiEdit(edit);
+        }
+        else if (strcmp(cmd, "motor_cal_set") == 0 || strcmp(cmd, "motor_cal_get") == 0 ||
+                 strcmp(cmd, "motor_cal_reset") == 0)
+        {
+            UiEdit edit = {};
+            edit.type = UI_EDIT_MOTOR_CAL;
+            MotorCalEdit &e = edit.motorCal;
+            const char *motor = doc["motor"] | "";
+            e.motor = strcmp(motor, "left") == 0 ? 0 : strcmp(motor, "right") == 0 ? 1 : 0xFF;
+            e.reset = strcmp(cmd, "motor_cal_reset") == 0;
+            e.save = doc["save"] | true;
+
+            if (doc.containsKey("deadband"))
+            {
+                e.deadband = doc["deadband"] | -1.0f;
+                e.setDeadband = true;
+            }
 
-                // Ensure motors are stopped (safety)
-                rearMotors.stopMotors();
-                sendMotorCommandToFront(0, 0);
+            // Duty fractions at evenly spaced speeds, deadband first, ending at 1
+            JsonArrayConst curve = doc["curve"];
+            if (curve && curve.size() == MotorLinearizer::CURVE_POINTS)
+            {
+                for (uint8_t i = 0; i < MotorLinearizer::CURVE_POINTS; i++) e.curve[i] = curve[i] | -1.0f;
+                e.setCurve = true;
+            }
 
-                // Broadcast status update
-                StaticJsonDocument<256> alert;
-                Msg::buildStatus(alert, Msg::ROLE_BACK, "emergency_cleared", "Operator reset");
-                wsServer.broadcast(alert);
+            // A get is an empty edit: loop() replies with the curves
+            if (strcmp(cmd, "motor_cal_get") == 0)
+            {
+                e = MotorCalEdit();
+                e.motor = 0xFF;
             }
+            posted = postUiEdit(edit);
         }
-        else if (strcmp(cmd, "pid_tune") == 0)
+        else if (strcmp(cmd, "pid_autotune_cancel") == 0)
         {
-            // Extract with defaults
-            float kP = doc["kP"] | 4.0f;
-            float kI = doc["kI"] | 0.0f;
-            float kD = doc["kD"] | 1.0f;
-
-            // SAFETY: Clamp to safe ranges
-            kP = constrain(kP, 0.0f, 20.0f); // Max P prevents oscillation
-            kI = constrain(kI, 0.0f, 2.0f);  // Max I prevents overshoot
-            kD = constrain(kD, 0.0f, 10.0f); // Max D prevents noise amplification
-
-            autonomyModule.setApproachPID(kP, kI, kD);
-
-            // Acknowledge to dashboard
-            StaticJsonDocument<128> ack;
-            ack["type"] = "pid_ack";
-            ack["kP"] = kP;
-            ack["kI"] = kI;
-            ack["kD"] = kD;
-            wsServer.broadcast(ack);
-
-            DEBUG_PRINTF("[PID] Tuned: P=%.2f I=%.2f D=%.2f\n", kP, kI, kD);
+            c.type = UI_CMD_AUTOTUNE_CANCEL;
+            posted = postUiCommand(c);
         }
         else if (strcmp(cmd, "pid_enable") == 0)
         {
-            bool enable = doc["enable"] | true;
-            autonomyModule.setPIDEnabled(enable);
-            DEBUG_PRINTF("[PID] %s\n", enable ? "Enabled" : "Disabled");
+            c.type = UI_CMD_PID_ENABLE;
+            c.enable = doc["enable"] | true;
+            posted = postUiCommand(c);
+        }
+
+        // Queue full: tell the sender rather than drop it silently
+        if (!posted) rejectUiCommand(client, cmd);
+    }
+}
+
+// ============================================
+// INBOUND COMMANDS (WebSocket task -> loop)
+// ============================================
+
+// A failed push() is counted by the queue (cmd_drop in telemetry)
+bool postUiCommand(UiCommand cmd)
+{
+    cmd.postedMs = millis();
+    if (uiCommands.push(cmd)) return true;
+    DEBUG_PRINTLN("[WS] Command queue full - dropped");
+    return false;
+}
+
+bool postUiEdit(UiEdit &edit)
+{
+    edit.postedMs = millis();
+    if (uiEdits.push(edit)) return true;
+    DEBUG_PRINTLN("[WS] Edit queue full - dropped");
+    return false;
+}
+
+void rejectUiCommand(AsyncWebSocketClient *client, const char *cmd)
+{
+    StaticJsonDocument<192> reply;
+    Msg::buildStatus(reply, Msg::ROLE_BACK, "cmd_rejected", "Command queue full - resend");
+    reply["cmd"] = cmd;
+    wsServer.sendTo(client, reply);
+}
+
+static bool isDriveCommand(const UiCommand &cmd)
+{
+    return cmd.type == UI_CMD_MODE && cmd.event == ROBOT_EV_DRIVE;
+}
+
+void processUiCommands()
+{
+    // Take what is queued now; anything posted meanwhile waits for the next tick
+    UiCommand batch[UI_COMMAND_DEPTH];
+    uint8_t count = 0;
+    while (count < UI_COMMAND_DEPTH && uiCommands.pop(batch[count])) count++;
+
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const UiCommand &cmd = batch[i];
+        if (now - cmd.postedMs > uiCommandMaxLatencyMs) uiCommandMaxLatencyMs = now - cmd.postedMs;
+
+        // Of back-to-back drive commands only the newest matters
+        if (isDriveCommand(cmd) && i + 1 < count && isDriveCommand(batch[i + 1]))
+        {
+            uiCommandsCoalesced++;
+            continue;
+        }
+        applyUiCommand(cmd);
+    }
+}
+
+void applyUiCommand(const UiCommand &cmd)
+{
+    switch (cmd.type)
+    {
+    case UI_CMD_MODE:
+        if (cmd.event == ROBOT_EV_STOP) autotuneCancelRequested = true;
+        fsm.dispatch(cmd.event, cmd.left, cmd.right);
+        break;
+
+    case UI_CMD_PID_TUNE:
+    {
+        // SAFETY: Clamp to safe ranges
+        float kP = cmd.gains[0], kI = cmd.gains[1], kD = cmd.gains[2];
+        setApproachGains(kP, kI, kD);
+
+        // Acknowledge to dashboard
+        StaticJsonDocument<128> ack;
+        ack["type"] = "pid_ack";
+        ack["kP"] = kP;
+        ack["kI"] = kI;
+        ack["kD"] = kD;
+        wsServer.publish(ack);
+
+        DEBUG_PRINTF("[PID] Tuned: P=%.2f I=%.2f D=%.2f\n", kP, kI, kD);
+        break;
+    }
+
+    case UI_CMD_PID_ENABLE:
+        autonomyModule.setPIDEnabled(cmd.enable);
+        DEBUG_PRINTF("[PID] %s\n", cmd.enable ? "Enabled" : "Disabled");
+        break;
+
+    case UI_CMD_AUTOTUNE_CANCEL:
+        autotuneCancelRequested = true;
+        break;
+    }
+}
+
+void processUiEdits()
+{
+    // Rare and self-contained: apply each, in order, as it comes
+    UiEdit edit;
+    uint32_t now = millis();
+    while (uiEdits.pop(edit))
+    {
+        if (now - edit.postedMs > uiCommandMaxLatencyMs) uiCommandMaxLatencyMs = now - edit.postedMs;
+
+        switch (edit.type)
+        {
+        case UI_EDIT_AUTOTUNE:
+            autotuneRequest = edit.autotune;
+            autotuneRequest.setpoint = autonomyModule.getPIDSetpoint(); // Tune where the loop regulates
+            autotuneApply = edit.autotuneApply;
+            autotuneStartRequested = true;
+            break;
+
+        case UI_EDIT_SCHEDULE:
+            applyScheduleEdit(edit.schedule);
+            break;
+
+        case UI_EDIT_MOTOR_CAL:
+            applyMotorCalEdit(edit.motorCal);
+            break;
         }
     }
 }
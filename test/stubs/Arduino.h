@@ -0,0 +1,31 @@
+#ifndef ARDUINO_HOST_STUB_H
+#define ARDUINO_HOST_STUB_H
+
+/**
+ * Host stand-in for the Arduino core (native test env only)
+ *
+ * Just what the navigation code uses: a clock the test advances by hand,
+ * constrain() and PI. Anything else failing to compile here is a sign
+ * the module grew a real hardware dependency.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include <string.h>
+
+#define PI 3.1415926535897932384626433832795
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+namespace HostClock
+{
+    inline unsigned long nowMs = 0;
+
+    inline void set(unsigned long ms) { nowMs = ms; }
+    inline void advance(unsigned long ms) { nowMs += ms; }
+}
+
+inline unsigned long millis() { return HostClock::nowMs; }
+inline unsigned long micros() { return HostClock::nowMs * 1000UL; }
+
+#endif // ARDUINO_HOST_STUB_H
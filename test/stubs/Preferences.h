@@ -0,0 +1,20 @@
+#ifndef PREFERENCES_HOST_STUB_H
+#define PREFERENCES_HOST_STUB_H
+
+#include <stddef.h>
+
+/**
+ * Host stand-in for the ESP32 NVS Preferences (native test env only)
+ * Nothing persists: begin() fails, so loads and saves report failure.
+ */
+class Preferences
+{
+public:
+    bool begin(const char *, bool) { return false; }
+    void end() {}
+    size_t getBytes(const char *, void *, size_t) { return 0; }
+    size_t putBytes(const char *, const void *, size_t) { return 0; }
+    bool remove(const char *) { return false; }
+};
+
+#endif // PREFERENCES_HOST_STUB_H
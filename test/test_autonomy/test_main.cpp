@@ -0,0 +1,116 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "Autonomy.h"
+
+static const unsigned long TICK_MS = 20;    // Navigation update rate
+static const float OPEN_FLOOR_CM = 150.0f;  // Range with nothing ahead
+
+// Rear wheel encoders as on the robot: 80 counts per 6.5 cm wheel turn
+static const float COUNTS_PER_CM = 80.0f / (6.5f * (float)PI);
+
+/**
+ * Robot driving straight at something
+ * Ground speed follows the command (linear drive); a load makes the
+ * wheels turn slower than commanded, and the encoders see that.
+ */
+struct Run
+{
+    Autonomy nav;
+    StallDetector detector;
+    float rangeCm;
+    float counts;
+    bool climbed;
+    bool avoided;
+
+    Run() : detector(DRIVE_FULL_SCALE_CM_S * COUNTS_PER_CM), rangeCm(OPEN_FLOOR_CM), counts(0),
+            climbed(false), avoided(false)
+    {
+        HostClock::set(1000);
+    }
+
+    /** One navigation tick; returns the ground speed it drove at */
+    float tick(float load)
+    {
+        int commands[StallDetector::WHEELS] = {nav.getLeftSpeed(), nav.getRightSpeed()};
+        float speed = commands[0] / 255.0f * DRIVE_FULL_SCALE_CM_S * load;
+        counts += speed * COUNTS_PER_CM * TICK_MS / 1000.0f;
+        int32_t wheelCounts[StallDetector::WHEELS] = {(int32_t)counts, (int32_t)counts};
+
+        detector.update(commands, wheelCounts, true, HostClock::nowMs);
+        nav.setTraction(detector);
+        nav.setMeasuredSpeed(speed);
+        nav.update(rangeCm, -1.0f);
+
+        climbed |= nav.getNavState() == NAV_CLIMBING;
+        avoided |= nav.getNavState() == NAV_OBSTACLE_DETECTED;
+        HostClock::advance(TICK_MS);
+        return speed;
+    }
+
+    void cruise(unsigned long ms, float load)
+    {
+        for (unsigned long end = HostClock::nowMs + ms; HostClock::nowMs < end;) tick(load);
+    }
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ============================================
+// CLIMBING
+// ============================================
+
+void test_low_edge_starts_a_climb(void)
+{
+    Run run;
+    run.cruise(1000, 1.0f);
+    TEST_ASSERT_EQUAL(NAV_FORWARD, run.nav.getNavState());
+
+    // Front wheels meet a kerb below the beam: the rear labours against it
+    run.cruise(300, 0.5f);
+    TEST_ASSERT_EQUAL(NAV_FORWARD, run.nav.getNavState());
+
+    // The kerb only shows in the range once the nose is over it
+    run.rangeCm = 15.0f;
+    run.tick(0.5f);
+
+    TEST_ASSERT_TRUE(run.climbed);
+    TEST_ASSERT_FALSE(run.avoided);
+    TEST_ASSERT_EQUAL(MOTOR_CLIMB_SPEED, run.nav.getFrontLeftSpeed());
+}
+
+void test_load_a_while_ago_still_counts(void)
+{
+    Run run;
+    run.cruise(1000, 1.0f);
+    run.cruise(300, 0.5f);
+
+    // The wheels freed up a moment before the range caught the edge
+    run.cruise(200, 1.0f);
+    run.rangeCm = 12.0f;
+    run.tick(1.0f);
+
+    TEST_ASSERT_TRUE(run.climbed);
+}
+
+void test_wall_without_load_is_avoided(void)
+{
+    Run run;
+    run.cruise(1000, 1.0f);
+
+    // Something steps in front at the same range, wheels running free
+    run.rangeCm = 15.0f;
+    run.tick(1.0f);
+
+    TEST_ASSERT_TRUE(run.avoided);
+    TEST_ASSERT_FALSE(run.climbed);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_low_edge_starts_a_climb);
+    RUN_TEST(test_load_a_while_ago_still_counts);
+    RUN_TEST(test_wall_without_load_is_avoided);
+    return UNITY_END();
+}
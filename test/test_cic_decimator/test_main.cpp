@@ -0,0 +1,86 @@
+#include <unity.h>
+#include "CicDecimator.h"
+
+static const int32_t FULL_SCALE = 4095;   // 12-bit ADC
+static const int32_t Q4 = 16;
+
+// At full scale the third integrator passes 2^64 after roughly 300k samples
+static const uint32_t PAST_WRAP = 1000000;
+
+/** Push n copies of sample; returns the outputs produced, each checked against expectQ4 if asked */
+static uint32_t feed(CicDecimator &cic, int32_t sample, uint32_t n, int32_t expectQ4, bool check)
+{
+    uint32_t outputs = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (!cic.push(sample)) continue;
+        outputs++;
+        if (check) TEST_ASSERT_EQUAL(expectQ4, cic.getOutputQ4());
+    }
+    return outputs;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ============================================
+// GAIN
+// ============================================
+
+void test_dc_passes_at_unity_gain(void)
+{
+    CicDecimator cic(8);
+    TEST_ASSERT_EQUAL(256, cic.getRatio());
+
+    // Start-up outputs are held back while the zero history drains
+    TEST_ASSERT_EQUAL_UINT32(0, feed(cic, 1000, CicDecimator::ORDER * 256, 0, false));
+    TEST_ASSERT_EQUAL_UINT32(4, feed(cic, 1000, 4 * 256, 1000 * Q4, true));
+}
+
+void test_small_ratio_keeps_fraction_bits(void)
+{
+    CicDecimator cic(1);   // Gain 2^3 is below the 4 fractional bits
+    feed(cic, 300, 20, 0, false);
+    TEST_ASSERT_EQUAL(300 * Q4, cic.getOutputQ4());
+}
+
+// ============================================
+// WRAP-AROUND
+// ============================================
+
+void test_full_scale_survives_integrator_wrap(void)
+{
+    CicDecimator cic(8);
+    feed(cic, FULL_SCALE, CicDecimator::ORDER * 256, 0, false);
+    uint32_t outputs = feed(cic, FULL_SCALE, PAST_WRAP, FULL_SCALE * Q4, true);
+    TEST_ASSERT_EQUAL_UINT32(PAST_WRAP / 256, outputs);
+}
+
+void test_negative_input_survives_integrator_wrap(void)
+{
+    CicDecimator cic(8);
+    feed(cic, -2048, CicDecimator::ORDER * 256, 0, false);
+    feed(cic, -2048, PAST_WRAP, -2048 * Q4, true);
+}
+
+void test_step_after_wrap_settles(void)
+{
+    CicDecimator cic(12);   // Largest ratio: the widest comb results
+    feed(cic, FULL_SCALE, PAST_WRAP, 0, false);
+    TEST_ASSERT_EQUAL(FULL_SCALE * Q4, cic.getOutputQ4());
+
+    // A step settles after ORDER output periods
+    feed(cic, 100, CicDecimator::ORDER * 4096, 0, false);
+    feed(cic, 100, 2 * 4096, 100 * Q4, true);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_dc_passes_at_unity_gain);
+    RUN_TEST(test_small_ratio_keeps_fraction_bits);
+    RUN_TEST(test_full_scale_survives_integrator_wrap);
+    RUN_TEST(test_negative_input_survives_integrator_wrap);
+    RUN_TEST(test_step_after_wrap_settles);
+    return UNITY_END();
+}
@@ -0,0 +1,197 @@
+#include <unity.h>
+#include "CollisionGuard.h"
+
+// Scripted approaches towards a wall, one range sample per control tick
+static const unsigned long TICK_MS = 20;
+static const unsigned long REACTION_MS = 100;   // Sensor + loop, as in the brake table
+static const float BRAKE_CM_S2 = 300.0f;        // Braking, as in the brake table
+static const float START_CM = 200.0f;
+
+struct Approach
+{
+    long capMs, stopMs, latchMs;    // First tick at each level, -1 if never
+    float capCm, stopCm, latchCm;   // Range at that tick
+    float finalCm;
+    bool stopped;
+    float stoppedCm;                // Range when the wheels first came to rest
+    unsigned long endMs;
+};
+
+/**
+ * Cruise at pwm towards a wall from START_CM; the guard sees the requested
+ * command, like SafetyManager::setMotion().
+ * obeyLimit: the drive follows getSpeedLimit() after REACTION_MS and brakes
+ * at BRAKE_CM_S2, else it keeps the command (a stuck driver) until it latches.
+ * holdMs: keep requesting pwm this long after the wheels stop
+ * guard: continue with this guard afterwards (optional)
+ */
+static Approach runApproach(int pwm, bool obeyLimit, unsigned long holdMs = 0, CollisionGuard *useGuard = nullptr)
+{
+    CollisionGuard ownGuard;
+    CollisionGuard &guard = useGuard ? *useGuard : ownGuard;
+    Approach a = {-1, -1, -1, 0, 0, 0, 0, false, 0, 0};
+    unsigned long stoppedAt = 0;
+
+    float dist = START_CM;
+    float speed = guard.speedForPwm(pwm);
+    int applied = pwm;
+    int limits[REACTION_MS / TICK_MS] = {};
+    for (int &l : limits) l = 255;
+
+    unsigned long now = 1000;
+    for (; now < 20000; now += TICK_MS)
+    {
+        CollisionLevel level = guard.update(dist, now, pwm, speed);
+
+        if (level >= COLLISION_CAP && a.capMs < 0) { a.capMs = now; a.capCm = dist; }
+        if (level >= COLLISION_STOP && a.stopMs < 0) { a.stopMs = now; a.stopCm = dist; }
+        if (level >= COLLISION_LATCH && a.latchMs < 0) { a.latchMs = now; a.latchCm = dist; }
+        if (level == COLLISION_LATCH && !obeyLimit) break;
+
+        // The limit reaches the wheels REACTION_MS later
+        int limit = limits[0];
+        for (unsigned i = 1; i < REACTION_MS / TICK_MS; i++) limits[i - 1] = limits[i];
+        limits[REACTION_MS / TICK_MS - 1] = guard.getSpeedLimit();
+        if (obeyLimit) applied = (pwm < limit) ? pwm : limit;
+
+        float target = guard.speedForPwm(applied);
+        if (speed > target)
+        {
+            speed -= BRAKE_CM_S2 * TICK_MS / 1000.0f;
+            if (speed < target) speed = target;
+        }
+        dist -= speed * TICK_MS / 1000.0f;
+
+        if (dist <= 0.0f) break;
+        if (speed <= 0.0f && applied == 0 && !a.stopped)
+        {
+            a.stopped = true;
+            a.stoppedCm = dist;
+            stoppedAt = now;
+        }
+        if (a.stopped && now - stoppedAt >= holdMs) break;
+    }
+
+    a.finalCm = dist;
+    a.endMs = now;
+    return a;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void assertEscalatesInOrder(const Approach &a)
+{
+    TEST_ASSERT_TRUE(a.capMs > 0);
+    TEST_ASSERT_TRUE(a.stopMs > a.capMs);
+    TEST_ASSERT_TRUE(a.latchMs > a.stopMs);
+    TEST_ASSERT_GREATER_THAN_FLOAT(a.stopCm, a.capCm);
+    TEST_ASSERT_GREATER_THAN_FLOAT(a.latchCm, a.stopCm);
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.0f, a.latchCm);    // Latched before contact
+}
+
+void test_low_pwm_escalates_cap_stop_latch(void)
+{
+    assertEscalatesInOrder(runApproach(100, false));
+}
+
+void test_high_pwm_escalates_cap_stop_latch(void)
+{
+    assertEscalatesInOrder(runApproach(255, false));
+}
+
+void test_higher_pwm_reacts_earlier(void)
+{
+    Approach slow = runApproach(100, false);
+    Approach fast = runApproach(255, false);
+
+    TEST_ASSERT_GREATER_THAN_FLOAT(slow.capCm, fast.capCm);
+    TEST_ASSERT_GREATER_THAN_FLOAT(slow.stopCm, fast.stopCm);
+    TEST_ASSERT_GREATER_THAN_FLOAT(slow.latchCm, fast.latchCm);
+}
+
+void test_obeying_the_limit_stops_short_without_latching(void)
+{
+    const int pwms[] = {100, 180, 255};
+    for (int pwm : pwms)
+    {
+        Approach a = runApproach(pwm, true);
+        TEST_ASSERT_TRUE(a.stopped);
+        TEST_ASSERT_TRUE(a.latchMs < 0);
+        TEST_ASSERT_GREATER_THAN_FLOAT(4.0f, a.finalCm);   // Standoff floor
+    }
+}
+
+void test_held_forward_request_stays_stopped(void)
+{
+    // Operator keeps pushing forward after the stop: no stop/go creep
+    const int pwms[] = {100, 180, 255};
+    for (int pwm : pwms)
+    {
+        Approach a = runApproach(pwm, true, 5000);
+        TEST_ASSERT_TRUE(a.stopped);
+        TEST_ASSERT_TRUE(a.latchMs < 0);
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, a.stoppedCm, a.finalCm);
+    }
+}
+
+void test_stop_releases_once_the_request_is_safe(void)
+{
+    // Stopped by the guard with full forward held
+    CollisionGuard guard;
+    Approach a = runApproach(255, true, 1000, &guard);
+    TEST_ASSERT_TRUE(a.stopped);
+    TEST_ASSERT_EQUAL(COLLISION_STOP, guard.getLevel());
+
+    // At the standoff even a creep is held
+    unsigned long now = a.endMs;
+    for (unsigned long end = now + 1000; now < end; now += TICK_MS) guard.update(a.finalCm, now, 60, 0.0f);
+    TEST_ASSERT_EQUAL(COLLISION_STOP, guard.getLevel());
+
+    // Letting go releases it; pushing again is caught on the first tick
+    for (unsigned long end = now + 1000; now < end; now += TICK_MS) guard.update(a.finalCm, now, 0, 0.0f);
+    TEST_ASSERT_EQUAL(COLLISION_CLEAR, guard.getLevel());
+    TEST_ASSERT_TRUE(guard.update(a.finalCm, now, 60, 0.0f) >= COLLISION_STOP);
+
+    // So is the obstacle moving away with full forward held
+    CollisionGuard moved;
+    a = runApproach(255, true, 1000, &moved);
+    now = a.endMs;
+    for (unsigned long end = now + 1000; now < end; now += TICK_MS) moved.update(150.0f, now, 255, 0.0f);
+    TEST_ASSERT_EQUAL(COLLISION_CLEAR, moved.getLevel());
+}
+
+void test_zero_encoder_reading_does_not_hide_the_command(void)
+{
+    // Fresh encoders reading 0 (just commanded, or a dead sensor) at 30 cm
+    CollisionGuard guard;
+    CollisionLevel level = guard.update(30.0f, 1000, 255, 0.0f);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, guard.speedForPwm(255), guard.getClosingSpeed());
+    TEST_ASSERT_TRUE(level >= COLLISION_STOP);
+}
+
+void test_reversing_away_stays_clear(void)
+{
+    CollisionGuard guard;
+    float dist = 10.0f;
+    for (unsigned long now = 1000; now < 2000; now += TICK_MS)
+    {
+        TEST_ASSERT_EQUAL(COLLISION_CLEAR, guard.update(dist, now, -150, 0.0f));
+        dist += 1.0f;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_low_pwm_escalates_cap_stop_latch);
+    RUN_TEST(test_high_pwm_escalates_cap_stop_latch);
+    RUN_TEST(test_higher_pwm_reacts_earlier);
+    RUN_TEST(test_obeying_the_limit_stops_short_without_latching);
+    RUN_TEST(test_held_forward_request_stays_stopped);
+    RUN_TEST(test_stop_releases_once_the_request_is_safe);
+    RUN_TEST(test_zero_encoder_reading_does_not_hide_the_command);
+    RUN_TEST(test_reversing_away_stays_clear);
+    return UNITY_END();
+}
@@ -0,0 +1,171 @@
+#include <unity.h>
+#include <math.h>
+#include "config.h"
+#include "GasRiseDetector.h"
+
+// Synthetic MQ-2 curves (counts vs seconds), fed at the main loop rate
+// with +/-3 counts of deterministic noise like the decimated ADC reading
+static const unsigned long SAMPLE_MS = MAIN_LOOP_RATE_MS;
+static const float BASE = 300.0f;
+static const float RISE_START_S = 60.0f;   // Well after the 30 s warm-up
+
+typedef float (*GasCurve)(float tS);
+
+struct Replay
+{
+    float firstS[GAS_RISE_ALARM + 1];   // First time at or above each level, -1 if never
+    float thresholdS;                   // Curve reaches GAS_THRESHOLD_EMERGENCY, -1 if never
+    GasRiseLevel maxLevel;
+    GasRiseLevel finalLevel;
+    float finalBaseline;
+    float finalValue;
+    bool warnedDuringWarmup;
+};
+
+static Replay replay(GasCurve curve, float durationS)
+{
+    GasRiseDetector detector(GAS_THRESHOLD_EMERGENCY);
+    Replay r;
+    for (float &t : r.firstS) t = -1.0f;
+    r.thresholdS = -1.0f;
+    r.maxLevel = GAS_RISE_NONE;
+    r.warnedDuringWarmup = false;
+
+    uint32_t seed = 1;
+    float value = 0;
+    for (unsigned long ms = 0; ms <= (unsigned long)(durationS * 1000); ms += SAMPLE_MS)
+    {
+        float t = ms / 1000.0f;
+        seed = seed * 1103515245u + 12345u;
+        value = curve(t) + (float)((seed >> 16) % 7) - 3.0f;
+
+        GasRiseLevel level = detector.update(value, ms);
+        if (!detector.isWarmedUp() && level != GAS_RISE_NONE) r.warnedDuringWarmup = true;
+        if (level > r.maxLevel) r.maxLevel = level;
+        for (uint8_t l = GAS_RISE_WATCH; l <= level; l++)
+        {
+            if (r.firstS[l] < 0) r.firstS[l] = t;
+        }
+        if (r.thresholdS < 0 && curve(t) >= GAS_THRESHOLD_EMERGENCY) r.thresholdS = t;
+    }
+
+    r.finalLevel = detector.getLevel();
+    r.finalBaseline = detector.getBaseline();
+    r.finalValue = value;
+    return r;
+}
+
+// ============================================
+// CURVES
+// ============================================
+
+static float flatCurve(float t) { return BASE; }
+
+// Heater/humidity drift: 36 counts over half an hour
+static float driftCurve(float t) { return BASE + 0.02f * t; }
+
+// Cold heater reads high and settles over the warm-up period
+static float warmupCurve(float t) { return BASE + 250.0f * expf(-t / 8.0f); }
+
+// Fast fire: 12 counts/s from the baseline
+static float rampCurve(float t) { return (t < RISE_START_S) ? BASE : BASE + 12.0f * (t - RISE_START_S); }
+
+// Smouldering: 1 count/s, too slow for the slope detector
+static float smoulderCurve(float t) { return (t < RISE_START_S) ? BASE : BASE + 1.0f * (t - RISE_START_S); }
+
+// A whiff past the sensor: +30 counts for 1 s through the sensor's own
+// response (2 s rise, 5 s recovery)
+static float puffCurve(float t)
+{
+    if (t < RISE_START_S) return BASE;
+    float peak = 30.0f * (1.0f - expf(-fminf(t - RISE_START_S, 1.0f) / 2.0f));
+    if (t < RISE_START_S + 1.0f) return BASE + peak;
+    return BASE + peak * expf(-(t - RISE_START_S - 1.0f) / 5.0f);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ============================================
+// NO WARNING
+// ============================================
+
+void test_flat_reading_never_warns(void)
+{
+    Replay r = replay(flatCurve, 300.0f);
+    TEST_ASSERT_EQUAL(GAS_RISE_NONE, r.maxLevel);
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, BASE, r.finalBaseline);
+}
+
+void test_slow_drift_is_tracked_by_the_baseline(void)
+{
+    Replay r = replay(driftCurve, 1800.0f);
+    TEST_ASSERT_EQUAL(GAS_RISE_NONE, r.maxLevel);
+
+    // Baseline lags by rate * rise tau (~6 counts), inside the drift band
+    TEST_ASSERT_FLOAT_WITHIN(10.0f, r.finalValue, r.finalBaseline);
+}
+
+void test_warmup_decay_is_learned_without_warnings(void)
+{
+    Replay r = replay(warmupCurve, 180.0f);
+    TEST_ASSERT_FALSE(r.warnedDuringWarmup);
+    TEST_ASSERT_EQUAL(GAS_RISE_NONE, r.maxLevel);
+    TEST_ASSERT_FLOAT_WITHIN(5.0f, BASE, r.finalBaseline);
+}
+
+void test_short_puff_stays_at_watch_and_clears(void)
+{
+    Replay r = replay(puffCurve, 120.0f);
+    TEST_ASSERT_EQUAL(GAS_RISE_WATCH, r.maxLevel);
+    TEST_ASSERT_EQUAL(GAS_RISE_NONE, r.finalLevel);
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, BASE, r.finalBaseline);  // Not absorbed
+}
+
+// ============================================
+// LEAD TIME
+// ============================================
+
+void test_fast_ramp_escalates_ahead_of_the_threshold(void)
+{
+    Replay r = replay(rampCurve, 90.0f);
+    TEST_ASSERT_EQUAL(GAS_RISE_ALARM, r.maxLevel);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, RISE_START_S + 200.0f / 12.0f, r.thresholdS);
+
+    // Watch and warning within ~3 s of the rise starting
+    TEST_ASSERT_GREATER_THAN_FLOAT(RISE_START_S, r.firstS[GAS_RISE_WATCH]);
+    TEST_ASSERT_LESS_THAN_FLOAT(RISE_START_S + 3.0f, r.firstS[GAS_RISE_WARNING]);
+
+    // Lead time over the absolute threshold: warning >= 12 s, alarm >= 8 s
+    TEST_ASSERT_GREATER_THAN_FLOAT(12.0f, r.thresholdS - r.firstS[GAS_RISE_WARNING]);
+    TEST_ASSERT_GREATER_THAN_FLOAT(8.0f, r.thresholdS - r.firstS[GAS_RISE_ALARM]);
+    TEST_ASSERT_TRUE(r.firstS[GAS_RISE_WARNING] < r.firstS[GAS_RISE_ALARM]);
+}
+
+void test_smoulder_is_caught_by_cusum_minutes_ahead(void)
+{
+    Replay r = replay(smoulderCurve, RISE_START_S + 200.0f);
+
+    // Slope stays under the watch rate: the accumulated excess raises it
+    TEST_ASSERT_EQUAL(GAS_RISE_WARNING, r.maxLevel);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, RISE_START_S + 200.0f, r.thresholdS);
+
+    TEST_ASSERT_LESS_THAN_FLOAT(RISE_START_S + 30.0f, r.firstS[GAS_RISE_WATCH]);
+    TEST_ASSERT_LESS_THAN_FLOAT(RISE_START_S + 45.0f, r.firstS[GAS_RISE_WARNING]);
+    TEST_ASSERT_GREATER_THAN_FLOAT(150.0f, r.thresholdS - r.firstS[GAS_RISE_WARNING]);
+
+    // Baseline frozen during the rise, not dragged up with it
+    TEST_ASSERT_FLOAT_WITHIN(5.0f, BASE, r.finalBaseline);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_flat_reading_never_warns);
+    RUN_TEST(test_slow_drift_is_tracked_by_the_baseline);
+    RUN_TEST(test_warmup_decay_is_learned_without_warnings);
+    RUN_TEST(test_short_puff_stays_at_watch_and_clears);
+    RUN_TEST(test_fast_ramp_escalates_ahead_of_the_threshold);
+    RUN_TEST(test_smoulder_is_caught_by_cusum_minutes_ahead);
+    return UNITY_END();
+}
@@ -0,0 +1,118 @@
+#include <unity.h>
+#include "LinkSupervisor.h"
+#include "ClientTable.h"
+
+static const unsigned long T0 = 1000;
+static const unsigned long PING_MS = 100;   // Evaluation and ping rate
+
+/** Keep a client answering pings until `until` */
+static void keepAlive(LinkSupervisor &links, uint32_t clientId, unsigned long &now, unsigned long until)
+{
+    for (; now < until; now += PING_MS)
+    {
+        links.onPingSent(clientId, now);
+        links.onPong(clientId, now + 5);
+        links.evaluate(now + 5);
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ============================================
+// REGISTRATION
+// ============================================
+
+void test_unregistered_client_marks_no_role_seen(void)
+{
+    LinkSupervisor links;
+    unsigned long now = T0;
+    links.onConnect(1, now);
+    keepAlive(links, 1, now, T0 + 1000);
+
+    TEST_ASSERT_EQUAL(LINK_ABSENT, links.getState(LINK_ROLE_DASHBOARD));
+    TEST_ASSERT_EQUAL(LINK_ABSENT, links.getState(LINK_ROLE_FRONT));
+    TEST_ASSERT_EQUAL(LINK_ABSENT, links.getState(LINK_ROLE_UNKNOWN));
+    TEST_ASSERT_EQUAL(1, links.getHealth(LINK_ROLE_UNKNOWN).clients);
+}
+
+void test_board_registering_late_leaves_dashboard_absent(void)
+{
+    LinkSupervisor links;
+    unsigned long now = T0;
+
+    // The front connects, is evaluated a few times, then registers
+    links.onConnect(1, now);
+    keepAlive(links, 1, now, T0 + 500);
+    links.setRole(1, LinkSupervisor::roleFromString("front"));
+    keepAlive(links, 1, now, T0 + 1000);
+
+    TEST_ASSERT_EQUAL(LINK_OK, links.getState(LINK_ROLE_FRONT));
+    TEST_ASSERT_EQUAL(LINK_ABSENT, links.getState(LINK_ROLE_DASHBOARD));
+
+    // Its reconnect goes through the same unregistered window
+    links.onDisconnect(1);
+    links.onConnect(2, now);
+    keepAlive(links, 2, now, T0 + 1500);
+    links.setRole(2, LINK_ROLE_FRONT);
+    keepAlive(links, 2, now, T0 + 2000);
+
+    TEST_ASSERT_EQUAL(LINK_OK, links.getState(LINK_ROLE_FRONT));
+    TEST_ASSERT_EQUAL(LINK_ABSENT, links.getState(LINK_ROLE_DASHBOARD));
+    TEST_ASSERT_EQUAL_UINT32(0, links.getHealth(LINK_ROLE_DASHBOARD).lostCount);
+}
+
+void test_dashboard_is_seen_once_registered(void)
+{
+    LinkSupervisor links;
+    unsigned long now = T0;
+    links.onConnect(7, now);
+    keepAlive(links, 7, now, T0 + 300);
+    TEST_ASSERT_EQUAL(LINK_ABSENT, links.getState(LINK_ROLE_DASHBOARD));
+
+    links.setRole(7, LinkSupervisor::roleFromString("dashboard"));
+    keepAlive(links, 7, now, T0 + 600);
+    TEST_ASSERT_EQUAL(LINK_OK, links.getState(LINK_ROLE_DASHBOARD));
+
+    // Silence -> LOST, and it stays a dashboard loss, not an unknown one
+    links.evaluate(now + 1000);
+    TEST_ASSERT_EQUAL(LINK_LOST, links.getState(LINK_ROLE_DASHBOARD));
+}
+
+void test_role_strings(void)
+{
+    TEST_ASSERT_EQUAL(LINK_ROLE_FRONT, LinkSupervisor::roleFromString("FRONT"));
+    TEST_ASSERT_EQUAL(LINK_ROLE_CAMERA, LinkSupervisor::roleFromString("camera"));
+    TEST_ASSERT_EQUAL(LINK_ROLE_DASHBOARD, LinkSupervisor::roleFromString("gateway"));
+    TEST_ASSERT_EQUAL(LINK_ROLE_UNKNOWN, LinkSupervisor::roleFromString("toaster"));
+    TEST_ASSERT_EQUAL_STRING("unknown", LinkSupervisor::roleName(LINK_ROLE_UNKNOWN));
+}
+
+// ============================================
+// CLIENT TABLE
+// ============================================
+
+void test_client_table_moves_registration_out_of_unknown(void)
+{
+    ClientTable table;
+    table.add(1, T0);
+    TEST_ASSERT_EQUAL(LINK_ROLE_UNKNOWN, table.getRole(1));
+    TEST_ASSERT_FALSE(table.isRoleConnected(LINK_ROLE_DASHBOARD));
+
+    TEST_ASSERT_TRUE(table.setRole(1, LINK_ROLE_FRONT, T0 + 10));
+    TEST_ASSERT_FALSE(table.isRoleConnected(LINK_ROLE_UNKNOWN));
+    TEST_ASSERT_TRUE(table.isRoleConnected(LINK_ROLE_FRONT));
+    TEST_ASSERT_EQUAL_UINT32(1, table.getRoleClient(LINK_ROLE_FRONT));
+    TEST_ASSERT_EQUAL(1, table.getCount());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_unregistered_client_marks_no_role_seen);
+    RUN_TEST(test_board_registering_late_leaves_dashboard_absent);
+    RUN_TEST(test_dashboard_is_seen_once_registered);
+    RUN_TEST(test_role_strings);
+    RUN_TEST(test_client_table_moves_registration_out_of_unknown);
+    return UNITY_END();
+}
@@ -0,0 +1,230 @@
+#include <unity.h>
+#include <math.h>
+#include "PidBank.h"
+
+static const uint8_t CHANNELS = 4;
+static const uint32_t PERIOD_US = 10000;    // 100 Hz, like the wheel loops
+
+// Fix16 rounds gains and dt to 1/65536: allow a fraction of a PWM count
+static const float FIX_TOLERANCE = 0.05f;
+
+/** Same gains, limits and setpoints on a float and a Fix16 bank */
+template <typename Options>
+struct BankPair
+{
+    PidBank<float, CHANNELS, Options> flt;
+    PidBank<Fix16, CHANNELS, Options> fix;
+
+    void setTunings(uint8_t i, float kP, float kI, float kD)
+    {
+        flt.setTunings(i, kP, kI, kD);
+        fix.setTunings(i, kP, kI, kD);
+    }
+
+    void setOutputLimits(uint8_t i, float lo, float hi)
+    {
+        flt.setOutputLimits(i, lo, hi);
+        fix.setOutputLimits(i, lo, hi);
+    }
+
+    void setSetpoint(uint8_t i, float sp)
+    {
+        flt.setSetpoint(i, sp);
+        fix.setSetpoint(i, Fix16(sp));
+    }
+
+    void update(uint32_t nowUs, const float *inputs)
+    {
+        Fix16 fixInputs[CHANNELS];
+        for (uint8_t i = 0; i < CHANNELS; i++) fixInputs[i] = Fix16(inputs[i]);
+        flt.update(nowUs, inputs);
+        fix.update(nowUs, fixInputs);
+    }
+
+    void assertMatch() const
+    {
+        for (uint8_t i = 0; i < CHANNELS; i++)
+        {
+            TEST_ASSERT_FLOAT_WITHIN(FIX_TOLERANCE, flt.getOutput(i), (float)fix.getOutput(i));
+            TEST_ASSERT_FLOAT_WITHIN(FIX_TOLERANCE, flt.getIntegral(i), (float)fix.getIntegral(i));
+        }
+    }
+};
+
+/** Distinct gains per channel so a mixed-up index shows */
+template <typename Options>
+static void configure(BankPair<Options> &banks)
+{
+    banks.setTunings(0, 2.0f, 0.5f, 0.00f);
+    banks.setTunings(1, 1.2f, 3.0f, 0.05f);
+    banks.setTunings(2, 0.4f, 8.0f, 0.02f);
+    banks.setTunings(3, 5.0f, 0.0f, 0.10f);
+    for (uint8_t i = 0; i < CHANNELS; i++) banks.setSetpoint(i, 20.0f + 10.0f * i);
+}
+
+/** Open-loop inputs: each channel wanders around its setpoint */
+static void inputsAt(uint32_t step, float *inputs)
+{
+    for (uint8_t i = 0; i < CHANNELS; i++)
+    {
+        inputs[i] = 20.0f + 10.0f * i + 8.0f * sinf(0.05f * step * (i + 1));
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ============================================
+// FIX16 AGAINST FLOAT
+// ============================================
+
+void test_fix16_bank_tracks_float_bank(void)
+{
+    BankPair<PidOptions<>> banks;
+    configure(banks);
+
+    float inputs[CHANNELS];
+    for (uint32_t step = 0; step < 500; step++)
+    {
+        inputsAt(step, inputs);
+        banks.update(step * PERIOD_US, inputs);
+        banks.assertMatch();
+    }
+
+    // Channels really are independent: different gains, different outputs
+    TEST_ASSERT_TRUE(fabsf(banks.flt.getOutput(0) - banks.flt.getOutput(1)) > 1.0f);
+}
+
+void test_saturated_outputs_match_exactly(void)
+{
+    BankPair<PidOptions<>> banks;
+    configure(banks);
+    banks.setOutputLimits(1, -100.0f, 100.0f);
+    banks.setOutputLimits(2, 0.0f, 60.0f);
+
+    // Far below every setpoint: every output pinned at its own limit
+    float inputs[CHANNELS] = {-500.0f, -500.0f, -500.0f, -500.0f};
+    for (uint32_t step = 0; step < 50; step++) banks.update(step * PERIOD_US, inputs);
+
+    const float highs[CHANNELS] = {255.0f, 100.0f, 60.0f, 255.0f};
+    for (uint8_t i = 0; i < CHANNELS; i++)
+    {
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, highs[i], banks.flt.getOutput(i));
+        TEST_ASSERT_EQUAL(Fix16(highs[i]).raw(), banks.fix.getOutput(i).raw());
+    }
+}
+
+void test_windup_clamp_holds_integral_at_the_limit(void)
+{
+    BankPair<PidOptions<>> banks;
+    configure(banks);
+    banks.setOutputLimits(2, -40.0f, 40.0f);
+
+    // Long saturation: the I term climbs to the limit and stops there
+    float inputs[CHANNELS] = {0.0f, 0.0f, 0.0f, 0.0f};
+    uint32_t step = 0;
+    for (; step < 300; step++) banks.update(step * PERIOD_US, inputs);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 40.0f, banks.flt.getIntegral(2));
+    TEST_ASSERT_EQUAL(Fix16(40.0f).raw(), banks.fix.getIntegral(2).raw());
+
+    // Reverse the error: both unwind from the clamp, step for step
+    inputs[2] = 100.0f;
+    uint32_t fltLeft = 0;
+    uint32_t fixLeft = 0;
+    for (uint32_t n = 1; n <= 200; n++, step++)
+    {
+        banks.update(step * PERIOD_US, inputs);
+        banks.assertMatch();
+        if (!fltLeft && banks.flt.getOutput(2) < 40.0f) fltLeft = n;
+        if (!fixLeft && banks.fix.getOutput(2) < Fix16(40.0f)) fixLeft = n;
+    }
+    TEST_ASSERT_TRUE(fltLeft > 0);
+    TEST_ASSERT_EQUAL_UINT32(fltLeft, fixLeft);
+}
+
+void test_conditional_windup_matches_float(void)
+{
+    BankPair<PidOptions<true, PID_WINDUP_CONDITIONAL>> banks;
+    configure(banks);
+    for (uint8_t i = 0; i < CHANNELS; i++) banks.setOutputLimits(i, -30.0f, 30.0f);
+
+    float inputs[CHANNELS];
+    for (uint32_t step = 0; step < 400; step++)
+    {
+        // Alternate long pushes into each limit
+        bool high = (step / 100) % 2 == 0;
+        for (uint8_t i = 0; i < CHANNELS; i++) inputs[i] = high ? -50.0f : 150.0f;
+        banks.update(step * PERIOD_US, inputs);
+        banks.assertMatch();
+    }
+}
+
+// ============================================
+// BANK BEHAVIOUR
+// ============================================
+
+void test_disabled_channel_is_skipped(void)
+{
+    BankPair<PidOptions<>> banks;
+    configure(banks);
+    banks.flt.setEnabled(1, false);
+    banks.fix.setEnabled(1, false);
+
+    float inputs[CHANNELS];
+    for (uint32_t step = 0; step < 100; step++)
+    {
+        inputsAt(step, inputs);
+        banks.update(step * PERIOD_US, inputs);
+    }
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, banks.flt.getOutput(1));
+    TEST_ASSERT_EQUAL(0, banks.fix.getOutput(1).raw());
+    TEST_ASSERT_TRUE(banks.fix.getOutput(2) != Fix16(0.0f));
+    banks.assertMatch();
+}
+
+void test_stall_restarts_every_channel(void)
+{
+    BankPair<PidOptions<>> banks;
+    configure(banks);
+
+    float inputs[CHANNELS] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (uint32_t step = 0; step < 20; step++) banks.update(step * PERIOD_US, inputs);
+    TEST_ASSERT_TRUE(banks.fix.getIntegral(1) > Fix16(0.0f));
+
+    // A gap past MAX_DT_US clears every I term in both banks
+    banks.update(20 * PERIOD_US + PidBank<Fix16, CHANNELS>::MAX_DT_US, inputs);
+    for (uint8_t i = 0; i < CHANNELS; i++)
+    {
+        TEST_ASSERT_EQUAL(0, banks.fix.getIntegral(i).raw());
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, banks.flt.getIntegral(i));
+    }
+}
+
+// ============================================
+// FIX16
+// ============================================
+
+void test_fix16_saturates_instead_of_wrapping(void)
+{
+    Fix16 big(30000.0f);
+    TEST_ASSERT_EQUAL(Fix16::RAW_MAX, (big + big).raw());
+    TEST_ASSERT_EQUAL(Fix16::RAW_MIN, (-big - big).raw());
+    TEST_ASSERT_EQUAL(Fix16::RAW_MAX, (big * big).raw());
+    TEST_ASSERT_EQUAL(Fix16::RAW_MIN, (-big * big).raw());
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, -1.5f, (float)(Fix16(0.5f) * Fix16(-3.0f)));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fix16_bank_tracks_float_bank);
+    RUN_TEST(test_saturated_outputs_match_exactly);
+    RUN_TEST(test_windup_clamp_holds_integral_at_the_limit);
+    RUN_TEST(test_conditional_windup_matches_float);
+    RUN_TEST(test_disabled_channel_is_skipped);
+    RUN_TEST(test_stall_restarts_every_channel);
+    RUN_TEST(test_fix16_saturates_instead_of_wrapping);
+    return UNITY_END();
+}
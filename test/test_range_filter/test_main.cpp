@@ -0,0 +1,200 @@
+#include <unity.h>
+#include "config.h"
+#include "RangeFilter.h"
+
+static const unsigned long T0 = 1000;
+static const unsigned long PERIOD_MS = 60;   // One ping per sensor per scheduler round
+
+static void feed(RangeFilter &filter, float cm, uint8_t n, unsigned long &now)
+{
+    for (uint8_t i = 0; i < n; i++)
+    {
+        filter.addSample(cm, now);
+        now += PERIOD_MS;
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ============================================
+// MEDIAN
+// ============================================
+
+void test_no_sample_reads_invalid_and_stale(void)
+{
+    RangeFilter filter(US_MEDIAN_WINDOW, US_STALE_MS);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -1.0f, filter.getDistance());
+    TEST_ASSERT_TRUE(filter.isStale(T0));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, filter.getConfidence(T0));
+}
+
+void test_single_spike_is_rejected(void)
+{
+    RangeFilter filter(US_MEDIAN_WINDOW, US_STALE_MS);
+    unsigned long now = T0;
+    feed(filter, 100.0f, US_MEDIAN_WINDOW, now);
+
+    feed(filter, 300.0f, 1, now);   // Stray echo
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, filter.getDistance());
+    TEST_ASSERT_EQUAL_UINT32(1, filter.getOutliers());
+
+    feed(filter, 5.0f, 1, now);     // Crosstalk the other way
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, filter.getDistance());
+    TEST_ASSERT_EQUAL_UINT32(2, filter.getOutliers());
+}
+
+void test_step_change_wins_after_half_the_window(void)
+{
+    RangeFilter filter(US_MEDIAN_WINDOW, US_STALE_MS);
+    unsigned long now = T0;
+    feed(filter, 100.0f, US_MEDIAN_WINDOW, now);
+
+    // Obstacle appears at 50 cm: the median follows on the (window / 2 + 1)th sample
+    for (uint8_t i = 1; i <= US_MEDIAN_WINDOW / 2; i++)
+    {
+        feed(filter, 50.0f, 1, now);
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, filter.getDistance());
+    }
+    feed(filter, 50.0f, 1, now);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f, filter.getDistance());
+}
+
+// ============================================
+// STALENESS
+// ============================================
+
+void test_stale_after_stale_ms_without_valid_echo(void)
+{
+    RangeFilter filter(US_MEDIAN_WINDOW, US_STALE_MS);
+    filter.addSample(80.0f, T0);
+
+    TEST_ASSERT_EQUAL_UINT32(T0, filter.getTimestamp());
+    TEST_ASSERT_FALSE(filter.isStale(T0 + US_STALE_MS));
+    TEST_ASSERT_TRUE(filter.isStale(T0 + US_STALE_MS + 1));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, filter.getConfidence(T0 + US_STALE_MS + 1));
+
+    // The last distance is kept, it just isn't trusted
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 80.0f, filter.getDistance());
+
+    filter.addSample(80.0f, T0 + 2 * US_STALE_MS);
+    TEST_ASSERT_FALSE(filter.isStale(T0 + 2 * US_STALE_MS));
+}
+
+void test_stale_after_window_of_consecutive_dropouts(void)
+{
+    RangeFilter filter(US_MEDIAN_WINDOW, US_STALE_MS);
+    unsigned long now = T0;
+    feed(filter, 80.0f, US_MEDIAN_WINDOW, now);
+    unsigned long last = now - PERIOD_MS;
+
+    // Timeouts arrive quickly, well inside US_STALE_MS
+    for (uint8_t i = 1; i < US_MEDIAN_WINDOW; i++)
+    {
+        filter.addSample(-1.0f, last + i);
+        TEST_ASSERT_FALSE(filter.isStale(last + i));
+    }
+    filter.addSample(-1.0f, last + US_MEDIAN_WINDOW);
+
+    TEST_ASSERT_TRUE(filter.isStale(last + US_MEDIAN_WINDOW));
+    TEST_ASSERT_EQUAL_UINT8(US_MEDIAN_WINDOW, filter.getConsecutiveDropouts());
+    TEST_ASSERT_EQUAL_UINT32(US_MEDIAN_WINDOW, filter.getDropouts());
+
+    // One good echo recovers
+    filter.addSample(80.0f, last + 10);
+    TEST_ASSERT_FALSE(filter.isStale(last + 10));
+    TEST_ASSERT_EQUAL_UINT8(0, filter.getConsecutiveDropouts());
+}
+
+// ============================================
+// CONFIDENCE TERMS
+// ============================================
+
+void test_confidence_full_for_fresh_consistent_window(void)
+{
+    RangeFilter filter(US_MEDIAN_WINDOW, US_STALE_MS);
+    unsigned long now = T0;
+    feed(filter, 120.0f, US_MEDIAN_WINDOW, now);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, filter.getConfidence(filter.getTimestamp()));
+}
+
+void test_confidence_scales_with_window_fill(void)
+{
+    RangeFilter filter(US_MEDIAN_WINDOW, US_STALE_MS);
+    for (uint8_t n = 1; n <= US_MEDIAN_WINDOW; n++)
+    {
+        filter.addSample(120.0f, T0);
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, (float)n / US_MEDIAN_WINDOW, filter.getConfidence(T0));
+    }
+}
+
+void test_confidence_decays_with_age(void)
+{
+    RangeFilter filter(US_MEDIAN_WINDOW, US_STALE_MS);
+    unsigned long now = T0;
+    feed(filter, 120.0f, US_MEDIAN_WINDOW, now);
+    unsigned long last = filter.getTimestamp();
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.75f, filter.getConfidence(last + US_STALE_MS / 4));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.5f, filter.getConfidence(last + US_STALE_MS / 2));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, filter.getConfidence(last + US_STALE_MS));
+}
+
+void test_confidence_drops_with_recent_dropout_rate(void)
+{
+    RangeFilter filter(US_MEDIAN_WINDOW, US_STALE_MS);
+    unsigned long now = T0;
+    feed(filter, 120.0f, US_MEDIAN_WINDOW, now);
+
+    // 4 of the last 16 attempts timed out
+    feed(filter, -1.0f, 2, now);
+    feed(filter, 120.0f, 1, now);
+    feed(filter, -1.0f, 2, now);
+    feed(filter, 120.0f, 1, now);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.75f, filter.getConfidence(filter.getTimestamp()));
+
+    // Dropouts age out of the 16-attempt history
+    feed(filter, 120.0f, 16, now);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, filter.getConfidence(filter.getTimestamp()));
+}
+
+void test_confidence_drops_with_spread(void)
+{
+    RangeFilter filter(5, US_STALE_MS);
+    const float samples[5] = {100.0f, 102.0f, 104.0f, 106.0f, 108.0f};
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        filter.addSample(samples[i], T0);
+    }
+
+    // Median 104, median absolute deviation 2 cm, allowed 5 cm + 20 %
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 104.0f, filter.getDistance());
+    float expected = 1.0f - 2.0f / (5.0f + 0.2f * 104.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, expected, filter.getConfidence(T0));
+
+    // Spread beyond the allowance: no confidence left, but not stale
+    RangeFilter noisy(5, US_STALE_MS);
+    const float wild[5] = {20.0f, 60.0f, 100.0f, 140.0f, 180.0f};
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        noisy.addSample(wild[i], T0);
+    }
+    TEST_ASSERT_FALSE(noisy.isStale(T0));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, noisy.getConfidence(T0));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_no_sample_reads_invalid_and_stale);
+    RUN_TEST(test_single_spike_is_rejected);
+    RUN_TEST(test_step_change_wins_after_half_the_window);
+    RUN_TEST(test_stale_after_stale_ms_without_valid_echo);
+    RUN_TEST(test_stale_after_window_of_consecutive_dropouts);
+    RUN_TEST(test_confidence_full_for_fresh_consistent_window);
+    RUN_TEST(test_confidence_scales_with_window_fill);
+    RUN_TEST(test_confidence_decays_with_age);
+    RUN_TEST(test_confidence_drops_with_recent_dropout_rate);
+    RUN_TEST(test_confidence_drops_with_spread);
+    return UNITY_END();
+}
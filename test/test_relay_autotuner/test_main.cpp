@@ -0,0 +1,231 @@
+#include <unity.h>
+#include <math.h>
+#include "RelayAutotuner.h"
+
+// First-order-plus-dead-time plant: tau dy/dt = K u(t - theta) - y
+struct FopdtPlant
+{
+    static const uint16_t MAX_DELAY = 256;
+
+    float gain, tauSec, deadSec, dtSec;
+    float y;
+    float delayLine[MAX_DELAY];
+    uint16_t delaySteps, head;
+
+    FopdtPlant(float k, float tau, float dead, float dt, float y0)
+        : gain(k), tauSec(tau), deadSec(dead), dtSec(dt), y(y0), head(0)
+    {
+        delaySteps = (uint16_t)lroundf(dead / dt);
+        if (delaySteps < 1) delaySteps = 1;
+        for (uint16_t i = 0; i < MAX_DELAY; i++) delayLine[i] = y0 / k;
+    }
+
+    float step(float u)
+    {
+        float delayed = delayLine[head];
+        delayLine[head] = u;
+        head = (head + 1) % delaySteps;
+        y += (gain * delayed - y) * dtSec / tauSec;
+        return y;
+    }
+
+    // Exact relay limit cycle (no hysteresis) for relay amplitude d
+    void relayCycle(float d, float &amplitude, float &periodSec) const
+    {
+        amplitude = fabsf(gain) * d * (1.0f - expf(-deadSec / tauSec));
+        periodSec = 2.0f * tauSec * logf(2.0f * expf(deadSec / tauSec) - 1.0f);
+    }
+
+    // Analytic ultimate point: theta w + atan(tau w) = pi
+    void ultimate(float &ku, float &puSec) const
+    {
+        float lo = 0.0f, hi = (float)M_PI / deadSec;
+        for (int i = 0; i < 60; i++)
+        {
+            float w = 0.5f * (lo + hi);
+            if (deadSec * w + atanf(tauSec * w) < (float)M_PI) lo = w; else hi = w;
+        }
+        float w = 0.5f * (lo + hi);
+        ku = sqrtf(1.0f + tauSec * w * tauSec * w) / fabsf(gain);
+        puSec = 2.0f * (float)M_PI / w;
+    }
+};
+
+static const uint32_t TICK_MS = 20;     // Approach loop rate
+
+static RelayAutotuner::Config makeConfig(float setpoint, float bias, float amplitude, float hysteresis)
+{
+    RelayAutotuner::Config config = {};
+    config.setpoint = setpoint;
+    config.outputBias = bias;
+    config.relayAmplitude = amplitude;
+    config.hysteresis = hysteresis;
+    config.reverseActing = false;
+    config.cycles = 3;
+    config.timeoutMs = 60000;
+    config.rule = RelayAutotuner::RULE_ZIEGLER_NICHOLS;
+    return config;
+}
+
+/**
+ * Run the relay against the plant until the tuner finishes
+ * @param noise Peak measurement noise (deterministic)
+ */
+static RelayAutotuner::State runTune(RelayAutotuner &tuner, FopdtPlant &plant,
+                                     const RelayAutotuner::Config &config, float noise = 0.0f)
+{
+    uint32_t seed = 7;
+    uint32_t now = 0;
+    tuner.start(config, now);
+
+    float y = plant.y;
+    while (tuner.isRunning() && now < config.timeoutMs + 1000)
+    {
+        seed = seed * 1103515245u + 12345u;
+        float measured = y + noise * (((seed >> 16) % 201) / 100.0f - 1.0f);
+        float u = tuner.update(measured, now);
+        y = plant.step(u);
+        now += TICK_MS;
+    }
+    return tuner.getState();
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ============================================
+// IDENTIFICATION
+// ============================================
+
+static void assertMatchesRelayCycle(const FopdtPlant &plant, const RelayAutotuner::Result &r, float d)
+{
+    // Amplitude and period of the limit cycle itself: within a tick or so
+    float amplitude, period;
+    plant.relayCycle(d, amplitude, period);
+    TEST_ASSERT_FLOAT_WITHIN(0.08f * amplitude, amplitude, r.amplitude);
+    TEST_ASSERT_FLOAT_WITHIN(0.08f * period, period, r.puSec);
+    TEST_ASSERT_FLOAT_WITHIN(0.08f * r.ku, 4.0f * d / ((float)M_PI * amplitude), r.ku);
+
+    // Against the true ultimate point the describing function (first
+    // harmonic only) reads Ku low on a lag-dominant plant, Pu close
+    float ku, pu;
+    plant.ultimate(ku, pu);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f * pu, pu, r.puSec);
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.7f * ku, r.ku);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(ku, r.ku);
+}
+
+void test_identifies_ku_and_pu_of_fopdt_plant(void)
+{
+    FopdtPlant plant(2.0f, 1.0f, 0.2f, TICK_MS / 1000.0f, 100.0f);
+    RelayAutotuner tuner;
+    TEST_ASSERT_EQUAL(RelayAutotuner::TUNE_DONE, runTune(tuner, plant, makeConfig(100.0f, 50.0f, 10.0f, 0.0f)));
+
+    const RelayAutotuner::Result &r = tuner.getResult();
+    assertMatchesRelayCycle(plant, r, 10.0f);
+    TEST_ASSERT_EQUAL_UINT8(3, r.cycles);
+    TEST_ASSERT_TRUE(r.periodSpread <= 0.2f);
+}
+
+void test_gains_follow_the_selected_rule(void)
+{
+    FopdtPlant plant(2.0f, 1.0f, 0.2f, TICK_MS / 1000.0f, 100.0f);
+    RelayAutotuner tuner;
+    runTune(tuner, plant, makeConfig(100.0f, 50.0f, 10.0f, 0.0f));
+    const RelayAutotuner::Result &r = tuner.getResult();
+
+    // Ziegler-Nichols: kP = 0.6 Ku, Ti = Pu / 2, Td = Pu / 8
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.6f * r.ku, r.kP);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, r.kP / (0.5f * r.puSec), r.kI);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, r.kP * 0.125f * r.puSec, r.kD);
+
+    // Tyreus-Luyben from the same point is gentler on every term
+    float kP, kI, kD;
+    RelayAutotuner::gainsFor(RelayAutotuner::RULE_TYREUS_LUYBEN, r.ku, r.puSec, kP, kI, kD);
+    TEST_ASSERT_LESS_THAN_FLOAT(r.kP, kP);
+    TEST_ASSERT_LESS_THAN_FLOAT(r.kI, kI);
+    TEST_ASSERT_LESS_THAN_FLOAT(r.kD, kD);
+
+    // PI rule has no derivative
+    RelayAutotuner::gainsFor(RelayAutotuner::RULE_ZIEGLER_NICHOLS_PI, r.ku, r.puSec, kP, kI, kD);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, kD);
+}
+
+void test_longer_dead_time_lowers_ku_and_stretches_pu(void)
+{
+    FopdtPlant fast(2.0f, 1.0f, 0.1f, TICK_MS / 1000.0f, 100.0f);
+    FopdtPlant slow(2.0f, 1.0f, 0.4f, TICK_MS / 1000.0f, 100.0f);
+    RelayAutotuner a, b;
+    runTune(a, fast, makeConfig(100.0f, 50.0f, 10.0f, 0.0f));
+    runTune(b, slow, makeConfig(100.0f, 50.0f, 10.0f, 0.0f));
+
+    TEST_ASSERT_LESS_THAN_FLOAT(a.getResult().ku, b.getResult().ku);
+    TEST_ASSERT_GREATER_THAN_FLOAT(a.getResult().puSec, b.getResult().puSec);
+}
+
+void test_reverse_acting_plant(void)
+{
+    // Approach loop: more forward speed closes the range
+    FopdtPlant plant(-2.0f, 1.0f, 0.2f, TICK_MS / 1000.0f, -100.0f);
+    RelayAutotuner::Config config = makeConfig(-100.0f, 50.0f, 10.0f, 0.0f);
+    config.reverseActing = true;
+
+    RelayAutotuner tuner;
+    TEST_ASSERT_EQUAL(RelayAutotuner::TUNE_DONE, runTune(tuner, plant, config));
+    assertMatchesRelayCycle(plant, tuner.getResult(), 10.0f);
+}
+
+void test_hysteresis_rides_out_measurement_noise(void)
+{
+    FopdtPlant clean(2.0f, 1.0f, 0.2f, TICK_MS / 1000.0f, 100.0f);
+    FopdtPlant noisy(2.0f, 1.0f, 0.2f, TICK_MS / 1000.0f, 100.0f);
+    RelayAutotuner reference, tuner;
+    runTune(reference, clean, makeConfig(100.0f, 50.0f, 10.0f, 0.0f));
+    TEST_ASSERT_EQUAL(RelayAutotuner::TUNE_DONE,
+                      runTune(tuner, noisy, makeConfig(100.0f, 50.0f, 10.0f, 1.0f), 0.5f));
+
+    // The band adds lag: a wider, slower cycle, still near the clean one
+    const RelayAutotuner::Result &ref = reference.getResult();
+    TEST_ASSERT_FLOAT_WITHIN(0.25f * ref.ku, ref.ku, tuner.getResult().ku);
+    TEST_ASSERT_FLOAT_WITHIN(0.25f * ref.puSec, ref.puSec, tuner.getResult().puSec);
+}
+
+// ============================================
+// FAILURES
+// ============================================
+
+void test_times_out_when_the_plant_never_crosses(void)
+{
+    // Relay too weak to reach the setpoint: no limit cycle
+    FopdtPlant plant(2.0f, 1.0f, 0.2f, TICK_MS / 1000.0f, 0.0f);
+    RelayAutotuner::Config config = makeConfig(100.0f, 0.0f, 10.0f, 0.0f);
+    config.timeoutMs = 10000;
+
+    RelayAutotuner tuner;
+    TEST_ASSERT_EQUAL(RelayAutotuner::TUNE_FAILED, runTune(tuner, plant, config));
+    TEST_ASSERT_EQUAL(RelayAutotuner::TUNE_FAIL_TIMEOUT, tuner.getFailure());
+}
+
+void test_cancel_returns_the_bias(void)
+{
+    RelayAutotuner tuner;
+    tuner.start(makeConfig(100.0f, 50.0f, 10.0f, 0.0f), 0);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 60.0f, tuner.update(90.0f, 20));
+
+    tuner.cancel();
+    TEST_ASSERT_EQUAL(RelayAutotuner::TUNE_FAIL_CANCELLED, tuner.getFailure());
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 50.0f, tuner.update(90.0f, 40));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_identifies_ku_and_pu_of_fopdt_plant);
+    RUN_TEST(test_gains_follow_the_selected_rule);
+    RUN_TEST(test_longer_dead_time_lowers_ku_and_stretches_pu);
+    RUN_TEST(test_reverse_acting_plant);
+    RUN_TEST(test_hysteresis_rides_out_measurement_noise);
+    RUN_TEST(test_times_out_when_the_plant_never_crosses);
+    RUN_TEST(test_cancel_returns_the_bias);
+    return UNITY_END();
+}
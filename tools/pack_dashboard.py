@@ -0,0 +1,95 @@
+"""
+Pack the built dashboard into the rear board's filesystem image
+
+robot-dashboard/dist -> data/www (DASHBOARD_FS_ROOT):
+- every file gzipped as <path>.gz (level 9, no name or timestamp in the
+  header, so the bytes only change when the content does)
+- etags.txt: "<url path> <hash>" per file, read by DashboardAssets
+
+Standalone:  python tools/pack_dashboard.py [--build]
+PlatformIO:  runs before the LittleFS image is built (extra_scripts in
+             platformio.ini): pio run -e back_esp32 -t uploadfs
+"""
+
+import gzip
+import hashlib
+import os
+import shutil
+import subprocess
+import sys
+
+try:
+    Import("env")  # noqa: F821 - defined when run by PlatformIO (no __file__ there)
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    env = None
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+DASHBOARD_DIR = os.path.join(PROJECT_DIR, "robot-dashboard")
+DIST_DIR = os.path.join(DASHBOARD_DIR, "dist")
+DASHBOARD_ROOT = "/www"  # DASHBOARD_FS_ROOT in config.h
+OUT_DIR = os.path.join(PROJECT_DIR, "data", DASHBOARD_ROOT.lstrip("/"))
+
+MAX_FILES = 32      # DashboardAssets::MAX_FILES
+MAX_PATH_LEN = 63   # LittleFS object name limit, ".gz" included
+
+
+def build_dashboard():
+    tool = shutil.which("pnpm") or shutil.which("npm")
+    if not tool:
+        sys.exit("pack_dashboard: neither pnpm nor npm found")
+    subprocess.run([tool, "run", "build"], cwd=DASHBOARD_DIR, check=True)
+
+
+def pack():
+    if not os.path.isdir(DIST_DIR):
+        sys.exit("pack_dashboard: %s missing - run the dashboard build first (or --build)" % DIST_DIR)
+
+    if os.path.isdir(OUT_DIR):
+        shutil.rmtree(OUT_DIR)
+    os.makedirs(OUT_DIR)
+
+    entries = []
+    raw_total = 0
+    packed_total = 0
+    for folder, _, files in sorted(os.walk(DIST_DIR)):
+        for name in sorted(files):
+            src = os.path.join(folder, name)
+            url = "/" + os.path.relpath(src, DIST_DIR).replace(os.sep, "/")
+            if len(DASHBOARD_ROOT + url) + 3 > MAX_PATH_LEN:
+                sys.exit("pack_dashboard: path too long for LittleFS: " + url)
+
+            with open(src, "rb") as f:
+                raw = f.read()
+            packed = gzip.compress(raw, compresslevel=9, mtime=0)
+
+            dst = os.path.join(OUT_DIR, url.lstrip("/") + ".gz")
+            os.makedirs(os.path.dirname(dst), exist_ok=True)
+            with open(dst, "wb") as f:
+                f.write(packed)
+
+            # Strong validator: changes exactly when the bytes sent change
+            entries.append((url, hashlib.sha256(packed).hexdigest()[:16]))
+            raw_total += len(raw)
+            packed_total += len(packed)
+
+    if len(entries) > MAX_FILES:
+        sys.exit("pack_dashboard: %d files, the board serves at most %d" % (len(entries), MAX_FILES))
+
+    with open(os.path.join(OUT_DIR, "etags.txt"), "w", newline="\n") as f:
+        for url, etag in entries:
+            f.write("%s %s\n" % (url, etag))
+
+    print("pack_dashboard: %d files, %d -> %d bytes gzipped" % (len(entries), raw_total, packed_total))
+
+
+def _before_fs_image(target, source, env):
+    pack()
+
+
+if env is not None:
+    env.AddPreAction("$BUILD_DIR/littlefs.bin", _before_fs_image)
+elif __name__ == "__main__":
+    if "--build" in sys.argv[1:]:
+        build_dashboard()
+    pack()
@@ -0,0 +1,427 @@
+/**
+ * Telemetry fan-out gateway
+ *
+ * Holds the only connection to the rear board and serves any number of
+ * dashboards from it, so the robot serializes and sends each frame once
+ * however many people are watching.
+ *
+ * - Upstream frames are parsed once; clients get the original text
+ * - Latest state is kept per message type (telemetry, schedules, one alert
+ *   per hazard, the assembled occupancy map) and replayed to new clients
+ * - A client that can't keep up skips frames instead of queueing them
+ *   without bound: once its socket drains it gets the latest state of
+ *   whatever it missed
+ * - Client commands share one rate-limited queue to the robot; drive
+ *   commands coalesce (latest wins) and stop jumps the queue
+ *
+ * Usage: node gateway.js [--robot ws://192.168.4.1:8888/ws] [--port 8888] [--rate 20]
+ *        GET /stats on the same port for counters
+ */
+import http from 'node:http';
+import { WebSocket, WebSocketServer } from 'ws';
+
+// ============================================
+// CONFIG
+// ============================================
+
+const args = parseArgs(process.argv.slice(2));
+
+const ROBOT_URL = args.robot || process.env.ROBOT_WS || 'ws://192.168.4.1:8888/ws';
+const PORT = Number(args.port || process.env.GATEWAY_PORT || 8888);
+
+// Upstream reconnect backoff
+const RECONNECT_MIN_MS = 500;
+const RECONNECT_MAX_MS = 8000;
+
+// Per-client buffering (bytes queued in the client's socket)
+const HIGH_WATER_BYTES = 256 * 1024;    // Above: skip frames, remember what was missed
+const LOW_WATER_BYTES = 32 * 1024;      // Below again: catch up on the latest state
+const STUCK_BYTES = 4 * 1024 * 1024;    // Not draining at all: drop the client
+const CATCH_UP_INTERVAL_MS = 100;
+
+// Command channel
+const COMMAND_RATE = Number(args.rate || process.env.COMMAND_RATE || 20); // Commands/s to the robot
+const COMMAND_BURST = 5;
+const COMMAND_QUEUE = 32;
+
+// Protocol (MessageProtocol.h)
+const TYPE_STATUS = 'status';
+const TYPE_UI_CMD = 'ui_cmd';
+const TYPE_MAP_DELTA = 'map_delta';
+const TYPE_HAZARD_ALERT = 'hazard_alert';
+const MAP_WINDOW_CELLS = 64;            // OccupancyGrid::SIZE
+const RESTART_TS_SLACK_MS = 1000;       // "ts" (robot millis) going back this far = robot restarted
+
+// Replies and front-board traffic: passed through, never replayed
+const NO_REPLAY = new Set(['ack', 'pid_ack', 'motor_cmd', 'sensor_update', 'ping', TYPE_STATUS]);
+
+const DRIVE_CMDS = new Set(['forward', 'backward', 'left', 'right', 'stop']);
+const URGENT_CMDS = new Set(['stop', 'auto_off']);
+
+function parseArgs(argv) {
+  const out = {};
+  for (let i = 0; i < argv.length; i++) {
+    if (argv[i].startsWith('--')) out[argv[i].slice(2)] = argv[++i];
+  }
+  return out;
+}
+
+// ============================================
+// STATE CACHE
+// ============================================
+
+class StateCache {
+  constructor() {
+    this.clear();
+  }
+
+  clear() {
+    this.latest = new Map();    // type -> frame text
+    this.hazards = new Map();   // hazard -> frame text
+    this.mapHeader = null;      // Last map_delta without its tiles
+    this.tiles = new Map();     // "tx,ty" -> [tx, ty, b64]
+    this.lastTs = 0;
+  }
+
+  ingest(msg, text) {
+    if (typeof msg.ts === 'number') {
+      if (msg.ts + RESTART_TS_SLACK_MS < this.lastTs) this.clear();
+      this.lastTs = msg.ts;
+    }
+
+    if (msg.type === TYPE_MAP_DELTA) this.mergeMap(msg);
+    else if (msg.type === TYPE_HAZARD_ALERT) this.hazards.set(String(msg.hazard), text);
+    else if (!NO_REPLAY.has(msg.type)) this.latest.set(msg.type, text);
+  }
+
+  // Deltas only carry changed tiles: keep the whole window, like the dashboard does
+  mergeMap(msg) {
+    const { tiles = [], ...header } = msg;
+    for (const tile of tiles) this.tiles.set(`${tile[0]},${tile[1]}`, tile);
+
+    const [ox, oy] = header.origin || [0, 0];
+    for (const [key, [tx, ty]] of this.tiles) {
+      const cx = tx * header.tile, cy = ty * header.tile;
+      if (cx < ox || cy < oy || cx >= ox + MAP_WINDOW_CELLS || cy >= oy + MAP_WINDOW_CELLS) {
+        this.tiles.delete(key);
+      }
+    }
+    this.mapHeader = header;
+  }
+
+  /**
+   * Frames that bring a client up to date
+   * @param types Only these message types (all when omitted)
+   */
+  frames(types) {
+    const want = (type) => !types || types.has(type);
+    const out = [];
+    for (const [type, text] of this.latest) {
+      if (want(type)) out.push(text);
+    }
+    if (want(TYPE_HAZARD_ALERT)) out.push(...this.hazards.values());
+    if (want(TYPE_MAP_DELTA) && this.mapHeader) {
+      out.push(JSON.stringify({ ...this.mapHeader, tiles: [...this.tiles.values()] }));
+    }
+    return out;
+  }
+}
+
+// ============================================
+// UPSTREAM (one connection to the robot)
+// ============================================
+
+class Upstream {
+  constructor(url, onFrame, onLink) {
+    this.url = url;
+    this.onFrame = onFrame;
+    this.onLink = onLink;
+    this.ws = null;
+    this.connected = false;
+    this.delayMs = RECONNECT_MIN_MS;
+    this.stats = { connects: 0, frames: 0, bytes: 0, badFrames: 0, lastError: null };
+  }
+
+  get open() {
+    return this.ws?.readyState === WebSocket.OPEN;
+  }
+
+  connect() {
+    const ws = new WebSocket(this.url, { handshakeTimeout: 3000 });
+    this.ws = ws;
+
+    ws.on('open', () => {
+      console.log(`[Gateway] Robot connected (${this.url})`);
+      this.stats.connects++;
+      this.connected = true;
+      this.delayMs = RECONNECT_MIN_MS;
+      // Registers as a dashboard link on the robot (LinkSupervisor)
+      ws.send(JSON.stringify({ type: TYPE_STATUS, role: 'gateway', status: 'connected' }));
+      this.onLink(true);
+    });
+
+    ws.on('message', (data, isBinary) => {
+      if (isBinary) {
+        this.stats.badFrames++;
+        return;
+      }
+      const text = data.toString();
+      let msg;
+      try {
+        msg = JSON.parse(text);
+      } catch {
+        this.stats.badFrames++;
+        return;
+      }
+      if (!msg || typeof msg.type !== 'string') {
+        this.stats.badFrames++;
+        return;
+      }
+      this.stats.frames++;
+      this.stats.bytes += text.length;
+      this.onFrame(msg, text);
+    });
+
+    ws.on('error', (err) => {
+      this.stats.lastError = err.message;
+    });
+
+    // Also follows a failed connect
+    ws.on('close', () => {
+      if (this.connected) {
+        this.connected = false;
+        console.log('[Gateway] Robot disconnected');
+        this.onLink(false);
+      }
+      setTimeout(() => this.connect(), this.delayMs);
+      this.delayMs = Math.min(this.delayMs * 2, RECONNECT_MAX_MS);
+    });
+  }
+
+  send(text) {
+    this.ws.send(text);
+  }
+}
+
+// ============================================
+// COMMAND CHANNEL (clients -> robot)
+// ============================================
+
+class CommandChannel {
+  constructor(upstream) {
+    this.upstream = upstream;
+    this.queue = [];            // { key, urgent, text, at }
+    this.tokens = COMMAND_BURST;
+    this.lastRefill = Date.now();
+    this.timer = null;
+    this.stats = { forwarded: 0, coalesced: 0, dropped: 0, rejected: 0, maxWaitMs: 0, totalWaitMs: 0 };
+  }
+
+  push(msg, text) {
+    const drive = DRIVE_CMDS.has(msg.cmd);
+    const entry = { key: drive ? 'drive' : null, urgent: URGENT_CMDS.has(msg.cmd), text, at: Date.now() };
+
+    // A newer drive command supersedes one still waiting
+    const pending = drive ? this.queue.findIndex((e) => e.key === 'drive') : -1;
+    if (pending >= 0) {
+      this.stats.coalesced++;
+      if (!entry.urgent) {
+        this.queue[pending] = { ...entry, at: this.queue[pending].at };
+        this.pump();
+        return;
+      }
+      this.queue.splice(pending, 1);
+    }
+
+    if (entry.urgent) {
+      this.queue.unshift(entry);
+    } else {
+      if (this.queue.length >= COMMAND_QUEUE) {
+        const oldest = this.queue.findIndex((e) => !e.urgent);
+        this.queue.splice(oldest >= 0 ? oldest : 0, 1);
+        this.stats.dropped++;
+      }
+      this.queue.push(entry);
+    }
+    this.pump();
+  }
+
+  // Robot went away: nothing queued should reach it later
+  clear() {
+    this.stats.dropped += this.queue.length;
+    this.queue = [];
+  }
+
+  pump() {
+    const now = Date.now();
+    this.tokens = Math.min(COMMAND_BURST, this.tokens + (now - this.lastRefill) * COMMAND_RATE / 1000);
+    this.lastRefill = now;
+
+    while (this.queue.length && this.tokens >= 1 && this.upstream.open) {
+      const entry = this.queue.shift();
+      this.upstream.send(entry.text);
+      this.tokens -= 1;
+
+      const waitMs = now - entry.at;
+      this.stats.forwarded++;
+      this.stats.totalWaitMs += waitMs;
+      this.stats.maxWaitMs = Math.max(this.stats.maxWaitMs, waitMs);
+    }
+
+    if (this.queue.length && !this.timer) {
+      const delayMs = Math.ceil((1 - this.tokens) * 1000 / COMMAND_RATE);
+      this.timer = setTimeout(() => {
+        this.timer = null;
+        this.pump();
+      }, delayMs);
+    }
+  }
+}
+
+// ============================================
+// DOWNSTREAM (dashboards)
+// ============================================
+
+const cache = new StateCache();
+const clients = new Set();
+let nextClientId = 1;
+
+const upstream = new Upstream(ROBOT_URL, fanOut, onRobotLink);
+const commands = new CommandChannel(upstream);
+
+function fanOut(msg, text) {
+  cache.ingest(msg, text);
+
+  for (const client of clients) {
+    if (client.ws.readyState !== WebSocket.OPEN) continue;
+
+    // Behind: hold everything until the catch-up, which sends the latest instead
+    if (client.missed.size || client.ws.bufferedAmount > HIGH_WATER_BYTES) {
+      client.missed.add(msg.type);
+      client.skipped++;
+      continue;
+    }
+    client.ws.send(text);
+    client.sent++;
+  }
+}
+
+function catchUp() {
+  for (const client of clients) {
+    if (!client.missed.size) continue;
+
+    const buffered = client.ws.bufferedAmount;
+    if (buffered > STUCK_BYTES) {
+      console.log(`[Gateway] Client #${client.id} not draining - dropped`);
+      client.ws.terminate();
+    } else if (buffered < LOW_WATER_BYTES) {
+      for (const text of cache.frames(client.missed)) client.ws.send(text);
+      client.missed.clear();
+      client.catchUps++;
+    }
+  }
+}
+
+function onRobotLink(up) {
+  if (!up) commands.clear();
+
+  const status = JSON.stringify({ type: TYPE_STATUS, role: 'gateway', status: up ? 'robot_online' : 'robot_offline', ts: Date.now() });
+  for (const client of clients) {
+    if (client.ws.readyState === WebSocket.OPEN) client.ws.send(status);
+  }
+}
+
+function onClientMessage(client, data, isBinary) {
+  let msg = null;
+  if (!isBinary) {
+    try {
+      msg = JSON.parse(data.toString());
+    } catch {
+      msg = null;
+    }
+  }
+
+  // Handshakes stay here: the gateway is the robot's only dashboard link
+  if (msg?.type === TYPE_STATUS) return;
+
+  if (msg?.type !== TYPE_UI_CMD || typeof msg.cmd !== 'string' || !upstream.open) {
+    commands.stats.rejected++;
+    client.ws.send(JSON.stringify({
+      type: TYPE_STATUS, role: 'gateway', status: 'error',
+      msg: upstream.open ? 'only ui_cmd is forwarded' : 'robot offline'
+    }));
+    return;
+  }
+
+  client.commands++;
+  commands.push(msg, data.toString());
+}
+
+function attach(ws, req) {
+  const client = {
+    id: nextClientId++,
+    ws,
+    addr: req.socket.remoteAddress,
+    missed: new Set(),
+    sent: 0,
+    skipped: 0,
+    catchUps: 0,
+    commands: 0
+  };
+  clients.add(client);
+  console.log(`[Gateway] Client #${client.id} connected from ${client.addr} (${clients.size} total)`);
+
+  for (const text of cache.frames()) ws.send(text);
+
+  ws.on('message', (data, isBinary) => onClientMessage(client, data, isBinary));
+  ws.on('error', () => {});
+  ws.on('close', () => {
+    clients.delete(client);
+    console.log(`[Gateway] Client #${client.id} disconnected (${clients.size} total)`);
+  });
+}
+
+function stats() {
+  const c = commands.stats;
+  return {
+    robot: { url: ROBOT_URL, online: upstream.open, ...upstream.stats },
+    commands: {
+      ...c,
+      queued: commands.queue.length,
+      meanWaitMs: c.forwarded ? Math.round(c.totalWaitMs / c.forwarded) : 0,
+      ratePerS: COMMAND_RATE
+    },
+    clients: [...clients].map((client) => ({
+      id: client.id,
+      addr: client.addr,
+      sent: client.sent,
+      skipped: client.skipped,
+      catchUps: client.catchUps,
+      commands: client.commands,
+      buffered: client.ws.bufferedAmount
+    }))
+  };
+}
+
+// ============================================
+// SERVER
+// ============================================
+
+const server = http.createServer((req, res) => {
+  if (req.method === 'GET' && req.url === '/stats') {
+    res.writeHead(200, { 'Content-Type': 'application/json', 'Cache-Control': 'no-cache' });
+    res.end(JSON.stringify(stats(), null, 2));
+    return;
+  }
+  res.writeHead(404);
+  res.end();
+});
+
+// Any path: dashboards keep their URL, only the host changes
+new WebSocketServer({ server }).on('connection', attach);
+
+server.listen(PORT, () => {
+  console.log(`[Gateway] Serving dashboards on :${PORT}, robot at ${ROBOT_URL}, commands <= ${COMMAND_RATE}/s`);
+  upstream.connect();
+  setInterval(catchUp, CATCH_UP_INTERVAL_MS);
+});
@@ -0,0 +1,178 @@
+/**
+ * Stand-in for the rear board's WebSocket server
+ *
+ * Speaks the robot's protocol on the same path so the gateway (or the
+ * dashboard) can run without hardware: telemetry every
+ * TELEMETRY_INTERVAL_MS, occupancy map deltas every MAP_STREAM_INTERVAL_MS,
+ * a hazard alert now and then, and a WebSocket ping to every client like
+ * the LinkSupervisor. Handshakes and commands are logged, drive commands
+ * show up in the telemetry motor speeds, and the received command rate is
+ * printed each second so the gateway's limiter can be checked.
+ *
+ * Usage: node robot-standin.js [--port 8889]
+ *        node gateway.js --robot ws://localhost:8889/ws
+ */
+import { WebSocket, WebSocketServer } from 'ws';
+
+const args = {};
+for (let i = 2; i < process.argv.length; i++) {
+  if (process.argv[i].startsWith('--')) args[process.argv[i].slice(2)] = process.argv[++i];
+}
+const PORT = Number(args.port || 8889);
+
+// config.h
+const TELEMETRY_INTERVAL_MS = 500;
+const MAP_STREAM_INTERVAL_MS = 250;
+const MAP_TILES_PER_MESSAGE = 4;
+const LINK_PING_INTERVAL_MS = 100;
+const MOTOR_NORMAL_SPEED = 180;
+const MOTOR_TURN_SPEED = 150;
+const HAZARD_INTERVAL_MS = 15000;
+
+// OccupancyGrid
+const GRID_CELLS = 64;
+const TILE = 8;
+const CELL_CM = 5;
+
+const startMs = Date.now();
+const millis = () => Date.now() - startMs;
+
+const robot = {
+  autonomous: false,
+  left: 0,
+  right: 0,
+  commands: 0,
+  commandsThisSecond: 0
+};
+
+const wss = new WebSocketServer({ port: PORT, path: '/ws' });
+
+function broadcast(msg) {
+  const text = JSON.stringify(msg);
+  for (const ws of wss.clients) {
+    if (ws.readyState === WebSocket.OPEN) ws.send(text);
+  }
+}
+
+// ============================================
+// COMMANDS
+// ============================================
+
+function handleUiCmd(cmd) {
+  switch (cmd) {
+    case 'forward': robot.left = robot.right = MOTOR_NORMAL_SPEED; break;
+    case 'backward': robot.left = robot.right = -MOTOR_NORMAL_SPEED; break;
+    case 'left': robot.left = -MOTOR_TURN_SPEED; robot.right = MOTOR_TURN_SPEED; break;
+    case 'right': robot.left = MOTOR_TURN_SPEED; robot.right = -MOTOR_TURN_SPEED; break;
+    case 'stop': robot.left = robot.right = 0; break;
+    case 'auto_on': robot.autonomous = true; break;
+    case 'auto_off': robot.autonomous = false; robot.left = robot.right = 0; break;
+    default: break;
+  }
+}
+
+wss.on('connection', (ws, req) => {
+  console.log(`[Standin] Client connected from ${req.socket.remoteAddress} (${wss.clients.size} total)`);
+
+  ws.on('message', (data) => {
+    let msg;
+    try {
+      msg = JSON.parse(data.toString());
+    } catch {
+      console.log('[Standin] JSON error');
+      return;
+    }
+
+    if (msg.type === 'status' && msg.role) {
+      console.log(`[Standin] Client registered as ${msg.role}`);
+    } else if (msg.type === 'ui_cmd') {
+      robot.commands++;
+      robot.commandsThisSecond++;
+      handleUiCmd(msg.cmd);
+      console.log(`[Standin] ui_cmd ${msg.cmd}`);
+    }
+  });
+
+  ws.on('close', () => console.log(`[Standin] Client disconnected (${wss.clients.size} total)`));
+});
+
+// ============================================
+// STREAMS
+// ============================================
+
+function sendTelemetry() {
+  const t = millis() / 1000;
+  broadcast({
+    type: 'telemetry',
+    from: 'back',
+    sensors: {
+      front_dist: Math.round(80 + 60 * Math.sin(t / 3)),
+      rear_dist: Math.round(120 + 40 * Math.cos(t / 5)),
+      gas: Math.round(300 + 20 * Math.sin(t)),
+      front_conf: 1,
+      rear_conf: 1
+    },
+    motors: {
+      front_left: robot.left,
+      front_right: robot.right,
+      rear_left: robot.left,
+      rear_right: robot.right
+    },
+    state: {
+      autonomous: robot.autonomous,
+      nav_state: robot.autonomous ? 'forward' : 'idle',
+      mode: robot.autonomous ? 'AUTONOMOUS' : 'MANUAL'
+    },
+    server_clients: wss.clients.size,
+    network: { front: true, camera: false, front_link: 'healthy', dash_link: 'healthy' },
+    control: { out: 0, err: 0, sp: 0, P: 0, I: 0, D: 0 },
+    timing: { loop_us: 900 + Math.round(Math.random() * 200) },
+    ts: millis()
+  });
+}
+
+// One tile of RLE (run, value) pairs, base64 like OccupancyGrid::encodeTile
+function randomTile() {
+  const bytes = [];
+  for (let left = TILE * TILE; left > 0;) {
+    const run = Math.min(left, 1 + Math.floor(Math.random() * 16));
+    const value = Math.floor(Math.random() * 5) * 24 - 48;  // int8 log-odds
+    bytes.push(run, value & 0xff);
+    left -= run;
+  }
+  return Buffer.from(bytes).toString('base64');
+}
+
+function sendMapDelta() {
+  const tiles = [];
+  const perSide = GRID_CELLS / TILE;
+  for (let i = 0; i < MAP_TILES_PER_MESSAGE; i++) {
+    tiles.push([Math.floor(Math.random() * perSide), Math.floor(Math.random() * perSide), randomTile()]);
+  }
+  broadcast({
+    type: 'map_delta',
+    cell_cm: CELL_CM,
+    tile: TILE,
+    origin: [0, 0],
+    pose: [GRID_CELLS * CELL_CM / 2, GRID_CELLS * CELL_CM / 2, (millis() / 4000) % (2 * Math.PI)],
+    tiles,
+    ts: millis()
+  });
+}
+
+function sendHazard() {
+  broadcast({ type: 'hazard_alert', hazard: 'gas', msg: 'Gas level rising', critical: false, ts: millis() });
+}
+
+setInterval(sendTelemetry, TELEMETRY_INTERVAL_MS);
+setInterval(sendMapDelta, MAP_STREAM_INTERVAL_MS);
+setInterval(sendHazard, HAZARD_INTERVAL_MS);
+setInterval(() => {
+  for (const ws of wss.clients) ws.ping();
+}, LINK_PING_INTERVAL_MS);
+setInterval(() => {
+  if (robot.commandsThisSecond) console.log(`[Standin] ${robot.commandsThisSecond} cmd/s (${robot.commands} total)`);
+  robot.commandsThisSecond = 0;
+}, 1000);
+
+console.log(`[Standin] Robot protocol on ws://localhost:${PORT}/ws`);